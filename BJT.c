@@ -2,7 +2,9 @@
 
 I've started this project for making easier the transistor and 
 related operations. The important point is that all transistors are
-'npn' types. But, can be derivated easily 'pnp' implementations. 
+'npn' types. 'pnp' ones are their mirror images (opposite signs of
+voltages and currents) and are evaluated by same functions, see
+'POLARITY.h'.
 This package contains mostly used configuration and some special
 connections. Another important point is that in AC analysis of
 transistors, algorithms use 're' transistor model.
@@ -15,321 +17,10 @@ Boylestad and Louis Nashelsky
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
-
-// General constants
-#define Vbe 0.7
-
-// Results of DC analysis
-struct DCComponents {
-   float Ib; // base current
-   float Ic; // collector current 
-   float Ie; // emitter current
-   float Icsat; // collector saturation (max) current
-   float Vce; // collector-emitter voltage
-   float Vc; // collector voltage
-   float Ve; // emitter voltage
-   float Vb; // base voltage
-   float Vbc; // base-collector voltage
-};
-// Results of AC analysis
-struct ACComponents {
-   float re; // re factor
-   float Zi;  // input impedance
-   float Zo; // output impedance
-   float Av; // voltage gain
-   char* phase; // phase relationship
-};
-
-/* For all DC configuration: */
-struct DCComponents DCAnalysis;
-/* For all AC configuration */
-struct ACComponents ACAnalysis;
-
-float _Rth_(float R1, float R2) {
-   // Rth is necesarry for voltage divider config.
-   return 1 / (1/R1 + 1/R2); 
-}
-float _Eth_(float Vcc, float R1, float R2) {
-   // Eth is necesarry for voltage divider config.
-   return Vcc * (R2 / (R1 + R2));
-}
-
-void _save_dc_results_(float Ib, float Ic, float Ie, float Icsat,
-                       float Vce, float Vc, float Ve, float Vb, 
-                       float Vbc) {
-   // Save results into 'DCAnalysis' struct.
-   DCAnalysis.Ib = Ib; // base current
-   DCAnalysis.Ic = Ic; // collector current
-   DCAnalysis.Ie = Ie; // emitter current
-   DCAnalysis.Icsat = Icsat; // collector saturation (max) current
-   DCAnalysis.Vce = Vce; // collector-emitter voltage
-   DCAnalysis.Vc = Vc; // collector voltage
-   DCAnalysis.Ve = Ve; // emitter voltage
-   DCAnalysis.Vb = Vb; // base voltage
-   DCAnalysis.Vbc = Vbc; // base-collector voltage
-}
-
-void _save_ac_results_(float re, float Zi, float Zo, float Av,       
-                       char* phase) {
-   // Save results into 'ACAnalysis' struct.
-   ACAnalysis.re = re;
-   ACAnalysis.Zi = Zi; // input impedance
-   ACAnalysis.Zo = Zo; // output impedance
-   ACAnalysis.Av = Av; // voltage gain
-   ACAnalysis.phase = phase; // phase relationships
-}
-
-/* The DC and AC Analysis of Fixed-Bias Configuration */
-void fixed_bias(char* analysis, float Vcc, float Rb, float Rc, 
-                float beta, float ro) {
-   // Check if the parameters are correct.
-   assert (Rb > 0 && Rc > 0 && beta > 0 && ro > 0);
-   // These parameters can be required for both analyzes.
-   float Ib = (Vcc - Vbe) / Rb; // base current
-   float Ie = (beta + 1) * Ib; // emitter current
-   // Calculate the DC results.
-   float Ic = beta * Ib; // collector current
-   float Icsat = Vcc / Rc; // collector saturation current
-   float Vce = Vcc - (Ic * Rc); // collector-emitter voltage
-   float Vc = Vce; // collector voltage
-   float Ve = 0; // emitter voltage
-   float Vb = Vbe; // base voltage
-   float Vbc = Vb - Vc; // base-collector voltage
-   // Calculate the AC results.
-   float re = 0.026 / Ie; // re factor
-   float Zi = 1 / (1/Rb + 1/(beta * re)); // input impedance
-   float Zo = 1 / (1/Rc + 1/ro); // output impedance
-   float Av = -1 * (1 / (1/Rc + 1/ro)) / re; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "Out of phase");
-}
-
-/* The DC and AC Analysis of Emitter-Bias Configuration */
-void emitter_bias(char* analysis, float Vcc, float Rb, float Rc, 
-                  float Re, float beta, float ro) {
-   // Check if the parameters are correct.
-   assert (Rb > 0 && Rc > 0 && Re > 0 && beta > 0 && ro > 0);
-   // These parameters can be required for both analyzes.
-   float Ib = (Vcc - Vbe) / (Rb + (beta + 1) * Re); // base current
-   float Ie = (beta + 1) * Ib; // emitter current
-   // Calculate the DC results.
-   float Ic = beta * Ib; // collector current
-   float Icsat = Vcc / (Rc + Re); // collector saturation current
-   float Vce = Vcc - Ic * (Rc + Re); // collector-emitter voltage
-   float Ve = Ie * Re; // emitter voltage
-   float Vc = Vce + Ve; // collector voltage
-   float Vb = Vbe + Ve; // base voltage
-   float Vbc = Vb - Vc; // base-collector voltage
-   // Calculate the AC results.
-   float re = 0.026 / Ie; // re factor
-   float Zb1 = (beta + 1) + (Rc/ro);
-   float Zb2 = 1 + (Rc + Re) / ro;
-   float Zb = beta * re + (Zb1 / Zb2) * Re;
-   float Zi = 1 / (1/Rb + 1/Zb); // input impedance
-   float Zo1 = beta * (ro + re);
-   float Zo2 = 1 + (beta * re) / Re;
-   float Zo3 = ro + Zo1 / Zo2;
-   float Zo = 1 / (1/Rc + 1/Zo3); // output impedance
-   float Av1 = (-1 * (beta * Rc) / Zb) * (1 + (re/ro)) + (Rc/ro);
-   float Av2 = 1 + (Rc / ro);
-   float Av = Av1 / Av2; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "Out of phase");
-}
-
-/* The DC and AC Analysis of Voltage-Divider Configuration */
-void voltage_divider(char* analysis, float Vcc, float Rb1, 
-                     float Rb2, float Rc, float Re, float beta, 
-                     float ro, char* bypass) {
-   // Check if the parameters are correct.
-   assert (Rb1 > 0 && Rb2 > 0 && Rc > 0 && Re > 0);
-   assert (beta > 0 && ro > 0);
-   // These parameters can be required for both analyzes.
-   float rth = _Rth_(Rb1, Rb2); 
-   float eth = _Eth_(Vcc, Rb1, Rb2);
-   float Ib = (eth - Vbe) / (rth +(beta + 1) * Re); // base current
-   float Ie = (beta + 1) * Ib; // emitter current
-   float re = 0.026 / Ie; // re factor
-   // Calculate the DC results.
-   float Ic = beta * Ib; // collector current
-   float Icsat = Vcc / (Rc + Re); // collector saturation current
-   float Vce = Vcc - Ic * (Rc + Re); // collector-emitter current
-   float Ve = Ie * Re; // emitter voltage
-   float Vc = Vce + Ve; // collector voltage
-   float Vb = Vbe + Ve; // base voltage
-   float Vbc = Vb - Vc; // base-collector voltage
-   // Calculate the AC results.
-   float Zb1, Zb2, Zb, Zi, Zo1, Zo2, Zo3, Zo, Av1, Av2, Av;
-   // Specialize the calculations according to 'bypass' parameter.
-   if (strcmp(bypass, "bypassed") == 0) {
-      Zi = 1 / (1 /rth + 1 /(beta * re)); // input impedance
-      Zo = 1 / (1/Rc + 1/ro); // output impedance
-      Av = -1 * (1 / (1/Rc + 1/ro)) / re; // voltage gain
-   } else {
-      Zb1 = (beta + 1) + (Rc/ro);
-      Zb2 = 1 + (Rc + Re) / ro;
-      Zb = beta * re + (Zb1 / Zb2) * Re;
-      Zi = 1 / (1/rth + 1/Zb); // input impedance
-      Zo1 = beta * (ro + re);
-      Zo2 = 1 + (beta * re) / Re;
-      Zo3 = ro + Zo1 / Zo2;
-      Zo = 1 / (1/Rc + 1/Zo3); // output impedance
-      Av1 = (-1 * (beta * Rc) / Zb) * (1 + (re/ro)) + (Rc/ro);
-      Av2 = 1 + (Rc / ro);
-      Av = Av1 / Av2; // voltage gain
-   }
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "Out of phase");
-}
-
-void collector_feedback(char* analysis, float Vcc, float Rf, 
-                        float Rc, float Re, float beta, float ro) {
-   // Check if the parameters are correct.
-   assert (Rf > 0 && Rc > 0 && Re > 0 && beta > 0 && ro > 0);
-   // These parameters can be required for both analyzes.
-   float Ib;
-   if (strcmp(analysis, "ac")) // if 'analysis' is dc.
-   Ib = (Vcc - Vbe) / (Rf + beta * (Rc+Re)); // base current
-   else // if 'analysis' is ac.
-   Ib = (Vcc - Vbe) / (Rf + beta * Rc); // base current
-   float Ie = (beta + 1) * Ib; // emitter current
-   // Calculate the DC results.
-   float Ic = beta * Ib; // collector current
-   float Icsat = Vcc / (Rc + Re); // collector saturation current
-   float Vce = Vcc - Ic * (Rc + Re); // collector-emitter voltage
-   float Ve = Ie * Re; // emitter voltage
-   float Vc = Vce + Ve; // collector voltage
-   float Vb = Vbe + Ve; // base voltage
-   float Vbc = Vb - Vc; // base-collector voltage
-   // Calculate the AC results.
-   float re = 0.026 / Ie; // re factor
-   float Zi1 = 1 + (_Rth_(Rc, ro) / Rf);
-   float Zi2 = (1 / (beta * re)) + (1 / Rf);
-   float Zi3 = _Rth_(Rc, ro) / (beta * re * Rf);
-   float Zi4 = _Rth_(Rc, ro) / (Rf * re);
-   float Zi = Zi1 / (Zi2 + Zi3 + Zi4); // input impedance
-   float Zo = 1 / (1/ro + 1/Rc + 1/Rf); // output impedance
-   float Av1 = Rf / (_Rth_(Rc, ro) + Rf);
-   float Av2 = _Rth_(Rc, ro) / re;
-   float Av = -1 * Av1 * Av2; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "Out of phase");
-}
-
-/* The AC Analysis of Collector-DC-Feedback Configuration */
-void collector_dc_feedback(char* analysis, float Vcc, float Rf1,
-                           float Rf2, float Rc, float beta, 
-                           float ro) {
-   // Check if the parameters are correct.
-   assert (Rf1 > 0 && Rf2 > 0 && Rc > 0 && beta > 0 && ro > 0); 
-   // Calculate AC the results.
-   float Ib = (Vcc - Vbe) / (Rf1+Rf2 + (beta * Rc)); // base current
-   float Ie = (beta + 1) * Ib; // emitter current
-   float re = 0.026 / Ie; // re factor
-   float Zi = 1 / (1/Rf1 + 1/(beta * re)); // input impedance
-   float Zo = 1 / (1/Rc + 1/Rf2 + 1/ro); // output impedance
-   float Av = -1 * Zo / re; // voltage gain
-   if (strcmp(analysis, "dc") == 0 ) { // dc results
-   puts("Transistor do not support dc analysis !!!"); 
-   exit(EXIT_FAILURE); }
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "Out of phase");
-}
-
-/* The DC and AC Analysis of Emitter-Follower Configuration */
-void emitter_follower(char* analysis, float Vcc, float Vee, 
-                      float Rb, float Re, float beta, float ro) {
-   // Check if the parameters are correct.
-   assert (Rb > 0 && Re > 0 && beta > 0 && ro > 0);
-   // These parameters can be required for both analyzes.
-   float Ib; 
-   if (strcmp(analysis, "ac")) // dc analysis
-   Ib = (Vee - Vbe) / (Rb + (beta + 1) * Re); // base current
-   else // ac analysis
-   Ib = (Vcc - Vbe) / (Rb + (beta + 1) * Re); // base current
-   float Ie = (beta + 1) * Ib; // emitter current
-   // Calculate the DC results.
-   float Ic = beta * Ib; // collector current
-   float Vce = Vee - (Ie * Re); // collector-enitter voltage
-   float Ve = (Ie * Re) + Vee; // emitter voltage
-   float Vc = Vce + Ve; // collector voltage
-   float Vb = Vbe + Ve; // base voltage
-   float Vbc = Vb - Vc; // base-collector voltage
-   // Calculate the AC results.
-   float re = 0.026 / Ie; // re factor
-   float Zb1 = (beta + 1) * Re;
-   float Zb2 = 1 + (Re / ro);
-   float Zb = (beta * re) + (Zb1 / Zb2);
-   float Zi = 1 / (1 /Rb + 1 /Zb); // input impedance
-   float Zo1 = (beta * re) / (beta + 1);
-   float Zo = 1 / (1 /ro + 1 /Re + 1 /Zo1); // output impedance
-   float Av1 = (beta + 1) * Re / Zb;
-   float Av = Av1 / (1 + (Re/ro)); // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, -1.0, Vce, Vc, Ve, Vb, Vbc);
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "In phase");
-}
-
-/* The DC and AC Analysis of Common-Base COnfiguration */
-void common_base(char* analysis, float Vcc, float Vee, float Rc,
-                 float Re, float beta, float alpha) {
-   // Check if the parameters are correct.
-   assert (Rc > 0 && Re > 0 && beta > 0 && alpha > 0);
-   // These parameters can be required for both analyzes.
-   float Ie = (Vee - Vbe) / Re; // emitter current
-   // Calculate the DC results.
-   float Ib = Ie / (beta + 1); // base current
-   float Ic = Ib * beta; // collector current
-   float Vce = Vee + Vcc - Ie * (Rc + Re); // collector-emitter v.
-   float Vcb = Vcc - Ic * Rc; // collector-base voltage
-   float Vbc = -1 * Vcb; // base-collector voltage
-   // Calculate the AC results.
-   float re = 0.026 / Ie; // re factor
-   float Zi = 1 / (1/Re + 1/re); // input impedance
-   float Zo = Rc; // output impedance
-   float Av = alpha * Rc / re; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, -1.0, Vce, -1.0, -1.0, -1.0, Vbc);
-   else // ac results
-   _save_ac_results_(re, Zi, Zo, Av, "In phase");
-}
-
-/* The DC Analysis of Miscellaneous-Bias COnfiguration */
-void miscellaneous_bias(char* analysis, float Vcc, float Rb, 
-                        float Rc, float beta) {
-   // Check if the parameters are correct.
-   assert (Rb > 0 && Rc > 0 && beta > 0);
-   // Calculate DC the results.
-   float Ib = (Vcc - Vbe) / (Rb + beta * Rc); // base current
-   float Ic = beta * Ib; // collector current
-   float Ie = (beta + 1) * Ib; // emitter current
-   float Vce = Vcc - (Ie * Rc); // collector-emitter voltage
-   float Ve = 0; // emitter voltage
-   float Vc = Vce + Ve; // collector voltage
-   float Vb = Vbe + Ve; // base voltage
-   float Vbc = Vb - Vc; // base-collector voltage
-   // Save the results into struct.
-   if (strcmp(analysis, "dc") == 0) // dc results
-   _save_dc_results_(Ib, Ic, Ie, -1.0, Vce, Vc, Ve, Vb, Vbc);
-   else { // ac results
-   puts("Transistor do not support ac analysis !!!"); 
-   exit(EXIT_FAILURE); }
-}
+#include "BJT.h"
+#include "JOBS.h"
+#include "DECK.h"
+#include "OPTIMIZE.h"
 
 void _display_transistors_(char* analysis, char* transistor) {
    // Display the all transistors.
@@ -512,47 +203,65 @@ void _miscellaneous_bias_inputs_(char* analysis, float* Vcc,
    puts("-------------------------------------------");
 }
 
-void _display_dc_results_(char* transistor) {
+void _display_dc_results_(char* transistor, struct DCBJT* dc) {
    // Display the DC results.
    puts("RESULTS: ");
-   printf("Ib: %e A\n", DCAnalysis.Ib);
-   printf("Ic: %e A\n", DCAnalysis.Ic);
-   printf("Ie: %e A\n", DCAnalysis.Ie);
+   printf("Ib: %e A\n", dc->Ib);
+   printf("Ic: %e A\n", dc->Ic);
+   printf("Ie: %e A\n", dc->Ie);
    if (strcmp(transistor, "ef") && strcmp(transistor, "cb") &&
        strcmp(transistor, "mb"))
-   printf("Ic sat.: %e A\n", DCAnalysis.Icsat);
-   printf("Vce: %f V\n", DCAnalysis.Vce);
+   printf("Ic sat.: %e A\n", dc->Icsat);
+   printf("Vce: %f V\n", dc->Vce);
    if (strcmp(transistor, "cb")) {
-   printf("Vc: %f V\n", DCAnalysis.Vc);
-   printf("Ve: %f V\n", DCAnalysis.Ve);
-   printf("Vb: %f V\n", DCAnalysis.Vb);
+   printf("Vc: %f V\n", dc->Vc);
+   printf("Ve: %f V\n", dc->Ve);
+   printf("Vb: %f V\n", dc->Vb);
    }
-   printf("Vbc: %f V\n", DCAnalysis.Vbc);
-   printf("Vbe: %f V\n", Vbe);
+   printf("Vbc: %f V\n", dc->Vbc);
+   printf("Vbe: %f V\n", BJT_VBE);
    puts("-------------------------------------------");
 }
 
-void _display_ac_results_(void) {
+void _display_ac_results_(struct ACBJT* ac) {
    // Display the AC results
    puts("RESULTS: ");
-   printf("re: %f ohm\n", ACAnalysis.re);
-   printf("Zi: %f ohm\n", ACAnalysis.Zi);
-   printf("Zo: %f ohm\n", ACAnalysis.Zo);
-   printf("Av: %f\n", ACAnalysis.Av);
-   printf("phase: %s\n", ACAnalysis.phase);
+   printf("re: %f ohm\n", ac->re);
+   printf("Zi: %f ohm\n", ac->Zi);
+   printf("Zo: %f ohm\n", ac->Zo);
+   printf("Av: %f\n", ac->Av);
+   printf("phase: %s\n", ac->phase);
    puts("-------------------------------------------");
 }
 
 /* Main method that will display the all implemnetations */
-int main(void) {
+int main(int argc, char* argv[]) {
    // 'analysis' argument represents the type of analysis.
-   char analysis[2];
+   char analysis[3];
    // 'transistor' argument represents type of transistor.
-   char transistor[2];
+   char transistor[4];
    // These arguments represent the values of a transistor. 
    float Vcc, Rb1, Rb2, Rc, beta, Re, Rf1, Vee, ro, Rf2, alpha;
    // Determine the AC analysis of voltage-divider config status.
-   char bypass[10];
+   char bypass[11];
+   // Results of the analysis.
+   struct DCBJT dc = {0};
+   struct ACBJT ac = {0};
+
+   // Read jobs from a file or stdin, a deck or a design instead of
+   // prompts.
+   if (argc > 1 && (strcmp(argv[1], "-j") == 0 ||
+                    strcmp(argv[1], "-d") == 0 ||
+                    strcmp(argv[1], "-o") == 0)) {
+      struct JobTable tables[] = {{NULL, BJTConfigs, BJTConfigCount}};
+      char* format = argc > 3 ? argv[3] : "text";
+      if (strcmp(argv[1], "-d") == 0)
+         return argc > 2 ? run_deck_file(argv[2], format, tables, 1) : 1;
+      if (strcmp(argv[1], "-o") == 0)
+         return run_design_file(argc > 2 ? argv[2] : "-", format, tables,
+                                1);
+      return run_job_file(argc > 2 ? argv[2] : "-", format, tables, 1);
+   }
 
    puts("-------------------------------------------");
    puts("  WELLCOME TO ANALYSIS OF BJT TRANSISTORS  ");
@@ -572,18 +281,18 @@ int main(void) {
          // Get inputs of fixed-bias config.
          _fixed_bias_inputs_("dc", &Vcc, &Rb1, &Rc, &beta, 1);
          // Calculate the results of fixed-bias config.
-         fixed_bias("dc", Vcc, Rb1, Rc, beta, 1);
+         b_fixed_bias("dc", Vcc, Rb1, Rc, beta, 1, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_dc_results_("dc");
+         _display_dc_results_("dc", &dc);
       } 
       // For Emitter-Bias Configuration:
       else if (strcmp(transistor, "eb") == 0) {
          // Get inputs of emitter-bias config.
          _emitter_bias_inputs_("dc", &Vcc, &Rb1, &Rc, &Re, &beta, 1);
          // Calculate the results of emitter-bias config.
-         emitter_bias("dc", Vcc, Rb1, Rc, Re, beta, 1);
+         b_emitter_bias("dc", Vcc, Rb1, Rc, Re, beta, 1, &dc, &ac);
          // Diplay the results of emitter-bias config.
-         _display_dc_results_("em");
+         _display_dc_results_("em", &dc);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -591,10 +300,10 @@ int main(void) {
          _voltage_divider_inputs_("dc", &Vcc, &Rb1, &Rb2, &Rc, &Re,
                                   &beta, 1, "Undefined");
          // Calculate the results of voltage-divider config.
-         voltage_divider("dc", Vcc, Rb1, Rb2, Rc, Re, beta, 
-                         1, "Undefined");
+         b_voltage_divider("dc", Vcc, Rb1, Rb2, Rc, Re, beta, 
+                           1, "Undefined", &dc, &ac);
          // Display the results of voltage-divider config.
-         _display_dc_results_("dv");
+         _display_dc_results_("dv", &dc);
       }
       // For Collector-Feedback Configuration:
       else if (strcmp(transistor, "cf") == 0) {
@@ -602,9 +311,10 @@ int main(void) {
          _collector_feedback_inputs_("dc", &Vcc, &Rf1, &Rc, &Re, 
                                      &beta, 1);
          // Calculate the results of collector-feedback config.
-         collector_feedback("dc", Vcc, Rf1, Rc, Re, beta, 1);
+         b_collector_feedback("dc", Vcc, Rf1, Rc, Re, beta, 1, &dc, 
+                              &ac);
          // Display the results of collector-feedback config.
-         _display_dc_results_("cf");
+         _display_dc_results_("cf", &dc);
       }
       // For Emitter-Follower Configuration:
       else if (strcmp(transistor, "ef") == 0) {
@@ -612,27 +322,27 @@ int main(void) {
          _emitter_follower_inputs_("dc", 1, &Vee, &Rb1, &Re, 
                                    &beta, 1);
          // Calculate the results of emitter-follower config.
-         emitter_follower("dc", 1, Vee, Rb1, Re, beta, 1);
+         b_emitter_follower("dc", 1, Vee, Rb1, Re, beta, 1, &dc, &ac);
          // Display the results of emitter-follower config.
-         _display_dc_results_("ef");
+         _display_dc_results_("ef", &dc);
       }
       // For Common-Base Configuration:
       else if (strcmp(transistor, "cb") == 0) {
          // Get inputs of common-base config.
          _common_base_inputs_("dc", &Vcc, &Vee, &Rc, &Re, &beta, 1);
          // Calculate the results of common-base config.
-         common_base("dc", Vcc, Vee, Rc, Re, beta, 1);
+         b_common_base("dc", Vcc, Vee, Rc, Re, beta, 1, &dc, &ac);
          // Display the results of common-base config.
-         _display_dc_results_("cb");
+         _display_dc_results_("cb", &dc);
       }
       // For Miscellaneous-Bias Configuration:
       else if (strcmp(transistor, "mb") == 0) {
          // Get inputs of miscellaneous-bias config.
          _miscellaneous_bias_inputs_("dc", &Vcc, &Rb1, &Rc, &beta);
          // Calculate the results of miscellaneous-bias config.
-         miscellaneous_bias("dc", Vcc, Rb1, Rc, beta);
+         b_miscellaneous_bias("dc", Vcc, Rb1, Rc, beta, &dc, &ac);
          // Display the results of miscellaneous-bias config.
-         _display_dc_results_("mb");
+         _display_dc_results_("mb", &dc);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -645,9 +355,9 @@ int main(void) {
          // Get inputs of fixed-bias config.
          _fixed_bias_inputs_("ac", &Vcc, &Rb1, &Rc, &beta, &ro);
          // Calculate the results of fixed-bias config.
-         fixed_bias("ac", Vcc, Rb1, Rc, beta, ro);
+         b_fixed_bias("ac", Vcc, Rb1, Rc, beta, ro, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       } 
       // For Emitter-Bias Configuration:
       else if (strcmp(transistor, "eb") == 0) {
@@ -655,9 +365,9 @@ int main(void) {
          _emitter_bias_inputs_("ac", &Vcc, &Rb1, &Rc, &Re,
                                &beta, &ro);
          // Calculate the results of emitter-bias config.
-         emitter_bias("ac", Vcc, Rb1, Rc, Re, beta, ro);
+         b_emitter_bias("ac", Vcc, Rb1, Rc, Re, beta, ro, &dc, &ac);
          // Diplay the results of emitter-bias config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -666,14 +376,17 @@ int main(void) {
                                   &beta, &ro, &bypass);
          // Calculate the results of voltage-divider config.
          if (strcmp(bypass, "bypassed") == 0) 
-         voltage_divider("ac", Vcc, Rb1, Rb2, Rc, Re, beta, ro, 
-                         "bypassed");
+         b_voltage_divider("ac", Vcc, Rb1, Rb2, Rc, Re, beta, ro, 
+                           "bypassed", &dc, &ac);
          else if (strcmp(bypass, "unbypassed") == 0)
-         voltage_divider("ac", Vcc, Rb1, Rb2, Rc, Re, beta, ro, 
-                         "unbypassed");
-         else puts("Can not found that bypass !!!");
+         b_voltage_divider("ac", Vcc, Rb1, Rb2, Rc, Re, beta, ro, 
+                           "unbypassed", &dc, &ac);
+         else {
+            puts("Can not found that bypass !!!");
+            return 1;
+         }
          // Display the results of voltage-divider config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Collector-Feedback Configuration:
       else if (strcmp(transistor, "cf") == 0) {
@@ -681,9 +394,10 @@ int main(void) {
          _collector_feedback_inputs_("ac", &Vcc, &Rf1, &Rc, 1, 
                                      &beta, &ro);
          // Calculate the results of collector-feedback config.
-         collector_feedback("ac", Vcc, Rf1, Rc, 1, beta, ro);
+         b_collector_feedback("ac", Vcc, Rf1, Rc, 1, beta, ro, &dc, 
+                              &ac);
          // Display the results of collector-feedback config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Collector-DC-Feedback Configuration:
       else if (strcmp(transistor, "cdf") == 0) {
@@ -691,9 +405,10 @@ int main(void) {
          _collector_dc_feedback_inputs_("ac", &Vcc, &Rf1, &Rf2, 
                                         &Rc, &beta, &ro);
          // Calculate the results of collector-dc-feedback config.
-         collector_dc_feedback("ac", Vcc, Rf1, Rf2, Rc, beta, ro);
+         b_collector_dc_feedback("ac", Vcc, Rf1, Rf2, Rc, beta, ro, 
+                                 &dc, &ac);
          // Display the results of collector-dc-feedback config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Emitter-Follower Configuration:
       else if (strcmp(transistor, "ef") == 0) {
@@ -701,18 +416,18 @@ int main(void) {
          _emitter_follower_inputs_("ac", &Vcc, 1, &Rb1, &Re, 
                                    &beta, &ro);
          // Calculate the results of emitter-follower config.
-         emitter_follower("ac", Vcc, 1, Rb1, Re, beta, ro);
+         b_emitter_follower("ac", Vcc, 1, Rb1, Re, beta, ro, &dc, &ac);
          // Display the results of emitter-follower config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Common-Base Configuration:
       else if (strcmp(transistor, "cb") == 0) {
          // Get inputs of common-base config.
          _common_base_inputs_("ac", &Vcc, &Vee, &Rc, &Re, 1, &alpha);
          // Calculate the results of common-base config.
-         common_base("ac", Vcc, Vee, Rc, Re, 1, alpha);
+         b_common_base("ac", Vcc, Vee, Rc, Re, 1, alpha, &dc, &ac);
          // Display the results of common-base config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -0,0 +1,1823 @@
+/* Basics BJT Operations and Calculations */
+
+#ifndef BJT_H
+#define BJT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CONFIG.h"
+#include "DUAL.h"
+#include "INTERVAL.h"
+#include "BODE.h"
+#include "NEWTON.h"
+#include "REGION.h"
+#include "STATUS.h"
+
+// Base-emitter voltage and thermal voltage (re = VT / Ie) at room
+// temperature. Batch kernels take them as arguments, so a thermal run
+// (THERMAL.h) gives the values at other temperatures.
+#define BJT_VBE 0.7
+#define BJT_VT 0.026
+
+// Configuration functions save the results into 'DCBJT' or 'ACBJT'
+// struct (transistor.h) given by the caller (only the ones of
+// requested analysis are written). There is no shared state, so they
+// can run concurrently. Their kernels are also the loop bodies of the
+// batch functions: those give 0 for 'checked', so no status is saved,
+// and pass Vbe and VT of their own.
+
+static real _Rth_(real R1, real R2) {
+   // Rth is necesarry for voltage divider config.
+   return 1 / (1/R1 + 1/R2); 
+}
+static real _Eth_(real Vcc, real R1, real R2) {
+   // Eth is necesarry for voltage divider config.
+   return Vcc * (R2 / (R1 + R2));
+}
+
+static void _b_save_dc_results_(struct DCBJT* dc, real Ib, real Ic, real Ie,
+                                real Icsat, real Vce, real Vc, real Ve,
+                                real Vb, real Vbc) {
+   // Save results into 'dc' struct of the caller.
+   dc->Ib = Ib; // base current
+   dc->Ic = Ic; // collector current
+   dc->Ie = Ie; // emitter current
+   dc->Icsat = Icsat; // collector saturation (max) current
+   dc->Vce = Vce; // collector-emitter voltage
+   dc->Vc = Vc; // collector voltage
+   dc->Ve = Ve; // emitter voltage
+   dc->Vb = Vb; // base voltage
+   dc->Vbc = Vbc; // base-collector voltage
+   dc->region = _bjt_region_(Ic, Vce); // operating region
+}
+
+static void _b_save_ac_results_(struct ACBJT* ac, real re, real Zi, real Zo,
+                                real Av, char* phase) {
+   // Save results into 'ac' struct of the caller.
+   ac->re = re;
+   ac->Zi = Zi; // input impedance
+   ac->Zo = Zo; // output impedance
+   ac->Av = Av; // voltage gain
+   ac->phase = phase; // phase relationships
+}
+
+static void _b_status_(int analysis, int status, struct DCBJT* dc,
+                       struct ACBJT* ac) {
+   // Save status of point into results of 'analysis', the results are
+   // NaN if the point is not valid or the analysis is not supported
+   // (results which are not finite are kept like 'run_checked' does).
+   int nan = status == STATUS_INVALID || status == STATUS_UNSUPPORTED;
+   if (analysis & ANALYSIS_DC) {
+      if (nan)
+         _b_save_dc_results_(dc, NAN, NAN, NAN, NAN, NAN, NAN, NAN, NAN,
+                             NAN);
+      dc->status = status;
+   }
+   if (analysis & ANALYSIS_AC) {
+      if (nan)
+         _b_save_ac_results_(ac, NAN, NAN, NAN, NAN,
+                             status == STATUS_UNSUPPORTED ? "" :
+                             ac->phase);
+      ac->status = status;
+   }
+}
+
+static int _b_finite_(int analysis, struct DCBJT* dc, struct ACBJT* ac) {
+   // 1 if all results of 'analysis' are finite.
+   if (analysis & ANALYSIS_DC)
+      return isfinite(dc->Ib) && isfinite(dc->Ic) && isfinite(dc->Ie) &&
+             isfinite(dc->Icsat) && isfinite(dc->Vce) &&
+             isfinite(dc->Vc) && isfinite(dc->Ve) && isfinite(dc->Vb) &&
+             isfinite(dc->Vbc);
+   return isfinite(ac->re) && isfinite(ac->Zi) && isfinite(ac->Zo) &&
+          isfinite(ac->Av);
+}
+
+static void _b_check_(int analysis, int dc_valid, int ac_valid,
+                      struct DCBJT* dc, struct ACBJT* ac) {
+   // Save status of DC and AC stages. A stage is valid if the
+   // parameters of its 'Config' entry are in their domains, checked by
+   // '_status_valid_' like 'run_checked' does (STATUS.h). A valid
+   // stage with results that are not finite is STATUS_NONFINITE.
+   int dc_status = !dc_valid ? STATUS_INVALID :
+                   (analysis & ANALYSIS_DC) &&
+                   !_b_finite_(ANALYSIS_DC, dc, ac) ? STATUS_NONFINITE :
+                   STATUS_OK;
+   int ac_status = !ac_valid ? STATUS_INVALID :
+                   (analysis & ANALYSIS_AC) &&
+                   !_b_finite_(ANALYSIS_AC, dc, ac) ? STATUS_NONFINITE :
+                   STATUS_OK;
+   _b_status_(analysis & ANALYSIS_DC, dc_status, dc, ac);
+   _b_status_(analysis & ANALYSIS_AC, ac_status, dc, ac);
+}
+
+/* The DC and AC Analysis of Fixed-Bias Configuration */
+KERNEL void _b_fixed_bias_(const int analysis, const int checked, real Vbe,
+                           real VT, real Vcc, real Rb, real Rc, real beta,
+                           real ro, real* op, struct DCBJT* dc,
+                           struct ACBJT* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_POSITIVE, Rb) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, beta);
+   int ac_valid = dc_valid & _status_valid_(STATUS_POSITIVE, ro);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Ib = (Vcc - Vbe) / Rb; // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      op[0] = Ib; op[1] = Ie;
+   }
+   real Ib = op[0], Ie = op[1];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ic = beta * Ib; // collector current
+      real Icsat = Vcc / Rc; // collector saturation current
+      real Vce = Vcc - (Ic * Rc); // collector-emitter voltage
+      real Vc = Vce; // collector voltage
+      real Ve = 0; // emitter voltage
+      real Vb = Vbe; // base voltage
+      real Vbc = Vb - Vc; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real re = VT / Ie; // re factor
+      real Zi = 1 / (1/Rb + 1/(beta * re)); // input impedance
+      real Zo = 1 / (1/Rc + 1/ro); // output impedance
+      real Av = -1 * (1 / (1/Rc + 1/ro)) / re; // voltage gain
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _b_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void b_fixed_bias(char* analysis, real Vcc, real Rb, real Rc, real beta,
+                  real ro, struct DCBJT* dc, struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_fixed_bias_, 1, BJT_VBE, BJT_VT,
+                     Vcc, Rb, Rc, beta, ro, op, dc, ac);
+}
+
+/* The DC and AC Analysis of Emitter-Bias Configuration */
+KERNEL void _b_emitter_bias_(const int analysis, const int checked,
+                             real Vbe, real VT, real Vcc, real Rb, real Rc,
+                             real Re, real beta, real ro, real* op,
+                             struct DCBJT* dc, struct ACBJT* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_POSITIVE, Rb) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_POSITIVE, beta);
+   int ac_valid = dc_valid & _status_valid_(STATUS_POSITIVE, ro);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Ib = (Vcc - Vbe) / (Rb + (beta + 1) * Re); // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      op[0] = Ib; op[1] = Ie;
+   }
+   real Ib = op[0], Ie = op[1];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ic = beta * Ib; // collector current
+      real Icsat = Vcc / (Rc + Re); // collector saturation current
+      real Vce = Vcc - Ic * (Rc + Re); // collector-emitter voltage
+      real Ve = Ie * Re; // emitter voltage
+      real Vc = Vce + Ve; // collector voltage
+      real Vb = Vbe + Ve; // base voltage
+      real Vbc = Vb - Vc; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real re = VT / Ie; // re factor
+      real Zb1 = (beta + 1) + (Rc/ro);
+      real Zb2 = 1 + (Rc + Re) / ro;
+      real Zb = beta * re + (Zb1 / Zb2) * Re;
+      real Zi = 1 / (1/Rb + 1/Zb); // input impedance
+      real Zo1 = beta * (ro + re);
+      real Zo2 = 1 + (beta * re) / Re;
+      real Zo3 = ro + Zo1 / Zo2;
+      real Zo = 1 / (1/Rc + 1/Zo3); // output impedance
+      real Av1 = (-1 * (beta * Rc) / Zb) * (1 + (re/ro)) + (Rc/ro);
+      real Av2 = 1 + (Rc / ro);
+      real Av = Av1 / Av2; // voltage gain
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _b_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void b_emitter_bias(char* analysis, real Vcc, real Rb, real Rc, real Re,
+                    real beta, real ro, struct DCBJT* dc,
+                    struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_emitter_bias_, 1, BJT_VBE,
+                     BJT_VT, Vcc, Rb, Rc, Re, beta, ro, op, dc, ac);
+}
+
+/* The DC and AC Analysis of Voltage-Divider Configuration */
+KERNEL void _b_voltage_divider_(const int analysis, const int checked,
+                                real Vbe, real VT, real Vcc, real Rb1,
+                                real Rb2, real Rc, real Re, real beta,
+                                real ro, const int bypassed, real* op,
+                                struct DCBJT* dc, struct ACBJT* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_POSITIVE, Rb1) &
+                  _status_valid_(STATUS_POSITIVE, Rb2) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_POSITIVE, beta);
+   int ac_valid = dc_valid & _status_valid_(STATUS_POSITIVE, ro);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real rth = _Rth_(Rb1, Rb2); 
+      real eth = _Eth_(Vcc, Rb1, Rb2);
+      real Ib = (eth - Vbe) / (rth +(beta + 1) * Re); // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      op[0] = rth; op[1] = Ib; op[2] = Ie;
+   }
+   real rth = op[0], Ib = op[1], Ie = op[2];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ic = beta * Ib; // collector current
+      real Icsat = Vcc / (Rc + Re); // collector saturation current
+      real Vce = Vcc - Ic * (Rc + Re); // collector-emitter current
+      real Ve = Ie * Re; // emitter voltage
+      real Vc = Vce + Ve; // collector voltage
+      real Vb = Vbe + Ve; // base voltage
+      real Vbc = Vb - Vc; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real re = VT / Ie; // re factor
+      real Zb1, Zb2, Zb, Zi, Zo1, Zo2, Zo3, Zo, Av1, Av2, Av;
+      // Specialize the calculations according to 'bypass' parameter.
+      if (bypassed) {
+         Zi = 1 / (1 /rth + 1 /(beta * re)); // input impedance
+         Zo = 1 / (1/Rc + 1/ro); // output impedance
+         Av = -1 * (1 / (1/Rc + 1/ro)) / re; // voltage gain
+      } else {
+         Zb1 = (beta + 1) + (Rc/ro);
+         Zb2 = 1 + (Rc + Re) / ro;
+         Zb = beta * re + (Zb1 / Zb2) * Re;
+         Zi = 1 / (1/rth + 1/Zb); // input impedance
+         Zo1 = beta * (ro + re);
+         Zo2 = 1 + (beta * re) / Re;
+         Zo3 = ro + Zo1 / Zo2;
+         Zo = 1 / (1/Rc + 1/Zo3); // output impedance
+         Av1 = (-1 * (beta * Rc) / Zb) * (1 + (re/ro)) + (Rc/ro);
+         Av2 = 1 + (Rc / ro);
+         Av = Av1 / Av2; // voltage gain
+      }
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _b_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void b_voltage_divider(char* analysis, real Vcc, real Rb1, real Rb2,
+                       real Rc, real Re, real beta, real ro,
+                       char* bypass, struct DCBJT* dc, struct ACBJT* ac) {
+   // Run the kernel specialized for analysis and bypass.
+   real op[MODEL_OP]; // operating point
+   if (strcmp(bypass, "bypassed") == 0)
+      ANALYSIS_DISPATCH(_analysis_(analysis), _b_voltage_divider_, 1, BJT_VBE,
+                        BJT_VT, Vcc, Rb1, Rb2, Rc, Re, beta, ro, 1, op, dc,
+                        ac);
+   else
+      ANALYSIS_DISPATCH(_analysis_(analysis), _b_voltage_divider_, 1, BJT_VBE,
+                        BJT_VT, Vcc, Rb1, Rb2, Rc, Re, beta, ro, 0, op, dc,
+                        ac);
+}
+
+KERNEL void _b_collector_feedback_(const int analysis, const int checked,
+                                   real Vbe, real VT, real Vcc, real Rf,
+                                   real Rc, real Re, real beta, real ro,
+                                   real* op, struct DCBJT* dc,
+                                   struct ACBJT* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_POSITIVE, Rf) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_POSITIVE, beta);
+   int ac_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_POSITIVE, Rf) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, beta) &
+                  _status_valid_(STATUS_POSITIVE, ro);
+   // Operating points of DC (op[0]) and AC (op[1]) stages are
+   // different, only base currents of requested stages are solved.
+   if ((analysis & ANALYSIS_OP) && (analysis & ANALYSIS_DC))
+      op[0] = (Vcc - Vbe) / (Rf + beta * (Rc+Re)); // base current
+   if ((analysis & ANALYSIS_OP) && (analysis & ANALYSIS_AC))
+      op[1] = (Vcc - Vbe) / (Rf + beta * Rc); // base current
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ib = op[0]; // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      real Ic = beta * Ib; // collector current
+      real Icsat = Vcc / (Rc + Re); // collector saturation current
+      real Vce = Vcc - Ic * (Rc + Re); // collector-emitter voltage
+      real Ve = Ie * Re; // emitter voltage
+      real Vc = Vce + Ve; // collector voltage
+      real Vb = Vbe + Ve; // base voltage
+      real Vbc = Vb - Vc; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb, Vbc);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real Ib = op[1]; // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      real re = VT / Ie; // re factor
+      real Zi1 = 1 + (_Rth_(Rc, ro) / Rf);
+      real Zi2 = (1 / (beta * re)) + (1 / Rf);
+      real Zi3 = _Rth_(Rc, ro) / (beta * re * Rf);
+      real Zi4 = _Rth_(Rc, ro) / (Rf * re);
+      real Zi = Zi1 / (Zi2 + Zi3 + Zi4); // input impedance
+      real Zo = 1 / (1/ro + 1/Rc + 1/Rf); // output impedance
+      real Av1 = Rf / (_Rth_(Rc, ro) + Rf);
+      real Av2 = _Rth_(Rc, ro) / re;
+      real Av = -1 * Av1 * Av2; // voltage gain
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _b_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void b_collector_feedback(char* analysis, real Vcc, real Rf, real Rc,
+                          real Re, real beta, real ro, struct DCBJT* dc,
+                          struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_collector_feedback_, 1, BJT_VBE,
+                     BJT_VT, Vcc, Rf, Rc, Re, beta, ro, op, dc, ac);
+}
+
+/* The AC Analysis of Collector-DC-Feedback Configuration */
+KERNEL void _b_collector_dc_feedback_(const int analysis,
+                                      const int checked, real Vbe,
+                                      real VT, real Vcc, real Rf1,
+                                      real Rf2, real Rc, real beta,
+                                      real ro, real* op, struct DCBJT* dc,
+                                      struct ACBJT* ac) {
+   // Check if the parameters are in their domains, DC analysis is
+   // not supported.
+   int valid = _status_valid_(STATUS_FINITE, Vcc) &
+               _status_valid_(STATUS_POSITIVE, Rf1) &
+               _status_valid_(STATUS_POSITIVE, Rf2) &
+               _status_valid_(STATUS_POSITIVE, Rc) &
+               _status_valid_(STATUS_POSITIVE, beta) &
+               _status_valid_(STATUS_POSITIVE, ro);
+   // Operating point:
+   if (analysis & ANALYSIS_OP)
+      op[0] = (Vcc - Vbe) / (Rf1+Rf2 + (beta * Rc)); // base current
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real Ib = op[0]; // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      real re = VT / Ie; // re factor
+      real Zi = 1 / (1/Rf1 + 1/(beta * re)); // input impedance
+      real Zo = 1 / (1/Rc + 1/Rf2 + 1/ro); // output impedance
+      real Av = -1 * Zo / re; // voltage gain
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "Out of phase");
+   }
+   if (!checked) return;
+   _b_status_(analysis & ANALYSIS_DC, STATUS_UNSUPPORTED, dc, ac);
+   _b_check_(analysis & ANALYSIS_AC, valid, valid, dc, ac);
+}
+
+void b_collector_dc_feedback(char* analysis, real Vcc, real Rf1,
+                             real Rf2, real Rc, real beta, real ro,
+                             struct DCBJT* dc, struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_collector_dc_feedback_, 1,
+                     BJT_VBE, BJT_VT, Vcc, Rf1, Rf2, Rc, beta, ro, op, dc,
+                     ac);
+}
+
+/* The DC and AC Analysis of Emitter-Follower Configuration */
+KERNEL void _b_emitter_follower_(const int analysis, const int checked,
+                                 real Vbe, real VT, real Vcc, real Vee,
+                                 real Rb, real Re, real beta, real ro,
+                                 real* op, struct DCBJT* dc,
+                                 struct ACBJT* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vee) &
+                  _status_valid_(STATUS_POSITIVE, Rb) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_POSITIVE, beta);
+   int ac_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_POSITIVE, Rb) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_POSITIVE, beta) &
+                  _status_valid_(STATUS_POSITIVE, ro);
+   // Operating points of DC (op[0] with Vee) and AC (op[1] with Vcc)
+   // stages are different, only base currents of requested stages are
+   // solved.
+   if ((analysis & ANALYSIS_OP) && (analysis & ANALYSIS_DC))
+      op[0] = (Vee - Vbe) / (Rb + (beta + 1) * Re); // base current
+   if ((analysis & ANALYSIS_OP) && (analysis & ANALYSIS_AC))
+      op[1] = (Vcc - Vbe) / (Rb + (beta + 1) * Re); // base current
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ib = op[0]; // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      real Ic = beta * Ib; // collector current
+      real Vce = Vee - (Ie * Re); // collector-enitter voltage
+      real Ve = (Ie * Re) + Vee; // emitter voltage
+      real Vc = Vce + Ve; // collector voltage
+      real Vb = Vbe + Ve; // base voltage
+      real Vbc = Vb - Vc; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, -1.0, Vce, Vc, Ve, Vb, Vbc);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real Ib = op[1]; // base current
+      real Ie = (beta + 1) * Ib; // emitter current
+      real re = VT / Ie; // re factor
+      real Zb1 = (beta + 1) * Re;
+      real Zb2 = 1 + (Re / ro);
+      real Zb = (beta * re) + (Zb1 / Zb2);
+      real Zi = 1 / (1 /Rb + 1 /Zb); // input impedance
+      real Zo1 = (beta * re) / (beta + 1);
+      real Zo = 1 / (1 /ro + 1 /Re + 1 /Zo1); // output impedance
+      real Av1 = (beta + 1) * Re / Zb;
+      real Av = Av1 / (1 + (Re/ro)); // voltage gain
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "In phase");
+   }
+   if (checked) _b_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void b_emitter_follower(char* analysis, real Vcc, real Vee, real Rb,
+                        real Re, real beta, real ro, struct DCBJT* dc,
+                        struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_emitter_follower_, 1, BJT_VBE,
+                     BJT_VT, Vcc, Vee, Rb, Re, beta, ro, op, dc, ac);
+}
+
+/* The DC and AC Analysis of Common-Base COnfiguration */
+KERNEL void _b_common_base_(const int analysis, const int checked,
+                            real Vbe, real VT, real Vcc, real Vee, real Rc,
+                            real Re, real beta, real alpha, real* op,
+                            struct DCBJT* dc, struct ACBJT* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vcc) &
+                  _status_valid_(STATUS_FINITE, Vee) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_POSITIVE, beta);
+   int ac_valid = _status_valid_(STATUS_FINITE, Vee) &
+                  _status_valid_(STATUS_POSITIVE, Rc) &
+                  _status_valid_(STATUS_POSITIVE, Re) &
+                  _status_valid_(STATUS_FRACTION, alpha);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Ie = (Vee - Vbe) / Re; // emitter current
+      op[0] = Ie;
+   }
+   real Ie = op[0];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ib = Ie / (beta + 1); // base current
+      real Ic = Ib * beta; // collector current
+      real Vce = Vee + Vcc - Ie * (Rc + Re); // collector-emitter v.
+      real Vcb = Vcc - Ic * Rc; // collector-base voltage
+      real Vbc = -1 * Vcb; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, -1.0, Vce, -1.0, -1.0, -1.0,
+                          Vbc);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real re = VT / Ie; // re factor
+      real Zi = 1 / (1/Re + 1/re); // input impedance
+      real Zo = Rc; // output impedance
+      real Av = alpha * Rc / re; // voltage gain
+      _b_save_ac_results_(ac, re, Zi, Zo, Av, "In phase");
+   }
+   if (checked) _b_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void b_common_base(char* analysis, real Vcc, real Vee, real Rc, real Re,
+                   real beta, real alpha, struct DCBJT* dc,
+                   struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_common_base_, 1, BJT_VBE,
+                     BJT_VT, Vcc, Vee, Rc, Re, beta, alpha, op, dc, ac);
+}
+
+/* The DC Analysis of Miscellaneous-Bias COnfiguration */
+KERNEL void _b_miscellaneous_bias_(const int analysis, const int checked,
+                                   real Vbe, real VT, real Vcc, real Rb,
+                                   real Rc, real beta, real* op,
+                                   struct DCBJT* dc, struct ACBJT* ac) {
+   // Check if the parameters are in their domains, AC analysis is
+   // not supported.
+   int valid = _status_valid_(STATUS_FINITE, Vcc) &
+               _status_valid_(STATUS_POSITIVE, Rb) &
+               _status_valid_(STATUS_POSITIVE, Rc) &
+               _status_valid_(STATUS_POSITIVE, beta);
+   // Operating point:
+   if (analysis & ANALYSIS_OP)
+      op[0] = (Vcc - Vbe) / (Rb + beta * Rc); // base current
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Ib = op[0]; // base current
+      real Ic = beta * Ib; // collector current
+      real Ie = (beta + 1) * Ib; // emitter current
+      real Vce = Vcc - (Ie * Rc); // collector-emitter voltage
+      real Ve = 0; // emitter voltage
+      real Vc = Vce + Ve; // collector voltage
+      real Vb = Vbe + Ve; // base voltage
+      real Vbc = Vb - Vc; // base-collector voltage
+      _b_save_dc_results_(dc, Ib, Ic, Ie, -1.0, Vce, Vc, Ve, Vb, Vbc);
+   }
+   if (!checked) return;
+   _b_check_(analysis & ANALYSIS_DC, valid, valid, dc, ac);
+   _b_status_(analysis & ANALYSIS_AC, STATUS_UNSUPPORTED, dc, ac);
+}
+
+void b_miscellaneous_bias(char* analysis, real Vcc, real Rb, real Rc,
+                          real beta, struct DCBJT* dc, struct ACBJT* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _b_miscellaneous_bias_, 1, BJT_VBE,
+                     BJT_VT, Vcc, Rb, Rc, beta, op, dc, ac);
+}
+
+/* Batch Analysis of BJT Configurations
+
+Every batch function evaluates 'n' operating points in one call. The
+parameters are given as columns (one array per parameter, indexed by
+point) and the results are written into the columns of 'DCBJTBatch'
+or 'ACBJTBatch'. So, the loops have no string comparison and do not
+touch any shared state. The phase relation is same for all points of
+a configuration, so it is not stored. The kernels take Vbe (and VT)
+as arguments; the public batch functions pass BJT_VBE and BJT_VT.
+*/
+
+KERNEL void _b_save_dc_batch_(struct DCBJTBatch* dc, long i,
+                              struct DCBJT* point) {
+   // Save DC results of i'th point into 'dc' columns.
+   dc->Ib[i] = point->Ib; dc->Ic[i] = point->Ic; dc->Ie[i] = point->Ie;
+   dc->Icsat[i] = point->Icsat; dc->Vce[i] = point->Vce;
+   dc->Vc[i] = point->Vc; dc->Ve[i] = point->Ve; dc->Vb[i] = point->Vb;
+   dc->Vbc[i] = point->Vbc;
+}
+
+KERNEL void _b_save_ac_batch_(struct ACBJTBatch* ac, long i,
+                              struct ACBJT* point) {
+   // Save AC results of i'th point into 'ac' columns.
+   ac->re[i] = point->re; ac->Zi[i] = point->Zi; ac->Zo[i] = point->Zo;
+   ac->Av[i] = point->Av;
+}
+
+// Batch loops run the stages of the configuration kernels point by
+// point without status ('checked' is 0), so the formulas are written
+// once. Parameters that a stage does not read are given as 0.
+
+/* The Batch DC Analysis of Fixed-Bias Configuration */
+KERNEL void _b_fixed_bias_dc_batch_(real Vbe, long n, real* Vcc, real* Rb,
+                                    real* Rc, real* beta,
+                                    struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_fixed_bias_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, Vcc[i], Rb[i],
+                     Rc[i], beta[i], 0, op, &point, NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_fixed_bias_dc_batch(long n, real* Vcc, real* Rb, real* Rc,
+                           real* beta, struct DCBJTBatch* dc) {
+   _b_fixed_bias_dc_batch_(BJT_VBE, n, Vcc, Rb, Rc, beta, dc);
+}
+
+/* The Batch AC Analysis of Fixed-Bias Configuration */
+KERNEL void _b_fixed_bias_ac_batch_(real Vbe, real VT, long n, real* Vcc,
+                                    real* Rb, real* Rc, real* beta,
+                                    real* ro, struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_fixed_bias_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT, Vcc[i], Rb[i],
+                     Rc[i], beta[i], ro[i], op, NULL, &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_fixed_bias_ac_batch(long n, real* Vcc, real* Rb, real* Rc,
+                           real* beta, real* ro, struct ACBJTBatch* ac) {
+   _b_fixed_bias_ac_batch_(BJT_VBE, BJT_VT, n, Vcc, Rb, Rc, beta, ro, ac);
+}
+
+/* The Batch DC Analysis of Emitter-Bias Configuration */
+KERNEL void _b_emitter_bias_dc_batch_(real Vbe, long n, real* Vcc, real* Rb,
+                                      real* Rc, real* Re, real* beta,
+                                      struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_emitter_bias_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, Vcc[i], Rb[i],
+                       Rc[i], Re[i], beta[i], 0, op, &point, NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_emitter_bias_dc_batch(long n, real* Vcc, real* Rb, real* Rc,
+                             real* Re, real* beta, struct DCBJTBatch* dc) {
+   _b_emitter_bias_dc_batch_(BJT_VBE, n, Vcc, Rb, Rc, Re, beta, dc);
+}
+
+/* The Batch AC Analysis of Emitter-Bias Configuration */
+KERNEL void _b_emitter_bias_ac_batch_(real Vbe, real VT, long n, real* Vcc,
+                                      real* Rb, real* Rc, real* Re,
+                                      real* beta, real* ro,
+                                      struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_emitter_bias_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT, Vcc[i], Rb[i],
+                       Rc[i], Re[i], beta[i], ro[i], op, NULL, &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_emitter_bias_ac_batch(long n, real* Vcc, real* Rb, real* Rc,
+                             real* Re, real* beta, real* ro,
+                             struct ACBJTBatch* ac) {
+   _b_emitter_bias_ac_batch_(BJT_VBE, BJT_VT, n, Vcc, Rb, Rc, Re, beta, ro,
+                             ac);
+}
+
+/* The Batch DC Analysis of Voltage-Divider Configuration */
+KERNEL void _b_voltage_divider_dc_batch_(real Vbe, long n, real* Vcc,
+                                         real* Rb1, real* Rb2, real* Rc,
+                                         real* Re, real* beta,
+                                         struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_voltage_divider_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, Vcc[i],
+                          Rb1[i], Rb2[i], Rc[i], Re[i], beta[i], 0, 0, op,
+                          &point, NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_voltage_divider_dc_batch(long n, real* Vcc, real* Rb1, real* Rb2,
+                                real* Rc, real* Re, real* beta,
+                                struct DCBJTBatch* dc) {
+   _b_voltage_divider_dc_batch_(BJT_VBE, n, Vcc, Rb1, Rb2, Rc, Re, beta,
+                                dc);
+}
+
+/* The Batch AC Analysis of Voltage-Divider Configuration */
+KERNEL void _b_voltage_divider_ac_(const int bypassed, real Vbe, real VT,
+                                   long n, real* Vcc, real* Rb1,
+                                   real* Rb2, real* Rc, real* Re,
+                                   real* beta, real* ro,
+                                   struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_voltage_divider_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT, Vcc[i],
+                          Rb1[i], Rb2[i], Rc[i], Re[i], beta[i], ro[i],
+                          bypassed, op, NULL, &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_voltage_divider_ac_batch(long n, real* Vcc, real* Rb1, 
+                                real* Rb2, real* Rc, real* Re, 
+                                real* beta, real* ro, char* bypass,
+                                struct ACBJTBatch* ac) {
+   // The 'bypass' parameter is same for all points, so compare once
+   // and run the loop that is specialized for it.
+   if (strcmp(bypass, "bypassed") == 0)
+      _b_voltage_divider_ac_(1, BJT_VBE, BJT_VT, n, Vcc, Rb1, Rb2, Rc,
+                             Re, beta, ro, ac);
+   else
+      _b_voltage_divider_ac_(0, BJT_VBE, BJT_VT, n, Vcc, Rb1, Rb2, Rc,
+                             Re, beta, ro, ac);
+}
+
+/* The Batch DC Analysis of Collector-Feedback Configuration */
+KERNEL void _b_collector_feedback_dc_batch_(real Vbe, long n, real* Vcc,
+                                            real* Rf, real* Rc, real* Re,
+                                            real* beta,
+                                            struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_collector_feedback_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, Vcc[i],
+                             Rf[i], Rc[i], Re[i], beta[i], 0, op, &point,
+                             NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_collector_feedback_dc_batch(long n, real* Vcc, real* Rf, real* Rc,
+                                   real* Re, real* beta,
+                                   struct DCBJTBatch* dc) {
+   _b_collector_feedback_dc_batch_(BJT_VBE, n, Vcc, Rf, Rc, Re, beta, dc);
+}
+
+/* The Batch AC Analysis of Collector-Feedback Configuration */
+KERNEL void _b_collector_feedback_ac_batch_(real Vbe, real VT, long n,
+                                            real* Vcc, real* Rf, real* Rc,
+                                            real* beta, real* ro,
+                                            struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_collector_feedback_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT, Vcc[i],
+                             Rf[i], Rc[i], 0, beta[i], ro[i], op, NULL,
+                             &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_collector_feedback_ac_batch(long n, real* Vcc, real* Rf, real* Rc,
+                                   real* beta, real* ro,
+                                   struct ACBJTBatch* ac) {
+   _b_collector_feedback_ac_batch_(BJT_VBE, BJT_VT, n, Vcc, Rf, Rc, beta,
+                                   ro, ac);
+}
+
+/* The Batch AC Analysis of Collector-DC-Feedback Configuration */
+KERNEL void _b_collector_dc_feedback_ac_batch_(real Vbe, real VT, long n,
+                                               real* Vcc, real* Rf1,
+                                               real* Rf2, real* Rc,
+                                               real* beta, real* ro,
+                                               struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_collector_dc_feedback_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT,
+                                Vcc[i], Rf1[i], Rf2[i], Rc[i], beta[i],
+                                ro[i], op, NULL, &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_collector_dc_feedback_ac_batch(long n, real* Vcc, real* Rf1,
+                                      real* Rf2, real* Rc, real* beta,
+                                      real* ro, struct ACBJTBatch* ac) {
+   _b_collector_dc_feedback_ac_batch_(BJT_VBE, BJT_VT, n, Vcc, Rf1, Rf2, Rc,
+                                      beta, ro, ac);
+}
+
+/* The Batch DC Analysis of Emitter-Follower Configuration */
+KERNEL void _b_emitter_follower_dc_batch_(real Vbe, long n, real* Vee,
+                                          real* Rb, real* Re, real* beta,
+                                          struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_emitter_follower_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, 0, Vee[i],
+                           Rb[i], Re[i], beta[i], 0, op, &point, NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_emitter_follower_dc_batch(long n, real* Vee, real* Rb, real* Re,
+                                 real* beta, struct DCBJTBatch* dc) {
+   _b_emitter_follower_dc_batch_(BJT_VBE, n, Vee, Rb, Re, beta, dc);
+}
+
+/* The Batch AC Analysis of Emitter-Follower Configuration */
+KERNEL void _b_emitter_follower_ac_batch_(real Vbe, real VT, long n,
+                                          real* Vcc, real* Rb, real* Re,
+                                          real* beta, real* ro,
+                                          struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_emitter_follower_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT, Vcc[i],
+                           0, Rb[i], Re[i], beta[i], ro[i], op, NULL,
+                           &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_emitter_follower_ac_batch(long n, real* Vcc, real* Rb, real* Re,
+                                 real* beta, real* ro,
+                                 struct ACBJTBatch* ac) {
+   _b_emitter_follower_ac_batch_(BJT_VBE, BJT_VT, n, Vcc, Rb, Re, beta, ro,
+                                 ac);
+}
+
+/* The Batch DC Analysis of Common-Base Configuration */
+KERNEL void _b_common_base_dc_batch_(real Vbe, long n, real* Vcc, real* Vee,
+                                     real* Rc, real* Re, real* beta,
+                                     struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_common_base_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, Vcc[i], Vee[i],
+                      Rc[i], Re[i], beta[i], 0, op, &point, NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_common_base_dc_batch(long n, real* Vcc, real* Vee, real* Rc,
+                            real* Re, real* beta, struct DCBJTBatch* dc) {
+   _b_common_base_dc_batch_(BJT_VBE, n, Vcc, Vee, Rc, Re, beta, dc);
+}
+
+/* The Batch AC Analysis of Common-Base Configuration */
+KERNEL void _b_common_base_ac_batch_(real Vbe, real VT, long n, real* Vee,
+                                     real* Rc, real* Re, real* alpha,
+                                     struct ACBJTBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACBJT point; real op[MODEL_OP];
+      _b_common_base_(ANALYSIS_OP | ANALYSIS_AC, 0, Vbe, VT, 0, Vee[i],
+                      Rc[i], Re[i], 0, alpha[i], op, NULL, &point);
+      _b_save_ac_batch_(ac, i, &point);
+   }
+}
+
+void b_common_base_ac_batch(long n, real* Vee, real* Rc, real* Re,
+                            real* alpha, struct ACBJTBatch* ac) {
+   _b_common_base_ac_batch_(BJT_VBE, BJT_VT, n, Vee, Rc, Re, alpha, ac);
+}
+
+/* The Batch DC Analysis of Miscellaneous-Bias Configuration */
+KERNEL void _b_miscellaneous_bias_dc_batch_(real Vbe, long n, real* Vcc,
+                                            real* Rb, real* Rc, real* beta,
+                                            struct DCBJTBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCBJT point; real op[MODEL_OP];
+      _b_miscellaneous_bias_(ANALYSIS_OP | ANALYSIS_DC, 0, Vbe, 0, Vcc[i],
+                             Rb[i], Rc[i], beta[i], op, &point, NULL);
+      _b_save_dc_batch_(dc, i, &point);
+   }
+}
+
+void b_miscellaneous_bias_dc_batch(long n, real* Vcc, real* Rb, real* Rc,
+                                   real* beta, struct DCBJTBatch* dc) {
+   _b_miscellaneous_bias_dc_batch_(BJT_VBE, n, Vcc, Rb, Rc, beta, dc);
+}
+
+/* Sensitivities of BJT Configurations
+
+Dual kernels evaluate the formulas of the configuration kernels with
+dual numbers (DUAL.h), so their results carry derivatives with
+respect to all parameters. Results are written in order of result
+columns of 'BJTConfigs'.
+*/
+
+KERNEL void _b_save_dc_duals_(struct Dual* dc, struct Dual Ib,
+                              struct Dual Ic, struct Dual Ie,
+                              struct Dual Icsat, struct Dual Vce,
+                              struct Dual Vc, struct Dual Ve,
+                              struct Dual Vb, struct Dual Vbc) {
+   dc[0] = Ib; dc[1] = Ic; dc[2] = Ie; dc[3] = Icsat; dc[4] = Vce;
+   dc[5] = Vc; dc[6] = Ve; dc[7] = Vb; dc[8] = Vbc;
+}
+
+KERNEL void _b_save_ac_duals_(struct Dual* ac, struct Dual re,
+                              struct Dual Zi, struct Dual Zo,
+                              struct Dual Av) {
+   ac[0] = re; ac[1] = Zi; ac[2] = Zo; ac[3] = Av;
+}
+
+KERNEL void _b_common_dc_duals_(struct Dual* dc, struct Dual Vcc,
+                                struct Dual Rc, struct Dual Re,
+                                struct Dual beta, struct Dual Ib) {
+   // DC results of emitter-bias, voltage-divider and collector-feedback
+   // configurations from their base current.
+   struct Dual Ic = _d_mul_(beta, Ib); // collector current
+   struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+   struct Dual RcRe = _d_add_(Rc, Re);
+   struct Dual Icsat = _d_div_(Vcc, RcRe); // collector sat. current
+   struct Dual Vce = _d_sub_(Vcc, _d_mul_(Ic, RcRe)); // collector-emitter
+   struct Dual Ve = _d_mul_(Ie, Re); // emitter voltage
+   struct Dual Vc = _d_add_(Vce, Ve); // collector voltage
+   struct Dual Vb = _d_shift_(Ve, BJT_VBE); // base voltage
+   _b_save_dc_duals_(dc, Ib, Ic, Ie, Icsat, Vce, Vc, Ve, Vb,
+                     _d_sub_(Vb, Vc));
+}
+
+KERNEL void _b_unbypassed_ac_duals_(struct Dual* ac, struct Dual Rb,
+                                    struct Dual Rc, struct Dual Re,
+                                    struct Dual beta, struct Dual ro,
+                                    struct Dual Ie) {
+   // AC results of emitter-bias and unbypassed voltage-divider
+   // configurations (Rb is the base resistance or Rth).
+   struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+   struct Dual Rcro = _d_div_(Rc, ro);
+   struct Dual Zb1 = _d_add_(_d_shift_(beta, 1), Rcro);
+   struct Dual Zb2 = _d_shift_(_d_div_(_d_add_(Rc, Re), ro), 1);
+   struct Dual bre = _d_mul_(beta, re);
+   struct Dual Zb = _d_add_(bre, _d_mul_(_d_div_(Zb1, Zb2), Re));
+   struct Dual Zi = _d_parallel_(Rb, Zb); // input impedance
+   struct Dual Zo1 = _d_mul_(beta, _d_add_(ro, re));
+   struct Dual Zo2 = _d_shift_(_d_div_(bre, Re), 1);
+   struct Dual Zo3 = _d_add_(ro, _d_div_(Zo1, Zo2));
+   struct Dual Zo = _d_parallel_(Rc, Zo3); // output impedance
+   struct Dual Av1 = _d_add_(_d_mul_(_d_scale_(_d_div_(_d_mul_(beta, Rc),
+                             Zb), -1), _d_shift_(_d_div_(re, ro), 1)),
+                             Rcro);
+   struct Dual Av = _d_div_(Av1, _d_shift_(Rcro, 1)); // voltage gain
+   _b_save_ac_duals_(ac, re, Zi, Zo, Av);
+}
+
+KERNEL void _b_fixed_bias_dual_(const int analysis, struct Dual Vcc,
+                                struct Dual Rb, struct Dual Rc,
+                                struct Dual beta, struct Dual ro,
+                                struct Dual* dc, struct Dual* ac) {
+   struct Dual Ib = _d_div_(_d_shift_(Vcc, -BJT_VBE), Rb); // base current
+   struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+   if (analysis & ANALYSIS_DC) {
+      struct Dual Ic = _d_mul_(beta, Ib); // collector current
+      struct Dual Icsat = _d_div_(Vcc, Rc); // collector sat. current
+      struct Dual Vce = _d_sub_(Vcc, _d_mul_(Ic, Rc)); // collector-emitter
+      _b_save_dc_duals_(dc, Ib, Ic, Ie, Icsat, Vce, Vce, _d_(0),
+                        _d_(BJT_VBE), _d_sub_(_d_(BJT_VBE), Vce));
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+      struct Dual Zi = _d_parallel_(Rb, _d_mul_(beta, re)); // input imp.
+      struct Dual Zo = _d_parallel_(Rc, ro); // output impedance
+      _b_save_ac_duals_(ac, re, Zi, Zo, _d_scale_(_d_div_(Zo, re), -1));
+   }
+}
+
+KERNEL void _b_emitter_bias_dual_(const int analysis, struct Dual Vcc,
+                                  struct Dual Rb, struct Dual Rc,
+                                  struct Dual Re, struct Dual beta,
+                                  struct Dual ro, struct Dual* dc,
+                                  struct Dual* ac) {
+   // base current
+   struct Dual Ib = _d_div_(_d_shift_(Vcc, -BJT_VBE), _d_add_(Rb,
+                            _d_mul_(_d_shift_(beta, 1), Re)));
+   if (analysis & ANALYSIS_DC)
+      _b_common_dc_duals_(dc, Vcc, Rc, Re, beta, Ib);
+   if (analysis & ANALYSIS_AC)
+      _b_unbypassed_ac_duals_(ac, Rb, Rc, Re, beta, ro,
+                              _d_mul_(_d_shift_(beta, 1), Ib));
+}
+
+KERNEL void _b_voltage_divider_dual_(const int analysis, struct Dual Vcc,
+                                     struct Dual Rb1, struct Dual Rb2,
+                                     struct Dual Rc, struct Dual Re,
+                                     struct Dual beta, struct Dual ro,
+                                     const int bypassed, struct Dual* dc,
+                                     struct Dual* ac) {
+   struct Dual rth = _d_parallel_(Rb1, Rb2);
+   struct Dual eth = _d_mul_(Vcc, _d_div_(Rb2, _d_add_(Rb1, Rb2)));
+   // base current
+   struct Dual Ib = _d_div_(_d_shift_(eth, -BJT_VBE), _d_add_(rth,
+                            _d_mul_(_d_shift_(beta, 1), Re)));
+   struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+   if (analysis & ANALYSIS_DC)
+      _b_common_dc_duals_(dc, Vcc, Rc, Re, beta, Ib);
+   if ((analysis & ANALYSIS_AC) && bypassed) {
+      struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+      struct Dual Zi = _d_parallel_(rth, _d_mul_(beta, re)); // input imp.
+      struct Dual Zo = _d_parallel_(Rc, ro); // output impedance
+      _b_save_ac_duals_(ac, re, Zi, Zo, _d_scale_(_d_div_(Zo, re), -1));
+   }
+   if ((analysis & ANALYSIS_AC) && !bypassed)
+      _b_unbypassed_ac_duals_(ac, rth, Rc, Re, beta, ro, Ie);
+}
+
+KERNEL void _b_collector_feedback_dual_(const int analysis,
+                                        struct Dual Vcc, struct Dual Rf,
+                                        struct Dual Rc, struct Dual Re,
+                                        struct Dual beta, struct Dual ro,
+                                        struct Dual* dc, struct Dual* ac) {
+   struct Dual V = _d_shift_(Vcc, -BJT_VBE);
+   if (analysis & ANALYSIS_DC) {
+      // base current
+      struct Dual Ib = _d_div_(V, _d_add_(Rf, _d_mul_(beta,
+                               _d_add_(Rc, Re))));
+      _b_common_dc_duals_(dc, Vcc, Rc, Re, beta, Ib);
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual Ib = _d_div_(V, _d_add_(Rf, _d_mul_(beta, Rc)));
+      struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+      struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+      struct Dual rcro = _d_parallel_(Rc, ro);
+      struct Dual bre = _d_mul_(beta, re);
+      struct Dual Zi1 = _d_shift_(_d_div_(rcro, Rf), 1);
+      struct Dual Zi2 = _d_add_(_d_inv_(bre), _d_inv_(Rf));
+      struct Dual Zi3 = _d_div_(rcro, _d_mul_(bre, Rf));
+      struct Dual Zi4 = _d_div_(rcro, _d_mul_(Rf, re));
+      struct Dual Zi = _d_div_(Zi1, _d_add_(_d_add_(Zi2, Zi3), Zi4));
+      // output impedance
+      struct Dual Zo = _d_inv_(_d_add_(_d_add_(_d_inv_(ro), _d_inv_(Rc)),
+                                       _d_inv_(Rf)));
+      struct Dual Av1 = _d_div_(Rf, _d_add_(rcro, Rf));
+      struct Dual Av2 = _d_div_(rcro, re);
+      _b_save_ac_duals_(ac, re, Zi, Zo, _d_scale_(_d_mul_(Av1, Av2), -1));
+   }
+}
+
+KERNEL void _b_collector_dc_feedback_dual_(const int analysis,
+                                           struct Dual Vcc,
+                                           struct Dual Rf1,
+                                           struct Dual Rf2,
+                                           struct Dual Rc,
+                                           struct Dual beta,
+                                           struct Dual ro,
+                                           struct Dual* ac) {
+   (void) analysis; // AC only
+   // base current
+   struct Dual Ib = _d_div_(_d_shift_(Vcc, -BJT_VBE), _d_add_(_d_add_(Rf1,
+                            Rf2), _d_mul_(beta, Rc)));
+   struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+   struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+   struct Dual Zi = _d_parallel_(Rf1, _d_mul_(beta, re)); // input imp.
+   // output impedance
+   struct Dual Zo = _d_inv_(_d_add_(_d_add_(_d_inv_(Rc), _d_inv_(Rf2)),
+                                    _d_inv_(ro)));
+   _b_save_ac_duals_(ac, re, Zi, Zo, _d_scale_(_d_div_(Zo, re), -1));
+}
+
+KERNEL void _b_emitter_follower_dual_(const int analysis, struct Dual Vcc,
+                                      struct Dual Vee, struct Dual Rb,
+                                      struct Dual Re, struct Dual beta,
+                                      struct Dual ro, struct Dual* dc,
+                                      struct Dual* ac) {
+   struct Dual Rin = _d_add_(Rb, _d_mul_(_d_shift_(beta, 1), Re));
+   if (analysis & ANALYSIS_DC) {
+      // base current
+      struct Dual Ib = _d_div_(_d_shift_(Vee, -BJT_VBE), Rin);
+      struct Dual Ic = _d_mul_(beta, Ib); // collector current
+      struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+      struct Dual IeRe = _d_mul_(Ie, Re);
+      struct Dual Vce = _d_sub_(Vee, IeRe); // collector-emitter voltage
+      struct Dual Ve = _d_add_(IeRe, Vee); // emitter voltage
+      struct Dual Vc = _d_add_(Vce, Ve); // collector voltage
+      struct Dual Vb = _d_shift_(Ve, BJT_VBE); // base voltage
+      _b_save_dc_duals_(dc, Ib, Ic, Ie, _d_(-1), Vce, Vc, Ve, Vb,
+                        _d_sub_(Vb, Vc));
+   }
+   if (analysis & ANALYSIS_AC) {
+      // base current
+      struct Dual Ib = _d_div_(_d_shift_(Vcc, -BJT_VBE), Rin);
+      struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+      struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+      struct Dual bre = _d_mul_(beta, re);
+      struct Dual Reo = _d_shift_(_d_div_(Re, ro), 1);
+      struct Dual Zb1 = _d_mul_(_d_shift_(beta, 1), Re);
+      struct Dual Zb = _d_add_(bre, _d_div_(Zb1, Reo));
+      struct Dual Zi = _d_parallel_(Rb, Zb); // input impedance
+      struct Dual Zo1 = _d_div_(bre, _d_shift_(beta, 1));
+      // output impedance
+      struct Dual Zo = _d_inv_(_d_add_(_d_add_(_d_inv_(ro), _d_inv_(Re)),
+                                       _d_inv_(Zo1)));
+      struct Dual Av = _d_div_(_d_div_(Zb1, Zb), Reo); // voltage gain
+      _b_save_ac_duals_(ac, re, Zi, Zo, Av);
+   }
+}
+
+KERNEL void _b_common_base_dual_(const int analysis, struct Dual Vcc,
+                                 struct Dual Vee, struct Dual Rc,
+                                 struct Dual Re, struct Dual beta,
+                                 struct Dual alpha, struct Dual* dc,
+                                 struct Dual* ac) {
+   // emitter current
+   struct Dual Ie = _d_div_(_d_shift_(Vee, -BJT_VBE), Re);
+   if (analysis & ANALYSIS_DC) {
+      struct Dual Ib = _d_div_(Ie, _d_shift_(beta, 1)); // base current
+      struct Dual Ic = _d_mul_(Ib, beta); // collector current
+      // collector-emitter voltage
+      struct Dual Vce = _d_sub_(_d_add_(Vee, Vcc), _d_mul_(Ie,
+                                _d_add_(Rc, Re)));
+      struct Dual Vcb = _d_sub_(Vcc, _d_mul_(Ic, Rc)); // collector-base
+      _b_save_dc_duals_(dc, Ib, Ic, Ie, _d_(-1), Vce, _d_(-1), _d_(-1),
+                        _d_(-1), _d_scale_(Vcb, -1));
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual re = _d_rdiv_(BJT_VT, Ie); // re factor
+      struct Dual Zi = _d_parallel_(Re, re); // input impedance
+      struct Dual Av = _d_div_(_d_mul_(alpha, Rc), re); // voltage gain
+      _b_save_ac_duals_(ac, re, Zi, Rc, Av);
+   }
+}
+
+KERNEL void _b_miscellaneous_bias_dual_(struct Dual Vcc, struct Dual Rb,
+                                        struct Dual Rc, struct Dual beta,
+                                        struct Dual* dc) {
+   // base current
+   struct Dual Ib = _d_div_(_d_shift_(Vcc, -BJT_VBE), _d_add_(Rb,
+                            _d_mul_(beta, Rc)));
+   struct Dual Ic = _d_mul_(beta, Ib); // collector current
+   struct Dual Ie = _d_mul_(_d_shift_(beta, 1), Ib); // emitter current
+   struct Dual Vce = _d_sub_(Vcc, _d_mul_(Ie, Rc)); // collector-emitter
+   _b_save_dc_duals_(dc, Ib, Ic, Ie, _d_(-1), Vce, Vce, _d_(0),
+                     _d_(BJT_VBE), _d_sub_(_d_(BJT_VBE), Vce));
+}
+
+// Jacobian functions of 'BJTConfigs' entries. Parameters which are
+// not columns of an entry are not read by its stage.
+
+static void _b_fb_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[4], dc[9];
+   _d_inputs_(4, in, p);
+   _b_fixed_bias_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], _d_(1), dc,
+                       NULL);
+   _d_outputs_(9, 4, dc, out, jacobian);
+}
+static void _b_fb_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], ac[4];
+   _d_inputs_(5, in, p);
+   _b_fixed_bias_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4], NULL,
+                       ac);
+   _d_outputs_(4, 5, ac, out, jacobian);
+}
+static void _b_eb_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], dc[9];
+   _d_inputs_(5, in, p);
+   _b_emitter_bias_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4],
+                         _d_(1), dc, NULL);
+   _d_outputs_(9, 5, dc, out, jacobian);
+}
+static void _b_eb_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], ac[4];
+   _d_inputs_(6, in, p);
+   _b_emitter_bias_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4], p[5],
+                         NULL, ac);
+   _d_outputs_(4, 6, ac, out, jacobian);
+}
+static void _b_vd_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], dc[9];
+   _d_inputs_(6, in, p);
+   _b_voltage_divider_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4],
+                            p[5], _d_(1), 0, dc, NULL);
+   _d_outputs_(9, 6, dc, out, jacobian);
+}
+static void _b_vd_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[7], ac[4];
+   _d_inputs_(7, in, p);
+   _b_voltage_divider_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                            p[5], p[6], 0, NULL, ac);
+   _d_outputs_(4, 7, ac, out, jacobian);
+}
+static void _b_vd_bypassed_ac_jacobian_(real* in, real* out,
+                                        real* jacobian) {
+   struct Dual p[7], ac[4];
+   _d_inputs_(7, in, p);
+   _b_voltage_divider_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                            p[5], p[6], 1, NULL, ac);
+   _d_outputs_(4, 7, ac, out, jacobian);
+}
+static void _b_cf_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], dc[9];
+   _d_inputs_(5, in, p);
+   _b_collector_feedback_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4],
+                               _d_(1), dc, NULL);
+   _d_outputs_(9, 5, dc, out, jacobian);
+}
+static void _b_cf_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], ac[4];
+   _d_inputs_(5, in, p);
+   _b_collector_feedback_dual_(ANALYSIS_AC, p[0], p[1], p[2], _d_(1),
+                               p[3], p[4], NULL, ac);
+   _d_outputs_(4, 5, ac, out, jacobian);
+}
+static void _b_cdf_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], ac[4];
+   _d_inputs_(6, in, p);
+   _b_collector_dc_feedback_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3],
+                                  p[4], p[5], ac);
+   _d_outputs_(4, 6, ac, out, jacobian);
+}
+static void _b_ef_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[4], dc[9];
+   _d_inputs_(4, in, p);
+   _b_emitter_follower_dual_(ANALYSIS_DC, _d_(0), p[0], p[1], p[2], p[3],
+                             _d_(1), dc, NULL);
+   _d_outputs_(9, 4, dc, out, jacobian);
+}
+static void _b_ef_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], ac[4];
+   _d_inputs_(5, in, p);
+   _b_emitter_follower_dual_(ANALYSIS_AC, p[0], _d_(0), p[1], p[2], p[3],
+                             p[4], NULL, ac);
+   _d_outputs_(4, 5, ac, out, jacobian);
+}
+static void _b_cb_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], dc[9];
+   _d_inputs_(5, in, p);
+   _b_common_base_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4], _d_(1),
+                        dc, NULL);
+   _d_outputs_(9, 5, dc, out, jacobian);
+}
+static void _b_cb_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[4], ac[4];
+   _d_inputs_(4, in, p);
+   _b_common_base_dual_(ANALYSIS_AC, _d_(0), p[0], p[1], p[2], _d_(1),
+                        p[3], NULL, ac);
+   _d_outputs_(4, 4, ac, out, jacobian);
+}
+static void _b_mb_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[4], dc[9];
+   _d_inputs_(4, in, p);
+   _b_miscellaneous_bias_dual_(p[0], p[1], p[2], p[3], dc);
+   _d_outputs_(9, 4, dc, out, jacobian);
+}
+
+/* Bounds of Voltage-Divider Configuration
+
+Bound kernel evaluates the formulas of voltage-divider with intervals
+(INTERVAL.h), so its results contain all results of the configuration
+while parameters are anywhere in their ranges. Thevenin values are
+bounded first, Eth = Vcc / (1 + Rb1/Rb2) and Rth = Rb1 || Rb2 use
+each resistance once, so a branch of a design with chosen Rb1 and Rb2
+bounds Ib, Ic and Ve over all values of Re.
+*/
+
+KERNEL void _b_voltage_divider_bound_(const int analysis,
+                                      struct Interval Vcc,
+                                      struct Interval Rb1,
+                                      struct Interval Rb2,
+                                      struct Interval Rc,
+                                      struct Interval Re,
+                                      struct Interval beta,
+                                      struct Interval ro,
+                                      const int bypassed,
+                                      struct Interval* dc,
+                                      struct Interval* ac) {
+   struct Interval rth = _i_parallel_(Rb1, Rb2);
+   struct Interval eth = _i_div_(Vcc, _i_shift_(_i_div_(Rb1, Rb2), 1));
+   struct Interval beta1 = _i_shift_(beta, 1);
+   // Emitter current and voltage use Re once.
+   struct Interval Ve = _i_div_(_i_shift_(eth, -BJT_VBE), _i_shift_(
+                                _i_div_(rth, _i_mul_(beta1, Re)), 1));
+   struct Interval Ie = _i_div_(_i_shift_(eth, -BJT_VBE),
+                                _i_add_(_i_div_(rth, beta1), Re));
+   if (analysis & ANALYSIS_DC) {
+      struct Interval Ib = _i_div_(_i_shift_(eth, -BJT_VBE), _i_add_(rth,
+                                   _i_mul_(beta1, Re))); // base current
+      struct Interval Ic = _i_mul_(beta, Ib); // collector current
+      // Vce = Vcc - Ic * Rc - beta / (beta + 1) * Ve
+      struct Interval Vce = _i_sub_(_i_sub_(Vcc, _i_mul_(Ic, Rc)),
+                                    _i_mul_(_i_div_(beta, beta1), Ve));
+      struct Interval Vc = _i_add_(Vce, Ve); // collector voltage
+      struct Interval Vb = _i_shift_(Ve, BJT_VBE); // base voltage
+      dc[0] = Ib; dc[1] = Ic; dc[2] = Ie;
+      dc[3] = _i_div_(Vcc, _i_add_(Rc, Re)); // collector sat. current
+      dc[4] = Vce; dc[5] = Vc; dc[6] = Ve; dc[7] = Vb;
+      dc[8] = _i_sub_(Vb, Vc);
+   }
+   if (!(analysis & ANALYSIS_AC)) return;
+   struct Interval re = _i_div_(_i_(BJT_VT), Ie); // re factor
+   if (bypassed) {
+      struct Interval Zo = _i_parallel_(Rc, ro); // output impedance
+      ac[0] = re;
+      ac[1] = _i_parallel_(rth, _i_mul_(beta, re)); // input impedance
+      ac[2] = Zo;
+      ac[3] = _i_scale_(_i_mul_(Zo, Ie), -1 / BJT_VT); // voltage gain
+      return;
+   }
+   struct Interval Rcro = _i_div_(Rc, ro);
+   struct Interval Zb1 = _i_add_(beta1, Rcro);
+   struct Interval Zb2 = _i_shift_(_i_div_(_i_add_(Rc, Re), ro), 1);
+   struct Interval bre = _i_mul_(beta, re);
+   struct Interval Zb = _i_add_(bre, _i_mul_(_i_div_(Zb1, Zb2), Re));
+   struct Interval Zo1 = _i_mul_(beta, _i_add_(ro, re));
+   struct Interval Zo2 = _i_shift_(_i_div_(bre, Re), 1);
+   struct Interval Zo3 = _i_add_(ro, _i_div_(Zo1, Zo2));
+   struct Interval Av1 = _i_add_(_i_mul_(_i_scale_(_i_div_(_i_mul_(beta,
+                                 Rc), Zb), -1), _i_shift_(_i_div_(re, ro),
+                                 1)), Rcro);
+   ac[0] = re;
+   ac[1] = _i_parallel_(rth, Zb); // input impedance
+   ac[2] = _i_parallel_(Rc, Zo3); // output impedance
+   ac[3] = _i_div_(Av1, _i_shift_(Rcro, 1)); // voltage gain
+}
+
+static void _b_vd_dc_bound_(real* low, real* high, real* out_low,
+                            real* out_high) {
+   struct Interval p[6], dc[9];
+   _i_inputs_(6, low, high, p);
+   _b_voltage_divider_bound_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4],
+                             p[5], _i_(1), 0, dc, NULL);
+   _i_outputs_(9, dc, out_low, out_high);
+}
+static void _b_vd_ac_bound_(real* low, real* high, real* out_low,
+                            real* out_high) {
+   struct Interval p[7], ac[4];
+   _i_inputs_(7, low, high, p);
+   _b_voltage_divider_bound_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                             p[5], p[6], 0, NULL, ac);
+   _i_outputs_(4, ac, out_low, out_high);
+}
+static void _b_vd_bypassed_ac_bound_(real* low, real* high, real* out_low,
+                                     real* out_high) {
+   struct Interval p[7], ac[4];
+   _i_inputs_(7, low, high, p);
+   _b_voltage_divider_bound_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                             p[5], p[6], 1, NULL, ac);
+   _i_outputs_(4, ac, out_low, out_high);
+}
+
+/* Configuration Table of BJT Batch Functions */
+
+static struct DCBJTBatch _b_dc_columns_(real** out) {
+   // Wrap result columns into 'DCBJTBatch' struct.
+   return (struct DCBJTBatch) {out[0], out[1], out[2], out[3], out[4],
+                               out[5], out[6], out[7], out[8]};
+}
+
+static struct ACBJTBatch _b_ac_columns_(real** out) {
+   // Wrap result columns into 'ACBJTBatch' struct.
+   return (struct ACBJTBatch) {out[0], out[1], out[2], out[3]};
+}
+
+static void _b_fb_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_fixed_bias_dc_batch(n, in[0], in[1], in[2], in[3], &dc);
+}
+static void _b_fb_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   b_fixed_bias_ac_batch(n, in[0], in[1], in[2], in[3], in[4], &ac);
+}
+static void _b_eb_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_emitter_bias_dc_batch(n, in[0], in[1], in[2], in[3], in[4], &dc);
+}
+static void _b_eb_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   b_emitter_bias_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5],
+                           &ac);
+}
+static void _b_vd_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_voltage_divider_dc_batch(n, in[0], in[1], in[2], in[3], in[4],
+                              in[5], &dc);
+}
+static void _b_vd_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_voltage_divider_ac_(0, BJT_VBE, BJT_VT, n, in[0], in[1], in[2],
+                          in[3], in[4], in[5], in[6], &ac);
+}
+static void _b_vd_bypassed_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_voltage_divider_ac_(1, BJT_VBE, BJT_VT, n, in[0], in[1], in[2],
+                          in[3], in[4], in[5], in[6], &ac);
+}
+static void _b_cf_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_collector_feedback_dc_batch(n, in[0], in[1], in[2], in[3], in[4],
+                                 &dc);
+}
+static void _b_cf_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   b_collector_feedback_ac_batch(n, in[0], in[1], in[2], in[3], in[4],
+                                 &ac);
+}
+static void _b_cdf_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   b_collector_dc_feedback_ac_batch(n, in[0], in[1], in[2], in[3],
+                                    in[4], in[5], &ac);
+}
+static void _b_ef_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_emitter_follower_dc_batch(n, in[0], in[1], in[2], in[3], &dc);
+}
+static void _b_ef_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   b_emitter_follower_ac_batch(n, in[0], in[1], in[2], in[3], in[4],
+                               &ac);
+}
+static void _b_cb_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_common_base_dc_batch(n, in[0], in[1], in[2], in[3], in[4], &dc);
+}
+static void _b_cb_ac_(long n, real** in, real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   b_common_base_ac_batch(n, in[0], in[1], in[2], in[3], &ac);
+}
+static void _b_mb_dc_(long n, real** in, real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   b_miscellaneous_bias_dc_batch(n, in[0], in[1], in[2], in[3], &dc);
+}
+
+
+// Batch functions at the base-emitter and thermal voltages of a
+// temperature ('thermal' of 'Config', see THERMAL.h).
+static void _b_fb_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_fixed_bias_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3], &dc);
+}
+static void _b_fb_ac_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_fixed_bias_ac_batch_(Vbe, VT, n, in[0], in[1], in[2], in[3], in[4],
+                           &ac);
+}
+static void _b_eb_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_emitter_bias_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3], in[4],
+                             &dc);
+}
+static void _b_eb_ac_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_emitter_bias_ac_batch_(Vbe, VT, n, in[0], in[1], in[2], in[3], in[4],
+                             in[5], &ac);
+}
+static void _b_vd_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_voltage_divider_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3], in[4],
+                                in[5], &dc);
+}
+static void _b_vd_ac_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_voltage_divider_ac_(0, Vbe, VT, n, in[0], in[1], in[2], in[3], in[4],
+                          in[5], in[6], &ac);
+}
+static void _b_vd_bypassed_ac_thermal_(real Vbe, real VT, long n, real** in,
+                                       real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_voltage_divider_ac_(1, Vbe, VT, n, in[0], in[1], in[2], in[3], in[4],
+                          in[5], in[6], &ac);
+}
+static void _b_cf_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_collector_feedback_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3],
+                                   in[4], &dc);
+}
+static void _b_cf_ac_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_collector_feedback_ac_batch_(Vbe, VT, n, in[0], in[1], in[2], in[3],
+                                   in[4], &ac);
+}
+static void _b_cdf_ac_thermal_(real Vbe, real VT, long n, real** in,
+                               real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_collector_dc_feedback_ac_batch_(Vbe, VT, n, in[0], in[1], in[2],
+                                      in[3], in[4], in[5], &ac);
+}
+static void _b_ef_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_emitter_follower_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3], &dc);
+}
+static void _b_ef_ac_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_emitter_follower_ac_batch_(Vbe, VT, n, in[0], in[1], in[2], in[3],
+                                 in[4], &ac);
+}
+static void _b_cb_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_common_base_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3], in[4], &dc);
+}
+static void _b_cb_ac_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct ACBJTBatch ac = _b_ac_columns_(out);
+   _b_common_base_ac_batch_(Vbe, VT, n, in[0], in[1], in[2], in[3], &ac);
+}
+static void _b_mb_dc_thermal_(real Vbe, real VT, long n, real** in,
+                              real** out) {
+   struct DCBJTBatch dc = _b_dc_columns_(out);
+   _b_miscellaneous_bias_dc_batch_(Vbe, n, in[0], in[1], in[2], in[3], &dc);
+}
+
+/* Loops of BJT Configurations for Nonlinear DC Analysis
+
+Base and collector loops of the networks of DC entries in terms of Ib
+and Ic (see NEWTON.h). Parameters are in order of the DC entry.
+*/
+static void _b_fb_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vcc Rb Rc beta
+   for (int k = 0; k < NEWTON_BLOCK; k++)
+      _newton_loops_(b, k, p[0][k], p[1][k], 0, p[0][k], 0, p[2][k], 0,
+                     0, p[0][k] / p[2][k], p[3][k]);
+}
+static void _b_eb_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vcc Rb Rc Re beta
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vcc = p[0][k], Rb = p[1][k], Rc = p[2][k], Re = p[3][k];
+      _newton_loops_(b, k, Vcc, Rb + Re, Re, Vcc, Re, Rc + Re, Re, 0,
+                     Vcc / (Rc + Re), p[4][k]);
+   }
+}
+static void _b_vd_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vcc Rb1 Rb2 Rc Re beta, base loop of the Thevenin equivalent.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vcc = p[0][k], Rb1 = p[1][k], Rb2 = p[2][k];
+      real Rc = p[3][k], Re = p[4][k];
+      _newton_loops_(b, k, _Eth_(Vcc, Rb1, Rb2), _Rth_(Rb1, Rb2) + Re,
+                     Re, Vcc, Re, Rc + Re, Re, 0, Vcc / (Rc + Re),
+                     p[5][k]);
+   }
+}
+static void _b_cf_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vcc Rf Rc Re beta, Ie flows through Rc.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vcc = p[0][k], Rf = p[1][k], Rc = p[2][k], Re = p[3][k];
+      _newton_loops_(b, k, Vcc, Rf + Rc + Re, Rc + Re, Vcc, Rc + Re,
+                     Rc + Re, Re, 0, Vcc / (Rc + Re), p[4][k]);
+   }
+}
+static void _b_ef_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vee Rb Re beta
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vee = p[0][k], Rb = p[1][k], Re = p[2][k];
+      _newton_loops_(b, k, Vee, Rb + Re, Re, Vee, Re, Re, Re, 0, -1,
+                     p[3][k]);
+   }
+}
+static void _b_cb_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vcc Vee Rc Re beta, base is grounded and Re returns to -Vee.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vcc = p[0][k], Vee = p[1][k], Rc = p[2][k], Re = p[3][k];
+      _newton_loops_(b, k, Vee, Re, Re, Vcc + Vee, Re, Rc + Re, Re, -Vee,
+                     -1, p[4][k]);
+   }
+}
+static void _b_mb_loops_(real (*p)[NEWTON_BLOCK], struct NewtonBlock* b) {
+   // Vcc Rb Rc beta, Rb is from collector to base.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vcc = p[0][k], Rb = p[1][k], Rc = p[2][k];
+      _newton_loops_(b, k, Vcc, Rb + Rc, Rc, Vcc, Rc, Rc, 0, 0, -1,
+                     p[3][k]);
+   }
+}
+
+// Instantiate the baseline, AVX2 and AVX-512 copies of '_newton_solve_'
+// (NEWTON.h) and '_newton_solve_batch_' which selects the widest one
+// that the running processor supports.
+#if NEWTON_SIMD
+static void _newton_solve_scalar_(struct NewtonBlock* b, real VT, real Vbe,
+                                  real (*out)[NEWTON_BLOCK]) {
+   _newton_solve_(b, VT, Vbe, out);
+}
+__attribute__((target("avx2")))
+static void _newton_solve_avx2_(struct NewtonBlock* b, real VT, real Vbe,
+                                real (*out)[NEWTON_BLOCK]) {
+   _newton_solve_(b, VT, Vbe, out);
+}
+__attribute__((target("avx512f")))
+static void _newton_solve_avx512_(struct NewtonBlock* b, real VT, real Vbe,
+                                  real (*out)[NEWTON_BLOCK]) {
+   _newton_solve_(b, VT, Vbe, out);
+}
+static void _newton_solve_batch_(struct NewtonBlock* b, real VT, real Vbe,
+                                 real (*out)[NEWTON_BLOCK]) {
+   if (__builtin_cpu_supports("avx512f"))
+      _newton_solve_avx512_(b, VT, Vbe, out);
+   else if (__builtin_cpu_supports("avx2"))
+      _newton_solve_avx2_(b, VT, Vbe, out);
+   else _newton_solve_scalar_(b, VT, Vbe, out);
+}
+#else
+static void _newton_solve_batch_(struct NewtonBlock* b, real VT, real Vbe,
+                                 real (*out)[NEWTON_BLOCK]) {
+   _newton_solve_(b, VT, Vbe, out);
+}
+#endif
+
+static void _newton_batch_(void (*loops)(real (*)[NEWTON_BLOCK],
+                                         struct NewtonBlock*),
+                           int nin, real VT, real Vbe, long n, real** in,
+                           real** out) {
+   // Batch function of "newton" entries. 'loops' fills the loops of
+   // a block from its 'nin' DC parameters, the device parameters are
+   // after them. The last lanes of a block repeat its last point.
+   struct NewtonBlock b;
+   real p[CONFIG_COLUMNS][NEWTON_BLOCK], o[9][NEWTON_BLOCK];
+   for (long i = 0; i < n; i += NEWTON_BLOCK) {
+      long m = _newton_gather_(nin + 3, i, n, in, p);
+      loops(p, &b);
+      for (int k = 0; k < NEWTON_BLOCK; k++) {
+         real IKF = p[nin + 1][k], gK = 1 / IKF;
+         b.Is[k] = p[nin][k];
+         b.gK[k] = IKF > 0 ? gK : 0;
+         b.BR[k] = p[nin + 2][k];
+      }
+      _newton_solve_batch_(&b, VT, Vbe, o);
+      for (int c = 0; c < 9; c++)
+         memcpy(out[c] + i, o[c], m * sizeof(real));
+   }
+}
+
+// Batch functions of "newton" entries, at room temperature and at VT
+// and the start Vbe of a temperature (Is is a column, see THERMAL.h).
+#define BJT_NEWTON(name, nin) \
+static void _b_##name##_newton_(long n, real** in, real** out) { \
+   _newton_batch_(_b_##name##_loops_, nin, BJT_VT, BJT_VBE, n, in, out); \
+} \
+static void _b_##name##_newton_thermal_(real Vbe, real VT, long n, \
+                                        real** in, real** out) { \
+   _newton_batch_(_b_##name##_loops_, nin, VT, Vbe, n, in, out); \
+}
+BJT_NEWTON(fb, 4) BJT_NEWTON(eb, 5) BJT_NEWTON(vd, 6) BJT_NEWTON(cf, 5)
+BJT_NEWTON(ef, 4) BJT_NEWTON(cb, 5) BJT_NEWTON(mb, 4)
+
+#define BJT_DC_RESULTS 9, {"Ib", "Ic", "Ie", "Icsat", "Vce", "Vc", "Ve", \
+                           "Vb", "Vbc"}, "---------"
+#define BJT_AC_RESULTS 4, {"re", "Zi", "Zo", "Av"}, "++++"
+
+// Frequency response of BJT configurations (see BODE.h).
+struct BodeModel BJTBodeModels[] = {
+   {"bjt", "fb", NULL, BODE_INVERTING, 5, -1, -1, _b_fb_ac_},
+   {"bjt", "eb", NULL, BODE_INVERTING, 6, -1, -1, _b_eb_ac_},
+   {"bjt", "vd", "unbypassed", BODE_INVERTING, 7, -1, -1, _b_vd_ac_},
+   {"bjt", "vd", "bypassed", BODE_INVERTING, 7, 4, 5,
+    _b_vd_bypassed_ac_},
+   {"bjt", "cf", NULL, BODE_INVERTING, 5, -1, -1, _b_cf_ac_},
+   {"bjt", "cdf", NULL, BODE_INVERTING, 6, -1, -1, _b_cdf_ac_},
+   {"bjt", "ef", NULL, BODE_FOLLOWER, 5, -1, -1, _b_ef_ac_},
+   {"bjt", "cb", NULL, BODE_COMMON_BASE, 4, -1, -1, _b_cb_ac_},
+};
+int BJTBodeModelCount = sizeof(BJTBodeModels) / sizeof(BJTBodeModels[0]);
+
+BODE_ENTRY(_b_fb_bode_, BJTBodeModels[0])
+BODE_ENTRY(_b_eb_bode_, BJTBodeModels[1])
+BODE_ENTRY(_b_vd_bode_, BJTBodeModels[2])
+BODE_ENTRY(_b_vd_bypassed_bode_, BJTBodeModels[3])
+BODE_ENTRY(_b_cf_bode_, BJTBodeModels[4])
+BODE_ENTRY(_b_cdf_bode_, BJTBodeModels[5])
+BODE_ENTRY(_b_ef_bode_, BJTBodeModels[6])
+BODE_ENTRY(_b_cb_bode_, BJTBodeModels[7])
+
+// All BJT configurations which have batch functions.
+struct Config BJTConfigs[] = {
+   {"bjt", "fb", "dc", NULL, 4, {"Vcc", "Rb", "Rc", "beta"}, "-+++",
+    BJT_DC_RESULTS, _b_fb_dc_, _b_fb_dc_jacobian_, NULL, _b_fb_dc_thermal_},
+   {"bjt", "fb", "newton", NULL, 7, {"Vcc", "Rb", "Rc", "beta",
+    NEWTON_INPUTS}, "-+++" NEWTON_SIGNS, BJT_DC_RESULTS, _b_fb_newton_,
+    NULL, NULL, _b_fb_newton_thermal_},
+   {"bjt", "fb", "ac", NULL, 5, {"Vcc", "Rb", "Rc", "beta", "ro"}, "-++++",
+    BJT_AC_RESULTS, _b_fb_ac_, _b_fb_ac_jacobian_, NULL, _b_fb_ac_thermal_},
+   {"bjt", "fb", "bode", NULL, 11, {"Vcc", "Rb", "Rc", "beta", "ro",
+    BODE_INPUTS, "Cbe", "Cbc"}, "-++++" BODE_SIGNS "++", BODE_RESULTS,
+    _b_fb_bode_},
+   {"bjt", "eb", "dc", NULL, 5, {"Vcc", "Rb", "Rc", "Re", "beta"}, "-++++",
+    BJT_DC_RESULTS, _b_eb_dc_, _b_eb_dc_jacobian_, NULL, _b_eb_dc_thermal_},
+   {"bjt", "eb", "newton", NULL, 8, {"Vcc", "Rb", "Rc", "Re", "beta",
+    NEWTON_INPUTS}, "-++++" NEWTON_SIGNS, BJT_DC_RESULTS, _b_eb_newton_,
+    NULL, NULL, _b_eb_newton_thermal_},
+   {"bjt", "eb", "ac", NULL, 6, {"Vcc", "Rb", "Rc", "Re", "beta", "ro"},
+    "-+++++", BJT_AC_RESULTS, _b_eb_ac_, _b_eb_ac_jacobian_, NULL,
+    _b_eb_ac_thermal_},
+   {"bjt", "eb", "bode", NULL, 12, {"Vcc", "Rb", "Rc", "Re", "beta", "ro",
+    BODE_INPUTS, "Cbe", "Cbc"}, "-+++++" BODE_SIGNS "++", BODE_RESULTS,
+    _b_eb_bode_},
+   {"bjt", "vd", "dc", NULL, 6, {"Vcc", "Rb1", "Rb2", "Rc", "Re", "beta"},
+    "-+++++", BJT_DC_RESULTS, _b_vd_dc_, _b_vd_dc_jacobian_,
+    _b_vd_dc_bound_, _b_vd_dc_thermal_},
+   {"bjt", "vd", "newton", NULL, 9, {"Vcc", "Rb1", "Rb2", "Rc", "Re",
+    "beta", NEWTON_INPUTS}, "-+++++" NEWTON_SIGNS, BJT_DC_RESULTS,
+    _b_vd_newton_, NULL, NULL, _b_vd_newton_thermal_},
+   {"bjt", "vd", "ac", "unbypassed", 7, {"Vcc", "Rb1", "Rb2", "Rc", "Re",
+    "beta", "ro"}, "-++++++", BJT_AC_RESULTS, _b_vd_ac_, _b_vd_ac_jacobian_,
+    _b_vd_ac_bound_, _b_vd_ac_thermal_},
+   {"bjt", "vd", "bode", "unbypassed", 13, {"Vcc", "Rb1", "Rb2", "Rc", "Re",
+    "beta", "ro", BODE_INPUTS, "Cbe", "Cbc"}, "-++++++" BODE_SIGNS "++",
+    BODE_RESULTS, _b_vd_bode_},
+   {"bjt", "vd", "ac", "bypassed", 7, {"Vcc", "Rb1", "Rb2", "Rc", "Re",
+    "beta", "ro"}, "-++++++", BJT_AC_RESULTS, _b_vd_bypassed_ac_,
+    _b_vd_bypassed_ac_jacobian_, _b_vd_bypassed_ac_bound_,
+    _b_vd_bypassed_ac_thermal_},
+   {"bjt", "vd", "bode", "bypassed", 14, {"Vcc", "Rb1", "Rb2", "Rc", "Re",
+    "beta", "ro", BODE_INPUTS, "Ce", "Cbe", "Cbc"},
+    "-++++++" BODE_SIGNS "+++", BODE_RESULTS, _b_vd_bypassed_bode_},
+   {"bjt", "cf", "dc", NULL, 5, {"Vcc", "Rf", "Rc", "Re", "beta"}, "-++++",
+    BJT_DC_RESULTS, _b_cf_dc_, _b_cf_dc_jacobian_, NULL, _b_cf_dc_thermal_},
+   {"bjt", "cf", "newton", NULL, 8, {"Vcc", "Rf", "Rc", "Re", "beta",
+    NEWTON_INPUTS}, "-++++" NEWTON_SIGNS, BJT_DC_RESULTS, _b_cf_newton_,
+    NULL, NULL, _b_cf_newton_thermal_},
+   {"bjt", "cf", "ac", NULL, 5, {"Vcc", "Rf", "Rc", "beta", "ro"}, "-++++",
+    BJT_AC_RESULTS, _b_cf_ac_, _b_cf_ac_jacobian_, NULL, _b_cf_ac_thermal_},
+   {"bjt", "cf", "bode", NULL, 11, {"Vcc", "Rf", "Rc", "beta", "ro",
+    BODE_INPUTS, "Cbe", "Cbc"}, "-++++" BODE_SIGNS "++", BODE_RESULTS,
+    _b_cf_bode_},
+   {"bjt", "cdf", "ac", NULL, 6, {"Vcc", "Rf1", "Rf2", "Rc", "beta", "ro"},
+    "-+++++", BJT_AC_RESULTS, _b_cdf_ac_, _b_cdf_ac_jacobian_, NULL,
+    _b_cdf_ac_thermal_},
+   {"bjt", "cdf", "bode", NULL, 12, {"Vcc", "Rf1", "Rf2", "Rc", "beta",
+    "ro", BODE_INPUTS, "Cbe", "Cbc"}, "-+++++" BODE_SIGNS "++",
+    BODE_RESULTS, _b_cdf_bode_},
+   {"bjt", "ef", "dc", NULL, 4, {"Vee", "Rb", "Re", "beta"}, "-+++",
+    BJT_DC_RESULTS, _b_ef_dc_, _b_ef_dc_jacobian_, NULL, _b_ef_dc_thermal_},
+   {"bjt", "ef", "newton", NULL, 7, {"Vee", "Rb", "Re", "beta",
+    NEWTON_INPUTS}, "-+++" NEWTON_SIGNS, BJT_DC_RESULTS, _b_ef_newton_,
+    NULL, NULL, _b_ef_newton_thermal_},
+   {"bjt", "ef", "ac", NULL, 5, {"Vcc", "Rb", "Re", "beta", "ro"}, "-++++",
+    BJT_AC_RESULTS, _b_ef_ac_, _b_ef_ac_jacobian_, NULL, _b_ef_ac_thermal_},
+   {"bjt", "ef", "bode", NULL, 11, {"Vcc", "Rb", "Re", "beta", "ro",
+    BODE_INPUTS, "Cbe", "Cbc"}, "-++++" BODE_SIGNS "++", BODE_RESULTS,
+    _b_ef_bode_},
+   {"bjt", "cb", "dc", NULL, 5, {"Vcc", "Vee", "Rc", "Re", "beta"}, "--+++",
+    BJT_DC_RESULTS, _b_cb_dc_, _b_cb_dc_jacobian_, NULL, _b_cb_dc_thermal_},
+   {"bjt", "cb", "newton", NULL, 8, {"Vcc", "Vee", "Rc", "Re", "beta",
+    NEWTON_INPUTS}, "--+++" NEWTON_SIGNS, BJT_DC_RESULTS, _b_cb_newton_,
+    NULL, NULL, _b_cb_newton_thermal_},
+   {"bjt", "cb", "ac", NULL, 4, {"Vee", "Rc", "Re", "alpha"}, "-+++",
+    BJT_AC_RESULTS, _b_cb_ac_, _b_cb_ac_jacobian_, NULL, _b_cb_ac_thermal_},
+   {"bjt", "cb", "bode", NULL, 10, {"Vee", "Rc", "Re", "alpha", BODE_INPUTS,
+    "Cbe", "Cbc"}, "-+++" BODE_SIGNS "++", BODE_RESULTS, _b_cb_bode_},
+   {"bjt", "mb", "dc", NULL, 4, {"Vcc", "Rb", "Rc", "beta"}, "-+++",
+    BJT_DC_RESULTS, _b_mb_dc_, _b_mb_dc_jacobian_, NULL, _b_mb_dc_thermal_},
+   {"bjt", "mb", "newton", NULL, 7, {"Vcc", "Rb", "Rc", "beta",
+    NEWTON_INPUTS}, "-+++" NEWTON_SIGNS, BJT_DC_RESULTS, _b_mb_newton_,
+    NULL, NULL, _b_mb_newton_thermal_},
+};
+int BJTConfigCount = sizeof(BJTConfigs) / sizeof(BJTConfigs[0]);
+
+/* Models of BJT Configurations
+
+Stages of configuration kernels with the common signature of 'Model'
+(see INCREMENTAL.h). Parameters are in order of the configuration
+functions.
+*/
+
+static void _b_fb_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_fixed_bias_, 1, BJT_VBE, BJT_VT, p[0], p[1],
+                  p[2], p[3], p[4], op, dc, ac);
+}
+
+static void _b_eb_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_emitter_bias_, 1, BJT_VBE, BJT_VT, p[0], p[1],
+                  p[2], p[3], p[4], p[5], op, dc, ac);
+}
+
+static void _b_vd_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_voltage_divider_, 1, BJT_VBE, BJT_VT, p[0], p[1],
+                  p[2], p[3], p[4], p[5], p[6], 0, op, dc, ac);
+}
+
+static void _b_vd_bypassed_model_(int stages, real* p, real* op, void* dc,
+                                  void* ac) {
+   STAGE_DISPATCH(stages, _b_voltage_divider_, 1, BJT_VBE, BJT_VT, p[0], p[1],
+                  p[2], p[3], p[4], p[5], p[6], 1, op, dc, ac);
+}
+
+static void _b_cf_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_collector_feedback_, 1, BJT_VBE, BJT_VT, p[0],
+                  p[1], p[2], p[3], p[4], p[5], op, dc, ac);
+}
+
+static void _b_cdf_model_(int stages, real* p, real* op, void* dc,
+                          void* ac) {
+   STAGE_DISPATCH(stages, _b_collector_dc_feedback_, 1, BJT_VBE, BJT_VT, p[0],
+                  p[1], p[2], p[3], p[4], p[5], op, dc, ac);
+}
+
+static void _b_ef_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_emitter_follower_, 1, BJT_VBE, BJT_VT, p[0],
+                  p[1], p[2], p[3], p[4], p[5], op, dc, ac);
+}
+
+static void _b_cb_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_common_base_, 1, BJT_VBE, BJT_VT, p[0], p[1],
+                  p[2], p[3], p[4], p[5], op, dc, ac);
+}
+
+static void _b_mb_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _b_miscellaneous_bias_, 1, BJT_VBE, BJT_VT, p[0],
+                  p[1], p[2], p[3], op, dc, ac);
+}
+
+// All BJT configurations with parameters of operating point, DC stage
+// and AC stage.
+struct Model BJTModels[] = {
+   {"bjt", "fb", NULL, "both", 5, {"Vcc", "Rb", "Rc", "beta", "ro"},
+    "Vcc Rb beta", "Vcc Rc beta", "Rb Rc beta ro", _b_fb_model_},
+   {"bjt", "eb", NULL, "both", 6, {"Vcc", "Rb", "Rc", "Re", "beta",
+    "ro"}, "Vcc Rb Re beta", "Vcc Rc Re beta", "Rb Rc Re beta ro",
+    _b_eb_model_},
+   {"bjt", "vd", "unbypassed", "both", 7, {"Vcc", "Rb1", "Rb2", "Rc",
+    "Re", "beta", "ro"}, "Vcc Rb1 Rb2 Re beta", "Vcc Rc Re beta",
+    "Rc Re beta ro", _b_vd_model_},
+   {"bjt", "vd", "bypassed", "both", 7, {"Vcc", "Rb1", "Rb2", "Rc",
+    "Re", "beta", "ro"}, "Vcc Rb1 Rb2 Re beta", "Vcc Rc Re beta",
+    "Rc beta ro", _b_vd_bypassed_model_},
+   {"bjt", "cf", NULL, "both", 6, {"Vcc", "Rf", "Rc", "Re", "beta",
+    "ro"}, "Vcc Rf Rc Re beta", "Vcc Rc Re beta", "Rf Rc beta ro",
+    _b_cf_model_},
+   {"bjt", "cdf", NULL, "ac", 6, {"Vcc", "Rf1", "Rf2", "Rc", "beta",
+    "ro"}, "Vcc Rf1 Rf2 Rc beta", "", "Rf1 Rf2 Rc beta ro",
+    _b_cdf_model_},
+   {"bjt", "ef", NULL, "both", 6, {"Vcc", "Vee", "Rb", "Re", "beta",
+    "ro"}, "Vcc Vee Rb Re beta", "Vee Re beta", "Rb Re beta ro",
+    _b_ef_model_},
+   {"bjt", "cb", NULL, "both", 6, {"Vcc", "Vee", "Rc", "Re", "beta",
+    "alpha"}, "Vee Re", "Vcc Vee Rc Re beta", "Rc Re alpha",
+    _b_cb_model_},
+   {"bjt", "mb", NULL, "dc", 4, {"Vcc", "Rb", "Rc", "beta"},
+    "Vcc Rb Rc beta", "Vcc Rc beta", "", _b_mb_model_},
+};
+int BJTModelCount = sizeof(BJTModels) / sizeof(BJTModels[0]);
+
+#endif
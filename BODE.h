@@ -0,0 +1,313 @@
+/* Frequency Response of Configurations
+
+Coupling capacitors (Cin, Cout), the capacitor of a bypassed Re or
+Rs (Ce, Cs) and capacitances of the device (Cbe and Cbc of a BJT, Cgs
+and Cgd of a FET) make the gain fall at low and high frequencies.
+Each capacitor gives one pole with the resistance that it sees, from
+the mid-band results (re or gm, Zi, Zo, Av) of the AC entry:
+
+   fLi = 1 / (2 pi (Rsig + Zi) Cin)        input coupling
+   fLo = 1 / (2 pi (Zo + RL) Cout)         output coupling
+   fLb = 1 / (2 pi Req Cbyp)               bypass capacitor
+   fHi = 1 / (2 pi (Rsig || Zi) Ci)        input capacitance
+   fHo = 1 / (2 pi (Zo || RL) Co)          output capacitance
+
+Req is Re || (Rsig' / beta + re) of a BJT (Rsig' is Rsig parallel to
+the bias resistors) or Rs || 1/gm of a FET. Ci and Co are the Miller
+capacitances of the capacitance that bridges input and output: Cbc or
+Cgd of inverting configurations, Cbe or Cgs of followers. Common
+base and common gate have no bridge (Ci = Cbe or Cgs, Co = Cbc or
+Cgd). A capacitor of zero has no pole, so Cin = 0 is direct coupling,
+and RL <= 0 is no load.
+
+'bode' entries of the configuration tables have the parameters of the
+AC entry followed by Rsig, RL, Cin, Cout, the bypass capacitor (only
+bypassed configurations) and the two device capacitances. They give
+the mid-band gain from source to load (Avs), the low and high cutoff
+frequencies (-3 dB of the product of all poles) and the poles. A
+missing pole or cutoff is given as zero, so results stay finite.
+'bode_response' writes the complex gain, input and output impedance
+of one design at any number of frequencies.
+
+Kernels work on blocks of BODE_BLOCK designs or frequencies. Complex
+numbers are split into arrays of real and imaginary parts and loops
+have constant length, so the compiler vectorizes them. Like FET.h,
+the widest kernel (AVX-512, AVX2 or the baseline) is selected at
+runtime.
+*/
+
+#ifndef BODE_H
+#define BODE_H
+
+#include <string.h>
+#include <math.h>
+#include "CONFIG.h"
+
+// Designs or frequencies of a block of kernels.
+#define BODE_BLOCK 64
+// Bisection steps of cutoff frequencies (from a ratio of 4).
+#define BODE_STEPS 32
+#define BODE_TWO_PI ((real) 6.28318530717958647692)
+
+#define BODE_RESULTS 8, {"Avs", "fL", "fH", "fLi", "fLo", "fLb", "fHi", \
+                         "fHo"}, "++++++++"
+// Parameters of 'bode' entries after the ones of the AC entry and
+// their signs (see POLARITY.h).
+#define BODE_INPUTS "Rsig", "RL", "Cin", "Cout"
+#define BODE_SIGNS "++++"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BODE_SIMD 1
+#else
+#define BODE_SIMD 0
+#endif
+
+// Mid-band results and poles of a block of designs. High poles are
+// kept as time constants 1 / f, so a missing pole is zero.
+struct BodeBlock {
+   real Avs[BODE_BLOCK]; // mid-band gain from source to load
+   real fLi[BODE_BLOCK], fLo[BODE_BLOCK], fLb[BODE_BLOCK]; // low poles
+   real tHi[BODE_BLOCK], tHo[BODE_BLOCK]; // 1 / fHi and 1 / fHo
+   real Zi[BODE_BLOCK], Zo[BODE_BLOCK]; // mid-band impedances
+   // Time constants of Zi || Ci and Zo || Co (2 pi C Z).
+   real tZi[BODE_BLOCK], tZo[BODE_BLOCK];
+   // Reactance factors of coupling capacitors (1 / (2 pi C)).
+   real kCi[BODE_BLOCK], kCo[BODE_BLOCK];
+};
+
+static int _bode_columns_(struct BodeModel* model) {
+   // Number of parameters of 'bode' entry of model.
+   return model->nin + 6 + (model->bypassed >= 0);
+}
+
+static void _bode_copy_(long n, real* column, real* block) {
+   // Copy a column into a block, the lanes after 'n' are one.
+   for (long i = 0; i < BODE_BLOCK; i++) block[i] = i < n ? column[i] : 1;
+}
+
+static void _bode_block_(struct BodeModel* model, long n, real** in,
+                         struct BodeBlock* b) {
+   // Mid-band results and poles of 'n' (at most BODE_BLOCK) designs.
+   real x[BODE_BLOCK], Zi[BODE_BLOCK], Zo[BODE_BLOCK], Av[BODE_BLOCK];
+   real* ac[4] = {x, Zi, Zo, Av};
+   model->ac(n, in, ac);
+   for (long i = n; i < BODE_BLOCK; i++) x[i] = Zi[i] = Zo[i] = Av[i] = 1;
+   real Rsig[BODE_BLOCK], RL[BODE_BLOCK], Cin[BODE_BLOCK];
+   real Cout[BODE_BLOCK], Cbyp[BODE_BLOCK], Req[BODE_BLOCK];
+   real C1[BODE_BLOCK], C2[BODE_BLOCK];
+   int c = model->nin;
+   _bode_copy_(n, in[c], Rsig); _bode_copy_(n, in[c + 1], RL);
+   _bode_copy_(n, in[c + 2], Cin); _bode_copy_(n, in[c + 3], Cout);
+   c += 4;
+   if (model->bypassed >= 0) _bode_copy_(n, in[c++], Cbyp);
+   else memset(Cbyp, 0, sizeof(Cbyp));
+   _bode_copy_(n, in[c], C1); _bode_copy_(n, in[c + 1], C2);
+   // Resistance that the bypass capacitor sees.
+   if (model->bypassed >= 0 && model->beta >= 0) {
+      real R[BODE_BLOCK], beta[BODE_BLOCK];
+      _bode_copy_(n, in[model->bypassed], R);
+      _bode_copy_(n, in[model->beta], beta);
+      for (long i = 0; i < BODE_BLOCK; i++) {
+         // Conductance of bias resistors is 1/Zi - 1/(beta re).
+         real g = 1 / Zi[i] - 1 / (beta[i] * x[i]);
+         real Rth = Rsig[i] / (1 + Rsig[i] * g); // Rsig'
+         Req[i] = 1 / (1 / R[i] + 1 / (Rth / beta[i] + x[i]));
+      }
+   }
+   else if (model->bypassed >= 0) {
+      real R[BODE_BLOCK];
+      _bode_copy_(n, in[model->bypassed], R);
+      for (long i = 0; i < BODE_BLOCK; i++)
+         Req[i] = R[i] / (1 + x[i] * R[i]);
+   }
+   else for (long i = 0; i < BODE_BLOCK; i++) Req[i] = 1;
+   // Direct input and output capacitances and the bridge of them.
+   real* Cd_in = C1;
+   real* Cbr = C2;
+   real Cd_out[BODE_BLOCK] = {0};
+   if (model->topology == BODE_FOLLOWER) Cd_in = C2, Cbr = C1;
+   else if (model->topology == BODE_COMMON_BASE) {
+      memcpy(Cd_out, C2, sizeof(Cd_out));
+      memset(C2, 0, sizeof(C2));
+   }
+   real w = BODE_TWO_PI;
+   for (long i = 0; i < BODE_BLOCK; i++) {
+      // Results of a zero capacitor or load are computed and then
+      // dropped, so the loop has no branches.
+      real GL = 1 / RL[i];
+      GL = RL[i] > 0 ? GL : 0; // load conductance
+      real Zl = Zo[i] / (1 + Zo[i] * GL); // Zo || RL
+      real A = Av[i] / (1 + Zo[i] * GL); // gain with load
+      real Rp = Rsig[i] * Zi[i] / (Rsig[i] + Zi[i]); // Rsig || Zi
+      b->Avs[i] = A * Zi[i] / (Zi[i] + Rsig[i]);
+      real kCi = 1 / (w * Cin[i]), kCo = 1 / (w * Cout[i]);
+      kCi = Cin[i] > 0 ? kCi : 0;
+      kCo = Cout[i] > 0 ? kCo : 0;
+      real fLb = 1 / (w * Req[i] * Cbyp[i]);
+      b->fLi[i] = kCi / (Rsig[i] + Zi[i]);
+      b->fLo[i] = kCo * GL / (1 + Zo[i] * GL);
+      b->fLb[i] = Cbyp[i] > 0 ? fLb : 0;
+      // Miller capacitances, a negative one (follower) is dropped.
+      real Ci = Cd_in[i] + (1 - A) * Cbr[i];
+      real Co = Cd_out[i] + (1 - 1 / A) * Cbr[i];
+      Ci = Ci > 0 ? Ci : 0;
+      Co = Co > 0 ? Co : 0;
+      b->tHi[i] = w * Rp * Ci;
+      b->tHo[i] = w * Zl * Co;
+      b->Zi[i] = Zi[i]; b->Zo[i] = Zo[i];
+      b->tZi[i] = w * Ci * Zi[i];
+      b->tZo[i] = w * Co * Zo[i];
+      b->kCi[i] = kCi; b->kCo[i] = kCo;
+   }
+}
+
+KERNEL void _bode_cutoffs_(struct BodeBlock* b, real* fL, real* fH) {
+   // Bisect |H|^2 = 1/2 of low and high poles of a block in log space.
+   // The cutoff is between the largest low pole and 4 times it, and
+   // between 1/4 of the smallest high pole and it (at most 3 poles).
+   real ratio[BODE_STEPS], low[BODE_BLOCK], high[BODE_BLOCK];
+   ratio[0] = 2;
+   for (int s = 1; s < BODE_STEPS; s++)
+      ratio[s] = real_sqrt(ratio[s - 1]);
+   for (long i = 0; i < BODE_BLOCK; i++) {
+      real p = b->fLi[i] > b->fLo[i] ? b->fLi[i] : b->fLo[i];
+      low[i] = p > b->fLb[i] ? p : b->fLb[i];
+      real t = b->tHi[i] > b->tHo[i] ? b->tHi[i] : b->tHo[i];
+      high[i] = (real) 0.25 / t; // infinity if there is not a pole
+   }
+   for (int s = 0; s < BODE_STEPS; s++) {
+      real r = ratio[s];
+      for (long i = 0; i < BODE_BLOCK; i++) {
+         // Without poles the bound stays zero or infinity (its
+         // gain is not a number).
+         real f = low[i] * r;
+         real a = b->fLi[i] / f, c = b->fLo[i] / f, d = b->fLb[i] / f;
+         real g = (1 + a * a) * (1 + c * c) * (1 + d * d);
+         low[i] = g > 2 ? f : low[i];
+         real h = high[i] * r;
+         real u = h * b->tHi[i], v = h * b->tHo[i];
+         real k = (1 + u * u) * (1 + v * v);
+         high[i] = k < 2 ? h : high[i];
+      }
+   }
+   memcpy(fL, low, sizeof(low));
+   for (long i = 0; i < BODE_BLOCK; i++) // zero if there is not a pole
+      fH[i] = b->tHi[i] > 0 || b->tHo[i] > 0 ? high[i] : 0;
+}
+
+KERNEL void _bode_factor_(real a, real* re, real* im) {
+   // (re + j im) * (1 + j a)
+   real t = *re - *im * a;
+   *im = *im + *re * a;
+   *re = t;
+}
+
+KERNEL void _bode_curve_(struct BodeBlock* b, long nf, real* f,
+                         real** out) {
+   // Complex gain, input and output impedance of the first design of
+   // a block at 'nf' frequencies (real and imaginary columns).
+   real Avs = b->Avs[0], fLi = b->fLi[0], fLo = b->fLo[0];
+   real fLb = b->fLb[0], tHi = b->tHi[0], tHo = b->tHo[0];
+   real Zi = b->Zi[0], Zo = b->Zo[0], tZi = b->tZi[0], tZo = b->tZo[0];
+   real kCi = b->kCi[0], kCo = b->kCo[0];
+   real o[6][BODE_BLOCK], fr[BODE_BLOCK];
+   for (long i = 0; i < nf; i += BODE_BLOCK) {
+      long m = nf - i < BODE_BLOCK ? nf - i : BODE_BLOCK;
+      for (long k = m; k < BODE_BLOCK; k++) fr[k] = 1;
+      memcpy(fr, f + i, m * sizeof(real));
+      for (long k = 0; k < BODE_BLOCK; k++) {
+         real x = 1 / fr[k];
+         // Gain is Avs / product of (1 - j fL/f) and (1 + j f/fH).
+         real dr = 1, di = 0;
+         _bode_factor_(-fLi * x, &dr, &di);
+         _bode_factor_(-fLo * x, &dr, &di);
+         _bode_factor_(-fLb * x, &dr, &di);
+         _bode_factor_(fr[k] * tHi, &dr, &di);
+         _bode_factor_(fr[k] * tHo, &dr, &di);
+         real g = Avs / (dr * dr + di * di);
+         o[0][k] = g * dr; o[1][k] = -g * di;
+         // Coupling reactance in series with Z || C.
+         real u = fr[k] * tZi, zi = Zi / (1 + u * u);
+         o[2][k] = zi; o[3][k] = -zi * u - kCi * x;
+         real v = fr[k] * tZo, zo = Zo / (1 + v * v);
+         o[4][k] = zo; o[5][k] = -zo * v - kCo * x;
+      }
+      for (int c = 0; c < 6; c++)
+         memcpy(out[c] + i, o[c], m * sizeof(real));
+   }
+}
+
+// Instantiate the baseline, AVX2 and AVX-512 copies of a kernel and
+// the function 'name_batch_' which selects the widest one that the
+// running processor supports.
+#if BODE_SIMD
+#define BODE_KERNELS(name, params, args) \
+static void name##_scalar_ params { name##_ args; } \
+__attribute__((target("avx2"))) static void name##_avx2_ params { \
+   name##_ args; \
+} \
+__attribute__((target("avx512f"))) static void name##_avx512_ params { \
+   name##_ args; \
+} \
+static void name##_batch_ params { \
+   if (__builtin_cpu_supports("avx512f")) name##_avx512_ args; \
+   else if (__builtin_cpu_supports("avx2")) name##_avx2_ args; \
+   else name##_scalar_ args; \
+}
+#else
+#define BODE_KERNELS(name, params, args) \
+static void name##_scalar_ params { name##_ args; } \
+static void name##_batch_ params { name##_scalar_ args; }
+#endif
+
+// '_bode_cutoffs_batch_(b, fL, fH)' and
+// '_bode_curve_batch_(b, nf, f, out)'.
+BODE_KERNELS(_bode_cutoffs, (struct BodeBlock* b, real* fL, real* fH),
+             (b, fL, fH))
+BODE_KERNELS(_bode_curve, (struct BodeBlock* b, long nf, real* f,
+                           real** out), (b, nf, f, out))
+
+static void _bode_batch_(struct BodeModel* model, long n, real** in,
+                         real** out) {
+   // Batch function of 'bode' entries: results of BODE_RESULTS.
+   struct BodeBlock b;
+   real fL[BODE_BLOCK], fH[BODE_BLOCK];
+   real* columns[CONFIG_COLUMNS];
+   int nin = _bode_columns_(model);
+   for (long i = 0; i < n; i += BODE_BLOCK) {
+      long m = n - i < BODE_BLOCK ? n - i : BODE_BLOCK;
+      for (int c = 0; c < nin; c++) columns[c] = in[c] + i;
+      _bode_block_(model, m, columns, &b);
+      _bode_cutoffs_batch_(&b, fL, fH);
+      for (long k = 0; k < m; k++) {
+         out[0][i + k] = b.Avs[k]; out[1][i + k] = fL[k];
+         out[2][i + k] = fH[k]; out[3][i + k] = b.fLi[k];
+         out[4][i + k] = b.fLo[k]; out[5][i + k] = b.fLb[k];
+         real fHi = 1 / b.tHi[k], fHo = 1 / b.tHo[k];
+         out[6][i + k] = b.tHi[k] > 0 ? fHi : 0;
+         out[7][i + k] = b.tHo[k] > 0 ? fHo : 0;
+      }
+   }
+}
+
+// Define batch function 'name' of the 'bode' entry of 'model'.
+#define BODE_ENTRY(name, model) \
+static void name(long n, real** in, real** out) { \
+   _bode_batch_(&model, n, in, out); \
+}
+
+void bode_response(struct BodeModel* model, real* in, long nf, real* f,
+                   real** out) {
+   real* columns[CONFIG_COLUMNS];
+   struct BodeBlock b;
+   for (int c = 0; c < _bode_columns_(model); c++) columns[c] = in + c;
+   _bode_block_(model, 1, columns, &b);
+   _bode_curve_batch_(&b, nf, f, out);
+}
+
+void bode_frequencies(real low, real high, long n, real* f) {
+   for (long i = 0; i < n; i++)
+      f[i] = n > 1 ? low * real_pow(high / low, (real) i / (n - 1)) : low;
+}
+
+#endif
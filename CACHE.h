@@ -0,0 +1,262 @@
+/* Operating-Point Cache
+
+Interactive tools evaluate same configuration again and again with
+nearly same parameters (e.g. while a slider is dragged). 'OpCache'
+remembers results of configuration entries (see 'Config') keyed by
+their quantized parameters, so a repeated query is a hash and a few
+compares instead of a solution of the circuit.
+
+A parameter is rounded to 'bits' bits of its mantissa after the
+leading one (0 keeps all bits), i.e. parameters within a relative
+step of at most 2^-bits are same key. On a miss, the configuration
+is evaluated at the quantized parameters, so results of a key do not
+depend on which query came first.
+
+The table is split into shards, each one has its own clock on its
+own cache line. A key goes to one set of CACHE_WAYS slots of a
+shard. Sequence counters and hash tags of a set are in one cache
+line, so a lookup reads that line and only the slot whose tag
+matches. A full set evicts its least recently used slot (the clock
+counts misses, a hit marks its slot with current clock).
+
+Hit and miss counters are striped by thread: the first CACHE_STRIPES
+threads that use caches own a stripe and count with plain atomic
+stores. Later threads share a second set of CACHE_STRIPES stripes and
+count with atomic additions, an owned stripe is never written by
+another thread. So, a hit of an owner has no locked instruction.
+
+Slots are guarded by sequence counters (odd while a slot is written):
+readers never wait and retry nothing, a reader that sees a slot being
+written takes it as a miss, and a writer that can not take a slot at
+once does not store its result. So, no thread ever blocks another.
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "CONFIG.h"
+
+// Number of shards (a power of two).
+#define CACHE_SHARDS 64
+// Number of slots of a set.
+#define CACHE_WAYS 8
+// Number of owned (and of shared) stripes of hit and miss counters.
+#define CACHE_STRIPES 64
+
+// Header of a set, a slot is empty while its tag is zero.
+struct CacheSet {
+   atomic_uint versions[CACHE_WAYS]; // odd while slot is written
+   atomic_uint tags[CACHE_WAYS]; // high bits of hash of keys
+} __attribute__((aligned(64)));
+
+struct CacheSlot {
+   atomic_uint used; // shard clock of last use
+   struct Config* config; // configuration of key
+   real key[CONFIG_COLUMNS]; // quantized parameters
+   real value[CONFIG_COLUMNS]; // results
+};
+
+struct CacheShard {
+   struct CacheSet* sets; // headers of sets
+   struct CacheSlot* slots; // CACHE_WAYS slots of each set
+   long nsets; // number of sets (a power of two)
+   atomic_uint clock; // counts misses for LRU eviction
+} __attribute__((aligned(64)));
+
+struct CacheStripe {
+   atomic_long hits, misses;
+} __attribute__((aligned(64)));
+
+struct OpCache {
+   int bits; // kept mantissa bits of parameters, 0 for all
+   struct CacheShard shards[CACHE_SHARDS];
+   // Owned stripes, then stripes shared by later threads.
+   struct CacheStripe stripes[2 * CACHE_STRIPES];
+};
+
+// Number of threads which have used a cache. Stripes are owned per
+// program, so one translation unit of a program includes this header
+// (transistor.c in the library).
+static atomic_int cache_threads;
+// Stripe of thread plus one, above CACHE_STRIPES if it is shared.
+static _Thread_local int cache_stripe;
+
+static void _cache_count_(struct OpCache* cache, int hit) {
+   // Count a hit or a miss in stripe of the calling thread.
+   if (!cache_stripe)
+      cache_stripe = atomic_fetch_add(&cache_threads, 1) + 1;
+   int owner = cache_stripe <= CACHE_STRIPES;
+   int index = (cache_stripe - 1) % CACHE_STRIPES;
+   struct CacheStripe* stripe = &cache->stripes[owner ? index :
+                                                CACHE_STRIPES + index];
+   atomic_long* counter = hit ? &stripe->hits : &stripe->misses;
+   if (owner)
+      atomic_store_explicit(counter, atomic_load_explicit(counter,
+                            memory_order_relaxed) + 1,
+                            memory_order_relaxed);
+   else atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static real _quantize_(real value, int bits) {
+   // Round 'value' to 'bits' bits of mantissa. Rounding is done on
+   // bits of double, a carry into exponent is correct.
+   if (bits <= 0 || bits >= (sizeof(real) == 4 ? 23 : 52)) return value;
+   union { double d; uint64_t u; } x = {value};
+   uint64_t drop = 52 - bits;
+   x.u = (x.u + (1ULL << (drop - 1))) & ~((1ULL << drop) - 1);
+   return (real) x.d;
+}
+
+static uint64_t _cache_hash_(struct Config* config, int nin, real* key) {
+   // Hash of configuration and quantized parameters. Products of
+   // columns are independent, so they are computed in parallel.
+   uint64_t h = (uintptr_t) config;
+   for (int c = 0; c < nin; c++) {
+      uint64_t bits = 0;
+      memcpy(&bits, &key[c], sizeof(real));
+      h ^= (bits + c) * (0x9E3779B97F4A7C15ULL + 2 * c);
+   }
+   h ^= h >> 32; h *= 0xD6E8FEB86659FD93ULL;
+   h ^= h >> 32; h *= 0xD6E8FEB86659FD93ULL;
+   return h ^ (h >> 32);
+}
+
+void op_cache_destroy(struct OpCache* cache) {
+   if (!cache) return;
+   for (int s = 0; s < CACHE_SHARDS; s++) {
+      free(cache->shards[s].sets); free(cache->shards[s].slots);
+   }
+   free(cache);
+}
+
+struct OpCache* op_cache_create(long capacity, int bits) {
+   // Create a cache of at least 'capacity' results. NULL is returned
+   // if memory is not enough.
+   struct OpCache* cache = aligned_alloc(64, sizeof(struct OpCache));
+   if (!cache) return NULL;
+   memset(cache, 0, sizeof(struct OpCache));
+   cache->bits = bits;
+   long sets = 1;
+   while (sets * CACHE_SHARDS * CACHE_WAYS < capacity) sets *= 2;
+   for (int s = 0; s < CACHE_SHARDS; s++) {
+      struct CacheShard* shard = &cache->shards[s];
+      shard->nsets = sets;
+      shard->sets = aligned_alloc(64, sets * sizeof(struct CacheSet));
+      shard->slots = calloc(sets * CACHE_WAYS, sizeof(struct CacheSlot));
+      if (shard->sets)
+         memset(shard->sets, 0, sets * sizeof(struct CacheSet));
+      if (!shard->sets || !shard->slots) {
+         op_cache_destroy(cache);
+         return NULL;
+      }
+   }
+   return cache;
+}
+
+static int _cache_find_(struct CacheSet* set, struct CacheSlot* slots,
+                        unsigned tag, struct Config* config, real* key,
+                        real* out, struct CacheShard* shard) {
+   // Copy results of key from its set into 'out' if they are there.
+   for (int w = 0; w < CACHE_WAYS; w++) {
+      if (atomic_load_explicit(&set->tags[w], memory_order_relaxed)
+          != tag)
+         continue;
+      struct CacheSlot* slot = &slots[w];
+      unsigned version = atomic_load_explicit(&set->versions[w],
+                                              memory_order_acquire);
+      if ((version & 1) || slot->config != config) continue;
+      int c = 0;
+      while (c < config->nin && slot->key[c] == key[c]) c++;
+      if (c < config->nin) continue;
+      for (c = 0; c < config->nout; c++) out[c] = slot->value[c];
+      atomic_thread_fence(memory_order_acquire);
+      if (atomic_load_explicit(&set->versions[w], memory_order_relaxed)
+          != version)
+         return 0; // slot is changed while it is read
+      unsigned now = atomic_load_explicit(&shard->clock,
+                                          memory_order_relaxed);
+      if (atomic_load_explicit(&slot->used, memory_order_relaxed) != now)
+         atomic_store_explicit(&slot->used, now, memory_order_relaxed);
+      return 1;
+   }
+   return 0;
+}
+
+static void _cache_store_(struct CacheSet* set, struct CacheSlot* slots,
+                          unsigned tag, struct Config* config, real* key,
+                          real* out, struct CacheShard* shard) {
+   // Store results into an empty or the least recently used slot.
+   unsigned now = atomic_fetch_add_explicit(&shard->clock, 1,
+                                            memory_order_relaxed) + 1;
+   int victim = 0;
+   unsigned oldest = 0;
+   for (int w = 0; w < CACHE_WAYS; w++) {
+      unsigned age = ~0u; // age of an empty slot
+      if (atomic_load_explicit(&set->tags[w], memory_order_relaxed))
+         age = now - atomic_load_explicit(&slots[w].used,
+                                          memory_order_relaxed);
+      if (age >= oldest) { oldest = age; victim = w; }
+   }
+   unsigned version = atomic_load_explicit(&set->versions[victim],
+                                           memory_order_relaxed);
+   if ((version & 1) || !atomic_compare_exchange_strong_explicit(
+         &set->versions[victim], &version, version + 1,
+         memory_order_acquire, memory_order_relaxed))
+      return; // another thread writes this slot
+   atomic_thread_fence(memory_order_release);
+   struct CacheSlot* slot = &slots[victim];
+   slot->config = config;
+   memcpy(slot->key, key, config->nin * sizeof(real));
+   memcpy(slot->value, out, config->nout * sizeof(real));
+   atomic_store_explicit(&slot->used, now, memory_order_relaxed);
+   atomic_store_explicit(&set->tags[victim], tag, memory_order_relaxed);
+   atomic_store_explicit(&set->versions[victim], version + 2,
+                         memory_order_release);
+}
+
+int op_cache_eval(struct OpCache* cache, struct Config* config,
+                  real* in, real* out) {
+   // Write results of 'config' at parameters 'in' into 'out' (one
+   // value per column). 1 is returned for a hit, 0 for a miss.
+   int nin = config->nin;
+   real key[CONFIG_COLUMNS];
+   if (cache->bits)
+      for (int c = 0; c < nin; c++) key[c] = _quantize_(in[c], cache->bits);
+   else memcpy(key, in, nin * sizeof(real));
+   uint64_t h = _cache_hash_(config, nin, key);
+   struct CacheShard* shard = &cache->shards[h >> 58 & (CACHE_SHARDS-1)];
+   long index = h & (shard->nsets - 1);
+   struct CacheSet* set = &shard->sets[index];
+   struct CacheSlot* slots = &shard->slots[index * CACHE_WAYS];
+   unsigned tag = (unsigned) (h >> 26) | 1; // not zero
+   if (_cache_find_(set, slots, tag, config, key, out, shard)) {
+      _cache_count_(cache, 1);
+      return 1;
+   }
+   _cache_count_(cache, 0);
+   // Evaluate the point by batch function of configuration.
+   real* inputs[CONFIG_COLUMNS];
+   real* outputs[CONFIG_COLUMNS];
+   for (int c = 0; c < nin; c++) inputs[c] = &key[c];
+   for (int c = 0; c < config->nout; c++) outputs[c] = &out[c];
+   config->batch(1, inputs, outputs);
+   _cache_store_(set, slots, tag, config, key, out, shard);
+   return 0;
+}
+
+void op_cache_stats(struct OpCache* cache, long* hits, long* misses) {
+   // Sum counters of all stripes.
+   *hits = *misses = 0;
+   for (int s = 0; s < 2 * CACHE_STRIPES; s++) {
+      *hits += atomic_load_explicit(&cache->stripes[s].hits,
+                                    memory_order_relaxed);
+      *misses += atomic_load_explicit(&cache->stripes[s].misses,
+                                      memory_order_relaxed);
+   }
+}
+
+#endif
@@ -0,0 +1,237 @@
+/* Columnar Output of Results
+
+Results are written column by column in large chunks instead of one
+'printf' per value. There are three formats:
+
+--> COLUMNS_BINARY: a section starts with a header that describes the
+    configuration and column names, and is followed by blocks. Each
+    block has a 64 bytes header (number of rows as uint64) and then
+    each column as 'rows' fixed-width values in byte order of writer.
+    Every column is padded to 64 bytes, so a memory-mapped file has
+    aligned columns. A block with zero rows ends the section and an
+    other section can follow it.
+--> COLUMNS_CSV: a '#' line with configuration, a line of column
+    names and comma separated rows.
+--> COLUMNS_TEXT: a '#' line with configuration and column names and
+    space separated rows.
+
+Text formats use '_format_float_', which writes same digits as "%e"
+with plain integer arithmetic (and "%e" itself only for values near
+the middle of two last digits).
+*/
+
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "PRECISION.h"
+
+// Output formats.
+#define COLUMNS_TEXT 0
+#define COLUMNS_CSV 1
+#define COLUMNS_BINARY 2
+
+// Alignment of binary headers and columns.
+#define COLUMNS_ALIGN 64
+// Bytes of a column name in binary header.
+#define COLUMNS_NAME 16
+// Size of text chunks which are given to 'fwrite'.
+#define COLUMNS_TEXT_CHUNK (1 << 16)
+
+// Header of a binary section, followed by names of columns.
+struct ColumnHeader {
+   char magic[8]; // "TRCOLS1\n"
+   uint32_t size; // bytes of header with names and padding
+   uint32_t element; // bytes of a value, 4 (float) or 8 (double)
+   uint32_t columns; // number of columns
+   uint32_t order; // 1 in byte order of writer
+   char config[40]; // "family name analysis [option]"
+};
+
+struct ColumnWriter {
+   FILE* file;
+   int format; // COLUMNS_TEXT, COLUMNS_CSV or COLUMNS_BINARY
+   int element; // bytes of a binary value, 4 or 8 (sizeof(real))
+   int columns; // number of columns of current section
+   int open; // set while a section is written
+};
+
+static int _format_float_(char* s, double value) {
+   // Write 'value' like "%e" (7 significant digits) and return the
+   // number of written characters.
+   static const double tens[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+                                 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+                                 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+                                 1e19, 1e20, 1e21, 1e22};
+   char* start = s;
+   double x = value;
+   if (isnan(x)) { memcpy(s, "nan", 3); return 3; }
+   if (signbit(x)) { *s++ = '-'; x = -x; }
+   if (isinf(x)) { memcpy(s, "inf", 3); return s - start + 3; }
+   int exponent = 0;
+   uint32_t digits = 0;
+   if (x != 0) {
+      exponent = (int) floor(log10(x));
+      // Scale into [1e6, 1e7) in two steps for big exponents.
+      int shift = 6 - exponent;
+      double scaled = x;
+      while (shift > 22) { scaled *= tens[22]; shift -= 22; }
+      while (shift < -22) { scaled /= tens[22]; shift += 22; }
+      scaled = shift >= 0 ? scaled * tens[shift] : scaled / tens[-shift];
+      // log10 can be one off near powers of ten.
+      if (scaled >= 10000000) { scaled /= 10; exponent++; }
+      else if (scaled < 1000000) { scaled *= 10; exponent--; }
+      digits = (uint32_t) rint(scaled);
+      if (digits == 10000000) { digits = 1000000; exponent++; }
+      // 'scaled' is off by a few units of its last place, so a value
+      // near the middle of two last digits can be rounded either way.
+      // Such values are rare, their digits are taken from "%e".
+      if (fabs(scaled - floor(scaled) - 0.5) < 1e-6) {
+         char exact[32];
+         snprintf(exact, sizeof(exact), "%.6e", x);
+         digits = exact[0] - '0';
+         for (int i = 2; i < 8; i++) digits = 10 * digits + exact[i] - '0';
+         exponent = atoi(exact + 9);
+      }
+   }
+   char mantissa[7];
+   for (int i = 6; i >= 0; i--) {
+      mantissa[i] = '0' + digits % 10;
+      digits /= 10;
+   }
+   *s++ = mantissa[0];
+   *s++ = '.';
+   memcpy(s, mantissa + 1, 6); s += 6;
+   *s++ = 'e';
+   *s++ = exponent < 0 ? '-' : '+';
+   if (exponent < 0) exponent = -exponent;
+   // Doubles have three digits of exponent, like "%e".
+   if (exponent >= 100) {
+      *s++ = '0' + exponent / 100;
+      exponent %= 100;
+   }
+   *s++ = '0' + exponent / 10;
+   *s++ = '0' + exponent % 10;
+   return s - start;
+}
+
+int begin_columns(struct ColumnWriter* writer, char* config,
+                  int columns, char** names) {
+   // Start a section of 'columns' columns. Returns -1 on write error.
+   FILE* file = writer->file;
+   writer->columns = columns;
+   writer->open = 1;
+   if (writer->format == COLUMNS_BINARY) {
+      struct ColumnHeader header = {"TRCOLS1\n"};
+      uint32_t size = sizeof(header) + columns * COLUMNS_NAME;
+      header.size = (size + COLUMNS_ALIGN - 1) / COLUMNS_ALIGN *
+                    COLUMNS_ALIGN;
+      header.element = writer->element == 8 ? 8 : 4;
+      header.columns = columns;
+      header.order = 1;
+      strncpy(header.config, config, sizeof(header.config) - 1);
+      fwrite(&header, sizeof(header), 1, file);
+      for (int c = 0; c < columns; c++) {
+         char name[COLUMNS_NAME] = {0};
+         strncpy(name, names[c], COLUMNS_NAME - 1);
+         fwrite(name, COLUMNS_NAME, 1, file);
+      }
+      for (uint32_t i = size; i < header.size; i++) fputc(0, file);
+   }
+   else {
+      fprintf(file, "# %s", config);
+      if (writer->format == COLUMNS_CSV) fputc('\n', file);
+      else fputc(':', file);
+      for (int c = 0; c < columns; c++) {
+         if (writer->format == COLUMNS_CSV) fputs(c ? "," : "", file);
+         else fputc(' ', file);
+         fputs(names[c], file);
+      }
+      fputc('\n', file);
+   }
+   return ferror(file) ? -1 : 0;
+}
+
+int write_columns(struct ColumnWriter* writer, long n, real** columns) {
+   // Write 'n' rows of the columns. Returns -1 on write error.
+   FILE* file = writer->file;
+   if (n <= 0) return ferror(file) ? -1 : 0;
+   if (writer->format == COLUMNS_BINARY) {
+      char block[COLUMNS_ALIGN] = {0}, zeros[COLUMNS_ALIGN] = {0};
+      uint64_t rows = n;
+      memcpy(block, &rows, sizeof(rows));
+      fwrite(block, COLUMNS_ALIGN, 1, file);
+      long bytes = n * (writer->element == 8 ? 8 : 4);
+      long padding = (COLUMNS_ALIGN - bytes % COLUMNS_ALIGN) %
+                     COLUMNS_ALIGN;
+      for (int c = 0; c < writer->columns; c++) {
+         if (writer->element == (int) sizeof(real))
+            fwrite(columns[c], sizeof(real), n, file);
+         else if (writer->element == 8) {
+            // Convert through a small buffer to write large chunks.
+            double buffer[1024];
+            for (long i = 0; i < n; i += 1024) {
+               long m = n - i < 1024 ? n - i : 1024;
+               for (long j = 0; j < m; j++)
+                  buffer[j] = columns[c][i + j];
+               fwrite(buffer, sizeof(double), m, file);
+            }
+         }
+         else {
+            float buffer[1024];
+            for (long i = 0; i < n; i += 1024) {
+               long m = n - i < 1024 ? n - i : 1024;
+               for (long j = 0; j < m; j++)
+                  buffer[j] = columns[c][i + j];
+               fwrite(buffer, sizeof(float), m, file);
+            }
+         }
+         fwrite(zeros, 1, padding, file);
+      }
+      return ferror(file) ? -1 : 0;
+   }
+   // Rows are formatted into a chunk which is written at once.
+   char separator = writer->format == COLUMNS_CSV ? ',' : ' ';
+   char* chunk = malloc(COLUMNS_TEXT_CHUNK);
+   if (!chunk) return -1;
+   long used = 0;
+   for (long i = 0; i < n; i++) {
+      if (used + writer->columns * 16 > COLUMNS_TEXT_CHUNK) {
+         fwrite(chunk, 1, used, file);
+         used = 0;
+      }
+      for (int c = 0; c < writer->columns; c++) {
+         if (c) chunk[used++] = separator;
+         used += _format_float_(chunk + used, columns[c][i]);
+      }
+      chunk[used++] = '\n';
+   }
+   fwrite(chunk, 1, used, file);
+   free(chunk);
+   return ferror(file) ? -1 : 0;
+}
+
+int end_columns(struct ColumnWriter* writer) {
+   // End current section and flush it. Returns -1 on write error.
+   if (writer->open && writer->format == COLUMNS_BINARY) {
+      char block[COLUMNS_ALIGN] = {0};
+      fwrite(block, COLUMNS_ALIGN, 1, writer->file);
+   }
+   writer->open = 0;
+   fflush(writer->file);
+   return ferror(writer->file) ? -1 : 0;
+}
+
+static int _columns_format_(char* name) {
+   // Find output format from its name, -1 if it is unknown.
+   if (strcmp(name, "text") == 0) return COLUMNS_TEXT;
+   if (strcmp(name, "csv") == 0) return COLUMNS_CSV;
+   if (strcmp(name, "bin") == 0) return COLUMNS_BINARY;
+   return -1;
+}
+
+#endif
@@ -0,0 +1,103 @@
+/* Descriptions of Transistor Configurations
+
+Every configuration that has batch functions is described by 'Config'
+entries (one entry for each analysis type). An entry gives the names
+of the parameter and result columns and a batch function with common
+signature. So, drivers like sweeps can run any configuration without
+knowing its own function signature. 'Config' and the tables are
+declared in transistor.h.
+*/
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <string.h>
+#include "transistor.h"
+
+/* Specialized Kernels
+
+Settings that are same for all points of a run (analysis type, bypass
+option and transistor family) are 'const int' arguments of kernels
+marked with 'KERNEL'. A kernel is always inlined into its callers,
+which pass constants, so every caller gets its own copy of the kernel
+without branches on settings and without computations whose results
+are not saved (like templates with constant parameters in C++).
+
+A configuration kernel has two stages: the DC stage and the AC stage.
+The operating point which both stages need (e.g. Ib and Ie of a BJT,
+Id and Vgs of a FET) is computed once before them. 'analysis' is a
+set of stages, so "both" analysis writes 'dc' and 'ac' structs in one
+call without solving the operating point twice.
+
+The operating point is kept in 'op' of the caller. It is solved only
+when ANALYSIS_OP is in 'analysis', otherwise the stages use 'op' of
+the last call. So, an incremental evaluation (INCREMENTAL.h) runs only
+the stages whose parameters are changed.
+*/
+
+#define ANALYSIS_DC 1
+#define ANALYSIS_AC 2
+#define ANALYSIS_BOTH (ANALYSIS_DC | ANALYSIS_AC)
+#define ANALYSIS_OP 4
+
+#if defined(__GNUC__)
+#define KERNEL static inline __attribute__((always_inline))
+#else
+#define KERNEL static inline
+#endif
+
+// Call 'kernel' with the constant of analysis code 'code'. The
+// operating point is always solved.
+#define ANALYSIS_DISPATCH(code, kernel, ...) do { \
+   switch (code) { \
+   case ANALYSIS_DC: kernel(ANALYSIS_OP | ANALYSIS_DC, __VA_ARGS__); \
+      break; \
+   case ANALYSIS_AC: kernel(ANALYSIS_OP | ANALYSIS_AC, __VA_ARGS__); \
+      break; \
+   default: kernel(ANALYSIS_OP | ANALYSIS_BOTH, __VA_ARGS__); } \
+   } while (0)
+
+// Call 'kernel' with the constant of stage set 'stages' (analysis
+// codes, with or without ANALYSIS_OP).
+#define STAGE_DISPATCH(stages, kernel, ...) do { \
+   switch (stages) { \
+   case ANALYSIS_DC: kernel(ANALYSIS_DC, __VA_ARGS__); break; \
+   case ANALYSIS_AC: kernel(ANALYSIS_AC, __VA_ARGS__); break; \
+   case ANALYSIS_BOTH: kernel(ANALYSIS_BOTH, __VA_ARGS__); break; \
+   case ANALYSIS_OP | ANALYSIS_DC: \
+      kernel(ANALYSIS_OP | ANALYSIS_DC, __VA_ARGS__); break; \
+   case ANALYSIS_OP | ANALYSIS_AC: \
+      kernel(ANALYSIS_OP | ANALYSIS_AC, __VA_ARGS__); break; \
+   case ANALYSIS_OP | ANALYSIS_BOTH: \
+      kernel(ANALYSIS_OP | ANALYSIS_BOTH, __VA_ARGS__); break; } \
+   } while (0)
+
+static int _analysis_(char* analysis) {
+   // Find constant of "dc", "ac" or "both" analysis for kernels.
+   if (strcmp(analysis, "dc") == 0) return ANALYSIS_DC;
+   if (strcmp(analysis, "both") == 0) return ANALYSIS_BOTH;
+   return ANALYSIS_AC;
+}
+
+static inline struct Config* _find_config_(struct Config* table, int size,
+                                           char* name, char* analysis,
+                                           char* option) {
+   // Find the entry of configuration in 'table'. If 'option' is NULL,
+   // the first entry with same name and analysis is returned.
+   for (int i = 0; i < size; i++) {
+      if (strcmp(table[i].name, name) || 
+          strcmp(table[i].analysis, analysis)) continue;
+      if (option == NULL || (table[i].option && 
+          strcmp(table[i].option, option) == 0)) return &table[i];
+   }
+   return NULL;
+}
+
+static inline int _find_column_(char** names, int n, char* name) {
+   // Find index of the column that has 'name', -1 if there is not.
+   for (int i = 0; i < n; i++) 
+      if (strcmp(names[i], name) == 0) return i;
+   return -1;
+}
+
+#endif
@@ -0,0 +1,220 @@
+/* Memory-Mapped Parameter Decks
+
+A deck is a file of parameter columns in the binary format of
+COLUMNS.h. The configuration string of each section names the
+configuration ("fet vd ac", "bjt vd ac bypassed", ...) and the column
+names are the 'inputs' names of its entry, in any order. Any writer
+of that format can make a deck, e.g. 'begin_columns' with 'inputs'
+of configuration and then 'write_columns'.
+
+Programs run a deck with 'JFET -d deck [format]'. The file is mapped
+into memory and real columns are given to the batch functions as
+pointers into the mapped pages, so rows are neither parsed nor
+copied. Columns of the other precision (see PRECISION.h) are
+converted chunk by chunk. Rows are evaluated by 'run_checked' like
+jobs (JOBS.h): rows with parameters out of their domains are reported
+to stderr with their row in the section, and their results are NaN.
+*/
+
+#ifndef DECK_H
+#define DECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "CONFIG.h"
+#include "COLUMNS.h"
+#include "JOBS.h"
+
+// Number of rows which is given to a batch function at once.
+#define DECK_CHUNK 65536
+
+struct Deck {
+   char* data; // mapped file
+   size_t size; // bytes of file
+};
+
+int open_deck(struct Deck* deck, char* path) {
+   // Map deck file at 'path' into memory. Returns -1 on error.
+   struct stat status;
+   int file = open(path, O_RDONLY);
+   deck->data = NULL;
+   if (file < 0) return -1;
+   if (fstat(file, &status) || status.st_size == 0) {
+      close(file);
+      return -1;
+   }
+   deck->size = status.st_size;
+   deck->data = mmap(NULL, deck->size, PROT_READ, MAP_PRIVATE, file, 0);
+   close(file);
+   if (deck->data == MAP_FAILED) {
+      deck->data = NULL;
+      return -1;
+   }
+   // Rows are read once from front to back.
+   madvise(deck->data, deck->size, MADV_SEQUENTIAL);
+   return 0;
+}
+
+void close_deck(struct Deck* deck) {
+   if (deck->data) munmap(deck->data, deck->size);
+   deck->data = NULL;
+}
+
+static struct Config* _deck_config_(char* description,
+                                    struct JobTable* tables, int ntables) {
+   // Find configuration of "family name analysis [option]".
+   char copy[48];
+   char* rest;
+   strncpy(copy, description, sizeof(copy) - 1);
+   copy[sizeof(copy) - 1] = '\0';
+   char* family = strtok_r(copy, " ", &rest);
+   char* name = strtok_r(NULL, " ", &rest);
+   char* analysis = strtok_r(NULL, " ", &rest);
+   char* option = strtok_r(NULL, " ", &rest);
+   if (!family || !name || !analysis) return NULL;
+   for (int t = 0; t < ntables; t++) {
+      if (tables[t].count == 0 ||
+          strcmp(tables[t].configs[0].family, family)) continue;
+      struct Config* config = _find_config_(tables[t].configs,
+                                            tables[t].count, name,
+                                            analysis, option);
+      // Option must be given for configurations that have options.
+      if (config && (!config->option) == (!option)) return config;
+   }
+   return NULL;
+}
+
+long run_deck(struct Deck* deck, struct JobTable* tables, int ntables,
+              struct ColumnWriter* writer) {
+   // Evaluate all sections of deck and write results by 'writer'.
+   // Number of rows is returned, -1 if deck is wrong.
+   real* outputs[CONFIG_COLUMNS] = {NULL};
+   real* converted[CONFIG_COLUMNS] = {NULL};
+   unsigned char* status = malloc(DECK_CHUNK);
+   size_t offset = 0;
+   long total = status ? 0 : -1;
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      outputs[c] = malloc(DECK_CHUNK * sizeof(real));
+      converted[c] = malloc(DECK_CHUNK * sizeof(real));
+      if (!outputs[c] || !converted[c]) total = -1;
+   }
+   while (total >= 0 && offset < deck->size) {
+      struct ColumnHeader header = {{0}};
+      if (deck->size - offset >= sizeof(header))
+         memcpy(&header, deck->data + offset, sizeof(header));
+      header.config[sizeof(header.config) - 1] = '\0';
+      struct Config* config = _deck_config_(header.config, tables,
+                                            ntables);
+      if (memcmp(header.magic, "TRCOLS1\n", 8) || header.order != 1 ||
+          (header.element != 4 && header.element != 8) || !config ||
+          header.columns > 64 || header.size < sizeof(header) +
+          header.columns * COLUMNS_NAME ||
+          header.size > deck->size - offset) {
+         fprintf(stderr, "Wrong deck section at byte %zu !!!\n", offset);
+         total = -1;
+         break;
+      }
+      // Find the deck column of every parameter.
+      int index[CONFIG_COLUMNS];
+      char* names = deck->data + offset + sizeof(header);
+      for (int c = 0; c < config->nin; c++) {
+         index[c] = -1;
+         for (uint32_t k = 0; k < header.columns; k++)
+            if (strncmp(names + k * COLUMNS_NAME, config->inputs[c],
+                        COLUMNS_NAME) == 0) index[c] = k;
+         if (index[c] < 0) {
+            fprintf(stderr, "Deck has not '%s' column !!!\n",
+                    config->inputs[c]);
+            total = -1;
+         }
+      }
+      if (total < 0) break;
+      size_t section = offset;
+      long row = 0; // first row of block in section
+      offset += header.size;
+      end_columns(writer);
+      begin_columns(writer, header.config, config->nout,
+                    config->outputs);
+      // Evaluate blocks until a block with zero rows.
+      for (;;) {
+         uint64_t rows;
+         if (deck->size - offset < COLUMNS_ALIGN) { total = -1; break; }
+         memcpy(&rows, deck->data + offset, sizeof(rows));
+         offset += COLUMNS_ALIGN;
+         if (rows == 0) break;
+         size_t bytes = (rows * header.element + COLUMNS_ALIGN - 1) /
+                        COLUMNS_ALIGN * COLUMNS_ALIGN;
+         if (bytes / header.element < rows ||
+             (deck->size - offset) / header.columns < bytes) {
+            total = -1;
+            break;
+         }
+         char* block = deck->data + offset;
+         for (uint64_t i = 0; i < rows; i += DECK_CHUNK) {
+            long n = rows - i < DECK_CHUNK ? rows - i : DECK_CHUNK;
+            real* inputs[CONFIG_COLUMNS];
+            for (int c = 0; c < config->nin; c++) {
+               char* column = block + index[c] * bytes;
+               if (header.element == sizeof(real)) {
+                  inputs[c] = (real*) column + i;
+                  continue;
+               }
+               if (header.element == 8)
+                  for (long j = 0; j < n; j++)
+                     converted[c][j] = ((double*) column)[i + j];
+               else
+                  for (long j = 0; j < n; j++)
+                     converted[c][j] = ((float*) column)[i + j];
+               inputs[c] = converted[c];
+            }
+            if (run_checked(config, n, inputs, outputs, status) > 0)
+               for (long j = 0; j < n; j++)
+                  if (status[j] == STATUS_INVALID)
+                     fprintf(stderr, "Invalid parameters at row %ld of "
+                             "deck section at byte %zu !!!\n",
+                             row + (long) i + j, section);
+            write_columns(writer, n, outputs);
+         }
+         offset += bytes * header.columns;
+         total += rows;
+         row += rows;
+      }
+      if (total < 0)
+         fprintf(stderr, "Deck is truncated at byte %zu !!!\n", offset);
+   }
+   if (end_columns(writer)) total = -1;
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      free(outputs[c]); free(converted[c]);
+   }
+   free(status);
+   return total;
+}
+
+int run_deck_file(char* path, char* format, struct JobTable* tables,
+                  int ntables) {
+   // Run deck file at 'path' and write results to stdout in 'format'
+   // ("text", "csv" or "bin"). Returns the exit status of program.
+   struct Deck deck;
+   struct ColumnWriter writer = {stdout, _columns_format_(format),
+                                 sizeof(real)};
+   if (writer.format < 0) {
+      fprintf(stderr, "Can not found '%s' format !!!\n", format);
+      return 1;
+   }
+   if (open_deck(&deck, path)) {
+      fprintf(stderr, "Can not open deck file '%s' !!!\n", path);
+      return 1;
+   }
+   setvbuf(stdout, NULL, _IOFBF, JOB_BUFFER);
+   long rows = run_deck(&deck, tables, ntables, &writer);
+   close_deck(&deck);
+   return rows < 0;
+}
+
+#endif
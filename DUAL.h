@@ -0,0 +1,124 @@
+/* Dual Numbers for Sensitivities
+
+A dual number keeps a value and its partial derivatives with respect
+to all parameters of a configuration (forward-mode automatic
+differentiation). Parameter c is seeded with derivative 1 at index c
+and every operation applies its rule of derivative to all indices, so
+one evaluation gives the whole Jacobian: d out[r] / d in[c] of all
+results and parameters, without a step size and without one extra
+evaluation per parameter like finite differences.
+
+Derivatives are 'real' arrays of a fixed size (the maximum number of
+parameters of entries that have Jacobians), so the loops of operations
+have constant length and are vectorized by the compiler.
+
+The Jacobian functions of configurations ('jacobian' of 'Config')
+run the dual kernels of their family headers, see e.g.
+'_b_fixed_bias_dual_' of BJT.h.
+*/
+
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <math.h>
+#include "PRECISION.h"
+#include "CONFIG.h"
+
+// Number of derivatives of a dual number. "bode" entries have more
+// parameters but no Jacobians.
+#define DUAL_SIZE 12
+
+struct Dual {
+   real v; // value
+   real d[DUAL_SIZE]; // derivatives with respect to parameters
+};
+
+KERNEL struct Dual _d_(real v) {
+   // Constant, all derivatives are zero.
+   struct Dual x = {v, {0}};
+   return x;
+}
+
+KERNEL struct Dual _d_var_(real v, int k) {
+   // Parameter k, its derivative with respect to itself is one.
+   struct Dual x = {v, {0}};
+   x.d[k] = 1;
+   return x;
+}
+
+KERNEL struct Dual _d_add_(struct Dual a, struct Dual b) {
+   struct Dual x = {a.v + b.v, {0}};
+   for (int k = 0; k < DUAL_SIZE; k++) x.d[k] = a.d[k] + b.d[k];
+   return x;
+}
+
+KERNEL struct Dual _d_sub_(struct Dual a, struct Dual b) {
+   struct Dual x = {a.v - b.v, {0}};
+   for (int k = 0; k < DUAL_SIZE; k++) x.d[k] = a.d[k] - b.d[k];
+   return x;
+}
+
+KERNEL struct Dual _d_mul_(struct Dual a, struct Dual b) {
+   struct Dual x = {a.v * b.v, {0}};
+   for (int k = 0; k < DUAL_SIZE; k++)
+      x.d[k] = a.d[k] * b.v + a.v * b.d[k];
+   return x;
+}
+
+KERNEL struct Dual _d_div_(struct Dual a, struct Dual b) {
+   // (a/b)' = (a' - (a/b) * b') / b
+   struct Dual x = {a.v / b.v, {0}};
+   for (int k = 0; k < DUAL_SIZE; k++)
+      x.d[k] = (a.d[k] - x.v * b.d[k]) / b.v;
+   return x;
+}
+
+KERNEL struct Dual _d_scale_(struct Dual a, real s) {
+   // s * a
+   struct Dual x = {s * a.v, {0}};
+   for (int k = 0; k < DUAL_SIZE; k++) x.d[k] = s * a.d[k];
+   return x;
+}
+
+KERNEL struct Dual _d_shift_(struct Dual a, real s) {
+   // a + s
+   a.v += s;
+   return a;
+}
+
+KERNEL struct Dual _d_rdiv_(real s, struct Dual a) {
+   // s / a, (s/a)' = -(s/a) * a' / a
+   struct Dual x = {s / a.v, {0}};
+   for (int k = 0; k < DUAL_SIZE; k++) x.d[k] = -x.v * a.d[k] / a.v;
+   return x;
+}
+
+KERNEL struct Dual _d_inv_(struct Dual a) {
+   return _d_rdiv_(1, a);
+}
+
+KERNEL struct Dual _d_fabs_(struct Dual a) {
+   return (a.v < 0) ? _d_scale_(a, -1) : a;
+}
+
+KERNEL struct Dual _d_parallel_(struct Dual R1, struct Dual R2) {
+   // Resultant resistance of two parallel resistances.
+   return _d_inv_(_d_add_(_d_inv_(R1), _d_inv_(R2)));
+}
+
+KERNEL void _d_inputs_(int nin, real* in, struct Dual* p) {
+   // Seed parameters 'in' as dual numbers.
+   for (int c = 0; c < nin; c++) p[c] = _d_var_(in[c], c);
+}
+
+KERNEL void _d_outputs_(int nout, int nin, struct Dual* r, real* out,
+                        real* jacobian) {
+   // Write values of results into 'out' and their derivatives into
+   // rows of 'jacobian' (d out[i] / d in[c] at i * nin + c).
+   for (int i = 0; i < nout; i++) {
+      out[i] = r[i].v;
+      for (int c = 0; c < nin; c++) jacobian[i * nin + c] = r[i].d[c];
+   }
+}
+
+#endif
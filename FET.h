@@ -1,356 +1,1409 @@
 /* Basics FET Operations and Calculations */
 
+#ifndef FET_H
+#define FET_H
+
 #include <stdio.h>
 #include <stdlib.h>
-#include <assert.h>
 #include <string.h>
 #include <math.h>
+#include "CONFIG.h"
+#include "DUAL.h"
+#include "INTERVAL.h"
+#include "BODE.h"
+#include "NEWTON.h"
+#include "REGION.h"
+#include "STATUS.h"
 
-// Results of DC Analysis
-struct DCComponents {
-   float Id; // drain current
-   float Vgs; // gate-source voltage
-   float Vds; // drain-source voltage
-   float Vs; // source voltage
-   float Vd; // drain voltage
-   float Vg; // gate voltage
-};
-// Results of AC Analysis
-struct ACComponents {
-   float gm; // transconductance factor
-   float Zi; // input impedance
-   float Zo; // output impedance
-   float Av; // voltage gain
-   char* phase; // phase relationship
-};
+// Configuration functions save the results into 'DCFET' or 'ACFET'
+// struct (transistor.h) given by the caller (only the ones of
+// requested analysis are written). There is no shared state, so they
+// can run concurrently.
+
+KERNEL void _save_dc_results_(struct DCFET* dc, real Id, real Vds, real Vgs,
+                              real Vs, real Vd, real Vg, real Vp) {
+   // Save the results into 'dc' struct of the caller.
+   dc->Id = Id; // drain current
+   dc->Vds = Vds; // drain-source voltage
+   dc->Vgs = Vgs; // gate-source voltage
+   dc->Vs = Vs; // source voltage
+   dc->Vd = Vd; // drain voltage
+   dc->Vg = Vg; // gate voltage
+   dc->region = _fet_region_(Vgs, Vds, Vp); // operating region
+}
+
+KERNEL void _save_ac_results_(struct ACFET* ac, real gm, real Zi, real Zo,
+                              real Av, char* phase) {
+   // Save the results into 'ac' struct of the caller.
+   ac->gm = gm; // transconductance factor
+   ac->Zi = Zi; // input impedance
+   ac->Zo = Zo; // output impedance
+   ac->Av = Av; // voltage gain
+   ac->phase = phase; // phase relationship
+}
+
+static void _status_(int analysis, int status, struct DCFET* dc,
+                     struct ACFET* ac) {
+   // Save status of point into results of 'analysis' like the one of
+   // BJTs ('_b_status_').
+   int nan = status == STATUS_INVALID || status == STATUS_UNSUPPORTED;
+   if (analysis & ANALYSIS_DC) {
+      if (nan)
+         _save_dc_results_(dc, NAN, NAN, NAN, NAN, NAN, NAN, NAN);
+      dc->status = status;
+   }
+   if (analysis & ANALYSIS_AC) {
+      if (nan)
+         _save_ac_results_(ac, NAN, NAN, NAN, NAN,
+                           status == STATUS_UNSUPPORTED ? "" :
+                           ac->phase);
+      ac->status = status;
+   }
+}
+
+static int _finite_(int analysis, struct DCFET* dc, struct ACFET* ac) {
+   // 1 if all results of 'analysis' are finite.
+   if (analysis & ANALYSIS_DC)
+      return isfinite(dc->Id) && isfinite(dc->Vds) && isfinite(dc->Vgs) &&
+             isfinite(dc->Vs) && isfinite(dc->Vd) && isfinite(dc->Vg);
+   return isfinite(ac->gm) && isfinite(ac->Zi) && isfinite(ac->Zo) &&
+          isfinite(ac->Av);
+}
+
+static void _check_(int analysis, int dc_valid, int ac_valid,
+                    struct DCFET* dc, struct ACFET* ac) {
+   // Save status of DC and AC stages like the one of BJTs
+   // ('_b_check_').
+   int dc_status = !dc_valid ? STATUS_INVALID :
+                   (analysis & ANALYSIS_DC) &&
+                   !_finite_(ANALYSIS_DC, dc, ac) ? STATUS_NONFINITE :
+                   STATUS_OK;
+   int ac_status = !ac_valid ? STATUS_INVALID :
+                   (analysis & ANALYSIS_AC) &&
+                   !_finite_(ANALYSIS_AC, dc, ac) ? STATUS_NONFINITE :
+                   STATUS_OK;
+   _status_(analysis & ANALYSIS_DC, dc_status, dc, ac);
+   _status_(analysis & ANALYSIS_AC, ac_status, dc, ac);
+}
+
+#if PRECISION_MIXED
+static int _ill_conditioned_(float a, float b, float c) {
+   // Check if roots of a*x^2 + b*x + c lose precision in float.
+   float bb = b * b, ac4 = 4 * a * c;
+   return bb - ac4 < PRECISION_ILL * bb;
+}
+#endif
+
+static double _select_root_double_(double a, double b, double c) {
+   // Select same root as '_select_root_' in double. The roots are
+   // found as q/a and c/q, so the smaller one has no cancellation.
+   double q = -0.5 * (b + copysign(sqrt(b * b - 4 * a * c), b));
+   double root1 = q / a, root2 = c / q;
+   double low = fmin(root1, root2), high = fmax(root1, root2);
+   return (low >= 0) ? low : high;
+}
+
+static double _select_right_Id_double_(double a, double b, double c) {
+   // '_select_right_Id_' in double.
+   return fabs(_select_root_double_(a, b, c));
+}
+
+static real _select_root_(real a, real b, real c) {
+#if PRECISION_MIXED
+   // Solve again in double if float roots are not accurate.
+   if (_ill_conditioned_(a, b, c))
+      return _select_root_double_(a, b, c);
+#endif
+   // Find dicriminant and calculate two different roots. They are
+   // q/a and c/q like '_select_root_double_', so neither of them
+   // is a difference of nearly same numbers.
+   real dicriminant = (b * b) - (4 * a * c);
+   real q = (real) -0.5 * (b + real_copysign(real_sqrt(dicriminant), b));
+   real root1 = q / a, root2 = c / q;
+   // Specially, in some configuration, can be found two root and 
+   // requires selecting one. The smaller positive root is the right 
+   // one. If the smaller root is negative, the larger root is taken
+   // (with its sign, which '_select_right_Id_' drops).
+   real low = real_fmin(root1, root2), high = real_fmax(root1, root2);
+   return (low >= 0) ? low : high;
+}
+
+static real _select_right_Id_(real a, real b, real c) {
+   // Drain current is the magnitude of the selected root. If both
+   // roots are negative, it is the one that is nearer to zero.
+   return real_fabs(_select_root_(a, b, c));
+}
+
+// Laws of drain current which are solved by the same quadratic.
+#define FET_SHOCKLEY 0 // JFET and D-MOSFET, Idss and Vp are given
+#define FET_SQUARE_LAW 1 // E-MOSFET, k and Vgsth are given
+
+KERNEL double _drain_Id_double_(const int law, double P, double V,
+                                double Rs, double Vg) {
+   // '_drain_Id_' in double, from parameters to the root.
+   double u = law == FET_SQUARE_LAW ? P : P / (V * V);
+   double d = V - Vg;
+   double Id = _select_right_Id_double_(u * Rs * Rs, 2 * u * d * Rs - 1,
+                                        u * d * d);
+   return d >= 0 ? 0 : Id;
+}
 
-// For all DC configuration:
-struct DCComponents DCAnalysis;
-// For all AC configuration:
-struct ACComponents ACAnalysis;
-
-void _save_dc_results_(float Id, float Vds, float Vgs, float Vs, 
-                       float Vd, float Vg) {
-   // Save the results into 'DCAnalysis' struct.
-   DCAnalysis.Id = Id; // drain current
-   DCAnalysis.Vds = Vds; // drain-source voltage
-   DCAnalysis.Vgs = Vgs; // gate-source voltage
-   DCAnalysis.Vs = Vs; // source voltage
-   DCAnalysis.Vd = Vd; // drain voltage
-   DCAnalysis.Vg = Vg; // gate voltage
-}
-
-void _save_ac_results_(float gm, float Zi, float Zo, float Av, 
-                       char* phase) {
-   // Save the results into 'ACAnalysis' strcut.
-   ACAnalysis.gm = gm; // transconductance factor
-   ACAnalysis.Zi = Zi; // input impedance
-   ACAnalysis.Zo = Zo; // output impedance
-   ACAnalysis.Av = Av; // voltage gain
-   ACAnalysis.phase = phase; // phase relationship
-}
-
-float _select_right_Id_(float a, float b, float c) {
-   // Find dicriminant and calculate two different roots.
-   float dicriminant = (b * b) - (4 * a * c);
-   float root1 = (-1.0 * b + sqrt(dicriminant)) / (2 * a); 
-   float root2 = (-1.0 * b - sqrt(dicriminant)) / (2 * a);
-   // Specially, in some configuration, can be found two root
-   // and requires slecting one.
-   if (root1 >= 0 && root2 < 0) return root1;
-   if (root2 >= 0 && root1 < 0) return root2;
-   if (root1 >= 0 && root2 >= 0) {
-      if (root1 >= root2) return root2;
-      else return root1;
-   } 
-   if (root1 < 0 && root2 < 0) {
-      if (abs(root1) >= abs(root2)) return abs(root2);
-      else return abs(root1);
-   }
-}
-
-float _find_gm_factor_(float Idss, float Vp, float Vgs) {
-   // Find transconductance factor (gm).
-   return (2.0 * Idss / abs(Vp)) * (1.0 - Vgs / Vp); 
-}
-
-float _parallel_(float R1, float R2) {
+KERNEL real _drain_Id_(const int law, real P, real V, real Rs, real Vg) {
+   // Solve Id = u * (V - Vgs)^2 with Vgs = Vg - Id * Rs. For Shockley
+   // law P is Idss, V is Vp and u is Idss / Vp^2. For square law P is
+   // k, V is Vgsth and u is k, so it is not divided. It is the common
+   // quadratic of self-bias, voltage-divider and common-gate (Vg is
+   // zero, gate voltage and Vss of them) and E-MOSFET configurations.
+   // A point whose Vg is not above V is cut off (Vgs <= V already at
+   // Id = 0), its roots are not drain currents or not real, so Id is 0.
+   real u = law == FET_SQUARE_LAW ? P : P / (V * V);
+   real d = V - Vg;
+   real a = u * Rs * Rs, b = 2 * u * d * Rs - 1, c = u * d * d;
+#if PRECISION_MIXED
+   if (_ill_conditioned_(a, b, c))
+      return _drain_Id_double_(law, P, V, Rs, Vg);
+#endif
+   real Id = _select_right_Id_(a, b, c);
+   return d >= 0 ? 0 : Id;
+}
+
+static real _shockley_Id_(real Idss, real Vp, real Rs, real Vg) {
+   return _drain_Id_(FET_SHOCKLEY, Idss, Vp, Rs, Vg);
+}
+
+KERNEL real _find_gm_factor_(real Idss, real Vp, real Vgs) {
+   // Find transconductance factor (gm), it is zero in cut-off.
+   return (2.0f * Idss / real_fabs(Vp)) * real_fmax(1.0f - Vgs / Vp, 0);
+}
+
+KERNEL real _parallel_(real R1, real R2) {
    // Find resultant resistance for two paallel resistances.
    return 1.0 / (1.0/R1 + 1.0/R2);
 }
 
+KERNEL real _divider_Vg_(real Vdd, real Rg1, real Rg2) {
+   // Gate voltage of voltage-divider configurations.
+   return (Rg2 * Vdd) / (Rg1 + Rg2);
+}
+
+// Bit of analysis codes of kernels with a drain current quadratic:
+// with ANALYSIS_OP, the drain current is given in 'op[0]' and the rest
+// of the operating point is solved from it. Batch functions solve the
+// drain currents of a chunk of points at once by the vectorized
+// kernels, then run the stages point by point.
+#define FET_GIVEN_ID 8
+
 /* The DC and AC Analysis of Fixed-Bias Configuration */
-void fixed_bias(char* analysis, float Vdd, float Vgg, float Rg, 
-                float Rd, float Idss, float Vp, float rd) {
-   // Check if the parameters are correct.
-   assert (Rg > 0 && Rd > 0 && rd > 0);
-   // These results are required for both analysis type.
-   float Vgs = -1 * Vgg; // gate-source voltage
-   // Calculate DC analysis:
-   float Id1 = (1.0 - (Vgs / Vp)) * (1.0 - (Vgs / Vp));
-   float Id = Idss * Id1;  // drain current
-   float Vds = Vdd - Id * Rd; // drain-source voltage
-   float Vd = Vds; // drain voltage
-   float Vg = Vgs; // gate voltage
-   float Vs = 0; // source voltage
-   // AC analysis:
-   float gm = _find_gm_factor_(Idss, Vp, Vgs); // gm
-   float Zi = Rg; // input impedance
-   float Zo = _parallel_(Rd, rd); // output impedance
-   float Av = -1.0 * gm * Zo; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) 
-   _save_dc_results_(Id, Vds, Vgs, Vs, Vd, Vg);
-   else _save_ac_results_(gm, Zi, Zo, Av, "Out of phase");
+KERNEL void _fixed_bias_(const int analysis, const int checked, real Vdd,
+                         real Vgg, real Rg, real Rd, real Idss, real Vp,
+                         real rd, real* op, struct DCFET* dc,
+                         struct ACFET* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_FINITE, Vgg) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp);
+   int ac_valid = _status_valid_(STATUS_FINITE, Vgg) &
+                  _status_valid_(STATUS_POSITIVE, Rg) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp) &
+                  _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Vgs = -1 * Vgg; // gate-source voltage
+      op[0] = Vgs;
+   }
+   real Vgs = op[0];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      // Vgs at or beyond Vp is cut-off, there is no drain current.
+      real Id0 = real_fmax(1.0 - (Vgs / Vp), 0);
+      real Id = Idss * Id0 * Id0;  // drain current
+      real Vds = Vdd - Id * Rd; // drain-source voltage
+      real Vd = Vds; // drain voltage
+      real Vg = Vgs; // gate voltage
+      real Vs = 0; // source voltage
+      _save_dc_results_(dc, Id, Vds, Vgs, Vs, Vd, Vg, Vp);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = _find_gm_factor_(Idss, Vp, Vgs); // gm
+      real Zi = Rg; // input impedance
+      real Zo = _parallel_(Rd, rd); // output impedance
+      real Av = -1.0 * gm * Zo; // voltage gain
+      _save_ac_results_(ac, gm, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void f_fixed_bias(char* analysis, real Vdd, real Vgg, real Rg, real Rd,
+                  real Idss, real Vp, real rd, struct DCFET* dc,
+                  struct ACFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _fixed_bias_, 1, Vdd, Vgg, Rg,
+                     Rd, Idss, Vp, rd, op, dc, ac);
 }
 
 
 /* The DC and AC Analysis of Self-Bias Configuration */
-void self_bias(char* analysis, float Vdd, float Rg, float Rd, float Rs,
-               float Idss, float Vp, float rd) {
-   // Check if the parameters are correct.
-   assert (Rg > 0 && Rd > 0 && rd > 0 && Rs > 0);
-   // These results are required for both analysis type.
-   float a = Rs * Rs * Idss / Vp / Vp;
-   float b = Idss * 2.0 * Rs / Vp - 1;
-   float c = Idss;
-   // Can be used dicriminant for finding right 'Id'.
-   float Id = _select_right_Id_(a, b, c); // drain current
-   float Vgs = -1 * Id * Rs; // gate-source voltage
-   // DC analysis:
-   float Vds = Vdd - Id * (Rs + Rd); // drain-source voltage
-   float Vs = Id * Rs; // source voltage
-   float Vg = 0; // gate voltage
-   float Vd = Vds + Vs; // drain voltage
-   // AC analysis:
-   float gm = _find_gm_factor_(Idss, Vp, Vgs); // gm factor
-   float Zi = Rg; // input impedance
-   float Zo1 = 1 + gm * Rs + Rs / rd;
-   float Zo2 = 1 + gm * Rs + Rs / rd + Rd / rd;
-   float Zo = Zo1 * Rd / Zo2; // output impedance
-   float Av1 = gm * Rd;
-   float Av2 = 1.0 + gm * Rs + (Rd + Rs) / rd;
-   float Av = -1.0 * Av1 / Av2; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) 
-   _save_dc_results_(Id, Vds, Vgs, Vs, Vd, Vg);
-   else _save_ac_results_(gm, Zi, Zo, Av, "Out of phase");
+KERNEL void _self_bias_(const int analysis, const int checked, real Vdd,
+                        real Rg, real Rd, real Rs, real Idss, real Vp,
+                        real rd, real* op, struct DCFET* dc,
+                        struct ACFET* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Rs) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp);
+   int ac_valid = _status_valid_(STATUS_POSITIVE, Rg) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Rs) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp) &
+                  _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Id = analysis & FET_GIVEN_ID ? op[0] :
+                _shockley_Id_(Idss, Vp, Rs, 0); // drain current
+      real Vgs = -1 * Id * Rs; // gate-source voltage
+      op[0] = Id; op[1] = Vgs;
+   }
+   real Id = op[0], Vgs = op[1];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Vds = Vdd - Id * (Rs + Rd); // drain-source voltage
+      real Vs = Id * Rs; // source voltage
+      real Vg = 0; // gate voltage
+      real Vd = Vds + Vs; // drain voltage
+      _save_dc_results_(dc, Id, Vds, Vgs, Vs, Vd, Vg, Vp);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = _find_gm_factor_(Idss, Vp, Vgs); // gm factor
+      real Zi = Rg; // input impedance
+      real Zo1 = 1 + gm * Rs + Rs / rd;
+      real Zo2 = 1 + gm * Rs + Rs / rd + Rd / rd;
+      real Zo = Zo1 * Rd / Zo2; // output impedance
+      real Av1 = gm * Rd;
+      real Av2 = 1.0 + gm * Rs + (Rd + Rs) / rd;
+      real Av = -1.0 * Av1 / Av2; // voltage gain
+      _save_ac_results_(ac, gm, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void f_self_bias(char* analysis, real Vdd, real Rg, real Rd, real Rs,
+                 real Idss, real Vp, real rd, struct DCFET* dc,
+                 struct ACFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _self_bias_, 1, Vdd, Rg, Rd, Rs,
+                     Idss, Vp, rd, op, dc, ac);
 }
 
 /* The DC and AC Analysis of Voltage-Divider Configuration */
-void voltage_divider(char* analysis, float Vdd, float Rg1, float Rg2, 
-                     float Rd, float Rs, float Idss, float Vp, 
-                     float rd){
-   // Check if the parameters are correct.
-   assert (Rg1 > 0 && Rg2 > 0 && Rd > 0 && Rs > 0 && rd > 0);
-   // These results are required for both analysis type.
-   float Vg = (Rg2 * Vdd) / (Rg1 + Rg2);
-   // For quadritic equations, find discriminant.
-   float a = Rs * Rs * Idss / Vp / Vp;
-   float b1 = (2.0 * Rs * Idss / Vp);
-   float b2 = (2.0 * Vg * Rs * Idss / Vp / Vp);
-   float b = b1 - b2 - 1;
-   float c = Idss * (1.0 - (2.0 * Vg / Vp) + (Vg * Vg / Vp / Vp));
-   // Can be used dicriminant for finding right 'Id'.
-   float Id = _select_right_Id_(a, b, c); // drain current
-   float Vgs = Vg - Id * Rs;  // gate-source voltage
-   // DC analysis:
-   float Vds = Vdd - Id * (Rs + Rd); // drain-source voltage
-   float Vs = Id * Rs; // source voltage
-   float Vd = Vdd - Id * Rd; // drain voltage
-   // AC analysis:
-   float gm = _find_gm_factor_(Idss, Vp, Vgs); // gm factor
-   float Zi = _parallel_(Rg1, Rg2); // input impedance
-   float Zo = _parallel_(Rd, rd); // output impedance
-   float Av = -1 * gm * Zo; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) 
-   _save_dc_results_(Id, Vds, Vgs, Vs, Vd, Vg);
-   else _save_ac_results_(gm, Zi, Zo, Av, "Out of phase");
+KERNEL void _voltage_divider_(const int analysis, const int checked,
+                              real Vdd, real Rg1, real Rg2, real Rd,
+                              real Rs, real Idss, real Vp, real rd,
+                              real* op, struct DCFET* dc,
+                              struct ACFET* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_POSITIVE, Rg1) &
+                  _status_valid_(STATUS_POSITIVE, Rg2) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Rs) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp);
+   int ac_valid = dc_valid & _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Vg = _divider_Vg_(Vdd, Rg1, Rg2); // gate voltage
+      real Id = analysis & FET_GIVEN_ID ? op[0] :
+                _shockley_Id_(Idss, Vp, Rs, Vg); // drain current
+      real Vgs = Vg - Id * Rs;  // gate-source voltage
+      op[0] = Id; op[1] = Vg; op[2] = Vgs;
+   }
+   real Id = op[0], Vg = op[1], Vgs = op[2];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Vds = Vdd - Id * (Rs + Rd); // drain-source voltage
+      real Vs = Id * Rs; // source voltage
+      real Vd = Vdd - Id * Rd; // drain voltage
+      _save_dc_results_(dc, Id, Vds, Vgs, Vs, Vd, Vg, Vp);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = _find_gm_factor_(Idss, Vp, Vgs); // gm factor
+      real Zi = _parallel_(Rg1, Rg2); // input impedance
+      real Zo = _parallel_(Rd, rd); // output impedance
+      real Av = -1 * gm * Zo; // voltage gain
+      _save_ac_results_(ac, gm, Zi, Zo, Av, "Out of phase");
+   }
+   if (checked) _check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void f_voltage_divider(char* analysis, real Vdd, real Rg1, real Rg2,
+                       real Rd, real Rs, real Idss, real Vp, real rd,
+                       struct DCFET* dc, struct ACFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _voltage_divider_, 1, Vdd, Rg1,
+                     Rg2, Rd, Rs, Idss, Vp, rd, op, dc, ac);
 }
 
 /* The DC and AC Analysis of Common-Gate Configuration */
-void common_gate(char* analysis, float Vdd, float Vss, float Rd, 
-                 float Rs, float Idss, float Vp, float rd) {
-   // Check if the parameters are correct.
-   assert (Rd > 0 && Rs > 0 && rd > 0);
-   // For quadritic equations, find discriminant.
-   float a = (Rs * Rs) * Idss / (Vp * Vp);
-   float b1 = 2.0 * Rs * Idss / Vp;
-   float b2 = -2.0 * Vss * Rs * Idss / Vp / Vp;
-   float b = b1 + b2 - 1.0;
-   float c1 = 2.0 * Vss / Vp;
-   float c2 = Vss * Vss / Vp / Vp;
-   float c = (1.0 - c1 + c2) * Idss;
-   // Can be used dicriminant for finding right 'Id'.
-   float Id = _select_right_Id_(a, b, c); // drain current
-   // These results are required for both analysis type.
-   float Vgs = Vss - Id * Rs; // gate-source voltage
-   // DC analysis:
-   float Vds = Vdd + Vss - Id * (Rs + Rd); // drain-source voltage
-   float Vs = -Vss + Id * Rs; // source voltage
-   float Vd = Vdd - Id * Rd; // drain voltage
-   float Vg = 0; // gate voltage
-   // AC analysis:
-   float gm = _find_gm_factor_(Idss, Vp, Vgs); // gm factor
-   float Zi1 = (rd + Rd) / (1 + gm * rd);
-   float Zi = _parallel_(Rs, Zi1); // input impedance
-   float Zo = _parallel_(Rd, rd); // output impedance
-   float Av1 = gm * Rd + Rd / rd;
-   float Av2 = 1 + Rd / rd;
-   float Av = Av1 / Av2; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "dc") == 0) 
-   _save_dc_results_(Id, Vds, Vgs, Vs, Vd, Vg);
-   else _save_ac_results_(gm, Zi, Zo, Av, "In phase");
+KERNEL void _common_gate_(const int analysis, const int checked, real Vdd,
+                          real Vss, real Rd, real Rs, real Idss, real Vp,
+                          real rd, real* op, struct DCFET* dc,
+                          struct ACFET* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_FINITE, Vss) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Rs) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp);
+   int ac_valid = _status_valid_(STATUS_FINITE, Vss) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Rs) &
+                  _status_valid_(STATUS_POSITIVE, Idss) &
+                  _status_valid_(STATUS_NONZERO, Vp) &
+                  _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real Id = analysis & FET_GIVEN_ID ? op[0] :
+                _shockley_Id_(Idss, Vp, Rs, Vss); // drain current
+      real Vgs = Vss - Id * Rs; // gate-source voltage
+      op[0] = Id; op[1] = Vgs;
+   }
+   real Id = op[0], Vgs = op[1];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Vds = Vdd + Vss - Id * (Rs + Rd); // drain-source voltage
+      real Vs = -Vss + Id * Rs; // source voltage
+      real Vd = Vdd - Id * Rd; // drain voltage
+      real Vg = 0; // gate voltage
+      _save_dc_results_(dc, Id, Vds, Vgs, Vs, Vd, Vg, Vp);
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = _find_gm_factor_(Idss, Vp, Vgs); // gm factor
+      real Zi1 = (rd + Rd) / (1 + gm * rd);
+      real Zi = _parallel_(Rs, Zi1); // input impedance
+      real Zo = _parallel_(Rd, rd); // output impedance
+      real Av1 = gm * Rd + Rd / rd;
+      real Av2 = 1 + Rd / rd;
+      real Av = Av1 / Av2; // voltage gain
+      _save_ac_results_(ac, gm, Zi, Zo, Av, "In phase");
+   }
+   if (checked) _check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void f_common_gate(char* analysis, real Vdd, real Vss, real Rd, real Rs,
+                   real Idss, real Vp, real rd, struct DCFET* dc,
+                   struct ACFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _common_gate_, 1, Vdd, Vss, Rd,
+                     Rs, Idss, Vp, rd, op, dc, ac);
 }
 
 /* The AC Analysis of Source-Follower Configuration */
-void source_follower(char* analysis, float Vdd, float Vgs, float Rg, 
-                     float Rs, float Idss, float Vp, float rd) {
-   // Check if the parameters are correct.
-   assert (Rg > 0 && Rs > 0 && rd > 0);
-   // Calculate the results.
-   float gm = _find_gm_factor_(Idss, Vp, Vgs);
-   float Zi = Rg;
-   float Zo = _parallel_(rd, _parallel_(Rs, 1/gm));
-   float Av1 = gm * _parallel_(rd, Rs);
-   float Av2 = 1.0 + Av1;
-   float Av = Av1 / Av2;
-   // Save the results.
-   if (strcmp(analysis, "ac")) { // dc results
-      puts("Transistor do not support dc analysis !!!");
-      exit(EXIT_FAILURE); }
-   else // ac results
-   _save_ac_results_(gm, Zi, Zo, Av, "In phase");
-}
-
-
-void _display_transistors_(char* analysis, char* transistor) {
-   // Display the all transistors.
-   puts("TRANSISTOR:");
-   puts("--> 'fb' for fixed-bias config.");
-   puts("--> 'sb' for self-bias config.");
-   puts("--> 'vd' for voltage-divider config.");
-   puts("--> 'cg' for common-gate config.");
-   if (strcmp(analysis, "dc"))
-      puts("--> 'sf' for source-follower config.");
-   printf("Transistor type: "); scanf("%s", &(*transistor));
-   puts("--------------------------------------------");
-}
-
-void _fixed_bias_inputs_(char* analysis, float* Vdd, float* Vgg, 
-                        float* Rg, float* Rd, float* Idss, 
-                        float* Vp, float* rd) {
-   // Get inputs of fixed-bias configuration.
-   puts("PARAMETERS: ");
-   printf("Vdd (V): "); scanf("%f", &(*Vdd));
-   printf("Vgg (V): "); scanf("%f", &(*Vgg));
-   if (strcmp(analysis, "dc")) {
-      printf("Rg (ohm): "); scanf("%f", &(*Rg));
-   }
-   printf("Rd (ohm): "); scanf("%f", &(*Rd));
-   printf("Idss (A): "); scanf("%f", &(*Idss));
-   printf("Vp (V): "); scanf("%f", &(*Vp));
-   if (strcmp(analysis, "dc")) {
-      printf("rd (ohm): "); scanf("%f", &(*rd));
-   }
-   puts("Calculating results ...");
-   puts("--------------------------------------------");
-}
-
-void _self_bias_inputs_(char* analysis, float* Vdd, float* Rg, 
-                        float* Rd, float* Rs, float* Idss, 
-                        float* Vp, float* rd) {
-   // Get inputs of self-bias configuration.
-   puts("PARAMETERS: ");
-   printf("Vdd (V): "); scanf("%f", &(*Vdd));
-   if (strcmp(analysis, "dc")) {
-      printf("Rg (ohm): "); scanf("%f", &(*Rg));
-   }
-   printf("Rd (ohm): "); scanf("%f", &(*Rd));
-   printf("Rs (ohm): "); scanf("%f", &(*Rs));
-   printf("Idss (A): "); scanf("%f", &(*Idss));
-   printf("Vp (V): "); scanf("%f", &(*Vp));
-   if (strcmp(analysis, "dc")) {
-      printf("rd (ohm): "); scanf("%f", &(*rd));
-   }
-   puts("Calculating results ...");
-   puts("--------------------------------------------");
-}
-
-void _voltage_divider_inputs_(char* analysis, float* Vdd, float* Rg1, 
-                              float* Rg2, float* Rd, float* Rs, 
-                              float* Idss, float* Vp, float* rd) {
-   // Get inputs of voltage-divider configuration.
-   puts("PARAMETERS: ");
-   printf("Vdd (V): "); scanf("%f", &(*Vdd));
-   printf("Upper Rg (ohm): "); scanf("%f", &(*Rg1));
-   printf("Lower Rg (ohm): "); scanf("%f", &(*Rg2));
-   printf("Rd (ohm): "); scanf("%f", &(*Rd));
-   printf("Rs (ohm): "); scanf("%f", &(*Rs));
-   printf("Idss (A): "); scanf("%f", &(*Idss));
-   printf("Vp (V): "); scanf("%f", &(*Vp));
-   if (strcmp(analysis, "dc")) {
-      printf("rd (ohm): "); scanf("%f", &(*rd));
-   }
-   puts("Calculating results...");
-   puts("--------------------------------------------");
-}
-
-void _common_gate_inputs_(char* analysis, float* Vdd, float* Vss, 
-                          float* Rd, float* Rs, float* Idss, 
-                          float* Vp, float* rd) {
-   // Get inputs of common-gate configuration.
-   puts("PARAMETERS: ");
-   printf("Vdd (V): "); scanf("%f", &(*Vdd));
-   printf("Vss (V): "); scanf("%f", &(*Vss));
-   printf("Rd (ohm): "); scanf("%f", &(*Rd));
-   printf("Rs (ohm): "); scanf("%f", &(*Rs));
-   printf("Idss (A): "); scanf("%f", &(*Idss));
-   printf("Vp (V): "); scanf("%f", &(*Vp));
-   if (strcmp(analysis, "dc")) {
-      printf("rd (ohm): "); scanf("%f", &(*rd));
-   }
-   puts("Calculating results ...");
-   puts("--------------------------------------------");
-}
-
-void _source_follower_inputs_(char* analysis, float* Vdd, float* Vgs,
-                              float* Rg, float* Rs, float* Idss, 
-                              float* Vp, float* rd) {
-   // Get inputs of source-follower configuration.
-   puts("PARAMETERS: ");
-   printf("Vdd (V): "); scanf("%f", &(*Vdd));
-   printf("Vgs (V): "); scanf("%f", &(*Vgs));
-   printf("Rg (ohm): "); scanf("%f", &(*Rg));
-   printf("Rs (ohm): "); scanf("%f", &(*Rs));
-   printf("Idss (A): "); scanf("%f", &(*Idss));
-   printf("Vp (V): "); scanf("%f", &(*Vp));
-   printf("rd (ohm): "); scanf("%f", &(*rd));
-   puts("Calculating results ...");
-   puts("--------------------------------------------");
-}
-
-void _display_dc_results_(void) {
-   // Display the DC results.
-   puts("RESULTS: ");
-   printf("Id: %f A\n", DCAnalysis.Id);
-   printf("Vds: %f A\n", DCAnalysis.Vds);
-   printf("Vgs: %f A\n", DCAnalysis.Vgs);
-   printf("Vs: %f V\n", DCAnalysis.Vs);
-   printf("Vd: %f A\n", DCAnalysis.Vd);
-   printf("Vg: %f V\n", DCAnalysis.Vg);
-   puts("--------------------------------------------");
-}
-
-void _display_ac_results_(void) {
-   // Display the AC results.
-   puts("RESULTS: ");
-   printf("gm: %f S\n", ACAnalysis.gm);
-   printf("Zi: %f ohm\n", ACAnalysis.Zi);
-   printf("Zo: %f ohm\n", ACAnalysis.Zo);
-   printf("Av: %f\n", ACAnalysis.Av);
-   printf("Phase: %s\n", ACAnalysis.phase);
-   puts("--------------------------------------------");
+KERNEL void _source_follower_(const int analysis, const int checked,
+                              real Vdd, real Vgs, real Rg, real Rs,
+                              real Idss, real Vp, real rd, real* op,
+                              struct DCFET* dc, struct ACFET* ac) {
+   // Check if the parameters are in their domains, DC analysis is
+   // not supported.
+   int valid = _status_valid_(STATUS_FINITE, Vgs) &
+               _status_valid_(STATUS_POSITIVE, Rg) &
+               _status_valid_(STATUS_POSITIVE, Rs) &
+               _status_valid_(STATUS_POSITIVE, Idss) &
+               _status_valid_(STATUS_NONZERO, Vp) &
+               _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point (gm factor at given Vgs):
+   if (analysis & ANALYSIS_OP) op[0] = _find_gm_factor_(Idss, Vp, Vgs);
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = op[0];
+      real Zi = Rg;
+      real Zo = _parallel_(rd, _parallel_(Rs, 1/gm));
+      real Av1 = gm * _parallel_(rd, Rs);
+      real Av2 = 1.0 + Av1;
+      real Av = Av1 / Av2;
+      _save_ac_results_(ac, gm, Zi, Zo, Av, "In phase");
+   }
+   if (!checked) return;
+   _status_(analysis & ANALYSIS_DC, STATUS_UNSUPPORTED, dc, ac);
+   _check_(analysis & ANALYSIS_AC, valid, valid, dc, ac);
+}
+
+void f_source_follower(char* analysis, real Vdd, real Vgs, real Rg,
+                       real Rs, real Idss, real Vp, real rd,
+                       struct DCFET* dc, struct ACFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _source_follower_, 1, Vdd, Vgs,
+                     Rg, Rs, Idss, Vp, rd, op, dc, ac);
+}
+
+
+/* Batch Analysis of FET Configurations
+
+Batch functions evaluate 'n' operating points in one call. Parameters
+are columns (one array per parameter) and results are written into
+the columns of 'DCFETBatch' or 'ACFETBatch' (structure of arrays). 
+The Shockley quadratic of all points is solved by a vectorized kernel
+which is selected at runtime: AVX-512, AVX2 or the scalar fallback.
+*/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FET_SIMD 1
+#include <immintrin.h>
+// Intrinsics of 'real' vectors, e.g. _V256_(add) is _mm256_add_ps
+// for float and _mm256_add_pd for double.
+#if PRECISION_DOUBLE
+#define _V256_(op) _mm256_##op##_pd
+#define _V512_(op) _mm512_##op##_pd
+#define _V512_CMP_ _mm512_cmp_pd_mask
+typedef __m256d v256;
+typedef __m512d v512;
+typedef __mmask8 vmask;
+#else
+#define _V256_(op) _mm256_##op##_ps
+#define _V512_(op) _mm512_##op##_ps
+#define _V512_CMP_ _mm512_cmp_ps_mask
+typedef __m256 v256;
+typedef __m512 v512;
+typedef __mmask16 vmask;
+#endif
+// Number of 'real' numbers in a vector.
+#define V256_LANES ((long) (32 / sizeof(real)))
+#define V512_LANES ((long) (64 / sizeof(real)))
+#else
+#define FET_SIMD 0
+#endif
+
+// Number of points whose drain currents are solved together by batch
+// functions.
+#define FET_CHUNK 256
+
+
+KERNEL void _drain_Id_scalar_(const int law, long n, real* P, real* V,
+                              real* Rs, real* Vg, real* Id) {
+   // Scalar fallback of the drain current kernels.
+   for (long i = 0; i < n; i++)
+      Id[i] = _drain_Id_(law, P[i], V[i], Rs[i], Vg[i]);
+}
+
+#if FET_SIMD
+KERNEL __attribute__((target("avx2")))
+void _drain_Id_avx2_(const int law, long n, real* P, real* V, real* Rs,
+                     real* Vg, real* Id) {
+   // Solve 8 (float) or 4 (double) points at once with AVX2.
+   v256 one = _V256_(set1)(1.0), two = _V256_(set1)(2.0);
+   v256 four = _V256_(set1)(4.0), zero = _V256_(setzero)();
+   v256 minus_half = _V256_(set1)(-0.5);
+   v256 sign = _V256_(set1)(-0.0), ill = _V256_(set1)(PRECISION_ILL);
+   long i = 0;
+   for (; i + V256_LANES <= n; i += V256_LANES) {
+      v256 v = _V256_(loadu)(V + i);
+      v256 rs = _V256_(loadu)(Rs + i);
+      v256 u = _V256_(loadu)(P + i);
+      if (law == FET_SHOCKLEY) u = _V256_(div)(u, _V256_(mul)(v, v));
+      v256 d = _V256_(sub)(v, _V256_(loadu)(Vg + i));
+      // Coefficients of the quadratic equation.
+      v256 a = _V256_(mul)(_V256_(mul)(u, rs), rs);
+      v256 b = _V256_(sub)(_V256_(mul)(_V256_(mul)(
+                           _V256_(mul)(two, u), d), rs), one);
+      v256 c = _V256_(mul)(_V256_(mul)(u, d), d);
+      // Roots of the quadratic equation.
+      v256 bb = _V256_(mul)(b, b);
+      v256 ac4 = _V256_(mul)(_V256_(mul)(four, a), c);
+      // q = -(b + sign(b) sqrt(b^2 - 4ac)) / 2, roots are q/a and c/q.
+      v256 s = _V256_(sqrt)(_V256_(sub)(bb, ac4));
+      s = _V256_(or)(s, _V256_(and)(b, sign));
+      v256 q = _V256_(mul)(minus_half, _V256_(add)(b, s));
+      v256 root1 = _V256_(div)(q, a);
+      v256 root2 = _V256_(div)(c, q);
+      // Select the right root same as '_select_right_Id_'.
+      v256 low = _V256_(min)(root1, root2);
+      v256 high = _V256_(andnot)(sign, _V256_(max)(root1, root2));
+      v256 mask = _V256_(cmp)(low, zero, _CMP_GE_OQ);
+      v256 root = _V256_(blendv)(high, low, mask);
+      // Cut-off points have no drain current like '_drain_Id_'.
+      v256 off = _V256_(cmp)(d, zero, _CMP_GE_OQ);
+      _V256_(storeu)(Id + i, _V256_(blendv)(root, zero, off));
+#if PRECISION_MIXED
+      // Solve ill-conditioned points again in double.
+      v256 limit = _V256_(mul)(ill, bb);
+      int lanes = _V256_(movemask)(
+         _V256_(cmp)(_V256_(sub)(bb, ac4), limit, _CMP_LT_OQ));
+      for (; lanes; lanes &= lanes - 1) {
+         long k = i + __builtin_ctz(lanes);
+         Id[k] = _drain_Id_double_(law, P[k], V[k], Rs[k], Vg[k]);
+      }
+#endif
+   }
+   (void) ill;
+   _drain_Id_scalar_(law, n - i, P + i, V + i, Rs + i, Vg + i, Id + i);
+}
+
+KERNEL __attribute__((target("avx512f")))
+void _drain_Id_avx512_(const int law, long n, real* P, real* V,
+                       real* Rs, real* Vg, real* Id) {
+   // Solve 16 (float) or 8 (double) points at once with AVX-512.
+   v512 one = _V512_(set1)(1.0), two = _V512_(set1)(2.0);
+   v512 four = _V512_(set1)(4.0), zero = _V512_(setzero)();
+   v512 minus_half = _V512_(set1)(-0.5);
+   v512 ill = _V512_(set1)(PRECISION_ILL);
+   for (long i = 0; i < n; i += V512_LANES) {
+      // The last points are handled with a partial mask.
+      vmask m = (n - i >= V512_LANES) ? (vmask) -1 : (1u << (n - i)) - 1;
+      v512 v = _V512_(mask_loadu)(one, m, V + i);
+      v512 rs = _V512_(mask_loadu)(one, m, Rs + i);
+      v512 u = _V512_(mask_loadu)(one, m, P + i);
+      if (law == FET_SHOCKLEY) u = _V512_(div)(u, _V512_(mul)(v, v));
+      v512 d = _V512_(sub)(v, _V512_(maskz_loadu)(m, Vg + i));
+      // Coefficients of the quadratic equation.
+      v512 a = _V512_(mul)(_V512_(mul)(u, rs), rs);
+      v512 b = _V512_(sub)(_V512_(mul)(_V512_(mul)(
+                           _V512_(mul)(two, u), d), rs), one);
+      v512 c = _V512_(mul)(_V512_(mul)(u, d), d);
+      // Roots of the quadratic equation.
+      v512 bb = _V512_(mul)(b, b);
+      v512 ac4 = _V512_(mul)(_V512_(mul)(four, a), c);
+      // q = -(b + sign(b) sqrt(b^2 - 4ac)) / 2, roots are q/a and c/q.
+      // The sign is given by a masked negation (AVX-512F has no 'or'
+      // of floating-point vectors).
+      v512 s = _V512_(sqrt)(_V512_(sub)(bb, ac4));
+      s = _V512_(mask_sub)(s, _V512_CMP_(b, zero, _CMP_LT_OQ), zero, s);
+      v512 q = _V512_(mul)(minus_half, _V512_(add)(b, s));
+      v512 root1 = _V512_(div)(q, a);
+      v512 root2 = _V512_(div)(c, q);
+      // Select the right root same as '_select_right_Id_'.
+      v512 low = _V512_(min)(root1, root2);
+      v512 high = _V512_(abs)(_V512_(max)(root1, root2));
+      vmask ge = _V512_CMP_(low, zero, _CMP_GE_OQ);
+      v512 root = _V512_(mask_blend)(ge, high, low);
+      // Cut-off points have no drain current like '_drain_Id_'.
+      vmask off = _V512_CMP_(d, zero, _CMP_GE_OQ);
+      _V512_(mask_storeu)(Id + i, m, _V512_(mask_blend)(off, root, zero));
+#if PRECISION_MIXED
+      // Solve ill-conditioned points again in double.
+      v512 limit = _V512_(mul)(ill, bb);
+      unsigned lanes = m & _V512_CMP_(_V512_(sub)(bb, ac4), limit,
+                                      _CMP_LT_OQ);
+      for (; lanes; lanes &= lanes - 1) {
+         long k = i + __builtin_ctz(lanes);
+         Id[k] = _drain_Id_double_(law, P[k], V[k], Rs[k], Vg[k]);
+      }
+#endif
+   }
+   (void) ill;
+}
+#endif
+
+// Instantiate scalar, AVX2 and AVX-512 kernels of a law and the
+// function 'name_batch_' which selects the widest kernel that the
+// running processor supports.
+#if FET_SIMD
+#define FET_KERNELS(name, law) \
+static void name##_scalar_(long n, real* P, real* V, real* Rs, real* Vg, \
+                           real* Id) { \
+   _drain_Id_scalar_(law, n, P, V, Rs, Vg, Id); \
+} \
+__attribute__((target("avx2"))) \
+static void name##_avx2_(long n, real* P, real* V, real* Rs, real* Vg, \
+                         real* Id) { \
+   _drain_Id_avx2_(law, n, P, V, Rs, Vg, Id); \
+} \
+__attribute__((target("avx512f"))) \
+static void name##_avx512_(long n, real* P, real* V, real* Rs, real* Vg, \
+                           real* Id) { \
+   _drain_Id_avx512_(law, n, P, V, Rs, Vg, Id); \
+} \
+static void name##_batch_(long n, real* P, real* V, real* Rs, real* Vg, \
+                          real* Id) { \
+   if (__builtin_cpu_supports("avx512f")) \
+      name##_avx512_(n, P, V, Rs, Vg, Id); \
+   else if (__builtin_cpu_supports("avx2")) \
+      name##_avx2_(n, P, V, Rs, Vg, Id); \
+   else name##_scalar_(n, P, V, Rs, Vg, Id); \
+}
+#else
+#define FET_KERNELS(name, law) \
+static void name##_scalar_(long n, real* P, real* V, real* Rs, real* Vg, \
+                           real* Id) { \
+   _drain_Id_scalar_(law, n, P, V, Rs, Vg, Id); \
+} \
+static void name##_batch_(long n, real* P, real* V, real* Rs, real* Vg, \
+                          real* Id) { \
+   name##_scalar_(n, P, V, Rs, Vg, Id); \
+}
+#endif
+
+// '_shockley_Id_batch_(n, Idss, Vp, Rs, Vg, Id)' and
+// '_square_law_Id_batch_(n, k, Vgsth, Rs, Vg, Id)'.
+FET_KERNELS(_shockley_Id, FET_SHOCKLEY)
+FET_KERNELS(_square_law_Id, FET_SQUARE_LAW)
+
+KERNEL void _save_dc_batch_(struct DCFETBatch* dc, long i,
+                            struct DCFET* point) {
+   // Save DC results of i'th point into 'dc' columns.
+   dc->Id[i] = point->Id; dc->Vds[i] = point->Vds;
+   dc->Vgs[i] = point->Vgs; dc->Vs[i] = point->Vs; dc->Vd[i] = point->Vd;
+   dc->Vg[i] = point->Vg;
+}
+
+KERNEL void _save_ac_batch_(struct ACFETBatch* ac, long i,
+                            struct ACFET* point) {
+   // Save AC results of i'th point into 'ac' columns.
+   ac->gm[i] = point->gm; ac->Zi[i] = point->Zi; ac->Zo[i] = point->Zo;
+   ac->Av[i] = point->Av;
+}
+
+// Batch loops run the stages of the configuration kernels point by
+// point without status ('checked' is 0), after the drain currents of
+// a chunk are solved by '_shockley_Id_batch_' (FET_GIVEN_ID), so the
+// formulas are written once. Parameters that a stage does not read
+// are given as 0.
+
+/* The Batch DC Analysis of Fixed-Bias Configuration */
+void f_fixed_bias_dc_batch(long n, real* Vdd, real* Vgg, real* Rd,
+                           real* Idss, real* Vp, struct DCFETBatch* dc) {
+   for (long i = 0; i < n; i++) {
+      struct DCFET point; real op[MODEL_OP];
+      _fixed_bias_(ANALYSIS_OP | ANALYSIS_DC, 0, Vdd[i], Vgg[i], 0, Rd[i],
+                   Idss[i], Vp[i], 0, op, &point, NULL);
+      _save_dc_batch_(dc, i, &point);
+   }
+}
+
+/* The Batch AC Analysis of Fixed-Bias Configuration */
+void f_fixed_bias_ac_batch(long n, real* Vgg, real* Rg, real* Rd,
+                           real* Idss, real* Vp, real* rd,
+                           struct ACFETBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACFET point; real op[MODEL_OP];
+      _fixed_bias_(ANALYSIS_OP | ANALYSIS_AC, 0, 0, Vgg[i], Rg[i], Rd[i],
+                   Idss[i], Vp[i], rd[i], op, NULL, &point);
+      _save_ac_batch_(ac, i, &point);
+   }
+}
+
+/* The Batch DC Analysis of Self-Bias Configuration */
+void f_self_bias_dc_batch(long n, real* Vdd, real* Rd, real* Rs,
+                          real* Idss, real* Vp, struct DCFETBatch* dc) {
+   real Vg[FET_CHUNK] = {0}, Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      _shockley_Id_batch_(m, Idss + i0, Vp + i0, Rs + i0, Vg, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct DCFET point; real op[MODEL_OP] = {Id[j]};
+         _self_bias_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_DC, 0, Vdd[i], 0,
+                     Rd[i], Rs[i], Idss[i], Vp[i], 0, op, &point, NULL);
+         _save_dc_batch_(dc, i, &point);
+      }
+   }
+}
+
+/* The Batch AC Analysis of Self-Bias Configuration */
+void f_self_bias_ac_batch(long n, real* Rg, real* Rd, real* Rs,
+                          real* Idss, real* Vp, real* rd, 
+                          struct ACFETBatch* ac) {
+   real Vg[FET_CHUNK] = {0}, Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      _shockley_Id_batch_(m, Idss + i0, Vp + i0, Rs + i0, Vg, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct ACFET point; real op[MODEL_OP] = {Id[j]};
+         _self_bias_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_AC, 0, 0, Rg[i],
+                     Rd[i], Rs[i], Idss[i], Vp[i], rd[i], op, NULL, &point);
+         _save_ac_batch_(ac, i, &point);
+      }
+   }
+}
+
+/* The Batch DC Analysis of Voltage-Divider Configuration */
+void f_voltage_divider_dc_batch(long n, real* Vdd, real* Rg1, 
+                                real* Rg2, real* Rd, real* Rs,
+                                real* Idss, real* Vp, 
+                                struct DCFETBatch* dc) {
+   real Vg[FET_CHUNK], Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      for (long j = 0, i = i0; j < m; j++, i++)
+         Vg[j] = _divider_Vg_(Vdd[i], Rg1[i], Rg2[i]);
+      _shockley_Id_batch_(m, Idss + i0, Vp + i0, Rs + i0, Vg, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct DCFET point; real op[MODEL_OP] = {Id[j]};
+         _voltage_divider_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_DC, 0,
+                           Vdd[i], Rg1[i], Rg2[i], Rd[i], Rs[i], Idss[i],
+                           Vp[i], 0, op, &point, NULL);
+         _save_dc_batch_(dc, i, &point);
+      }
+   }
+}
+
+/* The Batch AC Analysis of Voltage-Divider Configuration */
+void f_voltage_divider_ac_batch(long n, real* Vdd, real* Rg1, 
+                                real* Rg2, real* Rd, real* Rs,
+                                real* Idss, real* Vp, real* rd,
+                                struct ACFETBatch* ac) {
+   real Vg[FET_CHUNK], Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      for (long j = 0, i = i0; j < m; j++, i++)
+         Vg[j] = _divider_Vg_(Vdd[i], Rg1[i], Rg2[i]);
+      _shockley_Id_batch_(m, Idss + i0, Vp + i0, Rs + i0, Vg, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct ACFET point; real op[MODEL_OP] = {Id[j]};
+         _voltage_divider_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_AC, 0,
+                           Vdd[i], Rg1[i], Rg2[i], Rd[i], Rs[i], Idss[i],
+                           Vp[i], rd[i], op, NULL, &point);
+         _save_ac_batch_(ac, i, &point);
+      }
+   }
+}
+
+/* The Batch DC Analysis of Common-Gate Configuration */
+void f_common_gate_dc_batch(long n, real* Vdd, real* Vss, real* Rd,
+                            real* Rs, real* Idss, real* Vp,
+                            struct DCFETBatch* dc) {
+   real Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      _shockley_Id_batch_(m, Idss + i0, Vp + i0, Rs + i0, Vss + i0, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct DCFET point; real op[MODEL_OP] = {Id[j]};
+         _common_gate_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_DC, 0, Vdd[i],
+                       Vss[i], Rd[i], Rs[i], Idss[i], Vp[i], 0, op, &point,
+                       NULL);
+         _save_dc_batch_(dc, i, &point);
+      }
+   }
+}
+
+/* The Batch AC Analysis of Common-Gate Configuration */
+void f_common_gate_ac_batch(long n, real* Vss, real* Rd, real* Rs,
+                            real* Idss, real* Vp, real* rd,
+                            struct ACFETBatch* ac) {
+   real Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      _shockley_Id_batch_(m, Idss + i0, Vp + i0, Rs + i0, Vss + i0, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct ACFET point; real op[MODEL_OP] = {Id[j]};
+         _common_gate_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_AC, 0, 0,
+                       Vss[i], Rd[i], Rs[i], Idss[i], Vp[i], rd[i], op,
+                       NULL, &point);
+         _save_ac_batch_(ac, i, &point);
+      }
+   }
+}
+
+/* The Batch AC Analysis of Source-Follower Configuration */
+void f_source_follower_ac_batch(long n, real* Vgs, real* Rg, real* Rs,
+                                real* Idss, real* Vp, real* rd,
+                                struct ACFETBatch* ac) {
+   for (long i = 0; i < n; i++) {
+      struct ACFET point; real op[MODEL_OP];
+      _source_follower_(ANALYSIS_OP | ANALYSIS_AC, 0, 0, Vgs[i], Rg[i],
+                        Rs[i], Idss[i], Vp[i], rd[i], op, NULL, &point);
+      _save_ac_batch_(ac, i, &point);
+   }
+}
+
+/* Sensitivities of FET Configurations
+
+Dual kernels evaluate the formulas of the configuration kernels with
+dual numbers (DUAL.h), so their results carry derivatives with
+respect to all parameters. Results are written in order of result
+columns of 'FETConfigs'.
+*/
+
+KERNEL struct Dual _d_select_right_Id_(struct Dual a, struct Dual b,
+                                       struct Dual c) {
+   // Root of '_select_right_Id_' with derivatives. The derivatives of
+   // a root x of a*x^2 + b*x + c are -(a'*x^2 + b'*x + c') / (2*a*x + b),
+   // so they do not have cancellation of the quadratic formula. Id is
+   // |x| of the root that '_select_root_' selects.
+   real x = _select_root_(a.v, b.v, c.v);
+   struct Dual Id = _d_(real_fabs(x));
+   real slope = (x < 0 ? -1 : 1) / (2 * a.v * x + b.v);
+   for (int k = 0; k < DUAL_SIZE; k++)
+      Id.d[k] = -(a.d[k] * x * x + b.d[k] * x + c.d[k]) * slope;
+   return Id;
+}
+
+KERNEL struct Dual _d_drain_Id_(const int law, struct Dual P,
+                                struct Dual V, struct Dual Rs,
+                                struct Dual Vg) {
+   // '_drain_Id_' with derivatives.
+   struct Dual u = law == FET_SQUARE_LAW ? P : _d_div_(P, _d_mul_(V, V));
+   struct Dual d = _d_sub_(V, Vg);
+   struct Dual uRs = _d_mul_(u, Rs);
+   struct Dual a = _d_mul_(uRs, Rs);
+   struct Dual b = _d_shift_(_d_scale_(_d_mul_(uRs, d), 2), -1);
+   struct Dual c = _d_mul_(_d_mul_(u, d), d);
+   // Id and its derivatives are zero in cut-off.
+   if (d.v >= 0) return _d_(0);
+   return _d_select_right_Id_(a, b, c);
+}
+
+KERNEL struct Dual _d_gm_factor_(struct Dual Idss, struct Dual Vp,
+                                 struct Dual Vgs) {
+   // '_find_gm_factor_' with derivatives.
+   struct Dual gm0 = _d_scale_(_d_div_(Idss, _d_fabs_(Vp)), 2);
+   struct Dual on = _d_sub_(_d_(1), _d_div_(Vgs, Vp));
+   return on.v < 0 ? _d_(0) : _d_mul_(gm0, on);
+}
+
+KERNEL void _save_dc_duals_(struct Dual* dc, struct Dual Id,
+                            struct Dual Vgs, struct Dual Vds,
+                            struct Dual Vs, struct Dual Vd,
+                            struct Dual Vg) {
+   dc[0] = Id; dc[1] = Vgs; dc[2] = Vds; dc[3] = Vs; dc[4] = Vd;
+   dc[5] = Vg;
+}
+
+KERNEL void _save_ac_duals_(struct Dual* ac, struct Dual gm,
+                            struct Dual Zi, struct Dual Zo,
+                            struct Dual Av) {
+   ac[0] = gm; ac[1] = Zi; ac[2] = Zo; ac[3] = Av;
+}
+
+KERNEL void _fixed_bias_dual_(const int analysis, struct Dual Vdd,
+                              struct Dual Vgg, struct Dual Rg,
+                              struct Dual Rd, struct Dual Idss,
+                              struct Dual Vp, struct Dual rd,
+                              struct Dual* dc, struct Dual* ac) {
+   struct Dual Vgs = _d_scale_(Vgg, -1); // gate-source voltage
+   if (analysis & ANALYSIS_DC) {
+      struct Dual Id0 = _d_sub_(_d_(1), _d_div_(Vgs, Vp));
+      if (Id0.v < 0) Id0 = _d_(0); // cut-off
+      struct Dual Id = _d_mul_(Idss, _d_mul_(Id0, Id0)); // drain current
+      struct Dual Vds = _d_sub_(Vdd, _d_mul_(Id, Rd)); // drain-source v.
+      _save_dc_duals_(dc, Id, Vgs, Vds, _d_(0), Vds, Vgs);
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual gm = _d_gm_factor_(Idss, Vp, Vgs); // gm
+      struct Dual Zo = _d_parallel_(Rd, rd); // output impedance
+      _save_ac_duals_(ac, gm, Rg, Zo, _d_scale_(_d_mul_(gm, Zo), -1));
+   }
+}
+
+KERNEL void _self_bias_dual_(const int analysis, struct Dual Vdd,
+                             struct Dual Rg, struct Dual Rd,
+                             struct Dual Rs, struct Dual Idss,
+                             struct Dual Vp, struct Dual rd,
+                             struct Dual* dc, struct Dual* ac) {
+   // drain current
+   struct Dual Id = _d_drain_Id_(FET_SHOCKLEY, Idss, Vp, Rs, _d_(0));
+   struct Dual Vs = _d_mul_(Id, Rs); // source voltage
+   struct Dual Vgs = _d_scale_(Vs, -1); // gate-source voltage
+   if (analysis & ANALYSIS_DC) {
+      // drain-source voltage
+      struct Dual Vds = _d_sub_(Vdd, _d_mul_(Id, _d_add_(Rs, Rd)));
+      _save_dc_duals_(dc, Id, Vgs, Vds, Vs, _d_add_(Vds, Vs), _d_(0));
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual gm = _d_gm_factor_(Idss, Vp, Vgs); // gm factor
+      struct Dual gmRs = _d_mul_(gm, Rs);
+      struct Dual Zo1 = _d_shift_(_d_add_(gmRs, _d_div_(Rs, rd)), 1);
+      struct Dual Zo2 = _d_add_(Zo1, _d_div_(Rd, rd));
+      struct Dual Zo = _d_div_(_d_mul_(Zo1, Rd), Zo2); // output imp.
+      struct Dual Av1 = _d_mul_(gm, Rd);
+      struct Dual Av2 = _d_shift_(_d_add_(gmRs, _d_div_(_d_add_(Rd, Rs),
+                                  rd)), 1);
+      _save_ac_duals_(ac, gm, Rg, Zo, _d_scale_(_d_div_(Av1, Av2), -1));
+   }
+}
+
+KERNEL void _voltage_divider_dual_(const int analysis, struct Dual Vdd,
+                                   struct Dual Rg1, struct Dual Rg2,
+                                   struct Dual Rd, struct Dual Rs,
+                                   struct Dual Idss, struct Dual Vp,
+                                   struct Dual rd, struct Dual* dc,
+                                   struct Dual* ac) {
+   // gate voltage
+   struct Dual Vg = _d_div_(_d_mul_(Rg2, Vdd), _d_add_(Rg1, Rg2));
+   // drain current
+   struct Dual Id = _d_drain_Id_(FET_SHOCKLEY, Idss, Vp, Rs, Vg);
+   struct Dual Vs = _d_mul_(Id, Rs); // source voltage
+   struct Dual Vgs = _d_sub_(Vg, Vs); // gate-source voltage
+   if (analysis & ANALYSIS_DC) {
+      // drain-source voltage
+      struct Dual Vds = _d_sub_(Vdd, _d_mul_(Id, _d_add_(Rs, Rd)));
+      struct Dual Vd = _d_sub_(Vdd, _d_mul_(Id, Rd)); // drain voltage
+      _save_dc_duals_(dc, Id, Vgs, Vds, Vs, Vd, Vg);
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual gm = _d_gm_factor_(Idss, Vp, Vgs); // gm factor
+      struct Dual Zi = _d_parallel_(Rg1, Rg2); // input impedance
+      struct Dual Zo = _d_parallel_(Rd, rd); // output impedance
+      _save_ac_duals_(ac, gm, Zi, Zo, _d_scale_(_d_mul_(gm, Zo), -1));
+   }
+}
+
+KERNEL void _common_gate_dual_(const int analysis, struct Dual Vdd,
+                               struct Dual Vss, struct Dual Rd,
+                               struct Dual Rs, struct Dual Idss,
+                               struct Dual Vp, struct Dual rd,
+                               struct Dual* dc, struct Dual* ac) {
+   // drain current
+   struct Dual Id = _d_drain_Id_(FET_SHOCKLEY, Idss, Vp, Rs, Vss);
+   struct Dual IdRs = _d_mul_(Id, Rs);
+   struct Dual Vgs = _d_sub_(Vss, IdRs); // gate-source voltage
+   if (analysis & ANALYSIS_DC) {
+      // drain-source voltage
+      struct Dual Vds = _d_sub_(_d_add_(Vdd, Vss), _d_mul_(Id,
+                                _d_add_(Rs, Rd)));
+      struct Dual Vs = _d_sub_(IdRs, Vss); // source voltage
+      struct Dual Vd = _d_sub_(Vdd, _d_mul_(Id, Rd)); // drain voltage
+      _save_dc_duals_(dc, Id, Vgs, Vds, Vs, Vd, _d_(0));
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual gm = _d_gm_factor_(Idss, Vp, Vgs); // gm factor
+      struct Dual Zi1 = _d_div_(_d_add_(rd, Rd), _d_shift_(_d_mul_(gm,
+                                rd), 1));
+      struct Dual Zi = _d_parallel_(Rs, Zi1); // input impedance
+      struct Dual Zo = _d_parallel_(Rd, rd); // output impedance
+      struct Dual Rdrd = _d_div_(Rd, rd);
+      struct Dual Av1 = _d_add_(_d_mul_(gm, Rd), Rdrd);
+      struct Dual Av = _d_div_(Av1, _d_shift_(Rdrd, 1)); // voltage gain
+      _save_ac_duals_(ac, gm, Zi, Zo, Av);
+   }
+}
+
+KERNEL void _source_follower_dual_(struct Dual Vgs, struct Dual Rg,
+                                   struct Dual Rs, struct Dual Idss,
+                                   struct Dual Vp, struct Dual rd,
+                                   struct Dual* ac) {
+   struct Dual gm = _d_gm_factor_(Idss, Vp, Vgs); // gm factor
+   struct Dual Zo = _d_parallel_(rd, _d_parallel_(Rs, _d_inv_(gm)));
+   struct Dual Av1 = _d_mul_(gm, _d_parallel_(rd, Rs));
+   _save_ac_duals_(ac, gm, Rg, Zo, _d_div_(Av1, _d_shift_(Av1, 1)));
+}
+
+// Jacobian functions of 'FETConfigs' entries. Parameters which are
+// not columns of an entry are not read by its stage.
+
+static void _fb_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], dc[6];
+   _d_inputs_(5, in, p);
+   _fixed_bias_dual_(ANALYSIS_DC, p[0], p[1], _d_(1), p[2], p[3], p[4],
+                     _d_(1), dc, NULL);
+   _d_outputs_(6, 5, dc, out, jacobian);
+}
+static void _fb_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], ac[4];
+   _d_inputs_(6, in, p);
+   _fixed_bias_dual_(ANALYSIS_AC, _d_(0), p[0], p[1], p[2], p[3], p[4],
+                     p[5], NULL, ac);
+   _d_outputs_(4, 6, ac, out, jacobian);
+}
+static void _sb_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], dc[6];
+   _d_inputs_(5, in, p);
+   _self_bias_dual_(ANALYSIS_DC, p[0], _d_(1), p[1], p[2], p[3], p[4],
+                    _d_(1), dc, NULL);
+   _d_outputs_(6, 5, dc, out, jacobian);
+}
+static void _sb_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], ac[4];
+   _d_inputs_(6, in, p);
+   _self_bias_dual_(ANALYSIS_AC, _d_(0), p[0], p[1], p[2], p[3], p[4],
+                    p[5], NULL, ac);
+   _d_outputs_(4, 6, ac, out, jacobian);
+}
+static void _vd_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[7], dc[6];
+   _d_inputs_(7, in, p);
+   _voltage_divider_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4], p[5],
+                          p[6], _d_(1), dc, NULL);
+   _d_outputs_(6, 7, dc, out, jacobian);
+}
+static void _vd_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[8], ac[4];
+   _d_inputs_(8, in, p);
+   _voltage_divider_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4], p[5],
+                          p[6], p[7], NULL, ac);
+   _d_outputs_(4, 8, ac, out, jacobian);
+}
+static void _cg_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], dc[6];
+   _d_inputs_(6, in, p);
+   _common_gate_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4], p[5],
+                      _d_(1), dc, NULL);
+   _d_outputs_(6, 6, dc, out, jacobian);
+}
+static void _cg_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], ac[4];
+   _d_inputs_(6, in, p);
+   _common_gate_dual_(ANALYSIS_AC, _d_(0), p[0], p[1], p[2], p[3], p[4],
+                      p[5], NULL, ac);
+   _d_outputs_(4, 6, ac, out, jacobian);
+}
+static void _sf_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[6], ac[4];
+   _d_inputs_(6, in, p);
+   _source_follower_dual_(p[0], p[1], p[2], p[3], p[4], p[5], ac);
+   _d_outputs_(4, 6, ac, out, jacobian);
+}
+
+/* Bounds of Voltage-Divider Configuration
+
+Bound kernel evaluates voltage-divider with intervals (INTERVAL.h).
+Drain current rises with gate voltage Vg = Vdd / (1 + Rg1/Rg2) and
+falls with Rs, so its ends are Shockley solutions at the corners of
+the ranges, which are solved in double. gm = 2 * sqrt(Idss * Id) /
+|Vp| rises with Id, so gain is bounded by the same corners.
+*/
+
+KERNEL struct Interval _i_shockley_Id_(struct Interval Idss,
+                                       struct Interval Vp,
+                                       struct Interval Rs,
+                                       struct Interval Vg) {
+   // Lowest and highest drain current of all corners of ranges.
+   struct Interval Id = {INFINITY, -INFINITY};
+   for (int k = 0; k < 16; k++) {
+      real id = _drain_Id_double_(FET_SHOCKLEY, k & 1 ? Idss.hi : Idss.lo,
+                                  k & 2 ? Vp.hi : Vp.lo,
+                                  k & 4 ? Rs.hi : Rs.lo,
+                                  k & 8 ? Vg.hi : Vg.lo);
+      Id.lo = real_fmin(Id.lo, id); Id.hi = real_fmax(Id.hi, id);
+   }
+   return Id;
+}
+
+KERNEL void _voltage_divider_bound_(const int analysis,
+                                    struct Interval Vdd,
+                                    struct Interval Rg1,
+                                    struct Interval Rg2,
+                                    struct Interval Rd,
+                                    struct Interval Rs,
+                                    struct Interval Idss,
+                                    struct Interval Vp,
+                                    struct Interval rd,
+                                    struct Interval* dc,
+                                    struct Interval* ac) {
+   // gate voltage
+   struct Interval Vg = _i_div_(Vdd, _i_shift_(_i_div_(Rg1, Rg2), 1));
+   // drain current
+   struct Interval Id = _i_shockley_Id_(Idss, Vp, Rs, Vg);
+   if (analysis & ANALYSIS_DC) {
+      struct Interval Vs = _i_mul_(Id, Rs); // source voltage
+      struct Interval Vd = _i_sub_(Vdd, _i_mul_(Id, Rd)); // drain voltage
+      dc[0] = Id; dc[1] = _i_sub_(Vg, Vs); dc[2] = _i_sub_(Vd, Vs);
+      dc[3] = Vs; dc[4] = Vd; dc[5] = Vg;
+   }
+   if (analysis & ANALYSIS_AC) {
+      // gm factor
+      struct Interval gm = _i_scale_(_i_sqrt_(_i_div_(_i_mul_(Idss, Id),
+                                     _i_mul_(Vp, Vp))), 2);
+      struct Interval Zo = _i_parallel_(Rd, rd); // output impedance
+      ac[0] = gm; ac[1] = _i_parallel_(Rg1, Rg2); ac[2] = Zo;
+      ac[3] = _i_scale_(_i_mul_(gm, Zo), -1); // voltage gain
+   }
+}
+
+static void _vd_dc_bound_(real* low, real* high, real* out_low,
+                          real* out_high) {
+   struct Interval p[7], dc[6];
+   _i_inputs_(7, low, high, p);
+   _voltage_divider_bound_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4],
+                           p[5], p[6], _i_(1), dc, NULL);
+   _i_outputs_(6, dc, out_low, out_high);
+}
+static void _vd_ac_bound_(real* low, real* high, real* out_low,
+                          real* out_high) {
+   struct Interval p[8], ac[4];
+   _i_inputs_(8, low, high, p);
+   _voltage_divider_bound_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                           p[5], p[6], p[7], NULL, ac);
+   _i_outputs_(4, ac, out_low, out_high);
+}
+
+/* Nonlinear DC Analysis of FET Configurations
+
+"newton" entries solve the drain current with channel-length
+modulation (lambda) by '_drain_solve_' of NEWTON.h. A configuration
+gives the linear bias network of Vgs and Vds of its lanes, the root
+of the quadratic without lambda is found by the vectorized kernels
+above and is the start of the solve. The fixed-bias configuration
+has a constant Vgs, so it has no "newton" entry.
+*/
+
+// Baseline, AVX2 and AVX-512 copies of '_drain_solve_' and
+// '_drain_solve_batch_' (NEWTON.h) like the ones of '_newton_solve_'
+// in BJT.h.
+#if NEWTON_SIMD
+static void _drain_solve_scalar_(struct DrainBlock* b) {
+   _drain_solve_(b);
 }
+__attribute__((target("avx2")))
+static void _drain_solve_avx2_(struct DrainBlock* b) {
+   _drain_solve_(b);
+}
+__attribute__((target("avx512f")))
+static void _drain_solve_avx512_(struct DrainBlock* b) {
+   _drain_solve_(b);
+}
+static void _drain_solve_batch_(struct DrainBlock* b) {
+   if (__builtin_cpu_supports("avx512f")) _drain_solve_avx512_(b);
+   else if (__builtin_cpu_supports("avx2")) _drain_solve_avx2_(b);
+   else _drain_solve_scalar_(b);
+}
+#else
+static void _drain_solve_batch_(struct DrainBlock* b) {
+   _drain_solve_(b);
+}
+#endif
+
+static void _drain_batch_(const int law,
+                          void (*network)(real (*)[NEWTON_BLOCK],
+                                          struct DrainBlock*),
+                          void (*results)(struct DrainBlock*,
+                                          real (*)[NEWTON_BLOCK]),
+                          int nin, int nout, long n, real** in,
+                          real** out) {
+   // Batch function of "newton" entries. 'network' fills a block from
+   // 'nin' parameter columns and 'results' writes 'nout' results of
+   // the solved block.
+   struct DrainBlock b;
+   real p[CONFIG_COLUMNS][NEWTON_BLOCK], r[CONFIG_COLUMNS][NEWTON_BLOCK];
+   for (long i = 0; i < n; i += NEWTON_BLOCK) {
+      long m = _newton_gather_(nin, i, n, in, p);
+      network(p, &b);
+      if (law == FET_SHOCKLEY)
+         _shockley_Id_batch_(NEWTON_BLOCK, b.P, b.V, b.Rgs, b.Vgs0, b.Id);
+      else _square_law_Id_batch_(NEWTON_BLOCK, b.P, b.V, b.Rgs, b.Vgs0,
+                                 b.Id);
+      for (int k = 0; k < NEWTON_BLOCK; k++)
+         b.u[k] = law == FET_SQUARE_LAW ? b.P[k] :
+                  b.P[k] / (b.V[k] * b.V[k]);
+      _drain_solve_batch_(&b);
+      results(&b, r);
+      for (int c = 0; c < nout; c++)
+         memcpy(out[c] + i, r[c], m * sizeof(real));
+   }
+}
+
+static void _dc_drain_(struct DrainBlock* b, real (*r)[NEWTON_BLOCK]) {
+   // FET_DC_RESULTS of a solved block.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Id = b->Id[k];
+      real Vgs = b->Vgs0[k] - b->Rgs[k] * Id; // gate-source voltage
+      real Vds = b->Vds0[k] - b->Rds[k] * Id; // drain-source voltage
+      real Vs = b->Vg[k] - Vgs; // source voltage
+      r[0][k] = Id; r[1][k] = Vgs; r[2][k] = Vds;
+      r[3][k] = Vs; r[4][k] = Vds + Vs; r[5][k] = b->Vg[k];
+   }
+}
+
+static void _sb_network_(real (*p)[NEWTON_BLOCK], struct DrainBlock* b) {
+   // Vdd Rd Rs Idss Vp lambda
+   for (int k = 0; k < NEWTON_BLOCK; k++)
+      _drain_network_(b, k, p[3][k], p[4][k], p[5][k], 0, p[2][k],
+                      p[0][k], p[1][k] + p[2][k], 0);
+}
+
+static void _vd_network_(real (*p)[NEWTON_BLOCK], struct DrainBlock* b) {
+   // Vdd Rg1 Rg2 Rd Rs Idss Vp lambda
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vg = (p[2][k] * p[0][k]) / (p[1][k] + p[2][k]);
+      _drain_network_(b, k, p[5][k], p[6][k], p[7][k], Vg, p[4][k],
+                      p[0][k], p[3][k] + p[4][k], Vg);
+   }
+}
+
+static void _cg_network_(real (*p)[NEWTON_BLOCK], struct DrainBlock* b) {
+   // Vdd Vss Rd Rs Idss Vp lambda
+   for (int k = 0; k < NEWTON_BLOCK; k++)
+      _drain_network_(b, k, p[4][k], p[5][k], p[6][k], p[1][k], p[3][k],
+                      p[0][k] + p[1][k], p[2][k] + p[3][k], 0);
+}
+
+/* Configuration Table of FET Batch Functions */
+
+static struct DCFETBatch _dc_columns_(real** out) {
+   // Wrap result columns into 'DCFETBatch' struct.
+   return (struct DCFETBatch) {out[0], out[1], out[2], out[3], out[4],
+                               out[5]};
+}
+
+static struct ACFETBatch _ac_columns_(real** out) {
+   // Wrap result columns into 'ACFETBatch' struct.
+   return (struct ACFETBatch) {out[0], out[1], out[2], out[3]};
+}
+
+static void _fb_dc_(long n, real** in, real** out) {
+   struct DCFETBatch dc = _dc_columns_(out);
+   f_fixed_bias_dc_batch(n, in[0], in[1], in[2], in[3], in[4], &dc);
+}
+static void _fb_ac_(long n, real** in, real** out) {
+   struct ACFETBatch ac = _ac_columns_(out);
+   f_fixed_bias_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5], &ac);
+}
+static void _sb_dc_(long n, real** in, real** out) {
+   struct DCFETBatch dc = _dc_columns_(out);
+   f_self_bias_dc_batch(n, in[0], in[1], in[2], in[3], in[4], &dc);
+}
+static void _sb_ac_(long n, real** in, real** out) {
+   struct ACFETBatch ac = _ac_columns_(out);
+   f_self_bias_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5], &ac);
+}
+static void _vd_dc_(long n, real** in, real** out) {
+   struct DCFETBatch dc = _dc_columns_(out);
+   f_voltage_divider_dc_batch(n, in[0], in[1], in[2], in[3], in[4], in[5],
+                              in[6], &dc);
+}
+static void _vd_ac_(long n, real** in, real** out) {
+   struct ACFETBatch ac = _ac_columns_(out);
+   f_voltage_divider_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5],
+                              in[6], in[7], &ac);
+}
+static void _cg_dc_(long n, real** in, real** out) {
+   struct DCFETBatch dc = _dc_columns_(out);
+   f_common_gate_dc_batch(n, in[0], in[1], in[2], in[3], in[4], in[5], &dc);
+}
+static void _cg_ac_(long n, real** in, real** out) {
+   struct ACFETBatch ac = _ac_columns_(out);
+   f_common_gate_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5], &ac);
+}
+static void _sf_ac_(long n, real** in, real** out) {
+   struct ACFETBatch ac = _ac_columns_(out);
+   f_source_follower_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5],
+                              &ac);
+}
+static void _sb_newton_(long n, real** in, real** out) {
+   _drain_batch_(FET_SHOCKLEY, _sb_network_, _dc_drain_, 6, 6, n, in,
+                 out);
+}
+static void _vd_newton_(long n, real** in, real** out) {
+   _drain_batch_(FET_SHOCKLEY, _vd_network_, _dc_drain_, 8, 6, n, in,
+                 out);
+}
+static void _cg_newton_(long n, real** in, real** out) {
+   _drain_batch_(FET_SHOCKLEY, _cg_network_, _dc_drain_, 7, 6, n, in,
+                 out);
+}
+
+#define FET_DC_RESULTS 6, {"Id", "Vgs", "Vds", "Vs", "Vd", "Vg"}, "------"
+#define FET_AC_RESULTS 4, {"gm", "Zi", "Zo", "Av"}, "++++"
+
+// Frequency response of JFET and D-MOSFET configurations (BODE.h).
+struct BodeModel FETBodeModels[] = {
+   {"fet", "fb", NULL, BODE_INVERTING, 6, -1, -1, _fb_ac_},
+   {"fet", "sb", NULL, BODE_INVERTING, 6, -1, -1, _sb_ac_},
+   {"fet", "vd", NULL, BODE_INVERTING, 8, 4, -1, _vd_ac_},
+   {"fet", "cg", NULL, BODE_COMMON_BASE, 6, -1, -1, _cg_ac_},
+   {"fet", "sf", NULL, BODE_FOLLOWER, 6, -1, -1, _sf_ac_},
+};
+int FETBodeModelCount = sizeof(FETBodeModels) / sizeof(FETBodeModels[0]);
+
+BODE_ENTRY(_fb_bode_, FETBodeModels[0])
+BODE_ENTRY(_sb_bode_, FETBodeModels[1])
+BODE_ENTRY(_vd_bode_, FETBodeModels[2])
+BODE_ENTRY(_cg_bode_, FETBodeModels[3])
+BODE_ENTRY(_sf_bode_, FETBodeModels[4])
+
+// All JFET and D-MOSFET configurations which have batch functions.
+struct Config FETConfigs[] = {
+   {"fet", "fb", "dc", NULL, 5, {"Vdd", "Vgg", "Rd", "Idss", "Vp"}, "--++-",
+    FET_DC_RESULTS, _fb_dc_, _fb_dc_jacobian_},
+   {"fet", "fb", "ac", NULL, 6, {"Vgg", "Rg", "Rd", "Idss", "Vp", "rd"},
+    "-+++-+", FET_AC_RESULTS, _fb_ac_, _fb_ac_jacobian_},
+   {"fet", "fb", "bode", NULL, 12, {"Vgg", "Rg", "Rd", "Idss", "Vp", "rd",
+    BODE_INPUTS, "Cgs", "Cgd"}, "-+++-+" BODE_SIGNS "++", BODE_RESULTS,
+    _fb_bode_},
+   {"fet", "sb", "dc", NULL, 5, {"Vdd", "Rd", "Rs", "Idss", "Vp"}, "-+++-",
+    FET_DC_RESULTS, _sb_dc_, _sb_dc_jacobian_},
+   {"fet", "sb", "newton", NULL, 6, {"Vdd", "Rd", "Rs", "Idss", "Vp",
+    "lambda"}, "-+++-+", FET_DC_RESULTS, _sb_newton_},
+   {"fet", "sb", "ac", NULL, 6, {"Rg", "Rd", "Rs", "Idss", "Vp", "rd"},
+    "++++-+", FET_AC_RESULTS, _sb_ac_, _sb_ac_jacobian_},
+   {"fet", "sb", "bode", NULL, 12, {"Rg", "Rd", "Rs", "Idss", "Vp", "rd",
+    BODE_INPUTS, "Cgs", "Cgd"}, "++++-+" BODE_SIGNS "++", BODE_RESULTS,
+    _sb_bode_},
+   {"fet", "vd", "dc", NULL, 7, {"Vdd", "Rg1", "Rg2", "Rd", "Rs", "Idss",
+    "Vp"}, "-+++++-", FET_DC_RESULTS, _vd_dc_, _vd_dc_jacobian_,
+    _vd_dc_bound_},
+   {"fet", "vd", "newton", NULL, 8, {"Vdd", "Rg1", "Rg2", "Rd", "Rs",
+    "Idss", "Vp", "lambda"}, "-+++++-+", FET_DC_RESULTS, _vd_newton_},
+   {"fet", "vd", "ac", NULL, 8, {"Vdd", "Rg1", "Rg2", "Rd", "Rs", "Idss",
+    "Vp", "rd"}, "-+++++-+", FET_AC_RESULTS, _vd_ac_, _vd_ac_jacobian_,
+    _vd_ac_bound_},
+   {"fet", "vd", "bode", NULL, 15, {"Vdd", "Rg1", "Rg2", "Rd", "Rs", "Idss",
+    "Vp", "rd", BODE_INPUTS, "Cs", "Cgs", "Cgd"},
+    "-+++++-+" BODE_SIGNS "+++", BODE_RESULTS, _vd_bode_},
+   {"fet", "cg", "dc", NULL, 6, {"Vdd", "Vss", "Rd", "Rs", "Idss", "Vp"},
+    "--+++-", FET_DC_RESULTS, _cg_dc_, _cg_dc_jacobian_},
+   {"fet", "cg", "newton", NULL, 7, {"Vdd", "Vss", "Rd", "Rs", "Idss", "Vp",
+    "lambda"}, "--+++-+", FET_DC_RESULTS, _cg_newton_},
+   {"fet", "cg", "ac", NULL, 6, {"Vss", "Rd", "Rs", "Idss", "Vp", "rd"},
+    "-+++-+", FET_AC_RESULTS, _cg_ac_, _cg_ac_jacobian_},
+   {"fet", "cg", "bode", NULL, 12, {"Vss", "Rd", "Rs", "Idss", "Vp", "rd",
+    BODE_INPUTS, "Cgs", "Cgd"}, "-+++-+" BODE_SIGNS "++", BODE_RESULTS,
+    _cg_bode_},
+   {"fet", "sf", "ac", NULL, 6, {"Vgs", "Rg", "Rs", "Idss", "Vp", "rd"},
+    "-+++-+", FET_AC_RESULTS, _sf_ac_, _sf_ac_jacobian_},
+   {"fet", "sf", "bode", NULL, 12, {"Vgs", "Rg", "Rs", "Idss", "Vp", "rd",
+    BODE_INPUTS, "Cgs", "Cgd"}, "-+++-+" BODE_SIGNS "++", BODE_RESULTS,
+    _sf_bode_},
+};
+int FETConfigCount = sizeof(FETConfigs) / sizeof(FETConfigs[0]);
+
+/* Models of JFET and D-MOSFET Configurations (see INCREMENTAL.h) */
+
+static void _fb_model_(int stages, real* p, real* op, void* dc, void* ac) {
+   STAGE_DISPATCH(stages, _fixed_bias_, 1, p[0], p[1], p[2], p[3], p[4],
+                  p[5], p[6], op, dc, ac);
+}
+
+static void _sb_model_(int stages, real* p, real* op, void* dc, void* ac) {
+   STAGE_DISPATCH(stages, _self_bias_, 1, p[0], p[1], p[2], p[3], p[4],
+                  p[5], p[6], op, dc, ac);
+}
+
+static void _vd_model_(int stages, real* p, real* op, void* dc, void* ac) {
+   STAGE_DISPATCH(stages, _voltage_divider_, 1, p[0], p[1], p[2], p[3],
+                  p[4], p[5], p[6], p[7], op, dc, ac);
+}
+
+static void _cg_model_(int stages, real* p, real* op, void* dc, void* ac) {
+   STAGE_DISPATCH(stages, _common_gate_, 1, p[0], p[1], p[2], p[3], p[4],
+                  p[5], p[6], op, dc, ac);
+}
+
+static void _sf_model_(int stages, real* p, real* op, void* dc, void* ac) {
+   STAGE_DISPATCH(stages, _source_follower_, 1, p[0], p[1], p[2], p[3],
+                  p[4], p[5], p[6], op, dc, ac);
+}
+
+// All JFET and D-MOSFET configurations with parameters of operating
+// point, DC stage and AC stage.
+struct Model FETModels[] = {
+   {"fet", "fb", NULL, "both", 7, {"Vdd", "Vgg", "Rg", "Rd", "Idss", "Vp",
+    "rd"}, "Vgg", "Vdd Rd Idss Vp", "Rg Rd Idss Vp rd", _fb_model_},
+   {"fet", "sb", NULL, "both", 7, {"Vdd", "Rg", "Rd", "Rs", "Idss", "Vp",
+    "rd"}, "Rs Idss Vp", "Vdd Rd Rs", "Rg Rd Rs Idss Vp rd", _sb_model_},
+   {"fet", "vd", NULL, "both", 8, {"Vdd", "Rg1", "Rg2", "Rd", "Rs",
+    "Idss", "Vp", "rd"}, "Vdd Rg1 Rg2 Rs Idss Vp", "Vdd Rd Rs",
+    "Rg1 Rg2 Rd Idss Vp rd", _vd_model_},
+   {"fet", "cg", NULL, "both", 7, {"Vdd", "Vss", "Rd", "Rs", "Idss", "Vp",
+    "rd"}, "Vss Rs Idss Vp", "Vdd Vss Rd Rs", "Rd Rs Idss Vp rd",
+    _cg_model_},
+   {"fet", "sf", NULL, "ac", 7, {"Vdd", "Vgs", "Rg", "Rs", "Idss", "Vp",
+    "rd"}, "Vgs Idss Vp", "", "Rg Rs rd", _sf_model_},
+};
+int FETModelCount = sizeof(FETModels) / sizeof(FETModels[0]);
+
+#endif
@@ -0,0 +1,96 @@
+/* Incremental Evaluation of Configurations
+
+A configuration kernel has three parts: the operating point (Ib/Ie of
+a BJT, Id/Vgs of a FET, ...), the DC stage and the AC stage (see
+CONFIG.h). The 'Model' of a configuration (BJTModels, FETModels and
+MOSFETModels) names the parameters that each part reads, e.g. ro of
+a BJT is only read by the AC stage and Rd of a self-bias JFET is not
+read by its Shockley solution.
+
+An 'Incremental' keeps parameters, operating point and results of a
+configuration. 'incremental_set' only marks a parameter as changed,
+'incremental_update' then runs the parts which read a changed
+parameter: a new operating point runs all kept stages again, else
+only the DC and/or the AC stage runs with the kept operating point.
+So, an optimizer that changes ro or rd one by one never solves the
+operating point again.
+*/
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <string.h>
+#include "CONFIG.h"
+
+static int _model_param_(struct Model* model, char* name, int length) {
+   // Index of parameter 'name' (first 'length' characters) of model.
+   for (int i = 0; i < model->nparams; i++)
+      if ((int) strlen(model->params[i]) == length &&
+          strncmp(model->params[i], name, length) == 0)
+         return i;
+   return -1;
+}
+
+static int _model_depends_(struct Model* model, char* names,
+                           unsigned* mask) {
+   // Find mask of parameters of space separated 'names'. -1 is
+   // returned for a name which is not a parameter of model.
+   *mask = 0;
+   while (*names) {
+      int length = strcspn(names, " ");
+      if (length > 0) {
+         int param = _model_param_(model, names, length);
+         if (param < 0) return -1;
+         *mask |= 1u << param;
+      }
+      names += length + (names[length] == ' ');
+   }
+   return 0;
+}
+
+int incremental_init(struct Incremental* inc, struct Model* model,
+                     char* analysis, real* params) {
+   memset(inc, 0, sizeof(struct Incremental));
+   inc->model = model;
+   inc->stages = _analysis_(analysis);
+   int supported = _analysis_(model->analyses);
+   if ((inc->stages & supported) != inc->stages) return -1;
+   if (_model_depends_(model, model->op_depends, &inc->depends[0]) ||
+       _model_depends_(model, model->dc_depends, &inc->depends[1]) ||
+       _model_depends_(model, model->ac_depends, &inc->depends[2]))
+      return -1;
+   memcpy(inc->params, params, model->nparams * sizeof(real));
+   return 0;
+}
+
+int incremental_param(struct Incremental* inc, char* name) {
+   return _model_param_(inc->model, name, strlen(name));
+}
+
+void incremental_set(struct Incremental* inc, int param, real value) {
+   // Same value does not make the results old.
+   if (inc->params[param] == value) return;
+   inc->params[param] = value;
+   inc->changed |= 1u << param;
+}
+
+void incremental_update(struct Incremental* inc) {
+   int stages = 0;
+   if (!inc->solved || (inc->changed & inc->depends[0]))
+      stages = ANALYSIS_OP | inc->stages;
+   else {
+      if (inc->changed & inc->depends[1])
+         stages |= inc->stages & ANALYSIS_DC;
+      if (inc->changed & inc->depends[2])
+         stages |= inc->stages & ANALYSIS_AC;
+   }
+   inc->changed = 0;
+   inc->solved = 1;
+   if (!stages) return;
+   inc->model->run(stages, inc->params, inc->op, &inc->dc, &inc->ac);
+   inc->runs[0] += (stages & ANALYSIS_OP) != 0;
+   inc->runs[1] += (stages & ANALYSIS_DC) != 0;
+   inc->runs[2] += (stages & ANALYSIS_AC) != 0;
+}
+
+#endif
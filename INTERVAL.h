@@ -0,0 +1,124 @@
+/* Intervals for Bounds of Results
+
+An interval keeps the lowest and the highest value that a quantity
+can take while parameters are anywhere in their ranges (interval
+arithmetic). Every operation gives an interval that contains all of
+its results, so a formula that is evaluated with intervals bounds its
+result over the whole box of parameters. A parameter which appears
+more than once in a formula makes the bound wider than the true
+range but never narrower, so bound kernels rewrite formulas to use
+each parameter once where it is easy (e.g. Eth = Vcc / (1 + R1/R2)).
+
+The bound functions of configurations ('bound' of 'Config') run the
+bound kernels of their family headers, see e.g.
+'_b_voltage_divider_bound_' of BJT.h. The design optimizer
+(OPTIMIZE.h) drops a branch of partial resistor values whose bounds
+can not meet targets.
+*/
+
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include <math.h>
+#include "PRECISION.h"
+#include "CONFIG.h"
+
+// Relative widening of bounds which covers rounding errors of bound
+// kernels and of configuration kernels that are bounded.
+#if PRECISION_DOUBLE
+#define INTERVAL_SLACK 1e-9
+#else
+#define INTERVAL_SLACK 1e-4f
+#endif
+
+struct Interval {
+   real lo, hi; // lowest and highest value
+};
+
+KERNEL struct Interval _i_(real v) {
+   // A point, both ends are same.
+   struct Interval x = {v, v};
+   return x;
+}
+
+KERNEL struct Interval _i_add_(struct Interval a, struct Interval b) {
+   struct Interval x = {a.lo + b.lo, a.hi + b.hi};
+   return x;
+}
+
+KERNEL struct Interval _i_sub_(struct Interval a, struct Interval b) {
+   struct Interval x = {a.lo - b.hi, a.hi - b.lo};
+   return x;
+}
+
+KERNEL real _i_prod_(real x, real y) {
+   // Product of two ends, 0 * inf is 0 (not NaN) as the limit of the
+   // products inside the intervals.
+   return x == 0 || y == 0 ? 0 : x * y;
+}
+
+KERNEL struct Interval _i_mul_(struct Interval a, struct Interval b) {
+   // The ends are among the products of ends.
+   real p1 = _i_prod_(a.lo, b.lo), p2 = _i_prod_(a.lo, b.hi);
+   real p3 = _i_prod_(a.hi, b.lo), p4 = _i_prod_(a.hi, b.hi);
+   struct Interval x = {real_fmin(real_fmin(p1, p2), real_fmin(p3, p4)),
+                        real_fmax(real_fmax(p1, p2), real_fmax(p3, p4))};
+   return x;
+}
+
+KERNEL struct Interval _i_inv_(struct Interval a) {
+   // 1 / a is not bounded if a contains zero.
+   struct Interval x = {1 / a.hi, 1 / a.lo};
+   if (a.lo <= 0 && a.hi >= 0) x.lo = -INFINITY, x.hi = INFINITY;
+   return x;
+}
+
+KERNEL struct Interval _i_div_(struct Interval a, struct Interval b) {
+   return _i_mul_(a, _i_inv_(b));
+}
+
+KERNEL struct Interval _i_scale_(struct Interval a, real s) {
+   // s * a, a negative s swaps the ends.
+   struct Interval x = {_i_prod_(s, a.lo), _i_prod_(s, a.hi)};
+   if (s < 0) x.lo = s * a.hi, x.hi = s * a.lo;
+   return x;
+}
+
+KERNEL struct Interval _i_shift_(struct Interval a, real s) {
+   // a + s
+   struct Interval x = {a.lo + s, a.hi + s};
+   return x;
+}
+
+KERNEL struct Interval _i_sqrt_(struct Interval a) {
+   struct Interval x = {real_sqrt(real_fmax(a.lo, 0)),
+                        real_sqrt(real_fmax(a.hi, 0))};
+   return x;
+}
+
+KERNEL struct Interval _i_parallel_(struct Interval R1,
+                                    struct Interval R2) {
+   // Parallel resistance rises with both resistances, so its ends are
+   // the ones of the ends (each resistance is used once).
+   struct Interval x = {1 / (1 / R1.lo + 1 / R2.lo),
+                        1 / (1 / R1.hi + 1 / R2.hi)};
+   return x;
+}
+
+KERNEL void _i_inputs_(int nin, real* low, real* high, struct Interval* p) {
+   // Ranges of parameters as intervals.
+   for (int c = 0; c < nin; c++) {
+      p[c].lo = low[c]; p[c].hi = high[c];
+   }
+}
+
+KERNEL void _i_outputs_(int nout, struct Interval* r, real* low,
+                        real* high) {
+   // Write ends of results into 'low' and 'high', widened for rounding.
+   for (int i = 0; i < nout; i++) {
+      low[i] = r[i].lo - INTERVAL_SLACK * real_fabs(r[i].lo);
+      high[i] = r[i].hi + INTERVAL_SLACK * real_fabs(r[i].hi);
+   }
+}
+
+#endif
@@ -2,7 +2,9 @@
 
 I've started this project for making easier the transistor and 
 related operations. The important point is that all transistors are
-'npn' types. But, can be derivated easily 'pnp' implementations. 
+'n-channel' types. 'p-channel' ones are their mirror images (opposite
+signs of voltages and currents) and are evaluated by same functions,
+see 'POLARITY.h'.
 This package contains mostly used configuration and some special
 connections. Another important point is that in AC analysis of
 transistors, algorithms use 'JFET small-signal' transistor model.
@@ -19,15 +21,165 @@ Boylestad and Louis Nashelsky
 #include <assert.h>
 #include <math.h>
 #include "FET.h"
+#include "JOBS.h"
+#include "DECK.h"
+#include "OPTIMIZE.h"
+
+void _display_transistors_(char* analysis, char* transistor) {
+   // Display the all transistors.
+   puts("TRANSISTOR:");
+   puts("--> 'fb' for fixed-bias config.");
+   puts("--> 'sb' for self-bias config.");
+   puts("--> 'vd' for voltage-divider config.");
+   puts("--> 'cg' for common-gate config.");
+   if (strcmp(analysis, "dc"))
+      puts("--> 'sf' for source-follower config.");
+   printf("Transistor type: "); scanf("%s", &(*transistor));
+   puts("--------------------------------------------");
+}
+
+void _fixed_bias_inputs_(char* analysis, float* Vdd, float* Vgg, 
+                        float* Rg, float* Rd, float* Idss, 
+                        float* Vp, float* rd) {
+   // Get inputs of fixed-bias configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Vgg (V): "); scanf("%f", &(*Vgg));
+   if (strcmp(analysis, "dc")) {
+      printf("Rg (ohm): "); scanf("%f", &(*Rg));
+   }
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
+
+void _self_bias_inputs_(char* analysis, float* Vdd, float* Rg, 
+                        float* Rd, float* Rs, float* Idss, 
+                        float* Vp, float* rd) {
+   // Get inputs of self-bias configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   if (strcmp(analysis, "dc")) {
+      printf("Rg (ohm): "); scanf("%f", &(*Rg));
+   }
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
+
+void _voltage_divider_inputs_(char* analysis, float* Vdd, float* Rg1, 
+                              float* Rg2, float* Rd, float* Rs, 
+                              float* Idss, float* Vp, float* rd) {
+   // Get inputs of voltage-divider configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Upper Rg (ohm): "); scanf("%f", &(*Rg1));
+   printf("Lower Rg (ohm): "); scanf("%f", &(*Rg2));
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results...");
+   puts("--------------------------------------------");
+}
+
+void _common_gate_inputs_(char* analysis, float* Vdd, float* Vss, 
+                          float* Rd, float* Rs, float* Idss, 
+                          float* Vp, float* rd) {
+   // Get inputs of common-gate configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Vss (V): "); scanf("%f", &(*Vss));
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
+
+void _source_follower_inputs_(char* analysis, float* Vdd, float* Vgs,
+                              float* Rg, float* Rs, float* Idss, 
+                              float* Vp, float* rd) {
+   // Get inputs of source-follower configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Vgs (V): "); scanf("%f", &(*Vgs));
+   printf("Rg (ohm): "); scanf("%f", &(*Rg));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   printf("rd (ohm): "); scanf("%f", &(*rd));
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
+
+void _display_dc_results_(struct DCFET* dc) {
+   // Display the DC results.
+   puts("RESULTS: ");
+   printf("Id: %f A\n", dc->Id);
+   printf("Vds: %f A\n", dc->Vds);
+   printf("Vgs: %f A\n", dc->Vgs);
+   printf("Vs: %f V\n", dc->Vs);
+   printf("Vd: %f A\n", dc->Vd);
+   printf("Vg: %f V\n", dc->Vg);
+   puts("--------------------------------------------");
+}
+
+void _display_ac_results_(struct ACFET* ac) {
+   // Display the AC results.
+   puts("RESULTS: ");
+   printf("gm: %f S\n", ac->gm);
+   printf("Zi: %f ohm\n", ac->Zi);
+   printf("Zo: %f ohm\n", ac->Zo);
+   printf("Av: %f\n", ac->Av);
+   printf("Phase: %s\n", ac->phase);
+   puts("--------------------------------------------");
+}
 
 /* Main method that will display the all implemnetations */
-int main(void) {
+int main(int argc, char* argv[]) {
    // 'analysis' argument represents the type of analysis.
-   char analysis[2];
+   char analysis[3];
    // 'transistor' argument represents type of transistor.
-   char transistor[2];
+   char transistor[4];
    // These arguments represent the values of a transistor. 
    float Vdd, Vgg, Rd, Idss, Vp, Rs, Vss, Rg1, Rg2, rd, Vgs;
+   // Results of the analysis.
+   struct DCFET dc = {0};
+   struct ACFET ac = {0};
+
+   // Read jobs from a file or stdin, a deck or a design instead of
+   // prompts.
+   if (argc > 1 && (strcmp(argv[1], "-j") == 0 ||
+                    strcmp(argv[1], "-d") == 0 ||
+                    strcmp(argv[1], "-o") == 0)) {
+      struct JobTable tables[] = {{NULL, FETConfigs, FETConfigCount}};
+      char* format = argc > 3 ? argv[3] : "text";
+      if (strcmp(argv[1], "-d") == 0)
+         return argc > 2 ? run_deck_file(argv[2], format, tables, 1) : 1;
+      if (strcmp(argv[1], "-o") == 0)
+         return run_design_file(argc > 2 ? argv[2] : "-", format, tables,
+                                1);
+      return run_job_file(argc > 2 ? argv[2] : "-", format, tables, 1);
+   }
 
    puts("--------------------------------------------");
    puts("  WELLCOME TO ANALYSIS OF JFET TRANSISTORS  ");
@@ -47,18 +199,18 @@ int main(void) {
          // Get inputs of fixed-bias config.
          _fixed_bias_inputs_("dc", &Vdd, &Vgg, 1, &Rd, &Idss, &Vp, 1);
          // Calculate the results of fixed-bias config.
-         fixed_bias("dc", Vdd, Vgg, 1, Rd, Idss, Vp, 1);
+         f_fixed_bias("dc", Vdd, Vgg, 1, Rd, Idss, Vp, 1, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       // For Self-Bias Configuration:
       else if (strcmp(transistor, "sb") == 0) {
          // Get inputs of self-bias config.
          _self_bias_inputs_("dc", &Vdd, 1, &Rd, &Rs, &Idss, &Vp, 1);
          // Calculate the results of self-bias config.
-         self_bias("dc", Vdd, 1, Rd, Rs, Idss, Vp, 1);
+         f_self_bias("dc", Vdd, 1, Rd, Rs, Idss, Vp, 1, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -66,9 +218,10 @@ int main(void) {
          _voltage_divider_inputs_("dc", &Vdd, &Rg1, &Rg2, &Rd, &Rs, 
                                   &Idss, &Vp, 1);
          // Calculate the results of voltage-divider config.
-         voltage_divider("dc", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, 1);
+         f_voltage_divider("dc", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, 1, 
+                           &dc, &ac);
          // Display the results of voltage-divider config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       // For Common-Gate Configuration:
       else if (strcmp(transistor, "cg") == 0) {
@@ -76,9 +229,9 @@ int main(void) {
          _common_gate_inputs_("dc", &Vdd, &Vss, &Rd, &Rs, &Idss, 
                               &Vp, 1);
          // Calculate the results of common-gate config.
-         common_gate("dc", Vdd, Vss, Rd, Rs, Idss, Vp, 1);
+         f_common_gate("dc", Vdd, Vss, Rd, Rs, Idss, Vp, 1, &dc, &ac);
          // Display the results of common-gate config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -92,9 +245,9 @@ int main(void) {
          _fixed_bias_inputs_("ac", &Vdd, &Vgg, &Rg1, &Rd, &Idss, 
                              &Vp, &rd);
          // Calculate the results of fixed-bias config.
-         fixed_bias("ac", Vdd, Vgg, Rg1, Rd, Idss, Vp, rd);
+         f_fixed_bias("ac", Vdd, Vgg, Rg1, Rd, Idss, Vp, rd, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Self-Bias Configuration:
       else if (strcmp(transistor, "sb") == 0) {
@@ -102,9 +255,9 @@ int main(void) {
          _self_bias_inputs_("ac", &Vdd, &Rg1, &Rd, &Rs, &Idss, 
                             &Vp, &rd);
          // Calculate the results of self-bias config.
-         self_bias("ac", Vdd, Rg1, Rd, Rs, Idss, Vp, rd);
+         f_self_bias("ac", Vdd, Rg1, Rd, Rs, Idss, Vp, rd, &dc, &ac);
          // Display the results of self-bias config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -112,9 +265,10 @@ int main(void) {
          _voltage_divider_inputs_("ac", &Vdd, &Rg1, &Rg2, &Rd, &Rs, 
                                   &Idss, &Vp, &rd);
          // Calculate the results of voltage-divider config.
-         voltage_divider("ac", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, rd);
+         f_voltage_divider("ac", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, rd, 
+                           &dc, &ac);
          // Display the results of voltage-divider config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Common-Gate Configuration:
       else if (strcmp(transistor, "cg") == 0) {
@@ -122,9 +276,9 @@ int main(void) {
          _common_gate_inputs_("ac", &Vdd, &Vss, &Rd, &Rs, &Idss, 
                               &Vp, &rd);
          // Calculate the results of common-gate config.
-         common_gate("ac", Vdd, Vss, Rd, Rs, Idss, Vp, rd);
+         f_common_gate("ac", Vdd, Vss, Rd, Rs, Idss, Vp, rd, &dc, &ac);
          // Display the results of common-gate config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Self-Follower Configuration:
       else if (strcmp(transistor, "sf") == 0) {
@@ -132,9 +286,10 @@ int main(void) {
          _source_follower_inputs_("ac", &Vdd, &Vgs, &Rg1, &Rs, 
                                   &Idss, &Vp, &rd);
          // Calculate the results of self-follower config.
-         source_follower("ac", Vdd, Vgs, Rg1, Rs, Idss, Vp, rd);
+         f_source_follower("ac", Vdd, Vgs, Rg1, Rs, Idss, Vp, rd, 
+                           &dc, &ac);
          // Display the results of self-follower config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -0,0 +1,187 @@
+/* Non-Interactive Analysis Jobs
+
+Programs read analysis jobs from a file or stdin when they are run as
+'BJT -j [file [format]]' ('-' or no file is stdin). Every line is a
+job:
+
+   [type] configuration analysis [option] parameters ...
+
+'type' is only used by programs that have more than one family of
+transistors ('d' or 'e' in MOSFET). 'option' is only given for
+configurations that have options (bypass of BJT voltage-divider ac
+analysis). Parameters are in order of the 'inputs' of configuration
+entry (see BJTConfigs, FETConfigs and MOSFETConfigs). Tokens can be
+separated by spaces, tabs or commas. Empty lines and lines starting
+with '#' are skipped. Examples:
+
+   fb dc 12 240e3 2.2e3 50
+   vd ac bypassed 22 56e3 8.2e3 6.8e3 1.5e3 90 50e3
+   e vd dc 40 22e6 18e6 3e3 0.82e3 3e-3 10 5
+
+Consecutive jobs of same configuration are collected into columns and
+evaluated by the batch function of configuration, so one process can
+run millions of jobs. Results are written in 'text' (default), 'csv'
+or 'bin' format of COLUMNS.h, a new section is started whenever
+configuration changes. Wrong lines are reported to stderr and skipped.
+Jobs with parameters out of their domains (see STATUS.h) are reported
+too, but they do not stop their batch and their results are NaN.
+*/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CONFIG.h"
+#include "COLUMNS.h"
+#include "STATUS.h"
+
+// Number of jobs that is evaluated by a batch call.
+#define JOB_BATCH 4096
+// Size of stdio buffers of job input and output.
+#define JOB_BUFFER (1 << 20)
+
+// A table of configurations which can be selected by jobs.
+struct JobTable {
+   char* type; // type token of table, NULL if program has one table
+   struct Config* configs;
+   int count;
+};
+
+// Jobs that are collected but not evaluated yet.
+struct JobBatch {
+   struct Config* config; // configuration of collected jobs
+   struct Config* printed; // configuration of last results header
+   long n; // number of collected jobs
+   real* inputs[CONFIG_COLUMNS];
+   real* outputs[CONFIG_COLUMNS];
+   struct ColumnWriter* writer; // writer of results
+   long lines[JOB_BATCH]; // line numbers of collected jobs
+   unsigned char status[JOB_BATCH]; // status of evaluated jobs
+};
+
+static struct Config* _parse_job_(char* line, struct JobTable* tables,
+                                  int ntables, real* values) {
+   // Parse configuration and parameters of a job line. NULL is
+   // returned if the line is wrong.
+   char* rest;
+   char* token = strtok_r(line, " \t\r\n,", &rest);
+   struct JobTable* table = &tables[0];
+   if (tables[0].type) {
+      for (table = NULL; token && !table && ntables-- > 0; tables++)
+         if (strcmp(tables->type, token) == 0) table = tables;
+      if (!table) return NULL;
+      token = strtok_r(NULL, " \t\r\n,", &rest);
+   }
+   char* name = token;
+   char* analysis = strtok_r(NULL, " \t\r\n,", &rest);
+   if (!name || !analysis) return NULL;
+   struct Config* config = _find_config_(table->configs, table->count,
+                                         name, analysis, NULL);
+   if (config && config->option) {
+      char* option = strtok_r(NULL, " \t\r\n,", &rest);
+      if (!option) return NULL;
+      config = _find_config_(table->configs, table->count, name,
+                             analysis, option);
+   }
+   if (!config) return NULL;
+   for (int c = 0; c < config->nin; c++) {
+      char* end;
+      token = strtok_r(NULL, " \t\r\n,", &rest);
+      if (!token) return NULL;
+      values[c] = strtod(token, &end);
+      if (*end) return NULL;
+   }
+   return strtok_r(NULL, " \t\r\n,", &rest) ? NULL : config;
+}
+
+static void _flush_jobs_(struct JobBatch* batch) {
+   // Evaluate collected jobs and write their results.
+   struct Config* config = batch->config;
+   if (batch->n == 0) return;
+   if (run_checked(config, batch->n, batch->inputs, batch->outputs,
+                   batch->status) > 0)
+      for (long i = 0; i < batch->n; i++)
+         if (batch->status[i] == STATUS_INVALID)
+            fprintf(stderr, "Invalid parameters at line %ld !!!\n",
+                    batch->lines[i]);
+   if (batch->printed != config) {
+      char name[64];
+      snprintf(name, sizeof(name), "%s %s %s%s%s", config->family,
+               config->name, config->analysis, config->option ? " " : "",
+               config->option ? config->option : "");
+      end_columns(batch->writer);
+      begin_columns(batch->writer, name, config->nout, config->outputs);
+      batch->printed = config;
+   }
+   write_columns(batch->writer, batch->n, batch->outputs);
+   batch->n = 0;
+}
+
+long run_jobs(FILE* in, FILE* out, int format, struct JobTable* tables,
+              int ntables) {
+   // Run all jobs of 'in' and write results into 'out' in 'format'
+   // (see COLUMNS.h). Number of wrong lines is returned, -1 if memory
+   // is not enough or results can not be written.
+   setvbuf(in, NULL, _IOFBF, JOB_BUFFER);
+   setvbuf(out, NULL, _IOFBF, JOB_BUFFER);
+   struct ColumnWriter writer = {out, format, sizeof(real), 0, 0};
+   struct JobBatch batch = {NULL, NULL, 0, {NULL}, {NULL}, &writer};
+   real values[CONFIG_COLUMNS];
+   char* line = NULL;
+   size_t size = 0;
+   long number = 0, errors = 0;
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      batch.inputs[c] = malloc(JOB_BATCH * sizeof(real));
+      batch.outputs[c] = malloc(JOB_BATCH * sizeof(real));
+      if (!batch.inputs[c] || !batch.outputs[c]) errors = -1;
+   }
+   while (errors >= 0 && getline(&line, &size, in) != -1) {
+      number++;
+      char* first = line + strspn(line, " \t\r\n,");
+      if (*first == '\0' || *first == '#') continue;
+      struct Config* config = _parse_job_(line, tables, ntables, values);
+      if (!config) {
+         fprintf(stderr, "Wrong job at line %ld !!!\n", number);
+         errors++;
+         continue;
+      }
+      if (config != batch.config) _flush_jobs_(&batch);
+      batch.config = config;
+      for (int c = 0; c < config->nin; c++)
+         batch.inputs[c][batch.n] = values[c];
+      batch.lines[batch.n] = number;
+      if (++batch.n == JOB_BATCH) _flush_jobs_(&batch);
+   }
+   if (errors >= 0) _flush_jobs_(&batch);
+   if (end_columns(&writer)) errors = -1;
+   free(line);
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      free(batch.inputs[c]); free(batch.outputs[c]);
+   }
+   return errors;
+}
+
+int run_job_file(char* path, char* format, struct JobTable* tables,
+                 int ntables) {
+   // Run jobs of file at 'path' ('-' or NULL for stdin) and write
+   // results to stdout in 'format' ("text", "csv" or "bin"). Returns
+   // the exit status of program.
+   FILE* in = stdin;
+   if (_columns_format_(format) < 0) {
+      fprintf(stderr, "Can not found '%s' format !!!\n", format);
+      return 1;
+   }
+   if (path && strcmp(path, "-")) in = fopen(path, "r");
+   if (!in) {
+      fprintf(stderr, "Can not open job file '%s' !!!\n", path);
+      return 1;
+   }
+   long errors = run_jobs(in, stdout, _columns_format_(format), tables,
+                          ntables);
+   if (in != stdin) fclose(in);
+   return errors != 0;
+}
+
+#endif
@@ -0,0 +1,194 @@
+/* Monte Carlo Tolerance Analysis
+
+Parameters of a configuration (resistors, beta, Idss, Vp, Id(on),
+Vgs(th), ...) are perturbed around their nominal values and the
+configuration is evaluated for every trial. Tolerances are relative:
+a uniform parameter is in [nominal(1 - tol), nominal(1 + tol)] and
+a gaussian parameter has sigma of nominal*tol/3 (tol is 3 sigma).
+
+Random numbers come from the counter-based Philox4x32-10 generator.
+The counter of a trial is its index and the key is the seed, so each
+trial has its own stream. Results do not depend on the number of
+threads or on which thread runs a trial, and threads do not share
+any generator state.
+*/
+
+#ifndef MONTE_H
+#define MONTE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include "CONFIG.h"
+#include "SWEEP.h"
+
+// Distributions, struct MonteCarlo and struct MonteStats are in
+// transistor.h. Percentiles which are reported for every result column
+// ('monte_percentiles' of the library is defined in transistor.c).
+static real monte_ranks[MONTE_PERCENTILES] = {MONTE_RANKS};
+
+static void _philox_(uint32_t counter[4], uint32_t key[2],
+                     uint32_t out[4]) {
+   // Philox4x32 with 10 rounds.
+   uint32_t c0 = counter[0], c1 = counter[1];
+   uint32_t c2 = counter[2], c3 = counter[3];
+   uint32_t k0 = key[0], k1 = key[1];
+   for (int round = 0; round < 10; round++) {
+      uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+      uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+      uint32_t hi0 = p0 >> 32, lo0 = (uint32_t) p0;
+      uint32_t hi1 = p1 >> 32, lo1 = (uint32_t) p1;
+      c0 = hi1 ^ c1 ^ k0; c1 = lo1;
+      c2 = hi0 ^ c3 ^ k1; c3 = lo0;
+      k0 += 0x9E3779B9; k1 += 0xBB67AE85;
+   }
+   out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+#if PRECISION_DOUBLE
+// Random words of a uniform number.
+#define MONTE_WORDS 2
+
+static real _uniform_(uint32_t* x) {
+   // Map 53 bits of two random words to (0, 1).
+   uint64_t bits = (uint64_t) x[0] << 21 | x[1] >> 11;
+   return (bits + 0.5) * (1.0 / 9007199254740992.0);
+}
+#else
+#define MONTE_WORDS 1
+
+static real _uniform_(uint32_t* x) {
+   // Map 24 bits of a random word to (0, 1).
+   return ((*x >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+#endif
+
+static void _monte_inputs_(struct MonteCarlo* mc, long begin, long n,
+                           real** inputs) {
+   // Write perturbed parameters of trials [begin, begin + n).
+   uint32_t key[2] = {(uint32_t) mc->seed, (uint32_t) (mc->seed >> 32)};
+   uint32_t random[4];
+   for (long j = 0; j < n; j++) {
+      uint64_t trial = begin + j;
+      for (int c = 0; c < mc->config->nin; c++) {
+         // Every call gives 4 random words, two uniform numbers of
+         // each of 2 / MONTE_WORDS parameters.
+         int shared = 2 / MONTE_WORDS;
+         if (c % shared == 0) {
+            uint32_t counter[4] = {(uint32_t) trial,
+                                   (uint32_t) (trial >> 32), c / shared,
+                                   0};
+            _philox_(counter, key, random);
+         }
+         uint32_t* words = random + 2 * MONTE_WORDS * (c % shared);
+         real u1 = _uniform_(words);
+         real u2 = _uniform_(words + MONTE_WORDS);
+         real scale = 0;
+         if (mc->distributions[c] == MONTE_UNIFORM)
+            scale = mc->tolerances[c] * (2 * u1 - 1);
+         else if (mc->distributions[c] == MONTE_GAUSSIAN)
+            scale = mc->tolerances[c] / 3 * real_sqrt(-2 * real_log(u1)) *
+                    real_cos((real) 6.28318530717958648 * u2);
+         inputs[c][j] = mc->nominal[c] * (1 + scale);
+      }
+   }
+}
+
+// Context of a Monte Carlo run which is shared by its threads.
+struct MonteContext {
+   struct MonteCarlo* mc;
+   real** results;
+   real** inputs; // SWEEP_CHUNK values of each parameter per thread
+};
+
+static void _monte_task_(long begin, long end, int thread, void* context) {
+   // Evaluate a chunk of trials directly into the result columns.
+   struct MonteContext* monte = context;
+   struct Config* config = monte->mc->config;
+   real** inputs = monte->inputs + thread * CONFIG_COLUMNS;
+   real* outputs[CONFIG_COLUMNS];
+   for (int c = 0; c < config->nout; c++)
+      outputs[c] = monte->results[c] + begin;
+   _monte_inputs_(monte->mc, begin, end - begin, inputs);
+   config->batch(end - begin, inputs, outputs);
+}
+
+static int _compare_reals_(const void* a, const void* b) {
+   real x = *(const real*) a, y = *(const real*) b;
+   return (x > y) - (x < y);
+}
+
+static void _monte_stats_(real* column, long n, real* sorted,
+                          struct MonteStats* stats) {
+   // Find statistics of a column, NaN results are skipped.
+   long count = 0;
+   double sum = 0, squares = 0;
+   for (long i = 0; i < n; i++) {
+      if (isnan(column[i])) continue;
+      sorted[count++] = column[i];
+      sum += column[i];
+   }
+   stats->count = count;
+   stats->mean = count ? sum / count : NAN;
+   for (long i = 0; i < count; i++)
+      squares += (sorted[i] - stats->mean) * (sorted[i] - stats->mean);
+   stats->sigma = count > 1 ? sqrt(squares / (count - 1)) : 0;
+   qsort(sorted, count, sizeof(real), _compare_reals_);
+   stats->min = count ? sorted[0] : NAN;
+   stats->max = count ? sorted[count - 1] : NAN;
+   for (int p = 0; p < MONTE_PERCENTILES; p++) {
+      // Percentiles are interpolated between nearest ranks.
+      double rank = monte_ranks[p] / 100 * (count - 1);
+      long low = (long) rank;
+      long high = low + 1 < count ? low + 1 : low;
+      stats->percentiles[p] = count ? sorted[low] + (rank - low) *
+                              (sorted[high] - sorted[low]) : NAN;
+   }
+}
+
+int run_monte_carlo(struct MonteCarlo* mc, int threads, real** results,
+                    struct MonteStats* stats) {
+   // Run all trials on 'threads' threads (all cores if it is zero).
+   // Results of trials are written into 'results' columns if they
+   // are given. 'stats' gets statistics of every result column.
+   // -1 is returned if memory is not enough.
+   struct Config* config = mc->config;
+   threads = _sweep_threads_(threads);
+   real* columns[CONFIG_COLUMNS] = {NULL};
+   real** inputs = calloc(threads * CONFIG_COLUMNS, sizeof(real*));
+   int status = inputs ? 0 : -1;
+   for (int c = 0; status == 0 && c < config->nout; c++) {
+      columns[c] = results ? results[c] :
+                   malloc(mc->trials * sizeof(real));
+      if (!columns[c]) status = -1;
+   }
+   for (int t = 0; status == 0 && t < threads; t++)
+      for (int c = 0; c < config->nin; c++)
+         if (!(inputs[t * CONFIG_COLUMNS + c] =
+               malloc(SWEEP_CHUNK * sizeof(real)))) status = -1;
+   struct MonteContext context = {mc, columns, inputs};
+   if (status == 0)
+      status = _schedule_(mc->trials, threads, _monte_task_, &context);
+   real* sorted = status == 0 ? malloc(mc->trials * sizeof(real))
+                               : NULL;
+   if (!sorted) status = -1;
+   for (int c = 0; status == 0 && c < config->nout; c++)
+      _monte_stats_(columns[c], mc->trials, sorted, &stats[c]);
+   free(sorted);
+   for (int t = 0; inputs && t < threads * CONFIG_COLUMNS; t++)
+      free(inputs[t]);
+   free(inputs);
+   for (int c = 0; !results && c < config->nout; c++) free(columns[c]);
+   return status;
+}
+
+real monte_yield(real* column, long n, real low, real high) {
+   // Find fraction of trials whose result is in [low, high].
+   long passed = 0;
+   for (long i = 0; i < n; i++)
+      passed += column[i] >= low && column[i] <= high;
+   return n ? (real) passed / n : 0;
+}
+
+#endif
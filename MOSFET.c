@@ -2,7 +2,9 @@
 
 I've started this project for making easier the transistor and 
 related operations. The important point is that all transistors are
-'npn' types. But, can be derivated easily 'pnp' implementations. 
+'n-channel' types. 'p-channel' ones are their mirror images (opposite
+signs of voltages and currents) and are evaluated by same functions,
+see 'POLARITY.h'.
 This package contains mostly used configuration and some special
 connections. In specially, this source code contains e-type mosfet
 analyzes. Because, JFET and D-MOSFET analyzes are same things. 
@@ -16,93 +18,139 @@ Boylestad and Louis Nashelsky
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
-#include <math.h>
-#include "FET.h"
+#include "MOSFET.h"
+#include "JOBS.h"
+#include "DECK.h"
+#include "OPTIMIZE.h"
 
-// Results of DC Analysis
-struct DCMOSFET {
-   float k; // k constant
-   float Id; // drain current
-   float Vgs; // gate-source voltage
-   float Vds; // drain-source voltage
-};
-// Results of AC Analysis
-struct ACMOSFET {
-   float gm; // transconductance factor
-   float Zi; // input impedance
-   float Zo; // output impedance
-   float Av; // voltage gain
-   char* phase; // phase relationship
-};
+/* Inputs and results of D-MOSFETs, which are same as JFETs */
+void _display_transistors_(char* analysis, char* transistor) {
+   // Display the all transistors.
+   puts("TRANSISTOR:");
+   puts("--> 'fb' for fixed-bias config.");
+   puts("--> 'sb' for self-bias config.");
+   puts("--> 'vd' for voltage-divider config.");
+   puts("--> 'cg' for common-gate config.");
+   if (strcmp(analysis, "dc"))
+      puts("--> 'sf' for source-follower config.");
+   printf("Transistor type: "); scanf("%s", &(*transistor));
+   puts("--------------------------------------------");
+}
 
-// For all DC configuration:
-struct DCMOSFET DCMOSFET;
-// For all AC configuration:
-struct ACMOSFET ACMOSFET;
+void _fixed_bias_inputs_(char* analysis, float* Vdd, float* Vgg, 
+                        float* Rg, float* Rd, float* Idss, 
+                        float* Vp, float* rd) {
+   // Get inputs of fixed-bias configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Vgg (V): "); scanf("%f", &(*Vgg));
+   if (strcmp(analysis, "dc")) {
+      printf("Rg (ohm): "); scanf("%f", &(*Rg));
+   }
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
 
-/* The DC and AC Analysis of Drain-Feedback Configuration */
-void m_drain_feedback(char* analysis, float Vdd, float Rg, float Rd, 
-                    float Idon, float Vgson, float Vgsth, float rd) {
-   // Check if the parameters are correct.
-   assert (Rg > 0 && Rd > 0 && rd > 0);
-   // These results are required for both analysis type.
-   float k = Idon / ((Vgson - Vgsth) * (Vgson - Vgsth));
-   float a = Rd * Rd * k;
-   float b = 2 * k * Rd * (Vgsth - Vdd) - 1;
-   float c = k * (Vgsth -Vdd) * (Vgsth - Vdd);
-   // Can be used dicriminant for finding right 'Id'.
-   float Id = _select_right_Id_(a, b, c); // drain current
-   float Vgs = Vdd - Id * Rd; // gate-source voltage
-   // DC Analysis:
-   float Vds = Vgs; // drain-source voltage
-   // AC Analysis:
-   float gm = 2 * k * (Vgs - Vgsth); // gm factor
-   float Zi1 = Rg + _parallel_(rd, Rd);
-   float Zi2 = 1 + gm * _parallel_(rd, Rd); 
-   float Zi = Zi1 / Zi2; // input impedance
-   float Zo = _parallel_(Rg, _parallel_(rd, Rd)); // output impedance
-   // voltage gain
-   float Av = -1 * gm * _parallel_(Rg, _parallel_(rd, Rd)); 
-   // Save the results.
-   if (strcmp(analysis, "ac")) {
-      DCMOSFET.k = k; DCMOSFET.Id = Id; DCMOSFET.Vgs = Vgs;
-      DCMOSFET.Vds = Vds;
-   } else {
-      ACMOSFET.gm = gm; ACMOSFET.Zi = Zi; ACMOSFET.Zo = Zo;
-      ACMOSFET.Av = Av; ACMOSFET.phase = "Out of phase";
+void _self_bias_inputs_(char* analysis, float* Vdd, float* Rg, 
+                        float* Rd, float* Rs, float* Idss, 
+                        float* Vp, float* rd) {
+   // Get inputs of self-bias configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   if (strcmp(analysis, "dc")) {
+      printf("Rg (ohm): "); scanf("%f", &(*Rg));
    }
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
 }
 
-/* The DC and AC Analysis of Voltage-Divider Configuration */
-void m_voltage_divider(char* analysis, float Vdd, float Rg1, 
-                       float Rg2, float Rd, float Rs, float Idon, 
-                       float Vgson, float Vgsth, float rd) {
-   // Check if the parameters are correct.
-   assert (Rg1 > 0 && Rg1 > 0 && Rd > 0 && Rs > 0 && rd > 0);
-   // These results are required for both analysis type.
-   float k = Idon / ((Vgson - Vgsth) * (Vgson - Vgsth));
-   float Vg = Rg2 * Vdd / (Rg1 + Rg2);
-   float a = Rs * Rs * k;
-   float b = -2 * k * Rs * (Vg - Vgsth) - 1;
-   float c = k * (Vgsth - Vg) * (Vgsth - Vg);
-   // Can be used dicriminant for finding right 'Id'.
-   float Id = _select_right_Id_(a, b, c); // drain current
-   float Vgs = Vg - Id * Rs; // gate-source voltage
-   // DC Analysis:
-   float Vds = Vdd - Id * (Rs + Rd);
-   // AC Analysis:
-   float gm = 2 * k * (Vgs - Vgsth); // gm factor
-   float Zi = _parallel_(Rg1, Rg2); // input impedance
-   float Zo = _parallel_(rd, Rd); // output impedance
-   float Av = -1 * gm * Zo; // voltage gain
-   // Save the results.
-   if (strcmp(analysis, "ac")) {
-      DCMOSFET.k = k; DCMOSFET.Id = Id; DCMOSFET.Vgs = Vgs;
-      DCMOSFET.Vds = Vds;
-   } else {
-      ACMOSFET.gm = gm; ACMOSFET.Zi = Zi; ACMOSFET.Zo = Zo;
-      ACMOSFET.Av = Av; ACMOSFET.phase = "Out of phase";
+void _voltage_divider_inputs_(char* analysis, float* Vdd, float* Rg1, 
+                              float* Rg2, float* Rd, float* Rs, 
+                              float* Idss, float* Vp, float* rd) {
+   // Get inputs of voltage-divider configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Upper Rg (ohm): "); scanf("%f", &(*Rg1));
+   printf("Lower Rg (ohm): "); scanf("%f", &(*Rg2));
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
    }
+   puts("Calculating results...");
+   puts("--------------------------------------------");
+}
+
+void _common_gate_inputs_(char* analysis, float* Vdd, float* Vss, 
+                          float* Rd, float* Rs, float* Idss, 
+                          float* Vp, float* rd) {
+   // Get inputs of common-gate configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Vss (V): "); scanf("%f", &(*Vss));
+   printf("Rd (ohm): "); scanf("%f", &(*Rd));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   if (strcmp(analysis, "dc")) {
+      printf("rd (ohm): "); scanf("%f", &(*rd));
+   }
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
+
+void _source_follower_inputs_(char* analysis, float* Vdd, float* Vgs,
+                              float* Rg, float* Rs, float* Idss, 
+                              float* Vp, float* rd) {
+   // Get inputs of source-follower configuration.
+   puts("PARAMETERS: ");
+   printf("Vdd (V): "); scanf("%f", &(*Vdd));
+   printf("Vgs (V): "); scanf("%f", &(*Vgs));
+   printf("Rg (ohm): "); scanf("%f", &(*Rg));
+   printf("Rs (ohm): "); scanf("%f", &(*Rs));
+   printf("Idss (A): "); scanf("%f", &(*Idss));
+   printf("Vp (V): "); scanf("%f", &(*Vp));
+   printf("rd (ohm): "); scanf("%f", &(*rd));
+   puts("Calculating results ...");
+   puts("--------------------------------------------");
+}
+
+void _display_dc_results_(struct DCFET* dc) {
+   // Display the DC results.
+   puts("RESULTS: ");
+   printf("Id: %f A\n", dc->Id);
+   printf("Vds: %f A\n", dc->Vds);
+   printf("Vgs: %f A\n", dc->Vgs);
+   printf("Vs: %f V\n", dc->Vs);
+   printf("Vd: %f A\n", dc->Vd);
+   printf("Vg: %f V\n", dc->Vg);
+   puts("--------------------------------------------");
+}
+
+void _display_ac_results_(struct ACFET* ac) {
+   // Display the AC results.
+   puts("RESULTS: ");
+   printf("gm: %f S\n", ac->gm);
+   printf("Zi: %f ohm\n", ac->Zi);
+   printf("Zo: %f ohm\n", ac->Zo);
+   printf("Av: %f\n", ac->Av);
+   printf("Phase: %s\n", ac->phase);
+   puts("--------------------------------------------");
 }
 
 void _m_display_transistor(char* analysis, char* transistor) {
@@ -161,16 +209,38 @@ void _m_voltage_divider_inputs_(char* analysis, float* Vdd,
    puts("----------------------------------------------");
 }
 
-int main(void) {
+int main(int argc, char* argv[]) {
    // 'mosfet' argument represents type of mosfet transistor.
    char mosfet;
    // 'analysis' argument represents the type of analysis.
-   char analysis[2];
+   char analysis[3];
    // 'transistor' argument represents type of transistor.
-   char transistor[2];
+   char transistor[4];
    // These arguments represent the values of a transistor. 
    float Vdd, Vgg, Rd, Idss, Vp, Rs, Vss, Rg1, Rg2, rd, Vgs;
    float Idon, Vgson, Vgsth;
+   // Results of the analysis.
+   struct DCFET dc = {0};
+   struct ACFET ac = {0};
+   struct DCMOSFET mdc;
+   struct ACMOSFET mac;
+
+   // Read jobs from a file or stdin, a deck or a design instead of
+   // prompts.
+   if (argc > 1 && (strcmp(argv[1], "-j") == 0 ||
+                    strcmp(argv[1], "-d") == 0 ||
+                    strcmp(argv[1], "-o") == 0)) {
+      struct JobTable tables[] = {{"d", FETConfigs, FETConfigCount},
+                                  {"e", MOSFETConfigs,
+                                   MOSFETConfigCount}};
+      char* format = argc > 3 ? argv[3] : "text";
+      if (strcmp(argv[1], "-d") == 0)
+         return argc > 2 ? run_deck_file(argv[2], format, tables, 2) : 1;
+      if (strcmp(argv[1], "-o") == 0)
+         return run_design_file(argc > 2 ? argv[2] : "-", format, tables,
+                                2);
+      return run_job_file(argc > 2 ? argv[2] : "-", format, tables, 2);
+   }
 
    puts("----------------------------------------------");
    puts("  WELLCOME TO ANALYSIS OF MOSFET TRANSISTORS  ");
@@ -195,18 +265,18 @@ int main(void) {
          // Get inputs of fixed-bias config.
          _fixed_bias_inputs_("dc", &Vdd, &Vgg, 1, &Rd, &Idss, &Vp, 1);
          // Calculate the results of fixed-bias config.
-         fixed_bias("dc", Vdd, Vgg, 1, Rd, Idss, Vp, 1);
+         f_fixed_bias("dc", Vdd, Vgg, 1, Rd, Idss, Vp, 1, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       // For Self-Bias Configuration:
       else if (strcmp(transistor, "sb") == 0) {
          // Get inputs of self-bias config.
          _self_bias_inputs_("dc", &Vdd, 1, &Rd, &Rs, &Idss, &Vp, 1);
          // Calculate the results of self-bias config.
-         self_bias("dc", Vdd, 1, Rd, Rs, Idss, Vp, 1);
+         f_self_bias("dc", Vdd, 1, Rd, Rs, Idss, Vp, 1, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -214,9 +284,10 @@ int main(void) {
          _voltage_divider_inputs_("dc", &Vdd, &Rg1, &Rg2, &Rd, &Rs, 
                                   &Idss, &Vp, 1);
          // Calculate the results of voltage-divider config.
-         voltage_divider("dc", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, 1);
+         f_voltage_divider("dc", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, 1, 
+                           &dc, &ac);
          // Display the results of voltage-divider config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       // For Common-Gate Configuration:
       else if (strcmp(transistor, "cg") == 0) {
@@ -224,9 +295,9 @@ int main(void) {
          _common_gate_inputs_("dc", &Vdd, &Vss, &Rd, &Rs, &Idss, 
                                &Vp, 1);
          // Calculate the results of common-gate config.
-         common_gate("dc", Vdd, Vss, Rd, Rs, Idss, Vp, 1);
+         f_common_gate("dc", Vdd, Vss, Rd, Rs, Idss, Vp, 1, &dc, &ac);
          // Display the results of common-gate config.
-         _display_dc_results_();
+         _display_dc_results_(&dc);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -240,9 +311,9 @@ int main(void) {
          _fixed_bias_inputs_("ac", &Vdd, &Vgg, &Rg1, &Rd, &Idss, 
                              &Vp, &rd);
          // Calculate the results of fixed-bias config.
-         fixed_bias("ac", Vdd, Vgg, Rg1, Rd, Idss, Vp, rd);
+         f_fixed_bias("ac", Vdd, Vgg, Rg1, Rd, Idss, Vp, rd, &dc, &ac);
          // Display the results of fixed-bias config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Self-Bias Configuration:
       else if (strcmp(transistor, "sb") == 0) {
@@ -250,9 +321,9 @@ int main(void) {
          _self_bias_inputs_("ac", &Vdd, &Rg1, &Rd, &Rs, &Idss, 
                             &Vp, &rd);
          // Calculate the results of self-bias config.
-         self_bias("ac", Vdd, Rg1, Rd, Rs, Idss, Vp, rd);
+         f_self_bias("ac", Vdd, Rg1, Rd, Rs, Idss, Vp, rd, &dc, &ac);
          // Display the results of self-bias config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -260,9 +331,10 @@ int main(void) {
          _voltage_divider_inputs_("ac", &Vdd, &Rg1, &Rg2, &Rd, &Rs, 
                                   &Idss, &Vp, &rd);
          // Calculate the results of voltage-divider config.
-         voltage_divider("ac", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, rd);
+         f_voltage_divider("ac", Vdd, Rg1, Rg2, Rd, Rs, Idss, Vp, rd, 
+                           &dc, &ac);
          // Display the results of voltage-divider config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Common-Gate Configuration:
       else if (strcmp(transistor, "cg") == 0) {
@@ -270,9 +342,9 @@ int main(void) {
          _common_gate_inputs_("ac", &Vdd, &Vss, &Rd, &Rs, &Idss, 
                               &Vp, &rd);
          // Calculate the results of common-gate config.
-         common_gate("ac", Vdd, Vss, Rd, Rs, Idss, Vp, rd);
+         f_common_gate("ac", Vdd, Vss, Rd, Rs, Idss, Vp, rd, &dc, &ac);
          // Display the results of common-gate config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       // For Self-Follower Configuration:
       else if (strcmp(transistor, "sf") == 0) {
@@ -280,9 +352,10 @@ int main(void) {
          _source_follower_inputs_("ac", &Vdd, &Vgs, &Rg1, &Rs, 
                                   &Idss, &Vp, &rd);
          // Calculate the results of self-follower config.
-         source_follower("ac", Vdd, Vgs, Rg1, Rs, Idss, Vp, rd);
+         f_source_follower("ac", Vdd, Vgs, Rg1, Rs, Idss, Vp, rd, 
+                           &dc, &ac);
          // Display the results of self-follower config.
-         _display_ac_results_();
+         _display_ac_results_(&ac);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -297,12 +370,13 @@ int main(void) {
          _m_drain_feedback_inputs_("dc", &Vdd, &Rg1, &Rd, &Idon, 
                                    &Vgson, &Vgsth, 1);
          // Calculate the results of drain-feedback config.
-         m_drain_feedback("dc", Vdd, Rg1, Rd, Idon, Vgson, Vgsth, 1);
+         m_drain_feedback("dc", Vdd, Rg1, Rd, Idon, Vgson, Vgsth, 1,
+                          &mdc, &mac);
          // Display the results of drain-feedback config.
-         printf("k: %f (A/V^2)\n", DCMOSFET.k);
-         printf("Id: %f (A)\n", DCMOSFET.Id);
-         printf("Vgs: %f (V)\n", DCMOSFET.Vgs);
-         printf("Vds: %f (V)\n", DCMOSFET.Vds);
+         printf("k: %f (A/V^2)\n", mdc.k);
+         printf("Id: %f (A)\n", mdc.Id);
+         printf("Vgs: %f (V)\n", mdc.Vgs);
+         printf("Vds: %f (V)\n", mdc.Vds);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -311,12 +385,12 @@ int main(void) {
                                     &Idon, &Vgson, &Vgsth, 1);
          // Calculate the results of voltage-divider config.
          m_voltage_divider("dc", Vdd, Rg1, Rg2, Rd, Rs, Idon, Vgson,
-                           Vgsth, 1);
+                           Vgsth, 1, &mdc, &mac);
          // Display the results of voltage-divider config.
-         printf("k: %f (A/V^2)\n", DCMOSFET.k);
-         printf("Id: %f (A)\n", DCMOSFET.Id);
-         printf("Vgs: %f (V)\n", DCMOSFET.Vgs);
-         printf("Vds: %f (V)\n", DCMOSFET.Vds);
+         printf("k: %f (A/V^2)\n", mdc.k);
+         printf("Id: %f (A)\n", mdc.Id);
+         printf("Vgs: %f (V)\n", mdc.Vgs);
+         printf("Vds: %f (V)\n", mdc.Vds);
       }
       else puts("Can not found that transistor !!!");
    }
@@ -331,13 +405,14 @@ int main(void) {
          _m_drain_feedback_inputs_("ac", &Vdd, &Rg1, &Rd, &Idon, 
                                    &Vgson, &Vgsth, &rd);
          // Calculate the results of drain-feedback config.
-         m_drain_feedback("ac", Vdd, Rg1, Rd, Idon, Vgson, Vgsth, rd);
+         m_drain_feedback("ac", Vdd, Rg1, Rd, Idon, Vgson, Vgsth, rd,
+                          &mdc, &mac);
          // Display the results of drain-feedback config.
-         printf("gm: %f (S)\n", ACMOSFET.gm);
-         printf("Zi: %f (ohm)\n", ACMOSFET.Zi);
-         printf("Zo: %f (ohm)\n", ACMOSFET.Zo);
-         printf("Av: %f (V)\n", ACMOSFET.Av);
-         printf("Phase: %s\n", ACMOSFET.phase);
+         printf("gm: %f (S)\n", mac.gm);
+         printf("Zi: %f (ohm)\n", mac.Zi);
+         printf("Zo: %f (ohm)\n", mac.Zo);
+         printf("Av: %f (V)\n", mac.Av);
+         printf("Phase: %s\n", mac.phase);
       }
       // For Voltage-Divider Configuration:
       else if (strcmp(transistor, "vd") == 0) {
@@ -346,13 +421,13 @@ int main(void) {
                                     &Idon, &Vgson, &Vgsth, &rd);
          // Calculate the results of voltage-divider config.
          m_voltage_divider("ac", Vdd, Rg1, Rg2, Rd, Rs, Idon, Vgson,
-                           Vgsth, rd);
+                           Vgsth, rd, &mdc, &mac);
          // Display the results of voltage-divider config.
-         printf("gm: %f (S)\n", ACMOSFET.gm);
-         printf("Zi: %f (ohm)\n", ACMOSFET.Zi);
-         printf("Zo: %f (ohm)\n", ACMOSFET.Zo);
-         printf("Av: %f (V)\n", ACMOSFET.Av);
-         printf("Phase: %s\n", ACMOSFET.phase);
+         printf("gm: %f (S)\n", mac.gm);
+         printf("Zi: %f (ohm)\n", mac.Zi);
+         printf("Zo: %f (ohm)\n", mac.Zo);
+         printf("Av: %f (V)\n", mac.Av);
+         printf("Phase: %s\n", mac.phase);
       }
       else puts("Can not found that transistor !!!");
    }
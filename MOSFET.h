@@ -0,0 +1,536 @@
+/* Basics E-Type MOSFET Operations and Calculations */
+
+#ifndef MOSFET_H
+#define MOSFET_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "FET.h"
+#include "CONFIG.h"
+
+// Configuration functions save the results into 'DCMOSFET' or 
+// 'ACMOSFET' struct (transistor.h) given by the caller (only the ones
+// of requested analysis are written). So, they can run concurrently.
+
+static void _m_status_(int analysis, int status, struct DCMOSFET* dc,
+                       struct ACMOSFET* ac) {
+   // Save status of point into results of 'analysis' like the one of
+   // BJTs ('_b_status_').
+   int nan = status == STATUS_INVALID || status == STATUS_UNSUPPORTED;
+   if (analysis & ANALYSIS_DC) {
+      if (nan) {
+         dc->k = NAN; dc->Id = NAN; dc->Vgs = NAN; dc->Vds = NAN;
+         dc->region = REGION_INVALID;
+      }
+      dc->status = status;
+   }
+   if (analysis & ANALYSIS_AC) {
+      if (nan) {
+         ac->gm = NAN; ac->Zi = NAN; ac->Zo = NAN; ac->Av = NAN;
+      }
+      ac->status = status;
+   }
+}
+
+static int _m_finite_(int analysis, struct DCMOSFET* dc,
+                      struct ACMOSFET* ac) {
+   // 1 if all results of 'analysis' are finite.
+   if (analysis & ANALYSIS_DC)
+      return isfinite(dc->k) && isfinite(dc->Id) && isfinite(dc->Vgs) &&
+             isfinite(dc->Vds);
+   return isfinite(ac->gm) && isfinite(ac->Zi) && isfinite(ac->Zo) &&
+          isfinite(ac->Av);
+}
+
+static void _m_check_(int analysis, int dc_valid, int ac_valid,
+                      struct DCMOSFET* dc, struct ACMOSFET* ac) {
+   // Save status of DC and AC stages like the one of BJTs
+   // ('_b_check_').
+   int dc_status = !dc_valid ? STATUS_INVALID :
+                   (analysis & ANALYSIS_DC) &&
+                   !_m_finite_(ANALYSIS_DC, dc, ac) ? STATUS_NONFINITE :
+                   STATUS_OK;
+   int ac_status = !ac_valid ? STATUS_INVALID :
+                   (analysis & ANALYSIS_AC) &&
+                   !_m_finite_(ANALYSIS_AC, dc, ac) ? STATUS_NONFINITE :
+                   STATUS_OK;
+   _m_status_(analysis & ANALYSIS_DC, dc_status, dc, ac);
+   _m_status_(analysis & ANALYSIS_AC, ac_status, dc, ac);
+}
+
+KERNEL real _m_k_(real Idon, real Vgson, real Vgsth) {
+   // Constant k of the square law through the point (Vgson, Idon).
+   return Idon / ((Vgson - Vgsth) * (Vgson - Vgsth));
+}
+
+/* The DC and AC Analysis of Drain-Feedback Configuration */
+KERNEL void _m_drain_feedback_(const int analysis, const int checked,
+                               real Vdd, real Rg, real Rd, real Idon,
+                               real Vgson, real Vgsth, real rd, real* op,
+                               struct DCMOSFET* dc, struct ACMOSFET* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Idon) &
+                  _status_valid_(STATUS_FINITE, Vgson) &
+                  _status_valid_(STATUS_FINITE, Vgsth);
+   int ac_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_POSITIVE, Rg) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Idon) &
+                  _status_valid_(STATUS_FINITE, Vgson) &
+                  _status_valid_(STATUS_FINITE, Vgsth) &
+                  _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real k = _m_k_(Idon, Vgson, Vgsth);
+      // The gate is at the drain, so Id solves the square law with
+      // Vg = Vdd and Rd in place of Rs. It is 0 in cut-off (Vdd is not
+      // above Vgsth), then Vgs = Vds = Vdd.
+      real Id = analysis & FET_GIVEN_ID ? op[0] :
+                _drain_Id_(FET_SQUARE_LAW, k, Vgsth, Rd, Vdd);
+      real Vgs = Vdd - Id * Rd; // gate-source voltage
+      op[0] = Id; op[1] = k; op[2] = Vgs;
+   }
+   real Id = op[0], k = op[1], Vgs = op[2];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Vds = Vgs; // drain-source voltage
+      dc->k = k; dc->Id = Id; dc->Vgs = Vgs; dc->Vds = Vds;
+      dc->region = _fet_region_(Vgs, Vds, Vgsth); // operating region
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = 2 * k * real_fmax(Vgs - Vgsth, 0); // gm factor
+      real Zi1 = Rg + _parallel_(rd, Rd);
+      real Zi2 = 1 + gm * _parallel_(rd, Rd); 
+      real Zi = Zi1 / Zi2; // input impedance
+      real Zo = _parallel_(Rg, _parallel_(rd, Rd)); // output impedance
+      // voltage gain
+      real Av = -1 * gm * _parallel_(Rg, _parallel_(rd, Rd)); 
+      ac->gm = gm; ac->Zi = Zi; ac->Zo = Zo; ac->Av = Av; 
+      ac->phase = "Out of phase";
+   }
+   if (checked) _m_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void m_drain_feedback(char* analysis, real Vdd, real Rg, real Rd,
+                      real Idon, real Vgson, real Vgsth, real rd,
+                      struct DCMOSFET* dc, struct ACMOSFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _m_drain_feedback_, 1, Vdd, Rg,
+                     Rd, Idon, Vgson, Vgsth, rd, op, dc, ac);
+}
+
+/* The DC and AC Analysis of Voltage-Divider Configuration */
+KERNEL void _m_voltage_divider_(const int analysis, const int checked,
+                                real Vdd, real Rg1, real Rg2, real Rd,
+                                real Rs, real Idon, real Vgson, real Vgsth,
+                                real rd, real* op, struct DCMOSFET* dc,
+                                struct ACMOSFET* ac) {
+   // Check if the parameters of each stage are in their domains.
+   int dc_valid = _status_valid_(STATUS_FINITE, Vdd) &
+                  _status_valid_(STATUS_POSITIVE, Rg1) &
+                  _status_valid_(STATUS_POSITIVE, Rg2) &
+                  _status_valid_(STATUS_POSITIVE, Rd) &
+                  _status_valid_(STATUS_POSITIVE, Rs) &
+                  _status_valid_(STATUS_POSITIVE, Idon) &
+                  _status_valid_(STATUS_FINITE, Vgson) &
+                  _status_valid_(STATUS_FINITE, Vgsth);
+   int ac_valid = dc_valid & _status_valid_(STATUS_POSITIVE, rd);
+   // Operating point which is shared by DC and AC stages.
+   if (analysis & ANALYSIS_OP) {
+      real k = _m_k_(Idon, Vgson, Vgsth);
+      real Vg = _divider_Vg_(Vdd, Rg1, Rg2); // gate voltage
+      // Drain current, 0 in cut-off (Vg is not above Vgsth).
+      real Id = analysis & FET_GIVEN_ID ? op[0] :
+                _drain_Id_(FET_SQUARE_LAW, k, Vgsth, Rs, Vg);
+      real Vgs = Vg - Id * Rs; // gate-source voltage
+      op[0] = Id; op[1] = k; op[2] = Vgs;
+   }
+   real Id = op[0], k = op[1], Vgs = op[2];
+   // DC stage:
+   if (analysis & ANALYSIS_DC) {
+      real Vds = Vdd - Id * (Rs + Rd);
+      dc->k = k; dc->Id = Id; dc->Vgs = Vgs; dc->Vds = Vds;
+      dc->region = _fet_region_(Vgs, Vds, Vgsth); // operating region
+   }
+   // AC stage:
+   if (analysis & ANALYSIS_AC) {
+      real gm = 2 * k * real_fmax(Vgs - Vgsth, 0); // gm factor
+      real Zi = _parallel_(Rg1, Rg2); // input impedance
+      real Zo = _parallel_(rd, Rd); // output impedance
+      real Av = -1 * gm * Zo; // voltage gain
+      ac->gm = gm; ac->Zi = Zi; ac->Zo = Zo; ac->Av = Av; 
+      ac->phase = "Out of phase";
+   }
+   if (checked) _m_check_(analysis, dc_valid, ac_valid, dc, ac);
+}
+
+void m_voltage_divider(char* analysis, real Vdd, real Rg1, real Rg2,
+                       real Rd, real Rs, real Idon, real Vgson,
+                       real Vgsth, real rd, struct DCMOSFET* dc,
+                       struct ACMOSFET* ac) {
+   // Run the kernel specialized for analysis.
+   real op[MODEL_OP]; // operating point
+   ANALYSIS_DISPATCH(_analysis_(analysis), _m_voltage_divider_, 1, Vdd,
+                     Rg1, Rg2, Rd, Rs, Idon, Vgson, Vgsth, rd, op, dc, ac);
+}
+
+/* Batch Analysis of E-Type MOSFET Configurations
+
+Batch functions evaluate 'n' operating points in one call like the
+ones in 'FET.h'. The square law k * (Vgs - Vgsth)^2 is the Shockley
+equation with Idss = k * Vgsth^2 and Vp = Vgsth, so the quadratic of
+all points is solved by '_square_law_Id_batch_', the vectorized
+Shockley kernel specialized to take k directly.
+*/
+
+KERNEL void _m_save_dc_batch_(struct DCMOSFETBatch* dc, long i,
+                              struct DCMOSFET* point) {
+   // Save DC results of i'th point into 'dc' columns.
+   dc->k[i] = point->k; dc->Id[i] = point->Id; dc->Vgs[i] = point->Vgs;
+   dc->Vds[i] = point->Vds;
+}
+
+KERNEL void _m_save_ac_batch_(struct ACMOSFETBatch* ac, long i,
+                              struct ACMOSFET* point) {
+   // Save AC results of i'th point into 'ac' columns.
+   ac->gm[i] = point->gm; ac->Zi[i] = point->Zi; ac->Zo[i] = point->Zo;
+   ac->Av[i] = point->Av;
+}
+
+// Batch loops run the stages of the configuration kernels point by
+// point without status like the ones of FET.h, after the drain
+// currents of a chunk are solved (FET_GIVEN_ID).
+
+/* The Batch DC Analysis of Drain-Feedback Configuration */
+void m_drain_feedback_dc_batch(long n, real* Vdd, real* Rd,
+                               real* Idon, real* Vgson,
+                               real* Vgsth, struct DCMOSFETBatch* dc) {
+   real k[FET_CHUNK], Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      for (long j = 0, i = i0; j < m; j++, i++)
+         k[j] = _m_k_(Idon[i], Vgson[i], Vgsth[i]);
+      _square_law_Id_batch_(m, k, Vgsth + i0, Rd + i0, Vdd + i0, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct DCMOSFET point; real op[MODEL_OP] = {Id[j]};
+         _m_drain_feedback_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_DC, 0,
+                            Vdd[i], 0, Rd[i], Idon[i], Vgson[i], Vgsth[i],
+                            0, op, &point, NULL);
+         _m_save_dc_batch_(dc, i, &point);
+      }
+   }
+}
+
+/* The Batch AC Analysis of Drain-Feedback Configuration */
+void m_drain_feedback_ac_batch(long n, real* Vdd, real* Rg, real* Rd,
+                               real* Idon, real* Vgson, real* Vgsth,
+                               real* rd, struct ACMOSFETBatch* ac) {
+   real k[FET_CHUNK], Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      for (long j = 0, i = i0; j < m; j++, i++)
+         k[j] = _m_k_(Idon[i], Vgson[i], Vgsth[i]);
+      _square_law_Id_batch_(m, k, Vgsth + i0, Rd + i0, Vdd + i0, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct ACMOSFET point; real op[MODEL_OP] = {Id[j]};
+         _m_drain_feedback_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_AC, 0,
+                            Vdd[i], Rg[i], Rd[i], Idon[i], Vgson[i],
+                            Vgsth[i], rd[i], op, NULL, &point);
+         _m_save_ac_batch_(ac, i, &point);
+      }
+   }
+}
+
+/* The Batch DC Analysis of Voltage-Divider Configuration */
+void m_voltage_divider_dc_batch(long n, real* Vdd, real* Rg1,
+                                real* Rg2, real* Rd, real* Rs,
+                                real* Idon, real* Vgson,
+                                real* Vgsth, struct DCMOSFETBatch* dc) {
+   real k[FET_CHUNK], Vg[FET_CHUNK], Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         k[j] = _m_k_(Idon[i], Vgson[i], Vgsth[i]);
+         Vg[j] = _divider_Vg_(Vdd[i], Rg1[i], Rg2[i]);
+      }
+      _square_law_Id_batch_(m, k, Vgsth + i0, Rs + i0, Vg, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct DCMOSFET point; real op[MODEL_OP] = {Id[j]};
+         _m_voltage_divider_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_DC, 0,
+                             Vdd[i], Rg1[i], Rg2[i], Rd[i], Rs[i], Idon[i],
+                             Vgson[i], Vgsth[i], 0, op, &point, NULL);
+         _m_save_dc_batch_(dc, i, &point);
+      }
+   }
+}
+
+/* The Batch AC Analysis of Voltage-Divider Configuration */
+void m_voltage_divider_ac_batch(long n, real* Vdd, real* Rg1,
+                                real* Rg2, real* Rd, real* Rs,
+                                real* Idon, real* Vgson,
+                                real* Vgsth, real* rd,
+                                struct ACMOSFETBatch* ac) {
+   real k[FET_CHUNK], Vg[FET_CHUNK], Id[FET_CHUNK];
+   for (long i0 = 0; i0 < n; i0 += FET_CHUNK) {
+      long m = (n - i0 < FET_CHUNK) ? n - i0 : FET_CHUNK;
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         k[j] = _m_k_(Idon[i], Vgson[i], Vgsth[i]);
+         Vg[j] = _divider_Vg_(Vdd[i], Rg1[i], Rg2[i]);
+      }
+      _square_law_Id_batch_(m, k, Vgsth + i0, Rs + i0, Vg, Id);
+      for (long j = 0, i = i0; j < m; j++, i++) {
+         struct ACMOSFET point; real op[MODEL_OP] = {Id[j]};
+         _m_voltage_divider_(ANALYSIS_OP | FET_GIVEN_ID | ANALYSIS_AC, 0,
+                             Vdd[i], Rg1[i], Rg2[i], Rd[i], Rs[i], Idon[i],
+                             Vgson[i], Vgsth[i], rd[i], op, NULL, &point);
+         _m_save_ac_batch_(ac, i, &point);
+      }
+   }
+}
+
+/* Sensitivities of E-Type MOSFET Configurations
+
+Dual kernels like the ones of FET.h, results are written in order of
+result columns of 'MOSFETConfigs'.
+*/
+
+KERNEL void _m_save_duals_(struct Dual* r, struct Dual r0, struct Dual r1,
+                           struct Dual r2, struct Dual r3) {
+   r[0] = r0; r[1] = r1; r[2] = r2; r[3] = r3;
+}
+
+KERNEL struct Dual _m_k_dual_(struct Dual Idon, struct Dual Vgson,
+                              struct Dual Vgsth) {
+   // k constant
+   struct Dual Von = _d_sub_(Vgson, Vgsth);
+   return _d_div_(Idon, _d_mul_(Von, Von));
+}
+
+KERNEL struct Dual _m_gm_dual_(struct Dual k, struct Dual Vgs,
+                               struct Dual Vgsth) {
+   // gm factor, zero in cut-off
+   struct Dual on = _d_sub_(Vgs, Vgsth);
+   return on.v < 0 ? _d_(0) : _d_scale_(_d_mul_(k, on), 2);
+}
+
+KERNEL void _m_drain_feedback_dual_(const int analysis, struct Dual Vdd,
+                                    struct Dual Rg, struct Dual Rd,
+                                    struct Dual Idon, struct Dual Vgson,
+                                    struct Dual Vgsth, struct Dual rd,
+                                    struct Dual* dc, struct Dual* ac) {
+   struct Dual k = _m_k_dual_(Idon, Vgson, Vgsth);
+   // drain current
+   struct Dual Id = _d_drain_Id_(FET_SQUARE_LAW, k, Vgsth, Rd, Vdd);
+   struct Dual Vgs = _d_sub_(Vdd, _d_mul_(Id, Rd)); // gate-source v.
+   if (analysis & ANALYSIS_DC) _m_save_duals_(dc, k, Id, Vgs, Vgs);
+   if (analysis & ANALYSIS_AC) {
+      struct Dual gm = _m_gm_dual_(k, Vgs, Vgsth); // gm factor
+      struct Dual rdRd = _d_parallel_(rd, Rd);
+      struct Dual Zi = _d_div_(_d_add_(Rg, rdRd), _d_shift_(_d_mul_(gm,
+                               rdRd), 1)); // input impedance
+      struct Dual Zo = _d_parallel_(Rg, rdRd); // output impedance
+      _m_save_duals_(ac, gm, Zi, Zo, _d_scale_(_d_mul_(gm, Zo), -1));
+   }
+}
+
+KERNEL void _m_voltage_divider_dual_(const int analysis, struct Dual Vdd,
+                                     struct Dual Rg1, struct Dual Rg2,
+                                     struct Dual Rd, struct Dual Rs,
+                                     struct Dual Idon, struct Dual Vgson,
+                                     struct Dual Vgsth, struct Dual rd,
+                                     struct Dual* dc, struct Dual* ac) {
+   struct Dual k = _m_k_dual_(Idon, Vgson, Vgsth);
+   // gate voltage
+   struct Dual Vg = _d_div_(_d_mul_(Rg2, Vdd), _d_add_(Rg1, Rg2));
+   // drain current
+   struct Dual Id = _d_drain_Id_(FET_SQUARE_LAW, k, Vgsth, Rs, Vg);
+   struct Dual Vgs = _d_sub_(Vg, _d_mul_(Id, Rs)); // gate-source v.
+   if (analysis & ANALYSIS_DC) {
+      // drain-source voltage
+      struct Dual Vds = _d_sub_(Vdd, _d_mul_(Id, _d_add_(Rs, Rd)));
+      _m_save_duals_(dc, k, Id, Vgs, Vds);
+   }
+   if (analysis & ANALYSIS_AC) {
+      struct Dual gm = _m_gm_dual_(k, Vgs, Vgsth); // gm factor
+      struct Dual Zi = _d_parallel_(Rg1, Rg2); // input impedance
+      struct Dual Zo = _d_parallel_(rd, Rd); // output impedance
+      _m_save_duals_(ac, gm, Zi, Zo, _d_scale_(_d_mul_(gm, Zo), -1));
+   }
+}
+
+// Jacobian functions of 'MOSFETConfigs' entries.
+
+static void _m_df_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[5], dc[4];
+   _d_inputs_(5, in, p);
+   _m_drain_feedback_dual_(ANALYSIS_DC, p[0], _d_(1), p[1], p[2], p[3],
+                           p[4], _d_(1), dc, NULL);
+   _d_outputs_(4, 5, dc, out, jacobian);
+}
+static void _m_df_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[7], ac[4];
+   _d_inputs_(7, in, p);
+   _m_drain_feedback_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                           p[5], p[6], NULL, ac);
+   _d_outputs_(4, 7, ac, out, jacobian);
+}
+static void _m_vd_dc_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[8], dc[4];
+   _d_inputs_(8, in, p);
+   _m_voltage_divider_dual_(ANALYSIS_DC, p[0], p[1], p[2], p[3], p[4],
+                            p[5], p[6], p[7], _d_(1), dc, NULL);
+   _d_outputs_(4, 8, dc, out, jacobian);
+}
+static void _m_vd_ac_jacobian_(real* in, real* out, real* jacobian) {
+   struct Dual p[9], ac[4];
+   _d_inputs_(9, in, p);
+   _m_voltage_divider_dual_(ANALYSIS_AC, p[0], p[1], p[2], p[3], p[4],
+                            p[5], p[6], p[7], p[8], NULL, ac);
+   _d_outputs_(4, 9, ac, out, jacobian);
+}
+
+/* Configuration Table of E-Type MOSFET Batch Functions */
+
+static struct DCMOSFETBatch _m_dc_columns_(real** out) {
+   // Wrap result columns into 'DCMOSFETBatch' struct.
+   return (struct DCMOSFETBatch) {out[0], out[1], out[2], out[3]};
+}
+
+static struct ACMOSFETBatch _m_ac_columns_(real** out) {
+   // Wrap result columns into 'ACMOSFETBatch' struct.
+   return (struct ACMOSFETBatch) {out[0], out[1], out[2], out[3]};
+}
+
+static void _m_df_dc_(long n, real** in, real** out) {
+   struct DCMOSFETBatch dc = _m_dc_columns_(out);
+   m_drain_feedback_dc_batch(n, in[0], in[1], in[2], in[3], in[4], &dc);
+}
+static void _m_df_ac_(long n, real** in, real** out) {
+   struct ACMOSFETBatch ac = _m_ac_columns_(out);
+   m_drain_feedback_ac_batch(n, in[0], in[1], in[2], in[3], in[4], in[5],
+                             in[6], &ac);
+}
+static void _m_vd_dc_(long n, real** in, real** out) {
+   struct DCMOSFETBatch dc = _m_dc_columns_(out);
+   m_voltage_divider_dc_batch(n, in[0], in[1], in[2], in[3], in[4],
+                              in[5], in[6], in[7], &dc);
+}
+static void _m_vd_ac_(long n, real** in, real** out) {
+   struct ACMOSFETBatch ac = _m_ac_columns_(out);
+   m_voltage_divider_ac_batch(n, in[0], in[1], in[2], in[3], in[4],
+                              in[5], in[6], in[7], in[8], &ac);
+}
+
+// Results and networks of "newton" entries (see '_drain_batch_').
+
+static void _m_dc_drain_(struct DrainBlock* b, real (*r)[NEWTON_BLOCK]) {
+   // MOSFET_DC_RESULTS of a solved block.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      r[0][k] = b->P[k]; r[1][k] = b->Id[k];
+      r[2][k] = b->Vgs0[k] - b->Rgs[k] * b->Id[k];
+      r[3][k] = b->Vds0[k] - b->Rds[k] * b->Id[k];
+   }
+}
+
+static void _m_df_network_(real (*p)[NEWTON_BLOCK], struct DrainBlock* b) {
+   // Vdd Rd Idon Vgson Vgsth lambda, the gate is at the drain.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Von = p[3][k] - p[4][k];
+      _drain_network_(b, k, p[2][k] / (Von * Von), p[4][k], p[5][k],
+                      p[0][k], p[1][k], p[0][k], p[1][k], p[0][k]);
+   }
+}
+
+static void _m_vd_network_(real (*p)[NEWTON_BLOCK], struct DrainBlock* b) {
+   // Vdd Rg1 Rg2 Rd Rs Idon Vgson Vgsth lambda
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Von = p[6][k] - p[7][k];
+      real Vg = p[2][k] * p[0][k] / (p[1][k] + p[2][k]);
+      _drain_network_(b, k, p[5][k] / (Von * Von), p[7][k], p[8][k], Vg,
+                      p[4][k], p[0][k], p[3][k] + p[4][k], Vg);
+   }
+}
+
+static void _m_df_newton_(long n, real** in, real** out) {
+   _drain_batch_(FET_SQUARE_LAW, _m_df_network_, _m_dc_drain_, 6, 4, n,
+                 in, out);
+}
+static void _m_vd_newton_(long n, real** in, real** out) {
+   _drain_batch_(FET_SQUARE_LAW, _m_vd_network_, _m_dc_drain_, 9, 4, n,
+                 in, out);
+}
+
+#define MOSFET_DC_RESULTS 4, {"k", "Id", "Vgs", "Vds"}, "+---"
+#define MOSFET_AC_RESULTS 4, {"gm", "Zi", "Zo", "Av"}, "++++"
+
+// Frequency response of E-type MOSFET configurations (see BODE.h).
+struct BodeModel MOSFETBodeModels[] = {
+   {"mosfet", "df", NULL, BODE_INVERTING, 7, -1, -1, _m_df_ac_},
+   {"mosfet", "vd", NULL, BODE_INVERTING, 9, 4, -1, _m_vd_ac_},
+};
+int MOSFETBodeModelCount =
+   sizeof(MOSFETBodeModels) / sizeof(MOSFETBodeModels[0]);
+
+BODE_ENTRY(_m_df_bode_, MOSFETBodeModels[0])
+BODE_ENTRY(_m_vd_bode_, MOSFETBodeModels[1])
+
+// All E-type MOSFET configurations which have batch functions.
+struct Config MOSFETConfigs[] = {
+   {"mosfet", "df", "dc", NULL, 5, {"Vdd", "Rd", "Idon", "Vgson", "Vgsth"},
+    "-++--", MOSFET_DC_RESULTS, _m_df_dc_, _m_df_dc_jacobian_},
+   {"mosfet", "df", "newton", NULL, 6, {"Vdd", "Rd", "Idon", "Vgson",
+    "Vgsth", "lambda"}, "-++--+", MOSFET_DC_RESULTS, _m_df_newton_},
+   {"mosfet", "df", "ac", NULL, 7, {"Vdd", "Rg", "Rd", "Idon", "Vgson",
+    "Vgsth", "rd"}, "-+++--+", MOSFET_AC_RESULTS, _m_df_ac_,
+    _m_df_ac_jacobian_},
+   {"mosfet", "df", "bode", NULL, 13, {"Vdd", "Rg", "Rd", "Idon", "Vgson",
+    "Vgsth", "rd", BODE_INPUTS, "Cgs", "Cgd"}, "-+++--+" BODE_SIGNS "++",
+    BODE_RESULTS, _m_df_bode_},
+   {"mosfet", "vd", "dc", NULL, 8, {"Vdd", "Rg1", "Rg2", "Rd", "Rs", "Idon",
+    "Vgson", "Vgsth"}, "-+++++--", MOSFET_DC_RESULTS, _m_vd_dc_,
+    _m_vd_dc_jacobian_},
+   {"mosfet", "vd", "newton", NULL, 9, {"Vdd", "Rg1", "Rg2", "Rd", "Rs",
+    "Idon", "Vgson", "Vgsth", "lambda"}, "-+++++--+", MOSFET_DC_RESULTS,
+    _m_vd_newton_},
+   {"mosfet", "vd", "ac", NULL, 9, {"Vdd", "Rg1", "Rg2", "Rd", "Rs", "Idon",
+    "Vgson", "Vgsth", "rd"}, "-+++++--+", MOSFET_AC_RESULTS, _m_vd_ac_,
+    _m_vd_ac_jacobian_},
+   {"mosfet", "vd", "bode", NULL, 16, {"Vdd", "Rg1", "Rg2", "Rd", "Rs",
+    "Idon", "Vgson", "Vgsth", "rd", BODE_INPUTS, "Cs", "Cgs", "Cgd"},
+    "-+++++--+" BODE_SIGNS "+++", BODE_RESULTS, _m_vd_bode_},
+};
+int MOSFETConfigCount = sizeof(MOSFETConfigs) / sizeof(MOSFETConfigs[0]);
+
+/* Models of E-Type MOSFET Configurations (see INCREMENTAL.h) */
+
+static void _m_df_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _m_drain_feedback_, 1, p[0], p[1], p[2], p[3],
+                  p[4], p[5], p[6], op, dc, ac);
+}
+
+static void _m_vd_model_(int stages, real* p, real* op, void* dc,
+                         void* ac) {
+   STAGE_DISPATCH(stages, _m_voltage_divider_, 1, p[0], p[1], p[2],
+                  p[3], p[4], p[5], p[6], p[7], p[8], op, dc, ac);
+}
+
+// All E-type MOSFET configurations with parameters of operating
+// point, DC stage and AC stage.
+struct Model MOSFETModels[] = {
+   {"mosfet", "df", NULL, "both", 7, {"Vdd", "Rg", "Rd", "Idon", "Vgson",
+    "Vgsth", "rd"}, "Vdd Rd Idon Vgson Vgsth", "", "Rg Rd Vgsth rd",
+    _m_df_model_},
+   {"mosfet", "vd", NULL, "both", 9, {"Vdd", "Rg1", "Rg2", "Rd", "Rs",
+    "Idon", "Vgson", "Vgsth", "rd"}, "Vdd Rg1 Rg2 Rs Idon Vgson Vgsth",
+    "Vdd Rd Rs", "Rg1 Rg2 Rd Vgsth rd", _m_vd_model_},
+};
+int MOSFETModelCount = sizeof(MOSFETModels) / sizeof(MOSFETModels[0]);
+
+#endif
@@ -0,0 +1,362 @@
+/* Nonlinear DC Analysis
+
+The closed-form DC analysis of BJTs takes Vbe as a constant. The
+"newton" entries of BJTs solve the bias network with the exponential
+junctions of the Gummel-Poon model (Ebers-Moll when IKF is zero)
+instead:
+
+   Icc = Is (exp(Vbe/VT) - 1),   Iec = Is (exp(Vbc/VT) - 1)
+   qb  = (1 + sqrt(1 + 4 Icc/IKF)) / 2   (high injection)
+   Ic  = (Icc - Iec) / qb - Iec / BR,   Ib = Icc / beta + Iec / BR
+
+Every configuration is reduced to two linear loops of its network in
+terms of Ib and Ic (see '_b_fb_loops_' and others of BJT.h):
+
+   base loop:      Vb - Vbe - Rbb Ib - Rbc Ic = 0
+   collector loop: Vce = Vc - Rcb Ib - Rcc Ic,   Vbc = Vbe - Vce
+
+The two equations are solved for Vbe and Vbc by Newton-Raphson, so
+saturation and cut-off come out of the same solve as the active
+region. qb is taken one Newton step of its own quadratic in every
+iteration, so no square root is needed.
+
+Points are solved in blocks of NEWTON_BLOCK lanes (structure of
+arrays). Every iteration runs all lanes of a block; a lane that has
+converged is masked and keeps its values, and the block stops when
+all lanes have converged. The start is the closed-form answer: Vbe
+which gives its collector current, and Vbc of its Vce. A lane in
+cut-off starts without currents (Vbe = Vb, Vce = Vc). A rise of a
+junction voltage is limited to NEWTON_STEP per iteration, so exp()
+does not overflow far from the solution. exp() is a polynomial with
+the exponent built from bits, so the loops are vectorized (an AVX2
+and an AVX-512 copy are selected at runtime). Results of lanes that
+have not converged in NEWTON_ITERATIONS are NaN. "newton" entries of
+FETs solve the drain current with channel-length modulation (see
+'_drain_solve_' below).
+*/
+
+#ifndef NEWTON_H
+#define NEWTON_H
+
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include "CONFIG.h"
+
+// Points of a block of kernels.
+#define NEWTON_BLOCK 64
+// Largest number of iterations of a block.
+#define NEWTON_ITERATIONS 64
+// Largest rise of a junction voltage in an iteration and largest
+// junction voltage (V).
+#define NEWTON_STEP ((real) 0.1)
+#define NEWTON_VMAX ((real) 1.5)
+// A lane has converged when its steps are smaller than this (V) and
+// qb or Id change by less than this part. Rounding of residuals of supplies
+// of 20 V is a few uV in single precision.
+#if PRECISION_DOUBLE
+#define NEWTON_TOL 1e-10
+#else
+#define NEWTON_TOL 1e-5f
+#endif
+
+// Device parameters of "newton" entries after the ones of the DC
+// entry: saturation current, forward knee current (0 for none) and
+// reverse beta. They are magnitudes of the device, so they keep their
+// signs for p-type devices (see POLARITY.h).
+#define NEWTON_INPUTS "Is", "IKF", "BR"
+#define NEWTON_SIGNS "+++"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NEWTON_SIMD 1
+#else
+#define NEWTON_SIMD 0
+#endif
+
+// Loops of the network and state of the solve of a block of points.
+struct NewtonBlock {
+   real Vb[NEWTON_BLOCK], Rbb[NEWTON_BLOCK], Rbc[NEWTON_BLOCK];
+   real Vc[NEWTON_BLOCK], Rcb[NEWTON_BLOCK], Rcc[NEWTON_BLOCK];
+   // Emitter voltage is Ve0 + Re Ie.
+   real Re[NEWTON_BLOCK], Ve0[NEWTON_BLOCK];
+   real Icsat[NEWTON_BLOCK]; // collector saturation current
+   real BF[NEWTON_BLOCK], Is[NEWTON_BLOCK], BR[NEWTON_BLOCK];
+   real gK[NEWTON_BLOCK]; // 1 / IKF, zero without high injection
+   real Vbe[NEWTON_BLOCK], Vbc[NEWTON_BLOCK], qb[NEWTON_BLOCK];
+   int done[NEWTON_BLOCK]; // lane has converged
+};
+
+KERNEL void _newton_loops_(struct NewtonBlock* b, int k, real Vb,
+                           real Rbb, real Rbc, real Vc, real Rcb,
+                           real Rcc, real Re, real Ve0, real Icsat,
+                           real beta) {
+   // Save loops of k'th lane.
+   b->Vb[k] = Vb; b->Rbb[k] = Rbb; b->Rbc[k] = Rbc;
+   b->Vc[k] = Vc; b->Rcb[k] = Rcb; b->Rcc[k] = Rcc;
+   b->Re[k] = Re; b->Ve0[k] = Ve0; b->Icsat[k] = Icsat;
+   b->BF[k] = beta;
+}
+
+#if PRECISION_DOUBLE
+typedef int64_t newton_bits;
+#define NEWTON_MANTISSA 52
+#define NEWTON_BIAS 1023
+#define NEWTON_ROUND 6755399441055744.0 // 1.5 * 2^52
+#else
+typedef int32_t newton_bits;
+#define NEWTON_MANTISSA 23
+#define NEWTON_BIAS 127
+#define NEWTON_ROUND 12582912.0f // 1.5 * 2^23
+#endif
+
+KERNEL real _newton_exp_(real x) {
+   // exp(x) = 2^k exp(r) with |r| <= ln(2) / 2, k is rounded by adding
+   // and subtracting NEWTON_ROUND. The exponent is clamped, so exp of
+   // a large negative x is nearly zero.
+   real kd = (x * (real) 1.44269504088896341 + NEWTON_ROUND) -
+             NEWTON_ROUND;
+   real r = x - kd * (real) 0.693147180559945309;
+   real p = (real) (1 / 5040.0);
+#if PRECISION_DOUBLE
+   p = (real) (1 / 479001600.0);
+   p = p * r + (real) (1 / 39916800.0);
+   p = p * r + (real) (1 / 3628800.0);
+   p = p * r + (real) (1 / 362880.0);
+   p = p * r + (real) (1 / 40320.0);
+   p = p * r + (real) (1 / 5040.0);
+#endif
+   p = p * r + (real) (1 / 720.0);
+   p = p * r + (real) (1 / 120.0);
+   p = p * r + (real) (1 / 24.0);
+   p = p * r + (real) (1 / 6.0);
+   p = p * r + (real) 0.5;
+   p = p * r + 1;
+   p = p * r + 1;
+   // Clamp before the cast, which is undefined for NaN or a huge kd. A
+   // NaN goes to the lower bound, but 'p' is NaN already.
+   real kc = kd > 1 - NEWTON_BIAS ? kd : 1 - NEWTON_BIAS;
+   kc = kc < NEWTON_BIAS ? kc : NEWTON_BIAS;
+   int32_t k = (int32_t) kc;
+   union { newton_bits i; real r; } scale = {
+      (newton_bits) (k + NEWTON_BIAS) << NEWTON_MANTISSA};
+   return p * scale.r;
+}
+
+KERNEL void _newton_start_(struct NewtonBlock* b, real VT, real Vbe) {
+   // Closed-form answer with constant 'Vbe' as the start of lanes.
+   // Currents of a lane in cut-off are clamped at zero, a negative Ib
+   // would give Vce above Vc.
+   real Ic[NEWTON_BLOCK], Vce[NEWTON_BLOCK];
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Ib = (b->Vb[k] - Vbe) / (b->Rbb[k] + b->BF[k] * b->Rbc[k]);
+      Ib = Ib > 0 ? Ib : 0;
+      Ic[k] = b->BF[k] * Ib;
+      Vce[k] = b->Vc[k] - b->Rcb[k] * Ib - b->Rcc[k] * Ic[k];
+   }
+   // Vbe of the collector current, a lane in cut-off starts at Vb
+   // (and Vce at Vc), the solution without currents.
+   for (int k = 0; k < NEWTON_BLOCK; k++)
+      b->Vbe[k] = Ic[k] > 0 ? VT * real_log(Ic[k] / b->Is[k] + 1)
+                            : b->Vb[k];
+   // A saturated lane starts with Vce of NEWTON_STEP.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Vbc = b->Vbe[k] - Vce[k], limit = b->Vbe[k] - NEWTON_STEP;
+      b->Vbc[k] = Vbc < limit ? Vbc : limit;
+      b->qb[k] = 1;
+      b->done[k] = 0;
+   }
+}
+
+KERNEL void _newton_solve_(struct NewtonBlock* b, real VT, real Vbe,
+                           real (*out)[NEWTON_BLOCK]) {
+   // Solve lanes of block and write BJT_DC_RESULTS columns into 'out'.
+   real d1[NEWTON_BLOCK], d2[NEWTON_BLOCK], q[NEWTON_BLOCK];
+   real Ib[NEWTON_BLOCK], Ic[NEWTON_BLOCK];
+   real x1[NEWTON_BLOCK], x2[NEWTON_BLOCK];
+   real iVT = 1 / VT;
+   _newton_start_(b, VT, Vbe);
+   for (int iteration = 0; iteration < NEWTON_ITERATIONS; iteration++) {
+      // Newton steps of all lanes (masked lanes too, they are not
+      // used).
+      for (int k = 0; k < NEWTON_BLOCK; k++) {
+         real e1 = _newton_exp_(b->Vbe[k] * iVT);
+         real e2 = _newton_exp_(b->Vbc[k] * iVT);
+         real Icc = b->Is[k] * (e1 - 1), Iec = b->Is[k] * (e2 - 1);
+         real gcc = b->Is[k] * e1 * iVT, gec = b->Is[k] * e2 * iVT;
+         // One step of qb^2 - qb - Icc/IKF = 0 and its derivative.
+         real qb = b->qb[k];
+         q[k] = (qb * qb + Icc * b->gK[k]) / (2 * qb - 1);
+         real dq = b->gK[k] / (2 * q[k] - 1), iq = 1 / q[k];
+         real iBR = 1 / b->BR[k], Iy = Icc - Iec;
+         Ic[k] = Iy * iq - Iec * iBR;
+         Ib[k] = Icc / b->BF[k] + Iec * iBR;
+         real dIc1 = gcc * (iq - Iy * iq * iq * dq);
+         real dIc2 = -gec * (iq + iBR);
+         real dIb1 = gcc / b->BF[k], dIb2 = gec * iBR;
+         // Residuals of the loops and their Jacobian.
+         real F1 = b->Vb[k] - b->Vbe[k] - b->Rbb[k] * Ib[k] -
+                   b->Rbc[k] * Ic[k];
+         real F2 = b->Vc[k] - b->Rcb[k] * Ib[k] - b->Rcc[k] * Ic[k] -
+                   b->Vbe[k] + b->Vbc[k];
+         real J11 = -1 - b->Rbb[k] * dIb1 - b->Rbc[k] * dIc1;
+         real J12 = -b->Rbb[k] * dIb2 - b->Rbc[k] * dIc2;
+         real J21 = -1 - b->Rcb[k] * dIb1 - b->Rcc[k] * dIc1;
+         real J22 = 1 - b->Rcb[k] * dIb2 - b->Rcc[k] * dIc2;
+         real det = J11 * J22 - J12 * J21;
+         d1[k] = (F2 * J12 - F1 * J22) / det;
+         d2[k] = (F1 * J21 - F2 * J11) / det;
+         x1[k] = b->Vbe[k] + NEWTON_STEP;
+         x2[k] = b->Vbc[k] + NEWTON_STEP;
+      }
+      // Limited update of lanes that have not converged.
+      int active = 0;
+      for (int k = 0; k < NEWTON_BLOCK; k++) {
+         real Vbe1 = b->Vbe[k] + d1[k], Vbc1 = b->Vbc[k] + d2[k];
+         int small = (real_fabs(d1[k]) < NEWTON_TOL) &
+                     (real_fabs(d2[k]) < NEWTON_TOL) &
+                     (real_fabs(q[k] - b->qb[k]) < NEWTON_TOL * q[k]);
+         Vbe1 = Vbe1 > x1[k] ? x1[k] : Vbe1;
+         Vbe1 = Vbe1 > NEWTON_VMAX ? NEWTON_VMAX : Vbe1;
+         Vbc1 = Vbc1 > x2[k] ? x2[k] : Vbc1;
+         Vbc1 = Vbc1 > NEWTON_VMAX ? NEWTON_VMAX : Vbc1;
+         b->Vbe[k] = b->done[k] ? b->Vbe[k] : Vbe1;
+         b->Vbc[k] = b->done[k] ? b->Vbc[k] : Vbc1;
+         b->qb[k] = b->done[k] ? b->qb[k] : q[k];
+         b->done[k] |= small;
+         active += !b->done[k];
+      }
+      if (!active) break;
+   }
+   // Results at the solution, the currents are of the last step. NaN
+   // is added to the results of lanes that have not converged.
+   real nan[NEWTON_BLOCK], r[9][NEWTON_BLOCK];
+   for (int k = 0; k < NEWTON_BLOCK; k++)
+      nan[k] = b->done[k] ? 0 : NAN;
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Ie = Ib[k] + Ic[k];
+      real Ve = b->Ve0[k] + b->Re[k] * Ie;
+      real Vce = b->Vc[k] - b->Rcb[k] * Ib[k] - b->Rcc[k] * Ic[k];
+      r[0][k] = Ib[k] + nan[k]; r[1][k] = Ic[k] + nan[k];
+      r[2][k] = Ie + nan[k]; r[3][k] = b->Icsat[k] + nan[k];
+      r[4][k] = Vce + nan[k]; r[5][k] = Vce + Ve + nan[k];
+      r[6][k] = Ve + nan[k]; r[7][k] = b->Vbe[k] + Ve + nan[k];
+      r[8][k] = b->Vbe[k] - Vce + nan[k];
+   }
+   memcpy(out, r, sizeof(r));
+}
+
+static long _newton_gather_(int nin, long i, long n, real** in,
+                            real (*p)[NEWTON_BLOCK]) {
+   // Copy rows [i, i + NEWTON_BLOCK) of 'nin' columns into 'p'. Rows
+   // after the last point repeat it. The number of points is returned.
+   long m = n - i < NEWTON_BLOCK ? n - i : NEWTON_BLOCK;
+   for (int c = 0; c < nin; c++) {
+      memcpy(p[c], in[c] + i, m * sizeof(real));
+      for (long k = m; k < NEWTON_BLOCK; k++) p[c][k] = p[c][m - 1];
+   }
+   return m;
+}
+
+/* Drain Current with Channel-Length Modulation
+
+The square laws of FETs (see '_drain_Id_' of FET.h) with
+channel-length modulation
+
+   Id = u (Vgs - V)^2 (1 + lambda Vds)
+
+are solved with the linear bias network of a configuration:
+
+   Vgs = Vgs0 - Rgs Id,   Vds = Vds0 - Rds Id
+
+It is a cubic of Id. f(Id) = u (Vgs - V)^2 (1 + lambda Vds) - Id
+decreases from f(0) >= 0 until Vgs reaches V, so the right root is
+the only one in [0, Imax], Imax is the smaller of the current where
+Vgs is V and the current at Vgs0 and Vds0. A lane starts at the root
+of the quadratic without lambda, which is near, so blocks converge
+in three to five iterations. The bracket is narrowed by
+the sign of f in every iteration and a step which leaves it is
+replaced by bisection. A lane with Vgs0 at or below V is in cut-off
+(Id is zero).
+*/
+
+// Bias network and state of the solve of a block of points.
+struct DrainBlock {
+   real P[NEWTON_BLOCK]; // Idss or k of the start (see FET.h)
+   real u[NEWTON_BLOCK], V[NEWTON_BLOCK], lambda[NEWTON_BLOCK];
+   real Vgs0[NEWTON_BLOCK], Rgs[NEWTON_BLOCK];
+   real Vds0[NEWTON_BLOCK], Rds[NEWTON_BLOCK];
+   real Vg[NEWTON_BLOCK]; // gate voltage, only for results
+   real Id[NEWTON_BLOCK]; // root of the quadratic, then of the cubic
+   int done[NEWTON_BLOCK]; // lane has converged
+};
+
+KERNEL void _drain_network_(struct DrainBlock* b, int k, real P,
+                            real V, real lambda, real Vgs0, real Rgs,
+                            real Vds0, real Rds, real Vg) {
+   // Save device and bias network of k'th lane.
+   b->P[k] = P; b->V[k] = V; b->lambda[k] = lambda;
+   b->Vgs0[k] = Vgs0; b->Rgs[k] = Rgs;
+   b->Vds0[k] = Vds0; b->Rds[k] = Rds; b->Vg[k] = Vg;
+}
+
+KERNEL void _drain_solve_(struct DrainBlock* b) {
+   // Solve Id of lanes of block, NaN if a lane has not converged.
+   real lo[NEWTON_BLOCK], hi[NEWTON_BLOCK], x0[NEWTON_BLOCK];
+   real next[NEWTON_BLOCK], mid[NEWTON_BLOCK], step[NEWTON_BLOCK];
+   int up[NEWTON_BLOCK];
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      x0[k] = b->Vgs0[k] - b->V[k];
+      real I1 = x0[k] / b->Rgs[k];
+      real I2 = b->u[k] * x0[k] * x0[k] *
+                (1 + b->lambda[k] * b->Vds0[k]);
+      lo[k] = 0;
+      hi[k] = I1 < I2 ? I1 : I2;
+   }
+   // Start of lanes in the bracket, lanes in cut-off are done.
+   for (int k = 0; k < NEWTON_BLOCK; k++) {
+      real Id = b->Id[k] < hi[k] ? b->Id[k] : hi[k];
+      Id = Id > 0 ? Id : 0;
+      b->done[k] = x0[k] <= 0;
+      b->Id[k] = b->done[k] ? 0 : Id;
+   }
+   for (int iteration = 0; iteration < NEWTON_ITERATIONS; iteration++) {
+      // Newton steps and signs of residuals of all lanes.
+      for (int k = 0; k < NEWTON_BLOCK; k++) {
+         real Id = b->Id[k], u = b->u[k];
+         real x = x0[k] - b->Rgs[k] * Id;
+         real m = 1 + b->lambda[k] * (b->Vds0[k] - b->Rds[k] * Id);
+         real f = u * x * x * m - Id;
+         real df = -2 * u * x * b->Rgs[k] * m -
+                   u * x * x * b->lambda[k] * b->Rds[k] - 1;
+         step[k] = f / df;
+         next[k] = Id - step[k];
+         up[k] = f > 0;
+      }
+      // Brackets narrowed by the signs of residuals and their midpoints.
+      for (int k = 0; k < NEWTON_BLOCK; k++) {
+         lo[k] = up[k] ? b->Id[k] : lo[k];
+         hi[k] = up[k] ? hi[k] : b->Id[k];
+         mid[k] = (lo[k] + hi[k]) / 2;
+      }
+      // Update of lanes that have not converged, a step out of the
+      // narrowed bracket is replaced by its midpoint.
+      int active = 0;
+      for (int k = 0; k < NEWTON_BLOCK; k++) {
+         real Id = b->Id[k];
+         int inside = (next[k] >= lo[k]) & (next[k] <= hi[k]);
+         int small = inside & (real_fabs(step[k]) < NEWTON_TOL * Id);
+         Id = inside ? next[k] : mid[k];
+         b->Id[k] = b->done[k] ? b->Id[k] : Id;
+         b->done[k] |= small;
+         active += !b->done[k];
+      }
+      if (!active) break;
+   }
+   // NaN is added to Id of lanes that have not converged.
+   real nan[NEWTON_BLOCK];
+   for (int k = 0; k < NEWTON_BLOCK; k++)
+      nan[k] = b->done[k] ? 0 : NAN;
+   for (int k = 0; k < NEWTON_BLOCK; k++) b->Id[k] += nan[k];
+}
+
+#endif
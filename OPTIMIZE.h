@@ -0,0 +1,980 @@
+/* Design-Space Optimizer
+
+A design searches parameter values of a configuration (usually its
+resistors) that meet targets of its DC and AC results, e.g. Av = -50,
+Ic = 2 mA and Vce = 10 V of BJT voltage-divider with Vcc = 20 V.
+Searched parameters take values of E12, E24 or E96 series in their
+ranges, fixed parameters (transistor constants, supply) keep a value.
+Designs are ranked by the sum of squares of relative errors of
+targets, and a target with a tolerance is also a limit.
+
+Search is a tree, one level for each searched parameter. The order of
+levels comes from dependencies of targets, which are found from
+Jacobians of entries (DUAL.h): a target is checked at the first level
+where all parameters that it depends on are chosen. E.g. Ic of
+voltage-divider depends on Rb1, Rb2 and Re but not on Rc, so a bias
+that misses Ic is dropped before any value of Rc is tried. All values
+of a level are evaluated by one call of the batch function of entry,
+and values of the first level are spread across threads (SWEEP.h).
+A searched parameter which no target depends on keeps the value that
+is nearest to the geometric center of its range.
+
+Entries with bound functions (BJT and FET voltage-divider, see
+INTERVAL.h) also bound targets of later levels while their parameters
+are anywhere in their values, e.g. Ib of BJT from Thevenin values of
+chosen Rb1 and Rb2 over all values of Re. A branch whose bounds miss
+a limit is dropped, and a branch whose least error is not below the
+errors of kept designs is dropped too (branch and bound).
+
+With series 0 (any value), the tree is searched with E96 values and
+then the best designs are refined by Levenberg-Marquardt steps on
+logarithms of parameters, with derivatives from Jacobians.
+
+Programs run a design file with 'BJT -o file [format]':
+
+   # BJT voltage-divider with Av = -50, Ic = 2 mA and Vce = Vcc / 2
+   config vd unbypassed
+   series E24
+   param Vcc 20
+   param beta 120
+   param ro 50e3
+   param Rb1 1e3 1e6
+   param Rb2 1e3 1e6
+   param Rc 100 100e3
+   param Re 10 10e3
+   target Av -50 0.1
+   target Ic 2e-3 0.05
+   target Vce 10 0.1
+   best 5
+
+'config' is same as the configuration of a job (JOBS.h) without
+analysis, 'param name value' fixes and 'param name low high' searches
+a parameter, 'target result value [tolerance]' adds a target, 'best'
+is the number of designs and 'threads' the number of threads. Results
+are the best designs (searched parameters, results of targets and
+'error') in a format of COLUMNS.h. With a 'stream' line, the best-first
+search of 'stream_design' is run and each design is written as soon
+as it is found.
+*/
+
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "CONFIG.h"
+#include "DUAL.h"
+#include "INTERVAL.h"
+#include "SWEEP.h"
+#include "JOBS.h"
+
+// Maximum number of values of a searched parameter.
+#define DESIGN_VALUES 1024
+// Maximum number of refinement steps of a design of any value.
+#define DESIGN_STEPS 50
+
+// Mantissas of E-series values (x 0.1 or x 0.01).
+static short E12Values[] = {10, 12, 15, 18, 22, 27, 33, 39, 47, 56, 68, 82};
+static short E24Values[] = {10, 11, 12, 13, 15, 16, 18, 20, 22, 24, 27,
+                            30, 33, 36, 39, 43, 47, 51, 56, 62, 68, 75,
+                            82, 91};
+static short E96Values[] = {
+   100, 102, 105, 107, 110, 113, 115, 118, 121, 124, 127, 130, 133, 137,
+   140, 143, 147, 150, 154, 158, 162, 165, 169, 174, 178, 182, 187, 191,
+   196, 200, 205, 210, 215, 221, 226, 232, 237, 243, 249, 255, 261, 267,
+   274, 280, 287, 294, 301, 309, 316, 324, 332, 340, 348, 357, 365, 374,
+   383, 392, 402, 412, 422, 432, 442, 453, 464, 475, 487, 499, 511, 523,
+   536, 549, 562, 576, 590, 604, 619, 634, 649, 665, 681, 698, 715, 732,
+   750, 768, 787, 806, 825, 845, 866, 887, 909, 931, 953, 976};
+
+int e_series(int series, real low, real high, real* values, int max) {
+   // Write values of E-series 'series' (12, 24, 96) in [low, high]
+   // into 'values' in ascending order. The number of values is
+   // returned, -1 if they are more than 'max'.
+   short* mantissas = series == 12 ? E12Values : series == 24 ?
+                      E24Values : E96Values;
+   int count = series == 12 ? 12 : series == 24 ? 24 : 96;
+   double unit = series == 96 ? 0.01 : 0.1;
+   int n = 0;
+   if (!(low > 0) || !(high >= low)) return 0;
+   for (int decade = (int) floor(log10(low)) - 1;
+        decade <= (int) ceil(log10(high)); decade++) {
+      for (int i = 0; i < count; i++) {
+         // Rounded value of mantissa, so 4.7 k is exactly 4700.
+         double value = mantissas[i] * unit * pow(10, decade);
+         value = (double) (float) value;
+         if (value < low * (1 - 1e-6) || value > high * (1 + 1e-6))
+            continue;
+         if (n == max) return -1;
+         values[n++] = value;
+      }
+   }
+   return n;
+}
+
+int design_init(struct Design* design, struct Config* dc,
+                struct Config* ac) {
+   memset(design, 0, sizeof(struct Design));
+   design->dc = dc; design->ac = ac;
+   if (!dc && !ac) return -1;
+   // Parameters of both entries, each one once.
+   struct Config* entries[] = {dc, ac};
+   for (int e = 0; e < 2; e++) {
+      for (int c = 0; entries[e] && c < entries[e]->nin; c++) {
+         char* name = entries[e]->inputs[c];
+         if (_find_column_(design->params, design->nparams, name) >= 0)
+            continue;
+         if (design->nparams == CONFIG_COLUMNS) return -1;
+         design->low[design->nparams] = NAN;
+         design->high[design->nparams] = NAN;
+         design->params[design->nparams++] = name;
+      }
+   }
+   return 0;
+}
+
+int design_param(struct Design* design, char* name, real low, real high) {
+   int p = _find_column_(design->params, design->nparams, name);
+   if (p < 0) return -1;
+   design->low[p] = low; design->high[p] = high;
+   return 0;
+}
+
+int design_target(struct Design* design, char* result, real value,
+                  real tolerance) {
+   // Name of target is the name of result column of entry, so
+   // 'result' can be a temporary string.
+   struct Config* entries[] = {design->dc, design->ac};
+   char* name = NULL;
+   for (int e = 1; e >= 0; e--) {
+      int r = entries[e] ? _find_column_(entries[e]->outputs,
+                                         entries[e]->nout, result) : -1;
+      if (r >= 0) name = entries[e]->outputs[r];
+   }
+   if (!name || design->ntargets == CONFIG_COLUMNS) return -1;
+   struct DesignTarget target = {name, value, tolerance};
+   design->targets[design->ntargets++] = target;
+   return 0;
+}
+
+/* Search of a Design */
+
+// Shared state of a search.
+struct DesignSearch {
+   struct Design* design;
+   struct Config* entries[2]; // DC and AC entries
+   int inputs[2][CONFIG_COLUMNS]; // parameter of each input column
+   int nlevels; // number of levels of tree
+   int order[CONFIG_COLUMNS]; // parameter of each level
+   real* values[CONFIG_COLUMNS]; // values of each parameter
+   int counts[CONFIG_COLUMNS]; // number of values of each parameter
+   real center[CONFIG_COLUMNS]; // value of a parameter before its level
+   int entry[CONFIG_COLUMNS]; // entry of each target
+   int column[CONFIG_COLUMNS]; // result column of each target
+   real scale[CONFIG_COLUMNS]; // scale of relative error of each target
+   int check[CONFIG_COLUMNS]; // level where each target is checked
+   unsigned checks[CONFIG_COLUMNS]; // targets checked at each level
+   unsigned evaluate[CONFIG_COLUMNS]; // entries evaluated at each level
+   // Entries bounded below each level (the first one is below root).
+   unsigned bounded[CONFIG_COLUMNS + 1];
+   int count; // number of kept designs
+   struct DesignWork* works; // states of threads
+   real* memory; // memory of values
+};
+
+// State of a thread of search.
+struct DesignWork {
+   real point[CONFIG_COLUMNS]; // parameters of current branch
+   real results[CONFIG_COLUMNS]; // results of targets of branch
+   real errors[CONFIG_COLUMNS + 1]; // error of branch before level
+   real* in[CONFIG_COLUMNS]; // input columns of batch calls
+   // Result columns of each level and entry.
+   real* out[CONFIG_COLUMNS][2][CONFIG_COLUMNS];
+   real* memory; // memory of columns
+   long evaluated; // number of evaluated points
+   int found; // number of kept designs
+   struct DesignResult* best; // kept designs, the best one first
+};
+
+static void _design_keep_(struct DesignSearch* search,
+                          struct DesignWork* work, real error) {
+   // Keep design of current branch if it is one of best ones.
+   struct Design* design = search->design;
+   int i = work->found < search->count ? work->found++ : search->count;
+   if (i == search->count && !(error < work->best[i - 1].error)) return;
+   if (i == search->count) i--;
+   for (; i > 0 && error < work->best[i - 1].error; i--)
+      work->best[i] = work->best[i - 1];
+   memcpy(work->best[i].params, work->point,
+          design->nparams * sizeof(real));
+   memcpy(work->best[i].results, work->results,
+          design->ntargets * sizeof(real));
+   work->best[i].error = error;
+}
+
+static void _design_evaluate_(struct DesignSearch* search,
+                              struct DesignWork* work, int level, int e,
+                              long begin, long n) {
+   // Evaluate values [begin, begin + n) of parameter of 'level' with
+   // entry 'e'. Other parameters are taken from current branch.
+   struct Config* config = search->entries[e];
+   int p = search->order[level];
+   real* in[CONFIG_COLUMNS];
+   for (int c = 0; c < config->nin; c++) {
+      int q = search->inputs[e][c];
+      if (q == p) in[c] = search->values[p] + begin;
+      else {
+         in[c] = work->in[c];
+         for (long j = 0; j < n; j++) in[c][j] = work->point[q];
+      }
+   }
+   config->batch(n, in, work->out[level][e]);
+}
+
+static int _design_check_(struct DesignSearch* search,
+                          struct DesignWork* work, int level, long j,
+                          real* error) {
+   // Add squared errors of targets of 'level' at evaluated value 'j'
+   // to 'error' and keep their results. -1 is returned if a target
+   // misses its limit.
+   struct Design* design = search->design;
+   for (int t = 0; t < design->ntargets; t++) {
+      if (!(search->checks[level] & (1u << t))) continue;
+      real y = work->out[level][search->entry[t]][search->column[t]][j];
+      real d = (y - design->targets[t].value) / search->scale[t];
+      real tolerance = design->targets[t].tolerance;
+      if (d != d || (tolerance > 0 && real_fabs(d) > tolerance))
+         return -1;
+      work->results[t] = y;
+      *error += d * d;
+   }
+   return 0;
+}
+
+static int _design_bound_(struct DesignSearch* search,
+                          struct DesignWork* work, int level, real* error) {
+   // Add lower bounds of squared errors of targets that are checked
+   // below 'level' to 'error', from bounds of results while parameters
+   // of lower levels are anywhere in their values (see 'bound' of
+   // Config). -1 is returned if a target can not meet its limit.
+   struct Design* design = search->design;
+   unsigned bounded = search->bounded[level + 1];
+   real low[2][CONFIG_COLUMNS], high[2][CONFIG_COLUMNS];
+   real out_low[2][CONFIG_COLUMNS], out_high[2][CONFIG_COLUMNS];
+   if (!bounded) return 0;
+   for (int e = 0; e < 2; e++) {
+      if (!(bounded & (1u << e))) continue;
+      struct Config* config = search->entries[e];
+      for (int c = 0; c < config->nin; c++)
+         low[e][c] = high[e][c] = work->point[search->inputs[e][c]];
+      for (int l = level + 1; l < search->nlevels; l++) {
+         int p = search->order[l];
+         for (int c = 0; c < config->nin; c++) {
+            if (search->inputs[e][c] != p) continue;
+            low[e][c] = search->values[p][0];
+            high[e][c] = search->values[p][search->counts[p] - 1];
+         }
+      }
+      config->bound(low[e], high[e], out_low[e], out_high[e]);
+   }
+   for (int t = 0; t < design->ntargets; t++) {
+      int e = search->entry[t], r = search->column[t];
+      if (search->check[t] <= level || !(bounded & (1u << e))) continue;
+      real value = design->targets[t].value;
+      real lo = (out_low[e][r] - value) / search->scale[t];
+      real hi = (out_high[e][r] - value) / search->scale[t];
+      if (lo != lo || hi != hi) continue; // not bounded
+      real d = lo > 0 ? lo : hi < 0 ? -hi : 0;
+      real tolerance = design->targets[t].tolerance;
+      if (tolerance > 0 && d > tolerance) return -1;
+      *error += d * d;
+   }
+   return 0;
+}
+
+static void _design_level_(struct DesignSearch* search,
+                           struct DesignWork* work, int level, long begin,
+                           long end) {
+   // Try values [begin, end) of parameter of 'level' and go down into
+   // the branches which meet all limits of checked targets and whose
+   // bounds can meet limits of later targets (branch and bound).
+   if (level == search->nlevels) {
+      _design_keep_(search, work, work->errors[level]);
+      return;
+   }
+   int p = search->order[level];
+   for (int e = 0; e < 2; e++)
+      if (search->evaluate[level] & (1u << e))
+         _design_evaluate_(search, work, level, e, begin, end - begin);
+   work->evaluated += end - begin;
+   for (long j = 0; j < end - begin; j++) {
+      real error = work->errors[level];
+      if (_design_check_(search, work, level, j, &error)) continue;
+      work->point[p] = search->values[p][begin + j];
+      // A branch which can not be better than kept designs of this
+      // thread can not be one of the best designs.
+      real bound = error;
+      if (_design_bound_(search, work, level, &bound)) continue;
+      if (work->found == search->count &&
+          !(bound < work->best[search->count - 1].error))
+         continue;
+      work->errors[level + 1] = error;
+      long count = level + 1 < search->nlevels ?
+                   search->counts[search->order[level + 1]] : 0;
+      _design_level_(search, work, level + 1, 0, count);
+   }
+   work->point[p] = search->center[p];
+}
+
+static void _design_task_(long begin, long end, int thread, void* context) {
+   // Search branches of values [begin, end) of the first level.
+   struct DesignSearch* search = context;
+   _design_level_(search, &search->works[thread], 0, begin, end);
+}
+
+static unsigned _design_depends_(struct DesignSearch* search, int t) {
+   // Find mask of searched parameters that target 't' depends on. A
+   // derivative which is zero at two different points is taken as a
+   // parameter that is not read by the result.
+   struct Design* design = search->design;
+   struct Config* config = search->entries[search->entry[t]];
+   real in[CONFIG_COLUMNS], out[CONFIG_COLUMNS];
+   real jacobian[CONFIG_COLUMNS * CONFIG_COLUMNS];
+   unsigned mask = 0;
+   for (int k = 0; k < 2; k++) {
+      for (int c = 0; c < config->nin; c++) {
+         int p = search->inputs[search->entry[t]][c];
+         in[c] = search->center[p];
+         if (k == 1 && design->low[p] > 0 && design->high[p] >
+             design->low[p])
+            in[c] = design->low[p] * real_pow(design->high[p] /
+                                              design->low[p], 0.7f);
+      }
+      config->jacobian(in, out, jacobian);
+      for (int c = 0; c < config->nin; c++)
+         if (jacobian[search->column[t] * config->nin + c] != 0)
+            mask |= 1u << search->inputs[search->entry[t]][c];
+   }
+   return mask;
+}
+
+static int _design_prepare_(struct DesignSearch* search, real* memory) {
+   // Find values of parameters, order of levels and checks of targets.
+   // 'memory' has room for DESIGN_VALUES values of each parameter.
+   // -1 is returned if the design is not complete.
+   struct Design* design = search->design;
+   search->entries[0] = design->dc;
+   search->entries[1] = design->ac;
+   for (int e = 0; e < 2; e++) {
+      struct Config* config = search->entries[e];
+      for (int c = 0; config && c < config->nin; c++)
+         search->inputs[e][c] = _find_column_(design->params,
+                                              design->nparams,
+                                              config->inputs[c]);
+   }
+   unsigned searched = 0;
+   for (int p = 0; p < design->nparams; p++) {
+      real low = design->low[p], high = design->high[p];
+      if (!(high >= low)) return -1; // not set
+      search->values[p] = memory + p * DESIGN_VALUES;
+      if (low == high) {
+         search->values[p][0] = low;
+         search->counts[p] = 1;
+      } else {
+         int series = design->series ? design->series : 96;
+         search->counts[p] = e_series(series, low, high, search->values[p],
+                                      DESIGN_VALUES);
+         if (search->counts[p] <= 0) return -1;
+         searched |= 1u << p;
+      }
+      // Value nearest to geometric center of range.
+      int middle = 0;
+      for (int i = 1; i < search->counts[p]; i++)
+         if (real_fabs(real_pow(search->values[p][i], 2) - low * high) <
+             real_fabs(real_pow(search->values[p][middle], 2) - low * high))
+            middle = i;
+      search->center[p] = search->values[p][middle];
+   }
+   // Entries and columns of targets, and dependencies of them.
+   unsigned depends[CONFIG_COLUMNS];
+   int sorted[CONFIG_COLUMNS];
+   for (int t = 0; t < design->ntargets; t++) {
+      struct DesignTarget* target = &design->targets[t];
+      search->entry[t] = (design->dc && _find_column_(design->dc->outputs,
+                          design->dc->nout, target->result) >= 0) ? 0 : 1;
+      struct Config* config = search->entries[search->entry[t]];
+      search->column[t] = _find_column_(config->outputs, config->nout,
+                                        target->result);
+      search->scale[t] = target->value ? real_fabs(target->value) : 1;
+      depends[t] = _design_depends_(search, t) & searched;
+      // Insert target into the order of number of dependencies.
+      int i = t;
+      for (; i > 0 && __builtin_popcount(depends[sorted[i - 1]]) >
+                      __builtin_popcount(depends[t]); i--)
+         sorted[i] = sorted[i - 1];
+      sorted[i] = t;
+   }
+   // Levels of parameters of targets with less dependencies first.
+   unsigned placed = 0;
+   search->nlevels = 0;
+   for (int i = 0; i < design->ntargets; i++) {
+      int t = sorted[i], level = 0;
+      for (int p = 0; p < design->nparams; p++) {
+         if (!(depends[t] & (1u << p))) continue;
+         if (!(placed & (1u << p))) {
+            search->order[search->nlevels++] = p;
+            placed |= 1u << p;
+         }
+      }
+      for (int l = 0; l < search->nlevels; l++)
+         if (depends[t] & (1u << search->order[l])) level = l;
+      search->check[t] = level;
+      search->checks[level] |= 1u << t;
+      search->evaluate[level] |= 1u << search->entry[t];
+   }
+   // Entries that bound a target which is checked below a level.
+   for (int t = 0; t < design->ntargets; t++)
+      for (int l = 0; l <= search->check[t]; l++)
+         if (search->entries[search->entry[t]]->bound)
+            search->bounded[l] |= 1u << search->entry[t];
+   // Parameters that no target depends on keep their center values.
+   for (int p = 0; p < design->nparams; p++)
+      if ((searched & ~placed) & (1u << p)) {
+         search->values[p][0] = search->center[p];
+         search->counts[p] = 1;
+      }
+   // A tree has at least one level, a design without searched
+   // parameters is one point.
+   if (search->nlevels == 0) search->order[search->nlevels++] = 0;
+   return 0;
+}
+
+/* Refinement of a Design of Any Value */
+
+static real _design_point_(struct DesignSearch* search, real* params,
+                           real* results, real* jacobian) {
+   // Evaluate targets at 'params' and return the error. If 'jacobian'
+   // is not NULL, derivatives of relative errors of targets with
+   // respect to logarithms of parameters are written into it
+   // (jacobian[t * nparams + p]).
+   struct Design* design = search->design;
+   real in[2][CONFIG_COLUMNS], out[2][CONFIG_COLUMNS];
+   real derivatives[2][CONFIG_COLUMNS * CONFIG_COLUMNS];
+   for (int e = 0; e < 2; e++) {
+      struct Config* config = search->entries[e];
+      if (!config) continue;
+      for (int c = 0; c < config->nin; c++)
+         in[e][c] = params[search->inputs[e][c]];
+      config->jacobian(in[e], out[e], derivatives[e]);
+   }
+   real error = 0;
+   for (int t = 0; t < design->ntargets; t++) {
+      int e = search->entry[t], r = search->column[t];
+      struct Config* config = search->entries[e];
+      results[t] = out[e][r];
+      real d = (results[t] - design->targets[t].value) / search->scale[t];
+      error += d * d;
+      if (!jacobian) continue;
+      for (int p = 0; p < design->nparams; p++)
+         jacobian[t * design->nparams + p] = 0;
+      for (int c = 0; c < config->nin; c++) {
+         int p = search->inputs[e][c];
+         jacobian[t * design->nparams + p] = derivatives[e][r * config->nin
+                                             + c] * params[p] /
+                                             search->scale[t];
+      }
+   }
+   return error;
+}
+
+static int _design_solve_(int n, double* a, double* b) {
+   // Solve a * x = b (a is n x n) by Gaussian elimination with partial
+   // pivoting, x is written into 'b'. -1 is returned if a is singular.
+   for (int k = 0; k < n; k++) {
+      int pivot = k;
+      for (int i = k + 1; i < n; i++)
+         if (fabs(a[i * n + k]) > fabs(a[pivot * n + k])) pivot = i;
+      if (a[pivot * n + k] == 0) return -1;
+      for (int j = 0; j < n; j++) {
+         double swap = a[k * n + j];
+         a[k * n + j] = a[pivot * n + j]; a[pivot * n + j] = swap;
+      }
+      double swap = b[k]; b[k] = b[pivot]; b[pivot] = swap;
+      for (int i = k + 1; i < n; i++) {
+         double factor = a[i * n + k] / a[k * n + k];
+         for (int j = k; j < n; j++) a[i * n + j] -= factor * a[k * n + j];
+         b[i] -= factor * b[k];
+      }
+   }
+   for (int k = n - 1; k >= 0; k--) {
+      for (int j = k + 1; j < n; j++) b[k] -= a[k * n + j] * b[j];
+      b[k] /= a[k * n + k];
+   }
+   return 0;
+}
+
+static void _design_refine_(struct DesignSearch* search,
+                            struct DesignResult* result) {
+   // Improve a design by Levenberg-Marquardt steps on logarithms of
+   // searched parameters. Parameters stay in their ranges and the
+   // design is kept only if it still meets all limits.
+   struct Design* design = search->design;
+   int n = design->nparams, m = design->ntargets;
+   real jacobian[CONFIG_COLUMNS * CONFIG_COLUMNS];
+   real params[CONFIG_COLUMNS], results[CONFIG_COLUMNS];
+   real trial[CONFIG_COLUMNS], trial_results[CONFIG_COLUMNS];
+   double a[CONFIG_COLUMNS * CONFIG_COLUMNS], b[CONFIG_COLUMNS];
+   double lambda = 1e-3;
+   memcpy(params, result->params, n * sizeof(real));
+   real error = _design_point_(search, params, results, jacobian);
+   for (int step = 0; step < DESIGN_STEPS && lambda < 1e8; step++) {
+      real d[CONFIG_COLUMNS];
+      for (int t = 0; t < m; t++)
+         d[t] = (results[t] - design->targets[t].value) / search->scale[t];
+      // Normal equations of the damped least squares step.
+      for (int p = 0; p < n; p++) {
+         int free = design->high[p] > design->low[p];
+         b[p] = 0;
+         for (int q = 0; q < n; q++) {
+            double sum = 0;
+            for (int t = 0; t < m; t++)
+               sum += (double) jacobian[t * n + p] * jacobian[t * n + q];
+            a[p * n + q] = (free && design->high[q] > design->low[q]) ?
+                           sum : 0;
+         }
+         for (int t = 0; free && t < m; t++)
+            b[p] -= (double) jacobian[t * n + p] * d[t];
+         a[p * n + p] = a[p * n + p] * (1 + lambda) + 1e-12;
+      }
+      if (_design_solve_(n, a, b)) break;
+      for (int p = 0; p < n; p++) {
+         trial[p] = params[p] * exp(b[p]);
+         trial[p] = real_fmin(real_fmax(trial[p], design->low[p]),
+                              design->high[p]);
+      }
+      real trial_error = _design_point_(search, trial, trial_results,
+                                        NULL);
+      if (trial_error < error) {
+         int converged = error - trial_error < 1e-6 * error;
+         memcpy(params, trial, n * sizeof(real));
+         error = _design_point_(search, params, results, jacobian);
+         lambda /= 10;
+         if (converged) break;
+      } else lambda *= 10;
+   }
+   for (int t = 0; t < m; t++) {
+      real d = (results[t] - design->targets[t].value) / search->scale[t];
+      if (design->targets[t].tolerance > 0 &&
+          !(real_fabs(d) <= design->targets[t].tolerance)) return;
+   }
+   if (!(error < result->error)) return;
+   memcpy(result->params, params, n * sizeof(real));
+   memcpy(result->results, results, m * sizeof(real));
+   result->error = error;
+}
+
+static int _design_start_(struct DesignSearch* search,
+                          struct Design* design, int count) {
+   // Prepare a search of 'count' designs. -1 is returned if the
+   // design is not complete or memory is not enough.
+   memset(search, 0, sizeof(struct DesignSearch));
+   search->design = design;
+   search->count = count;
+   design->evaluated = 0;
+   real* values = malloc(CONFIG_COLUMNS * DESIGN_VALUES * sizeof(real));
+   if (!values) return -1;
+   search->memory = values;
+   if (_design_prepare_(search, values)) {
+      free(values);
+      return -1;
+   }
+   return 0;
+}
+
+static int _design_work_(struct DesignSearch* search,
+                         struct DesignWork* work) {
+   // Allocate columns of batch calls and kept designs of a thread. -1
+   // is returned if memory is not enough.
+   long width = 0;
+   for (int l = 0; l < search->nlevels; l++)
+      if (search->counts[search->order[l]] > width)
+         width = search->counts[search->order[l]];
+   long columns = CONFIG_COLUMNS * (1 + 2 * search->nlevels);
+   work->memory = malloc(columns * width * sizeof(real));
+   work->best = malloc(search->count * sizeof(struct DesignResult));
+   if (!work->memory || !work->best) return -1;
+   real* column = work->memory;
+   for (int c = 0; c < CONFIG_COLUMNS; c++, column += width)
+      work->in[c] = column;
+   for (int l = 0; l < search->nlevels; l++)
+      for (int e = 0; e < 2; e++)
+         for (int c = 0; c < CONFIG_COLUMNS; c++, column += width)
+            work->out[l][e][c] = column;
+   memcpy(work->point, search->center,
+          search->design->nparams * sizeof(real));
+   return 0;
+}
+
+int run_design(struct Design* design, int threads, int count,
+               struct DesignResult* best) {
+   struct DesignSearch search;
+   if (count <= 0) return 0;
+   if (_design_start_(&search, design, count)) return -1;
+   threads = _sweep_threads_(threads);
+   search.works = calloc(threads, sizeof(struct DesignWork));
+   int status = search.works ? 0 : -1;
+   for (int t = 0; status == 0 && t < threads; t++)
+      status = _design_work_(&search, &search.works[t]);
+   if (status == 0)
+      status = _schedule_chunks_(search.counts[search.order[0]], 1,
+                                 threads, _design_task_, &search);
+   // Merge kept designs of threads.
+   int found = 0;
+   for (int t = 0; search.works && t < threads; t++) {
+      struct DesignWork* work = &search.works[t];
+      for (int i = 0; status == 0 && i < work->found; i++) {
+         int k = found < count ? found++ : count;
+         if (k == count && !(work->best[i].error < best[k - 1].error))
+            continue;
+         if (k == count) k--;
+         for (; k > 0 && work->best[i].error < best[k - 1].error; k--)
+            best[k] = best[k - 1];
+         best[k] = work->best[i];
+      }
+      design->evaluated += work->evaluated;
+      free(work->memory); free(work->best);
+   }
+   // Designs of any value are refined and sorted again.
+   if (status == 0 && design->series == 0) {
+      for (int i = 0; i < found; i++) _design_refine_(&search, &best[i]);
+      for (int i = 1; i < found; i++)
+         for (int k = i; k > 0 && best[k].error < best[k - 1].error; k--) {
+            struct DesignResult swap = best[k];
+            best[k] = best[k - 1]; best[k - 1] = swap;
+         }
+   }
+   free(search.works); free(search.memory);
+   return status == 0 ? found : -1;
+}
+
+/* Best-First Search of a Design
+
+'stream_design' keeps the open branches of the tree in a heap ordered
+by lower bounds of their errors: the chosen levels give exact errors
+and the bound functions of entries give the least errors of later
+targets (zero for an entry without bounds). The branch with the least
+bound is always expanded first, so a complete design that comes out
+of the heap is better than every design of other branches, and
+designs are given to the caller as soon as they are found, the best
+one first. Only 'count' designs are wanted, so a branch whose bound is
+not below the errors of 'count' known designs is never kept.
+*/
+
+// Maximum number of open branches of a best-first search.
+#define DESIGN_NODES (1 << 20)
+
+// An open branch of best-first search.
+struct DesignNode {
+   real bound; // lower bound of errors of designs of branch
+   real error; // error of targets of chosen levels
+   int level; // next level of branch, nlevels for a design
+   real point[CONFIG_COLUMNS]; // parameters of chosen levels
+   real results[CONFIG_COLUMNS]; // results of checked targets
+};
+
+struct DesignHeap {
+   struct DesignNode* nodes; // binary heap, the least bound first
+   long n, size;
+};
+
+static int _design_push_(struct DesignHeap* heap, struct DesignNode* node) {
+   // Add a branch to heap. -1 is returned if branches are too many.
+   if (heap->n == heap->size) {
+      long size = heap->size ? 2 * heap->size : 1024;
+      struct DesignNode* nodes = NULL;
+      if (size <= DESIGN_NODES)
+         nodes = realloc(heap->nodes, size * sizeof(struct DesignNode));
+      if (!nodes) return -1;
+      heap->nodes = nodes; heap->size = size;
+   }
+   long i = heap->n++;
+   for (; i > 0 && node->bound < heap->nodes[(i - 1) / 2].bound;
+        i = (i - 1) / 2)
+      heap->nodes[i] = heap->nodes[(i - 1) / 2];
+   heap->nodes[i] = *node;
+   return 0;
+}
+
+static void _design_pop_(struct DesignHeap* heap, struct DesignNode* node) {
+   // Take the branch with the least bound from heap.
+   *node = heap->nodes[0];
+   struct DesignNode* last = &heap->nodes[--heap->n];
+   long i = 0;
+   for (long child = 1; child < heap->n; i = child, child = 2 * i + 1) {
+      if (child + 1 < heap->n &&
+          heap->nodes[child + 1].bound < heap->nodes[child].bound)
+         child++;
+      if (!(heap->nodes[child].bound < last->bound)) break;
+      heap->nodes[i] = heap->nodes[child];
+   }
+   heap->nodes[i] = *last;
+}
+
+static int _design_expand_(struct DesignSearch* search,
+                           struct DesignWork* work, struct DesignNode* node,
+                           struct DesignHeap* heap, real* errors,
+                           int* known) {
+   // Push branches of all values of the next level of 'node'. 'errors'
+   // keeps errors of the 'known' best designs found so far, at most
+   // 'count'. -1 is returned if branches are too many.
+   struct Design* design = search->design;
+   int level = node->level, p = search->order[level];
+   long n = search->counts[p];
+   memcpy(work->point, node->point, design->nparams * sizeof(real));
+   memcpy(work->results, node->results, design->ntargets * sizeof(real));
+   for (int e = 0; e < 2; e++)
+      if (search->evaluate[level] & (1u << e))
+         _design_evaluate_(search, work, level, e, 0, n);
+   work->evaluated += n;
+   struct DesignNode child;
+   child.level = level + 1;
+   for (long j = 0; j < n; j++) {
+      child.error = node->error;
+      if (_design_check_(search, work, level, j, &child.error)) continue;
+      work->point[p] = search->values[p][j];
+      child.bound = child.error;
+      if (_design_bound_(search, work, level, &child.bound)) continue;
+      if (*known == search->count &&
+          !(child.bound < errors[search->count - 1]))
+         continue;
+      if (child.level == search->nlevels) {
+         int i = *known < search->count ? (*known)++ : search->count - 1;
+         for (; i > 0 && child.error < errors[i - 1]; i--)
+            errors[i] = errors[i - 1];
+         errors[i] = child.error;
+      }
+      memcpy(child.point, work->point, design->nparams * sizeof(real));
+      memcpy(child.results, work->results,
+             design->ntargets * sizeof(real));
+      if (_design_push_(heap, &child)) return -1;
+   }
+   return 0;
+}
+
+int stream_design(struct Design* design, int count,
+                  int (*emit)(struct DesignResult* result, void* context),
+                  void* context) {
+   struct DesignSearch search;
+   struct DesignWork work;
+   struct DesignHeap heap = {NULL, 0, 0};
+   struct DesignNode node;
+   if (count <= 0) return 0;
+   if (_design_start_(&search, design, count)) return -1;
+   memset(&work, 0, sizeof(work));
+   real* errors = malloc(count * sizeof(real));
+   int status = (errors && _design_work_(&search, &work) == 0) ? 0 : -1;
+   // Root of tree, if bounds of all targets can meet their limits.
+   memset(&node, 0, sizeof(node));
+   memcpy(node.point, search.center, design->nparams * sizeof(real));
+   memcpy(work.point, search.center, design->nparams * sizeof(real));
+   if (status == 0 && _design_bound_(&search, &work, -1, &node.bound) == 0)
+      status = _design_push_(&heap, &node);
+   int emitted = 0, known = 0;
+   while (status == 0 && emitted < count && heap.n > 0) {
+      _design_pop_(&heap, &node);
+      if (node.level < search.nlevels) {
+         status = _design_expand_(&search, &work, &node, &heap, errors,
+                                  &known);
+         continue;
+      }
+      struct DesignResult result;
+      memcpy(result.params, node.point, design->nparams * sizeof(real));
+      memcpy(result.results, node.results,
+             design->ntargets * sizeof(real));
+      result.error = node.error;
+      if (design->series == 0) _design_refine_(&search, &result);
+      emitted++;
+      if (emit(&result, context)) break;
+   }
+   design->evaluated = work.evaluated;
+   free(heap.nodes); free(errors);
+   free(work.memory); free(work.best); free(search.memory);
+   return status == 0 ? emitted : -1;
+}
+
+/* Design Files */
+
+static int _design_line_(struct Design* design, char* line,
+                         struct JobTable* tables, int ntables, int* count,
+                         int* threads, int* stream) {
+   // Apply a line of design file. -1 is returned if it is wrong.
+   char* rest;
+   char* tokens[8];
+   int n = 0;
+   for (char* token = strtok_r(line, " \t\r\n,", &rest); token && n < 8;
+        token = strtok_r(NULL, " \t\r\n,", &rest))
+      tokens[n++] = token;
+   if (n == 0 || tokens[0][0] == '#') return 0;
+   char* end = "";
+   if (strcmp(tokens[0], "config") == 0) {
+      int k = 1;
+      struct JobTable* table = &tables[0];
+      if (tables[0].type) {
+         for (table = NULL; k < n && !table && ntables-- > 0; tables++)
+            if (strcmp(tables->type, tokens[k]) == 0) table = tables;
+         if (!table) return -1;
+         k++;
+      }
+      if (k >= n) return -1;
+      char* option = k + 1 < n ? tokens[k + 1] : NULL;
+      struct Config* dc = _find_config_(table->configs, table->count,
+                                        tokens[k], "dc", option);
+      if (!dc) dc = _find_config_(table->configs, table->count, tokens[k],
+                                  "dc", NULL);
+      struct Config* ac = _find_config_(table->configs, table->count,
+                                        tokens[k], "ac", option);
+      if (option && !ac && !(dc && dc->option)) return -1;
+      return design_init(design, dc, ac);
+   }
+   if (!design->dc && !design->ac) return -1;
+   if (strcmp(tokens[0], "series") == 0 && n == 2) {
+      if (strcmp(tokens[1], "any") == 0) design->series = 0;
+      else if (strcmp(tokens[1], "E12") == 0) design->series = 12;
+      else if (strcmp(tokens[1], "E24") == 0) design->series = 24;
+      else if (strcmp(tokens[1], "E96") == 0) design->series = 96;
+      else return -1;
+      return 0;
+   }
+   if (strcmp(tokens[0], "param") == 0 && (n == 3 || n == 4)) {
+      real low = strtod(tokens[2], &end);
+      real high = n == 4 ? strtod(tokens[3], &end) : low;
+      return *end ? -1 : design_param(design, tokens[1], low, high);
+   }
+   if (strcmp(tokens[0], "target") == 0 && (n == 3 || n == 4)) {
+      real value = strtod(tokens[2], &end);
+      real tolerance = 0;
+      if (!*end && n == 4) tolerance = strtod(tokens[3], &end);
+      return *end ? -1 : design_target(design, tokens[1], value,
+                                       tolerance);
+   }
+   if (strcmp(tokens[0], "best") == 0 && n == 2) {
+      *count = strtol(tokens[1], &end, 10);
+      return (*end || *count <= 0) ? -1 : 0;
+   }
+   if (strcmp(tokens[0], "threads") == 0 && n == 2) {
+      *threads = strtol(tokens[1], &end, 10);
+      return *end ? -1 : 0;
+   }
+   if (strcmp(tokens[0], "stream") == 0 && n == 1) {
+      *stream = 1;
+      return 0;
+   }
+   return -1;
+}
+
+// Writer of designs of a design file.
+struct DesignOutput {
+   struct Design* design;
+   struct ColumnWriter* writer;
+   int flush; // write each design at once
+};
+
+static int _design_emit_(struct DesignResult* result, void* context) {
+   // Write a design as a row of searched parameters, results of
+   // targets and error. Nonzero is returned on write error.
+   struct DesignOutput* output = context;
+   struct Design* design = output->design;
+   real row[3 * CONFIG_COLUMNS];
+   real* columns[3 * CONFIG_COLUMNS];
+   int c = 0;
+   for (int p = 0; p < design->nparams; p++)
+      if (design->high[p] > design->low[p]) row[c++] = result->params[p];
+   for (int t = 0; t < design->ntargets; t++)
+      row[c++] = result->results[t];
+   row[c++] = result->error;
+   for (int i = 0; i < c; i++) columns[i] = &row[i];
+   if (write_columns(output->writer, 1, columns)) return 1;
+   return output->flush && fflush(output->writer->file);
+}
+
+int run_design_file(char* path, char* format, struct JobTable* tables,
+                    int ntables) {
+   // Search the design of file at 'path' ('-' for stdin) and write the
+   // best designs to stdout in 'format'. Returns the exit status of
+   // program.
+   FILE* in = stdin;
+   if (_columns_format_(format) < 0) {
+      fprintf(stderr, "Can not found '%s' format !!!\n", format);
+      return 1;
+   }
+   if (path && strcmp(path, "-")) in = fopen(path, "r");
+   if (!in) {
+      fprintf(stderr, "Can not open design file '%s' !!!\n", path);
+      return 1;
+   }
+   struct Design design;
+   memset(&design, 0, sizeof(design));
+   design.series = 24;
+   int count = 10, threads = 0, stream = 0, errors = 0;
+   char* line = NULL;
+   size_t size = 0;
+   long number = 0;
+   while (getline(&line, &size, in) != -1) {
+      number++;
+      int series = design.series;
+      if (_design_line_(&design, line, tables, ntables, &count,
+                        &threads, &stream)) {
+         fprintf(stderr, "Wrong design at line %ld !!!\n", number);
+         errors++;
+      }
+      if (strncmp(line, "config", 6) == 0) design.series = series;
+   }
+   free(line);
+   if (in != stdin) fclose(in);
+   for (int p = 0; p < design.nparams; p++)
+      if (!(design.high[p] >= design.low[p])) {
+         fprintf(stderr, "Can not find value of '%s' !!!\n",
+                 design.params[p]);
+         errors++;
+      }
+   if (errors || (!design.dc && !design.ac)) return 1;
+   // Columns of searched parameters, results of targets and error.
+   char* names[3 * CONFIG_COLUMNS];
+   int ncolumns = 0, status = 0, found = 0;
+   for (int p = 0; p < design.nparams; p++)
+      if (design.high[p] > design.low[p])
+         names[ncolumns++] = design.params[p];
+   for (int t = 0; t < design.ntargets; t++)
+      names[ncolumns++] = design.targets[t].result;
+   names[ncolumns++] = "error";
+   struct Config* config = design.ac ? design.ac : design.dc;
+   char name[64];
+   snprintf(name, sizeof(name), "design %s %s%s%s", config->family,
+            config->name, config->option ? " " : "",
+            config->option ? config->option : "");
+   struct ColumnWriter writer = {stdout, _columns_format_(format),
+                                 sizeof(real), 0, 0};
+   struct DesignOutput output = {&design, &writer, stream};
+   if (begin_columns(&writer, name, ncolumns, names)) status = 1;
+   if (status == 0 && stream) {
+      // Designs are written while the search goes on.
+      fflush(stdout);
+      found = stream_design(&design, count, _design_emit_, &output);
+   } else if (status == 0) {
+      struct DesignResult* best = malloc(count *
+                                         sizeof(struct DesignResult));
+      found = best ? run_design(&design, threads, count, best) : -1;
+      for (int i = 0; i < found && status == 0; i++)
+         status = _design_emit_(&best[i], &output);
+      free(best);
+   }
+   if (end_columns(&writer)) status = 1;
+   if (found < 0) fprintf(stderr, "Can not search the design !!!\n");
+   else if (found == 0)
+      fprintf(stderr, "Can not find a design which meets targets !!!\n");
+   return status || found < 0;
+}
+
+#endif
@@ -0,0 +1,229 @@
+/* Points of Benchmarks and Tests
+
+bench.c and test.c evaluate every configuration of 'BJTConfigs',
+'FETConfigs' and 'MOSFETConfigs' on randomized but physically valid
+parameters, and compare (test.c) or time (bench.c) the batch
+functions against the original configuration functions. The scalar
+calls take the parameters of a point in order of 'inputs' of its
+entry, so both programs can run them like the batch functions.
+*/
+
+#ifndef POINTS_H
+#define POINTS_H
+
+#include <stdio.h>
+#include <string.h>
+#include "BJT.h"
+#include "FET.h"
+#include "MOSFET.h"
+
+/* Scalar Calls of Configuration Functions */
+
+// Copy results (and status) of scalar functions into result columns.
+static void _bjt_results_(char* analysis, struct DCBJT* dc,
+                          struct ACBJT* ac, real** out,
+                          unsigned char* status, long i) {
+   if (strcmp(analysis, "dc") == 0) {
+      if (status) status[i] = dc->status;
+      out[0][i] = dc->Ib; out[1][i] = dc->Ic; out[2][i] = dc->Ie;
+      out[3][i] = dc->Icsat; out[4][i] = dc->Vce; out[5][i] = dc->Vc;
+      out[6][i] = dc->Ve; out[7][i] = dc->Vb; out[8][i] = dc->Vbc;
+   } else {
+      if (status) status[i] = ac->status;
+      out[0][i] = ac->re; out[1][i] = ac->Zi; out[2][i] = ac->Zo;
+      out[3][i] = ac->Av;
+   }
+}
+
+static void _fet_results_(char* analysis, struct DCFET* dc,
+                          struct ACFET* ac, real** out,
+                          unsigned char* status, long i) {
+   if (strcmp(analysis, "dc") == 0) {
+      if (status) status[i] = dc->status;
+      out[0][i] = dc->Id; out[1][i] = dc->Vgs; out[2][i] = dc->Vds;
+      out[3][i] = dc->Vs; out[4][i] = dc->Vd; out[5][i] = dc->Vg;
+   } else {
+      if (status) status[i] = ac->status;
+      out[0][i] = ac->gm; out[1][i] = ac->Zi; out[2][i] = ac->Zo;
+      out[3][i] = ac->Av;
+   }
+}
+
+static void _mosfet_results_(char* analysis, struct DCMOSFET* dc,
+                             struct ACMOSFET* ac, real** out,
+                             unsigned char* status, long i) {
+   if (strcmp(analysis, "dc") == 0) {
+      if (status) status[i] = dc->status;
+      out[0][i] = dc->k; out[1][i] = dc->Id; out[2][i] = dc->Vgs;
+      out[3][i] = dc->Vds;
+   } else {
+      if (status) status[i] = ac->status;
+      out[0][i] = ac->gm; out[1][i] = ac->Zi; out[2][i] = ac->Zo;
+      out[3][i] = ac->Av;
+   }
+}
+
+// Scalar calls take parameters in order of 'inputs' of configuration
+// and give 1 for the parameters that are not used by the analysis.
+#define DC(a) (strcmp(a, "dc") == 0)
+
+static void _scalar_bjt_(struct Config* config, long i, real** in,
+                         real** out, unsigned char* status) {
+   char* a = config->analysis;
+   char* name = config->name;
+   real p[CONFIG_COLUMNS];
+   struct DCBJT dc;
+   struct ACBJT ac;
+   for (int c = 0; c < config->nin; c++) p[c] = in[c][i];
+   if (strcmp(name, "fb") == 0)
+      b_fixed_bias(a, p[0], p[1], p[2], p[3], DC(a) ? 1 : p[4], &dc, &ac);
+   else if (strcmp(name, "eb") == 0)
+      b_emitter_bias(a, p[0], p[1], p[2], p[3], p[4], DC(a) ? 1 : p[5],
+                     &dc, &ac);
+   else if (strcmp(name, "vd") == 0)
+      b_voltage_divider(a, p[0], p[1], p[2], p[3], p[4], p[5],
+                        DC(a) ? 1 : p[6],
+                        DC(a) ? "Undefined" : config->option, &dc, &ac);
+   else if (strcmp(name, "cf") == 0 && DC(a))
+      b_collector_feedback(a, p[0], p[1], p[2], p[3], p[4], 1, &dc, &ac);
+   else if (strcmp(name, "cf") == 0)
+      b_collector_feedback(a, p[0], p[1], p[2], 1, p[3], p[4], &dc, &ac);
+   else if (strcmp(name, "cdf") == 0)
+      b_collector_dc_feedback(a, p[0], p[1], p[2], p[3], p[4], p[5],
+                              &dc, &ac);
+   else if (strcmp(name, "ef") == 0 && DC(a))
+      b_emitter_follower(a, 1, p[0], p[1], p[2], p[3], 1, &dc, &ac);
+   else if (strcmp(name, "ef") == 0)
+      b_emitter_follower(a, p[0], 1, p[1], p[2], p[3], p[4], &dc, &ac);
+   else if (strcmp(name, "cb") == 0 && DC(a))
+      b_common_base(a, p[0], p[1], p[2], p[3], p[4], 1, &dc, &ac);
+   else if (strcmp(name, "cb") == 0)
+      b_common_base(a, 1, p[0], p[1], p[2], 1, p[3], &dc, &ac);
+   else if (strcmp(name, "mb") == 0)
+      b_miscellaneous_bias(a, p[0], p[1], p[2], p[3], &dc, &ac);
+   _bjt_results_(a, &dc, &ac, out, status, i);
+}
+
+static void _scalar_fet_(struct Config* config, long i, real** in,
+                         real** out, unsigned char* status) {
+   char* a = config->analysis;
+   char* name = config->name;
+   real p[CONFIG_COLUMNS];
+   struct DCFET dc;
+   struct ACFET ac;
+   for (int c = 0; c < config->nin; c++) p[c] = in[c][i];
+   if (strcmp(name, "fb") == 0 && DC(a))
+      f_fixed_bias(a, p[0], p[1], 1, p[2], p[3], p[4], 1, &dc, &ac);
+   else if (strcmp(name, "fb") == 0)
+      f_fixed_bias(a, 1, p[0], p[1], p[2], p[3], p[4], p[5], &dc, &ac);
+   else if (strcmp(name, "sb") == 0 && DC(a))
+      f_self_bias(a, p[0], 1, p[1], p[2], p[3], p[4], 1, &dc, &ac);
+   else if (strcmp(name, "sb") == 0)
+      f_self_bias(a, 1, p[0], p[1], p[2], p[3], p[4], p[5], &dc, &ac);
+   else if (strcmp(name, "vd") == 0)
+      f_voltage_divider(a, p[0], p[1], p[2], p[3], p[4], p[5], p[6],
+                        DC(a) ? 1 : p[7], &dc, &ac);
+   else if (strcmp(name, "cg") == 0 && DC(a))
+      f_common_gate(a, p[0], p[1], p[2], p[3], p[4], p[5], 1, &dc, &ac);
+   else if (strcmp(name, "cg") == 0)
+      f_common_gate(a, 1, p[0], p[1], p[2], p[3], p[4], p[5], &dc, &ac);
+   else if (strcmp(name, "sf") == 0)
+      f_source_follower(a, 1, p[0], p[1], p[2], p[3], p[4], p[5], &dc,
+                        &ac);
+   _fet_results_(a, &dc, &ac, out, status, i);
+}
+
+static void _scalar_mosfet_(struct Config* config, long i, real** in,
+                            real** out, unsigned char* status) {
+   char* a = config->analysis;
+   real p[CONFIG_COLUMNS];
+   struct DCMOSFET dc;
+   struct ACMOSFET ac;
+   for (int c = 0; c < config->nin; c++) p[c] = in[c][i];
+   if (strcmp(config->name, "df") == 0 && DC(a))
+      m_drain_feedback(a, p[0], 1, p[1], p[2], p[3], p[4], 1, &dc, &ac);
+   else if (strcmp(config->name, "df") == 0)
+      m_drain_feedback(a, p[0], p[1], p[2], p[3], p[4], p[5], p[6], &dc,
+                       &ac);
+   else if (strcmp(config->name, "vd") == 0)
+      m_voltage_divider(a, p[0], p[1], p[2], p[3], p[4], p[5], p[6],
+                        p[7], DC(a) ? 1 : p[8], &dc, &ac);
+   _mosfet_results_(a, &dc, &ac, out, status, i);
+}
+
+static void _scalar_call_(struct Config* config, long i, real** in,
+                          real** out, unsigned char* status) {
+   // Evaluate point 'i' of 'in' by the scalar function of 'config'.
+   // The status of the point is written into 'status[i]' if it is not
+   // NULL.
+   if (strcmp(config->family, "bjt") == 0)
+      _scalar_bjt_(config, i, in, out, status);
+   else if (strcmp(config->family, "fet") == 0)
+      _scalar_fet_(config, i, in, out, status);
+   else _scalar_mosfet_(config, i, in, out, status);
+}
+
+/* Random Parameters */
+
+// Range of a parameter, values are uniform in [low, high]. A range
+// with 'config' ("family name") is only used by that configuration.
+struct PointRange {
+   char* config;
+   char* name;
+   real low, high;
+};
+
+// Ranges keep (nearly) all transistors in the active region.
+// Ranges of a configuration are after the common ones and win.
+static struct PointRange point_ranges[] = {
+   {NULL, "Vcc", 10, 24}, {NULL, "Vee", 4, 12}, {NULL, "Vdd", 12, 24},
+   {NULL, "Vgg", 1, 2}, {NULL, "Vss", 0.5, 2}, {NULL, "Vgs", -2.5, -1},
+   {NULL, "Rb", 200e3, 500e3}, {NULL, "Rb1", 40e3, 90e3},
+   {NULL, "Rb2", 5e3, 8e3}, {NULL, "Rc", 1e3, 4e3},
+   {NULL, "Re", 500, 2e3}, {NULL, "Rf", 150e3, 400e3},
+   {NULL, "Rf1", 60e3, 150e3}, {NULL, "Rf2", 60e3, 150e3},
+   {NULL, "beta", 50, 200}, {NULL, "alpha", 0.98, 0.995},
+   {NULL, "ro", 20e3, 100e3}, {NULL, "Rg", 1e6, 10e6},
+   {NULL, "Rg1", 1e6, 3e6}, {NULL, "Rg2", 100e3, 300e3},
+   {NULL, "Rd", 1e3, 1.5e3}, {NULL, "Rs", 500, 1e3},
+   {NULL, "Idss", 6e-3, 10e-3}, {NULL, "Vp", -6, -3},
+   {NULL, "rd", 20e3, 100e3}, {NULL, "Idon", 3e-3, 8e-3},
+   {NULL, "Vgson", 6, 10}, {NULL, "Vgsth", 2, 4},
+   {"bjt fb", "Rb", 400e3, 600e3}, {"bjt fb", "Rc", 1e3, 2e3},
+   {"bjt fb", "beta", 50, 100}, {"bjt eb", "Rb", 400e3, 600e3},
+   {"bjt eb", "Rc", 1e3, 2e3}, {"bjt eb", "Re", 500, 1e3},
+   {"bjt eb", "beta", 50, 100}, {"bjt cb", "Vee", 2, 4},
+   {"bjt cb", "Re", 1.5e3, 2.5e3}, {"bjt cb", "Rc", 1e3, 2e3},
+   {"mosfet vd", "Rg1", 15e6, 25e6}, {"mosfet vd", "Rg2", 15e6, 20e6},
+   {NULL, "Rsig", 100, 1e3}, {NULL, "RL", 2e3, 10e3},
+   {NULL, "Cin", 1e-6, 10e-6}, {NULL, "Cout", 1e-6, 10e-6},
+   {NULL, "Ce", 10e-6, 100e-6}, {NULL, "Cs", 10e-6, 100e-6},
+   {NULL, "Cbe", 5e-12, 30e-12}, {NULL, "Cbc", 1e-12, 5e-12},
+   {NULL, "Cgs", 2e-12, 10e-12}, {NULL, "Cgd", 0.5e-12, 3e-12},
+   {NULL, "Is", 1e-15, 1e-13}, {NULL, "IKF", 50e-3, 200e-3},
+   {NULL, "BR", 1, 5}, {NULL, "lambda", 5e-3, 50e-3}
+};
+
+static void _random_parameters_(struct Config* config, long n,
+                                real** in) {
+   // Fill parameter columns with reproducible random values.
+   unsigned long long state = 88172645463325252ULL;
+   int nranges = sizeof(point_ranges) / sizeof(point_ranges[0]);
+   char name[32];
+   snprintf(name, sizeof(name), "%s %s", config->family, config->name);
+   for (int c = 0; c < config->nin; c++) {
+      struct PointRange range = {NULL, config->inputs[c], 1, 1};
+      for (int r = 0; r < nranges; r++)
+         if (strcmp(point_ranges[r].name, config->inputs[c]) == 0 &&
+             (!point_ranges[r].config ||
+              strcmp(point_ranges[r].config, name) == 0))
+            range = point_ranges[r];
+      for (long i = 0; i < n; i++) {
+         state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+         real u = (state >> 40) / 16777216.0f;
+         in[c][i] = range.low + (range.high - range.low) * u;
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,154 @@
+/* Polarity of Devices
+
+Configurations are written for npn BJTs and n-channel FETs. A pnp or
+p-channel circuit is the mirror image of the n-type one: every
+voltage and current has the opposite sign, while resistances, device
+magnitudes (beta, Idss, Idon, Is, IKF, lambda, ...) and small-signal
+results (re, gm, Zi, Zo, Av and the "bode" results) are same. So,
+p-type points are evaluated by the kernels of n-type ones: parameters
+are negated on the way in and results on the way out, as the
+'input_signs' and 'output_signs' of the entry give ('-' for voltages
+and currents of the circuit, '+' for resistances, capacitances and
+device magnitudes). The signs are written in every entry, so a new
+column (e.g. a thermal voltage) is not mirrored by its name. There is
+no second implementation of any configuration.
+
+Parameters and results of p-type points have the signs of their own
+circuit, e.g. Vcc = -20 V and Ic < 0 (current flows out of the
+collector) of a pnp fixed-bias, Vp = 4 V of a p-channel JFET and
+Vgsth = -2 V of a p-channel E-MOSFET.
+
+'run_polarity' evaluates a batch of one polarity, its mirror is a
+negation (the polarity is a 'const int' of the kernel). 'run_mixed'
+takes the polarity of every point from a column of POLARITY_N and
+POLARITY_P values, so complementary devices (e.g. both halves of a
+push-pull stage) are in the same batch, and its mirror is a
+multiplication by the column, without branches.
+*/
+
+#ifndef POLARITY_H
+#define POLARITY_H
+
+#include <stdlib.h>
+#include <string.h>
+#include "CONFIG.h"
+#include "SWEEP.h"
+
+// Points that are mirrored together into a local array.
+#define POLARITY_BLOCK 256
+
+KERNEL void _mirror_(const int mixed, long n, real* y, real* x,
+                     real* polarity) {
+   // Write 'x' into 'y' with the sign of p-type points changed ('y'
+   // may be 'x'). All points are p-type, or the ones whose 'polarity'
+   // is POLARITY_P if 'mixed'. A block is mirrored into a local array
+   // and then stored, so neither loop has memory to check for
+   // aliasing and both are vectorized.
+   real s[POLARITY_BLOCK];
+   long i = 0;
+   for (; i + POLARITY_BLOCK <= n; i += POLARITY_BLOCK) {
+      for (int k = 0; k < POLARITY_BLOCK; k++)
+         s[k] = (mixed ? polarity[i + k] : -1) * x[i + k];
+      for (int k = 0; k < POLARITY_BLOCK; k++) y[i + k] = s[k];
+   }
+   for (; i < n; i++) y[i] = (mixed ? polarity[i] : -1) * x[i];
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POLARITY_SIMD 1
+#else
+#define POLARITY_SIMD 0
+#endif
+
+// Baseline, AVX2 and AVX-512 copies of '_mirror_' (specialized for
+// 'mixed') and '_mirror_batch_' which selects the widest one like
+// '_regions_batch_' of REGION.h.
+#if POLARITY_SIMD
+static void _mirror_scalar_(int mixed, long n, real* y, real* x,
+                            real* polarity) {
+   if (mixed) _mirror_(1, n, y, x, polarity);
+   else _mirror_(0, n, y, x, polarity);
+}
+__attribute__((target("avx2")))
+static void _mirror_avx2_(int mixed, long n, real* y, real* x,
+                          real* polarity) {
+   if (mixed) _mirror_(1, n, y, x, polarity);
+   else _mirror_(0, n, y, x, polarity);
+}
+__attribute__((target("avx512f")))
+static void _mirror_avx512_(int mixed, long n, real* y, real* x,
+                            real* polarity) {
+   if (mixed) _mirror_(1, n, y, x, polarity);
+   else _mirror_(0, n, y, x, polarity);
+}
+static void _mirror_batch_(int mixed, long n, real* y, real* x,
+                           real* polarity) {
+   if (__builtin_cpu_supports("avx512f"))
+      _mirror_avx512_(mixed, n, y, x, polarity);
+   else if (__builtin_cpu_supports("avx2"))
+      _mirror_avx2_(mixed, n, y, x, polarity);
+   else _mirror_scalar_(mixed, n, y, x, polarity);
+}
+#else
+static void _mirror_batch_(int mixed, long n, real* y, real* x,
+                           real* polarity) {
+   if (mixed) _mirror_(1, n, y, x, polarity);
+   else _mirror_(0, n, y, x, polarity);
+}
+#endif
+
+static int _polarity_run_(int mixed, struct Config* config, long n,
+                          real** in, real* polarity, real** out) {
+   // Evaluate p-type (or 'mixed') points of 'config' by its batch
+   // function in chunks. Parameters with sign '-' are mirrored into
+   // a buffer (one pass, not a copy and a negation) and results in
+   // place.
+   int count = 0;
+   for (int c = 0; c < config->nin; c++)
+      count += config->input_signs[c] == '-';
+   real* buffer = malloc((count ? count : 1) * SWEEP_CHUNK * sizeof(real));
+   if (!buffer) return -1;
+   for (long i = 0; i < n; i += SWEEP_CHUNK) {
+      long m = n - i < SWEEP_CHUNK ? n - i : SWEEP_CHUNK;
+      real* s = mixed ? polarity + i : NULL;
+      real* p[CONFIG_COLUMNS];
+      real* o[CONFIG_COLUMNS];
+      real* column = buffer;
+      for (int c = 0; c < config->nin; c++) {
+         p[c] = in[c] + i;
+         if (config->input_signs[c] != '-') continue;
+         _mirror_batch_(mixed, m, column, in[c] + i, s);
+         p[c] = column;
+         column += SWEEP_CHUNK;
+      }
+      for (int c = 0; c < config->nout; c++) o[c] = out[c] + i;
+      config->batch(m, p, o);
+      for (int c = 0; c < config->nout; c++)
+         if (config->output_signs[c] == '-')
+            _mirror_batch_(mixed, m, o[c], o[c], s);
+   }
+   free(buffer);
+   return 0;
+}
+
+int run_polarity(struct Config* config, int polarity, long n,
+                 real** in, real** out) {
+   // Evaluate 'n' points of 'config' whose devices have 'polarity'
+   // (POLARITY_N or POLARITY_P) like its batch function. -1 is
+   // returned if memory is not enough.
+   if (polarity == POLARITY_N) {
+      config->batch(n, in, out);
+      return 0;
+   }
+   return _polarity_run_(0, config, n, in, NULL, out);
+}
+
+int run_mixed(struct Config* config, long n, real** in, real* polarity,
+              real** out) {
+   // Evaluate 'n' points of 'config' whose devices have polarities of
+   // column 'polarity' (POLARITY_N or POLARITY_P of every point) like
+   // its batch function. -1 is returned if memory is not enough.
+   return _polarity_run_(1, config, n, in, polarity, out);
+}
+
+#endif
@@ -0,0 +1,62 @@
+/* Precision of Calculations
+
+All configuration functions, batch kernels and result columns use
+'real' numbers. Precision is selected at compile time:
+
+--> default: 'real' is float, kernels use the widest SIMD (8 AVX2 or
+    16 AVX-512 lanes per instruction).
+--> -DPRECISION_DOUBLE: 'real' is double everywhere (4 or 8 lanes).
+--> -DPRECISION_MIXED: 'real' is float, but the Shockley and square
+    law quadratics are solved again in double for the points whose
+    roots are ill-conditioned in float (see '_ill_conditioned_' of FET.h).
+
+Mixed mode gives float speed for the bulk of points and double
+accuracy where resistances differ by many orders of magnitude (e.g.
+Rs of 1 ohm against Idss and Vp of a typical JFET).
+*/
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <math.h>
+
+#ifndef PRECISION_DOUBLE
+#define PRECISION_DOUBLE 0
+#endif
+#ifndef PRECISION_MIXED
+#define PRECISION_MIXED 0
+#endif
+#if PRECISION_DOUBLE && PRECISION_MIXED
+#error "PRECISION_DOUBLE and PRECISION_MIXED can not be used together"
+#endif
+
+#if PRECISION_DOUBLE
+typedef double real;
+#define real_sqrt sqrt
+#define real_fabs fabs
+#define real_fmin fmin
+#define real_fmax fmax
+#define real_pow pow
+#define real_copysign copysign
+#define real_log log
+#define real_exp exp
+#define real_cos cos
+#else
+typedef float real;
+#define real_sqrt sqrtf
+#define real_fabs fabsf
+#define real_fmin fminf
+#define real_fmax fmaxf
+#define real_pow powf
+#define real_copysign copysignf
+#define real_log logf
+#define real_exp expf
+#define real_cos cosf
+#endif
+
+// A quadratic is ill-conditioned in float when the discriminant is
+// smaller than this fraction of b^2. Then it loses more than 3 of 7
+// digits by cancellation (the roots q/a and c/q themselves have none).
+#define PRECISION_ILL 1e-3f
+
+#endif
@@ -0,0 +1,206 @@
+/* Operating Regions
+
+The closed-form DC analysis takes the transistor in its amplifying
+region, so its results of other points are not valid, e.g. Vce < 0
+of BJT fixed-bias when Ic is over Icsat. DC results are classified
+into the operating regions of transistor.h:
+
+   REGION_CUTOFF      no current: BJT Ic <= 0, FET Vgs <= Vp (JFET and
+                      D-MOSFET) or Vgs <= Vgs(th) (E-MOSFET)
+   REGION_ACTIVE      amplifying region: BJT forward-active, FET
+                      saturation (pinch-off), Vds >= Vgs - Vp
+   REGION_SATURATION  BJT saturation, Vce <= REGION_VCESAT
+   REGION_TRIODE      FET ohmic region, Vds < Vgs - Vp
+   REGION_INVALID     a result (or Vp, Vgs(th)) is NaN, e.g. of
+                      invalid parameters or a failed Newton solve
+
+Closed forms of FETs give no drain current at cut-off points, and
+their Vgs and Vds are the ones of Id = 0, e.g. Vgs = Vds = Vdd of
+E-MOSFET drain-feedback, so results agree with their region.
+
+NaN is checked first, since every comparison with NaN is false and a
+NaN point would be REGION_CUTOFF otherwise. A code is made from
+comparisons by integer arithmetic, without branches, so loops over
+millions of points are vectorized and have no mispredictions. Scalar
+functions write the code into 'region' of their DC results.
+
+'run_region' classifies the points of a "dc" or "newton" entry from
+its result columns. 'run_filter' is the filter mode: points are
+evaluated by a DC entry and only the ones in the given regions are
+given to the second (usually expensive AC) entry. REGION_INVALID
+points are never given to it.
+*/
+
+#ifndef REGION_H
+#define REGION_H
+
+#include <stdlib.h>
+#include <string.h>
+#include "CONFIG.h"
+#include "SWEEP.h"
+
+// Largest Vce of a saturated BJT (V).
+#define REGION_VCESAT ((real) 0.2)
+
+KERNEL int _bjt_region_(real Ic, real Vce) {
+   // Region of a BJT from its collector current and voltage.
+   int valid = (Ic == Ic) & (Vce == Vce);
+   int on = Ic > 0, saturated = Vce <= REGION_VCESAT;
+   return valid * on * (REGION_ACTIVE + saturated *
+                        (REGION_SATURATION - REGION_ACTIVE)) +
+          !valid * REGION_INVALID;
+}
+
+KERNEL int _fet_region_(real Vgs, real Vds, real V) {
+   // Region of a FET from Vgs, Vds and Vp or Vgs(th) ('V').
+   int valid = (Vgs == Vgs) & (Vds == Vds) & (V == V);
+   int on = Vgs > V, triode = Vds < Vgs - V;
+   return valid * on * (REGION_ACTIVE + triode *
+                        (REGION_TRIODE - REGION_ACTIVE)) +
+          !valid * REGION_INVALID;
+}
+
+// Points that are classified together into a local array (a loop
+// with constant count and without aliasing is vectorized).
+#define REGION_BLOCK 256
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define REGION_SIMD 1
+#else
+#define REGION_SIMD 0
+#endif
+
+KERNEL void _regions_(const int fet, long n, real* x, real* y, real* V,
+                      unsigned char* region) {
+   // Regions of BJTs (x is Ic, y is Vce) or FETs (x is Vgs, y is Vds
+   // and V is Vp or Vgs(th)).
+   unsigned char r[REGION_BLOCK];
+   long i = 0;
+   for (; i + REGION_BLOCK <= n; i += REGION_BLOCK) {
+      if (fet)
+         for (int k = 0; k < REGION_BLOCK; k++)
+            r[k] = _fet_region_(x[i + k], y[i + k], V[i + k]);
+      else
+         for (int k = 0; k < REGION_BLOCK; k++)
+            r[k] = _bjt_region_(x[i + k], y[i + k]);
+      memcpy(region + i, r, REGION_BLOCK);
+   }
+   for (; i < n; i++)
+      region[i] = fet ? _fet_region_(x[i], y[i], V[i]) :
+                  _bjt_region_(x[i], y[i]);
+}
+
+// Baseline, AVX2 and AVX-512 copies of '_regions_' and
+// '_regions_batch_' which selects the widest one that the running
+// processor supports (double comparisons are packed into bytes only
+// by AVX2 and AVX-512).
+#if REGION_SIMD
+static void _regions_scalar_(int fet, long n, real* x, real* y, real* V,
+                             unsigned char* region) {
+   _regions_(fet, n, x, y, V, region);
+}
+__attribute__((target("avx2")))
+static void _regions_avx2_(int fet, long n, real* x, real* y, real* V,
+                           unsigned char* region) {
+   _regions_(fet, n, x, y, V, region);
+}
+__attribute__((target("avx512f")))
+static void _regions_avx512_(int fet, long n, real* x, real* y, real* V,
+                             unsigned char* region) {
+   _regions_(fet, n, x, y, V, region);
+}
+static void _regions_batch_(int fet, long n, real* x, real* y, real* V,
+                            unsigned char* region) {
+   if (__builtin_cpu_supports("avx512f"))
+      _regions_avx512_(fet, n, x, y, V, region);
+   else if (__builtin_cpu_supports("avx2"))
+      _regions_avx2_(fet, n, x, y, V, region);
+   else _regions_scalar_(fet, n, x, y, V, region);
+}
+#else
+static void _regions_batch_(int fet, long n, real* x, real* y, real* V,
+                            unsigned char* region) {
+   _regions_(fet, n, x, y, V, region);
+}
+#endif
+
+int run_region(struct Config* config, long n, real** in, real** out,
+               unsigned char* region) {
+   // Write regions of 'n' points of 'config' from its parameter
+   // columns 'in' and result columns 'out' into 'region'. -1 is
+   // returned if results of entry do not have the region.
+   char** outputs = config->outputs;
+   if (strcmp(config->family, "bjt") == 0) {
+      int Ic = _find_column_(outputs, config->nout, "Ic");
+      int Vce = _find_column_(outputs, config->nout, "Vce");
+      if (Ic < 0 || Vce < 0) return -1;
+      _regions_batch_(0, n, out[Ic], out[Vce], NULL, region);
+      return 0;
+   }
+   int Vgs = _find_column_(outputs, config->nout, "Vgs");
+   int Vds = _find_column_(outputs, config->nout, "Vds");
+   int V = _find_column_(config->inputs, config->nin,
+                         strcmp(config->family, "mosfet") ? "Vp" :
+                         "Vgsth");
+   if (Vgs < 0 || Vds < 0 || V < 0) return -1;
+   _regions_batch_(1, n, out[Vgs], out[Vds], in[V], region);
+   return 0;
+}
+
+static long _region_select_(long n, unsigned char* region, int regions,
+                            long* index) {
+   // Write indexes of points that are in 'regions' into 'index', the
+   // number of them is returned. Every index is written and the count
+   // is moved only for kept points, so there is no branch.
+   long m = 0;
+   for (long i = 0; i < n; i++) {
+      index[m] = i;
+      m += (regions >> region[i]) & 1;
+   }
+   return m;
+}
+
+long run_filter(struct Config* dc, struct Config* next, long n,
+                real** dc_in, real** next_in, int regions, real** out,
+                long* index) {
+   // Evaluate 'n' points by 'dc' (parameter columns 'dc_in') and then
+   // the ones in 'regions' (a set of REGION_MASK, REGION_INVALID is
+   // never kept) by 'next' (columns 'next_in' of same points). Results
+   // of 'next' are written into rows of 'out' in order of points and
+   // 'index' gets the point of each row. The number of rows is
+   // returned, -1 if results of 'dc' do not have the region or memory
+   // is not enough.
+   long rows = 0, size = SWEEP_CHUNK * sizeof(real);
+   real* results = malloc(dc->nout * size);
+   real* gathered = malloc(next->nin * size);
+   unsigned char* region = malloc(SWEEP_CHUNK);
+   long* kept = malloc(SWEEP_CHUNK * sizeof(long));
+   if (!results || !gathered || !region || !kept) rows = -1;
+   regions &= ~REGION_MASK(REGION_INVALID);
+   for (long i = 0; rows >= 0 && i < n; i += SWEEP_CHUNK) {
+      long m = n - i < SWEEP_CHUNK ? n - i : SWEEP_CHUNK;
+      real* in[CONFIG_COLUMNS];
+      real* o[CONFIG_COLUMNS];
+      for (int c = 0; c < dc->nin; c++) in[c] = dc_in[c] + i;
+      for (int c = 0; c < dc->nout; c++)
+         o[c] = results + c * SWEEP_CHUNK;
+      dc->batch(m, in, o);
+      if (run_region(dc, m, in, o, region) < 0) { rows = -1; break; }
+      long k = _region_select_(m, region, regions, kept);
+      if (k == 0) continue;
+      // Gather the kept points and evaluate only them.
+      for (int c = 0; c < next->nin; c++) {
+         in[c] = gathered + c * SWEEP_CHUNK;
+         for (long j = 0; j < k; j++)
+            in[c][j] = next_in[c][i + kept[j]];
+      }
+      for (int c = 0; c < next->nout; c++) o[c] = out[c] + rows;
+      next->batch(k, in, o);
+      for (long j = 0; j < k; j++) index[rows + j] = i + kept[j];
+      rows += k;
+   }
+   free(results); free(gathered); free(region); free(kept);
+   return rows;
+}
+
+#endif
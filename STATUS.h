@@ -0,0 +1,268 @@
+/* Status of Points
+
+Batch functions run their kernels over all points and do not check
+parameters, so a wrong point gives wrong numbers but does not stop a
+run of millions of points. Parameters are checked by a separate
+validation stage instead. Every parameter column has a domain which
+is found by its name:
+
+   STATUS_POSITIVE     0 < x < inf: resistors, ro, rd, beta, Idss,
+                       Idon, Is and BR
+   STATUS_NONNEGATIVE  0 <= x < inf: capacitors, Rsig and RL (zero is
+                       no pole or no load, see BODE.h), IKF and lambda
+   STATUS_NONZERO      finite and not zero: Vp
+   STATUS_FRACTION     0 < x <= 1: alpha
+   STATUS_FINITE       all other parameters (voltages)
+
+NaN and infinities are in no domain. 'run_validate' writes the set of parameter
+columns that are out of their domains (bit c for column c) of every
+point, like a mask of lanes. The comparisons are done without
+branches in blocks, so the stage is vectorized.
+
+'run_checked' is the batch function of an entry with validation: all
+points are evaluated, then results of invalid points are made NaN
+and every point gets a status code of transistor.h (STATUS_INVALID,
+or STATUS_NONFINITE if a valid point has a result that is not finite,
+e.g. a Newton solve that has not converged; a missing pole of BODE.h
+is zero, not infinity). So, one bad point costs one lane of a run.
+Scalar functions write the status into 'status' of their results and
+give NaN results in place of an assertion. They check the parameters
+of the 'Config' entry of each stage by '_status_valid_', so they give
+the status of 'run_checked'.
+*/
+
+#ifndef STATUS_H
+#define STATUS_H
+
+#include <string.h>
+#include <math.h>
+#include "CONFIG.h"
+#include "SWEEP.h"
+
+#define STATUS_FINITE 0
+#define STATUS_POSITIVE 1
+#define STATUS_NONNEGATIVE 2
+#define STATUS_NONZERO 3
+#define STATUS_FRACTION 4
+
+// Domains of parameters, other parameters are STATUS_FINITE.
+struct StatusDomain {
+   char* name;
+   int domain;
+};
+static struct StatusDomain status_domains[] = {
+   {"Rb", STATUS_POSITIVE}, {"Rb1", STATUS_POSITIVE},
+   {"Rb2", STATUS_POSITIVE}, {"Rc", STATUS_POSITIVE},
+   {"Re", STATUS_POSITIVE}, {"Rf", STATUS_POSITIVE},
+   {"Rf1", STATUS_POSITIVE}, {"Rf2", STATUS_POSITIVE},
+   {"Rg", STATUS_POSITIVE}, {"Rg1", STATUS_POSITIVE},
+   {"Rg2", STATUS_POSITIVE}, {"Rd", STATUS_POSITIVE},
+   {"Rs", STATUS_POSITIVE}, {"ro", STATUS_POSITIVE},
+   {"rd", STATUS_POSITIVE}, {"beta", STATUS_POSITIVE},
+   {"Idss", STATUS_POSITIVE}, {"Idon", STATUS_POSITIVE},
+   {"Is", STATUS_POSITIVE}, {"BR", STATUS_POSITIVE},
+   {"Rsig", STATUS_NONNEGATIVE}, {"RL", STATUS_NONNEGATIVE},
+   {"Cin", STATUS_NONNEGATIVE}, {"Cout", STATUS_NONNEGATIVE},
+   {"Ce", STATUS_NONNEGATIVE}, {"Cs", STATUS_NONNEGATIVE},
+   {"Cbe", STATUS_NONNEGATIVE}, {"Cbc", STATUS_NONNEGATIVE},
+   {"Cgs", STATUS_NONNEGATIVE}, {"Cgd", STATUS_NONNEGATIVE},
+   {"IKF", STATUS_NONNEGATIVE}, {"lambda", STATUS_NONNEGATIVE},
+   {"Vp", STATUS_NONZERO}, {"alpha", STATUS_FRACTION}
+};
+
+static int _status_domain_(char* name) {
+   // Domain of the parameter column 'name'.
+   int n = sizeof(status_domains) / sizeof(status_domains[0]);
+   for (int i = 0; i < n; i++)
+      if (strcmp(status_domains[i].name, name) == 0)
+         return status_domains[i].domain;
+   return STATUS_FINITE;
+}
+
+KERNEL int _status_valid_(const int domain, real x) {
+   // 1 if 'x' is in 'domain', 0 if not (NaN and infinities are
+   // never). x - x is zero only for finite numbers.
+   int finite = x - x == 0;
+   switch (domain) {
+   case STATUS_POSITIVE: return finite & (x > 0);
+   case STATUS_NONNEGATIVE: return finite & (x >= 0);
+   case STATUS_NONZERO: return finite & (x != 0);
+   case STATUS_FRACTION: return (x > 0) & (x <= 1);
+   default: return finite;
+   }
+}
+
+// Points that are checked together into local arrays (see REGION.h).
+#define STATUS_BLOCK 256
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STATUS_SIMD 1
+#else
+#define STATUS_SIMD 0
+#endif
+
+KERNEL void _status_column_(const int domain, long n, real* x, int c,
+                            unsigned* invalid) {
+   // Add bit 'c' to 'invalid' of points whose 'x' is out of 'domain'.
+   real v[STATUS_BLOCK];
+   unsigned m[STATUS_BLOCK];
+   long i = 0;
+   for (; i + STATUS_BLOCK <= n; i += STATUS_BLOCK) {
+      memcpy(v, x + i, sizeof(v));
+      memcpy(m, invalid + i, sizeof(m));
+      for (int k = 0; k < STATUS_BLOCK; k++)
+         m[k] |= (unsigned) !_status_valid_(domain, v[k]) << c;
+      memcpy(invalid + i, m, sizeof(m));
+   }
+   for (; i < n; i++)
+      invalid[i] |= (unsigned) !_status_valid_(domain, x[i]) << c;
+}
+
+KERNEL void _status_validate_(int domain, long n, real* x, int c,
+                              unsigned* invalid) {
+   // '_status_column_' specialized for the domain.
+   switch (domain) {
+   case STATUS_POSITIVE:
+      _status_column_(STATUS_POSITIVE, n, x, c, invalid); break;
+   case STATUS_NONNEGATIVE:
+      _status_column_(STATUS_NONNEGATIVE, n, x, c, invalid); break;
+   case STATUS_NONZERO:
+      _status_column_(STATUS_NONZERO, n, x, c, invalid); break;
+   case STATUS_FRACTION:
+      _status_column_(STATUS_FRACTION, n, x, c, invalid); break;
+   default: _status_column_(STATUS_FINITE, n, x, c, invalid);
+   }
+}
+
+KERNEL void _status_mark_(int nout, long n, real** out,
+                          unsigned* invalid, unsigned char* status) {
+   // Make results of invalid points NaN and write status codes.
+   real nan[STATUS_BLOCK], v[STATUS_BLOCK];
+   unsigned m[STATUS_BLOCK], bad[STATUS_BLOCK];
+   unsigned char s[STATUS_BLOCK];
+   long i = 0;
+   for (; i + STATUS_BLOCK <= n; i += STATUS_BLOCK) {
+      memcpy(m, invalid + i, sizeof(m));
+      for (int k = 0; k < STATUS_BLOCK; k++) {
+         nan[k] = m[k] ? NAN : 0;
+         bad[k] = 0;
+      }
+      for (int c = 0; c < nout; c++) {
+         memcpy(v, out[c] + i, sizeof(v));
+         for (int k = 0; k < STATUS_BLOCK; k++) {
+            bad[k] |= !(v[k] - v[k] == 0);
+            v[k] += nan[k];
+         }
+         memcpy(out[c] + i, v, sizeof(v));
+      }
+      for (int k = 0; k < STATUS_BLOCK; k++)
+         s[k] = m[k] ? STATUS_INVALID : bad[k] * STATUS_NONFINITE;
+      memcpy(status + i, s, sizeof(s));
+   }
+   for (; i < n; i++) {
+      int finite = 1;
+      for (int c = 0; c < nout; c++) {
+         finite &= out[c][i] - out[c][i] == 0;
+         out[c][i] += invalid[i] ? NAN : 0;
+      }
+      status[i] = invalid[i] ? STATUS_INVALID :
+                  !finite * STATUS_NONFINITE;
+   }
+}
+
+// Baseline, AVX2 and AVX-512 copies of the validation and marking
+// loops and the '_batch_' functions which select the widest one like
+// '_regions_batch_' of REGION.h.
+#if STATUS_SIMD
+static void _status_validate_scalar_(int domain, long n, real* x, int c,
+                                     unsigned* invalid) {
+   _status_validate_(domain, n, x, c, invalid);
+}
+__attribute__((target("avx2")))
+static void _status_validate_avx2_(int domain, long n, real* x, int c,
+                                   unsigned* invalid) {
+   _status_validate_(domain, n, x, c, invalid);
+}
+__attribute__((target("avx512f")))
+static void _status_validate_avx512_(int domain, long n, real* x, int c,
+                                     unsigned* invalid) {
+   _status_validate_(domain, n, x, c, invalid);
+}
+static void _status_validate_batch_(int domain, long n, real* x, int c,
+                                    unsigned* invalid) {
+   if (__builtin_cpu_supports("avx512f"))
+      _status_validate_avx512_(domain, n, x, c, invalid);
+   else if (__builtin_cpu_supports("avx2"))
+      _status_validate_avx2_(domain, n, x, c, invalid);
+   else _status_validate_scalar_(domain, n, x, c, invalid);
+}
+static void _status_mark_scalar_(int nout, long n, real** out,
+                                 unsigned* invalid, unsigned char* status) {
+   _status_mark_(nout, n, out, invalid, status);
+}
+__attribute__((target("avx2")))
+static void _status_mark_avx2_(int nout, long n, real** out,
+                               unsigned* invalid, unsigned char* status) {
+   _status_mark_(nout, n, out, invalid, status);
+}
+__attribute__((target("avx512f")))
+static void _status_mark_avx512_(int nout, long n, real** out,
+                                 unsigned* invalid, unsigned char* status) {
+   _status_mark_(nout, n, out, invalid, status);
+}
+static void _status_mark_batch_(int nout, long n, real** out,
+                                unsigned* invalid, unsigned char* status) {
+   if (__builtin_cpu_supports("avx512f"))
+      _status_mark_avx512_(nout, n, out, invalid, status);
+   else if (__builtin_cpu_supports("avx2"))
+      _status_mark_avx2_(nout, n, out, invalid, status);
+   else _status_mark_scalar_(nout, n, out, invalid, status);
+}
+#else
+static void _status_validate_batch_(int domain, long n, real* x, int c,
+                                    unsigned* invalid) {
+   _status_validate_(domain, n, x, c, invalid);
+}
+static void _status_mark_batch_(int nout, long n, real** out,
+                                unsigned* invalid, unsigned char* status) {
+   _status_mark_(nout, n, out, invalid, status);
+}
+#endif
+
+long run_validate(struct Config* config, long n, real** in,
+                  unsigned* invalid) {
+   // Write the set of parameter columns of each of 'n' points which
+   // are out of their domains into 'invalid' (bit c for 'in[c]', zero
+   // for a valid point). The number of invalid points is returned.
+   memset(invalid, 0, n * sizeof(unsigned));
+   for (int c = 0; c < config->nin; c++)
+      _status_validate_batch_(_status_domain_(config->inputs[c]), n,
+                              in[c], c, invalid);
+   long count = 0;
+   for (long i = 0; i < n; i++) count += invalid[i] != 0;
+   return count;
+}
+
+long run_checked(struct Config* config, long n, real** in, real** out,
+                 unsigned char* status) {
+   // Evaluate 'n' points of 'config' like its batch function and
+   // write the status code of every point into 'status'. Results of
+   // invalid points are NaN. The number of points which are not
+   // STATUS_OK is returned.
+   unsigned invalid[SWEEP_CHUNK];
+   long count = 0;
+   for (long i = 0; i < n; i += SWEEP_CHUNK) {
+      long m = n - i < SWEEP_CHUNK ? n - i : SWEEP_CHUNK;
+      real* p[CONFIG_COLUMNS];
+      real* o[CONFIG_COLUMNS];
+      for (int c = 0; c < config->nin; c++) p[c] = in[c] + i;
+      for (int c = 0; c < config->nout; c++) o[c] = out[c] + i;
+      run_validate(config, m, p, invalid);
+      config->batch(m, p, o);
+      _status_mark_batch_(config->nout, m, o, invalid, status + i);
+      for (long j = 0; j < m; j++) count += status[i + j] != STATUS_OK;
+   }
+   return count;
+}
+
+#endif
@@ -0,0 +1,314 @@
+/* Multithreaded Parameter Sweeps
+
+A sweep evaluates one configuration (an entry of 'BJTConfigs',
+'FETConfigs' or 'MOSFETConfigs') over a grid of parameter values
+(every combination of them) or over a list of points (i'th values
+of all parameters form the i'th point).
+
+Points are spread across all cores by a work-stealing scheduler.
+Every thread starts with an equal range of points and takes small
+chunks from the front of its own range. A thread that finishes its
+range steals the back half of the range of another thread, so slow
+and fast threads finish at nearly same time. Each thread writes its
+results into its own buffer and buffers are merged at the end.
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "CONFIG.h"
+
+// Number of points that is given to a batch function at once.
+#define SWEEP_CHUNK 1024
+
+// Range of points which is owned by a thread.
+struct SweepRange {
+   pthread_mutex_t lock; // lock of range for stealing
+   long begin; // first point which is not taken yet
+   long end; // end of range (not included)
+};
+
+// State of a scheduled job which is shared by all threads.
+struct Schedule {
+   int threads; // number of threads
+   long chunk; // number of points that a thread takes at once
+   struct SweepRange* ranges; // ranges of threads
+   // Task which evaluates points of [begin, end) in a thread.
+   void (*task)(long begin, long end, int thread, void* context);
+   void* context; // context of task
+};
+
+// Argument of a scheduler thread.
+struct ScheduleThread {
+   struct Schedule* schedule;
+   int id;
+};
+
+static int _take_chunk_(struct SweepRange* range, long chunk, long* begin,
+                        long* end) {
+   // Take a chunk from front of the own range of thread.
+   int taken = 0;
+   pthread_mutex_lock(&range->lock);
+   if (range->begin < range->end) {
+      *begin = range->begin;
+      *end = range->end - *begin > chunk ? *begin + chunk : range->end;
+      range->begin = *end;
+      taken = 1;
+   }
+   pthread_mutex_unlock(&range->lock);
+   return taken;
+}
+
+static int _steal_range_(struct Schedule* schedule, int id) {
+   // Steal back half of the range of another thread. Zero is returned
+   // when all ranges are empty.
+   for (int k = 1; k < schedule->threads; k++) {
+      struct SweepRange* victim = &schedule->ranges[(id + k) %
+                                                    schedule->threads];
+      long begin = 0, end = 0;
+      pthread_mutex_lock(&victim->lock);
+      if (victim->begin < victim->end) {
+         end = victim->end;
+         begin = victim->begin + (victim->end - victim->begin) / 2;
+         victim->end = begin;
+      }
+      pthread_mutex_unlock(&victim->lock);
+      if (begin < end) {
+         pthread_mutex_lock(&schedule->ranges[id].lock);
+         schedule->ranges[id].begin = begin;
+         schedule->ranges[id].end = end;
+         pthread_mutex_unlock(&schedule->ranges[id].lock);
+         return 1;
+      }
+   }
+   return 0;
+}
+
+static void* _schedule_worker_(void* argument) {
+   // Evaluate chunks of own range, then steal from other threads.
+   struct ScheduleThread* thread = argument;
+   struct Schedule* schedule = thread->schedule;
+   long begin, end;
+   for (;;) {
+      if (_take_chunk_(&schedule->ranges[thread->id], schedule->chunk,
+                       &begin, &end))
+         schedule->task(begin, end, thread->id, schedule->context);
+      else if (!_steal_range_(schedule, thread->id)) break;
+   }
+   return NULL;
+}
+
+static int _sweep_threads_(int threads) {
+   // Number of threads to use, all cores if 'threads' is not given.
+   if (threads <= 0) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+   return threads > 0 ? threads : 1;
+}
+
+static int _schedule_chunks_(long total, long chunk, int threads,
+                             void (*task)(long, long, int, void*),
+                             void* context) {
+   // Run 'task' over points [0, total) on 'threads' threads, a thread
+   // takes 'chunk' points at once. The calling thread works as thread
+   // zero.
+   struct Schedule schedule = {threads, chunk, NULL, task, context};
+   schedule.ranges = malloc(threads * sizeof(struct SweepRange));
+   pthread_t* handles = malloc(threads * sizeof(pthread_t));
+   struct ScheduleThread* args = malloc(threads *
+                                        sizeof(struct ScheduleThread));
+   int* started = calloc(threads, sizeof(int));
+   if (!schedule.ranges || !handles || !args || !started) {
+      free(schedule.ranges); free(handles); free(args); free(started);
+      return -1;
+   }
+   // Split points into equal ranges.
+   for (int t = 0; t < threads; t++) {
+      pthread_mutex_init(&schedule.ranges[t].lock, NULL);
+      schedule.ranges[t].begin = total * t / threads;
+      schedule.ranges[t].end = total * (t + 1) / threads;
+      args[t].schedule = &schedule; args[t].id = t;
+   }
+   // If a thread can not be created, its range is stolen by others.
+   for (int t = 1; t < threads; t++)
+      started[t] = pthread_create(&handles[t], NULL, _schedule_worker_,
+                                  &args[t]) == 0;
+   _schedule_worker_(&args[0]);
+   for (int t = 1; t < threads; t++)
+      if (started[t]) pthread_join(handles[t], NULL);
+   for (int t = 0; t < threads; t++)
+      pthread_mutex_destroy(&schedule.ranges[t].lock);
+   free(schedule.ranges); free(handles); free(args); free(started);
+   return 0;
+}
+
+static int _schedule_(long total, int threads,
+                      void (*task)(long, long, int, void*), void* context) {
+   // Run 'task' over points [0, total) in chunks of SWEEP_CHUNK.
+   return _schedule_chunks_(total, SWEEP_CHUNK, threads, task, context);
+}
+
+/* Sweeps over Configurations */
+
+// struct Sweep is public, it is in transistor.h.
+
+// Results of a thread, they are merged after all threads finish.
+struct SweepBuffer {
+   long size, capacity; // number of stored and allocated points
+   real* columns[CONFIG_COLUMNS]; // result columns
+   long chunks, chunk_capacity; // number of stored and allocated chunks
+   long* starts; // first point of each chunk
+   long* lengths; // number of points of each chunk
+   real* inputs[CONFIG_COLUMNS]; // parameter columns of a chunk
+   int failed; // set if the buffer can not be grown
+};
+
+// Context of a sweep which is shared by its threads.
+struct SweepContext {
+   struct Sweep* sweep;
+   struct SweepBuffer* buffers;
+};
+
+long sweep_points(struct Sweep* sweep) {
+   // Find the number of points of sweep.
+   long total = sweep->grid ? 1 : 0;
+   for (int c = 0; c < sweep->config->nin; c++) {
+      if (sweep->grid) total *= sweep->counts[c];
+      else if (sweep->counts[c] > total) total = sweep->counts[c];
+   }
+   return total;
+}
+
+void sweep_range(real start, real stop, long count, int logarithmic,
+                 real* values) {
+   // Fill 'values' with 'count' linearly or logarithmically spaced
+   // values from 'start' to 'stop'.
+   for (long i = 0; i < count; i++) {
+      real t = count > 1 ? (real) i / (count - 1) : 0;
+      if (logarithmic) values[i] = start * real_pow(stop / start, t);
+      else values[i] = start + (stop - start) * t;
+   }
+}
+
+static void _sweep_inputs_(struct Sweep* sweep, long begin, long n,
+                           real** inputs) {
+   // Write parameters of points [begin, begin + n) into 'inputs'.
+   int nin = sweep->config->nin;
+   if (!sweep->grid) {
+      for (int c = 0; c < nin; c++) {
+         if (sweep->counts[c] == 1)
+            for (long j = 0; j < n; j++)
+               inputs[c][j] = sweep->values[c][0];
+         else memcpy(inputs[c], sweep->values[c] + begin,
+                     n * sizeof(real));
+      }
+      return;
+   }
+   // In a grid, the last parameter changes fastest. Find indexes of
+   // first point and then count up like an odometer.
+   long digits[CONFIG_COLUMNS];
+   long rest = begin;
+   for (int c = nin - 1; c >= 0; c--) {
+      digits[c] = rest % sweep->counts[c];
+      rest /= sweep->counts[c];
+   }
+   for (long j = 0; j < n; j++) {
+      for (int c = 0; c < nin; c++)
+         inputs[c][j] = sweep->values[c][digits[c]];
+      for (int c = nin - 1; c >= 0; c--) {
+         if (++digits[c] < sweep->counts[c]) break;
+         digits[c] = 0;
+      }
+   }
+}
+
+static int _grow_buffer_(struct SweepBuffer* buffer, int nout, long n) {
+   // Make room for 'n' more points and one more chunk.
+   if (buffer->size + n > buffer->capacity) {
+      long capacity = buffer->capacity ? buffer->capacity : SWEEP_CHUNK;
+      while (capacity < buffer->size + n) capacity *= 2;
+      for (int c = 0; c < nout; c++) {
+         real* column = realloc(buffer->columns[c],
+                                 capacity * sizeof(real));
+         if (!column) return 0;
+         buffer->columns[c] = column;
+      }
+      buffer->capacity = capacity;
+   }
+   if (buffer->chunks == buffer->chunk_capacity) {
+      long capacity = buffer->chunk_capacity ? 2 * buffer->chunk_capacity
+                                             : 64;
+      long* starts = realloc(buffer->starts, capacity * sizeof(long));
+      if (starts) buffer->starts = starts;
+      long* lengths = realloc(buffer->lengths, capacity * sizeof(long));
+      if (lengths) buffer->lengths = lengths;
+      if (!starts || !lengths) return 0;
+      buffer->chunk_capacity = capacity;
+   }
+   return 1;
+}
+
+static void _sweep_task_(long begin, long end, int thread, void* context) {
+   // Evaluate a chunk of sweep into buffer of the thread.
+   struct SweepContext* sweep = context;
+   struct SweepBuffer* buffer = &sweep->buffers[thread];
+   struct Config* config = sweep->sweep->config;
+   long n = end - begin;
+   if (buffer->failed || !_grow_buffer_(buffer, config->nout, n)) {
+      buffer->failed = 1;
+      return;
+   }
+   real* outputs[CONFIG_COLUMNS];
+   for (int c = 0; c < config->nout; c++)
+      outputs[c] = buffer->columns[c] + buffer->size;
+   _sweep_inputs_(sweep->sweep, begin, n, buffer->inputs);
+   config->batch(n, buffer->inputs, outputs);
+   buffer->starts[buffer->chunks] = begin;
+   buffer->lengths[buffer->chunks++] = n;
+   buffer->size += n;
+}
+
+int run_sweep(struct Sweep* sweep, int threads, real** results) {
+   // Evaluate all points of sweep on 'threads' threads (all cores if
+   // it is zero). Each of 'results' columns must have room for
+   // 'sweep_points' values. -1 is returned if memory is not enough
+   // or a parameter of a list has neither one value nor one value for
+   // each point.
+   struct Config* config = sweep->config;
+   long total = sweep_points(sweep);
+   for (int c = 0; !sweep->grid && c < config->nin; c++)
+      if (sweep->counts[c] != 1 && sweep->counts[c] != total) return -1;
+   threads = _sweep_threads_(threads);
+   struct SweepContext context = {sweep, NULL};
+   context.buffers = calloc(threads, sizeof(struct SweepBuffer));
+   if (!context.buffers) return -1;
+   int status = 0;
+   for (int t = 0; t < threads; t++)
+      for (int c = 0; c < config->nin; c++)
+         if (!(context.buffers[t].inputs[c] =
+               malloc(SWEEP_CHUNK * sizeof(real)))) status = -1;
+   if (status == 0)
+      status = _schedule_(total, threads, _sweep_task_, &context);
+   // Merge buffers of threads into result columns.
+   for (int t = 0; t < threads; t++) {
+      struct SweepBuffer* buffer = &context.buffers[t];
+      if (buffer->failed) status = -1;
+      for (long k = 0, offset = 0; status == 0 && k < buffer->chunks;
+           offset += buffer->lengths[k++])
+         for (int c = 0; c < config->nout; c++)
+            memcpy(results[c] + buffer->starts[k],
+                   buffer->columns[c] + offset,
+                   buffer->lengths[k] * sizeof(real));
+      for (int c = 0; c < CONFIG_COLUMNS; c++) {
+         free(buffer->columns[c]); free(buffer->inputs[c]);
+      }
+      free(buffer->starts); free(buffer->lengths);
+   }
+   free(context.buffers);
+   return status;
+}
+
+#endif
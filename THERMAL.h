@@ -0,0 +1,188 @@
+/* Temperature Sweeps
+
+Parameters of configurations are given at a reference temperature T0
+(27 °C). At another temperature T, the device parameters change
+linearly with dT = T - T0 by the coefficients of 'Thermal':
+
+   Vbe   = Vbe(T0) + dVbe * dT            (about -2.2 mV/°C)
+   VT    = VT(T0) * (T + 273.15) / (T0 + 273.15)
+   beta  = beta(T0) * (1 + dbeta * dT)    (alpha through beta)
+   Idss  = Idss(T0) * (1 + dIdss * dT)
+   Vp    = Vp(T0) + dVp * dT
+   Vgsth = Vgsth(T0) + dVgsth * dT        (Vgson moves with Vgsth)
+   Idon  = Idon(T0) * (1 + dk * dT)       (k of the square law)
+   Is    = Is(T0) * (T/T0)^XTI * exp(Eg/VT(T0) * (1 - T0/T))
+
+with T and T0 in kelvin in the ratios. Is of the "newton" entries
+follows the saturation current of SPICE, so it is not linear: it
+doubles about every 5 °C at room temperature.
+
+Vgs(on) is moved with Vgs(th), so the overdrive of the Id(on) point
+is kept and k changes only by 'dk'. Resistors do not depend on
+temperature.
+
+Device parameters of FETs and MOSFETs are columns, so they are
+changed before the batch function is called. Vbe and VT of BJTs are
+constants of kernels; the 'thermal' function of a configuration
+entry takes them as arguments ("newton" entries take VT and start at
+Vbe, their Vbe is solved from Is). "bode" entries of BJTs use Vbe and
+VT of T0.
+
+'run_thermal' evaluates n points at every temperature of a list (row
+t * n + i is point i at temperature t). Rows are spread across all
+cores in chunks of SWEEP_CHUNK (see SWEEP.h); a chunk is split where
+the temperature changes, so every batch call has one temperature and
+only the columns that depend on temperature are copied. A list of
+temperatures can be made by 'sweep_range'.
+*/
+
+#ifndef THERMAL_H
+#define THERMAL_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "CONFIG.h"
+#include "SWEEP.h"
+
+// struct Thermal is public, it is in transistor.h.
+
+// Kelvin of 0 °C.
+#define THERMAL_KELVIN 273.15
+
+void thermal_defaults(struct Thermal* thermal) {
+   // Typical coefficients of small-signal silicon transistors. Vbe and
+   // VT are BJT_VBE and BJT_VT of BJT.h.
+   thermal->T0 = 27;
+   thermal->Vbe = 0.7; thermal->VT = 0.026;
+   thermal->dVbe = -2.2e-3;
+   thermal->dbeta = 5e-3;
+   thermal->dIdss = -5e-3;
+   thermal->dVp = 2e-3;
+   thermal->dVgsth = -2e-3;
+   thermal->dk = -5e-3;
+   thermal->XTI = 3; thermal->Eg = 1.11;
+}
+
+// Change of a parameter column per °C: relative to the value, added
+// to the value, through beta for "alpha", or the saturation current.
+struct ThermalColumn {
+   real relative, shift;
+   int alpha, saturation;
+};
+
+// Context of a temperature sweep which is shared by its threads.
+struct ThermalContext {
+   struct Thermal* thermal;
+   struct Config* config;
+   long n; // number of points
+   real** in; // parameter columns of points
+   real* temperatures;
+   real** out; // result columns (nt * n rows)
+   struct ThermalColumn columns[CONFIG_COLUMNS];
+   real** scratch; // changed columns, nin of each thread
+};
+
+static struct ThermalColumn _thermal_column_(struct Thermal* thermal,
+                                             char* name) {
+   // Change of parameter column 'name' per °C.
+   struct ThermalColumn column = {0, 0, 0, 0};
+   if (strcmp(name, "beta") == 0) column.relative = thermal->dbeta;
+   else if (strcmp(name, "alpha") == 0) {
+      column.relative = thermal->dbeta;
+      column.alpha = 1;
+   }
+   else if (strcmp(name, "Idss") == 0) column.relative = thermal->dIdss;
+   else if (strcmp(name, "Vp") == 0) column.shift = thermal->dVp;
+   else if (strcmp(name, "Vgsth") == 0 || strcmp(name, "Vgson") == 0)
+      column.shift = thermal->dVgsth;
+   else if (strcmp(name, "Idon") == 0) column.relative = thermal->dk;
+   else if (strcmp(name, "Is") == 0) column.saturation = 1;
+   return column;
+}
+
+static real _thermal_saturation_(struct Thermal* thermal, real T) {
+   // Is(T) / Is(T0).
+   real ratio = (T + THERMAL_KELVIN) / (thermal->T0 + THERMAL_KELVIN);
+   return real_pow(ratio, thermal->XTI) *
+          real_exp(thermal->Eg / thermal->VT * (1 - 1 / ratio));
+}
+
+static void _thermal_inputs_(struct Thermal* thermal,
+                             struct ThermalColumn column, real T, long n,
+                             real* in, real* out) {
+   // Write parameters at temperature T into 'out'.
+   real dT = T - thermal->T0;
+   real scale = column.saturation ? _thermal_saturation_(thermal, T) :
+                1 + column.relative * dT;
+   real shift = column.shift * dT;
+   if (column.alpha)
+      for (long j = 0; j < n; j++) {
+         real beta = in[j] / (1 - in[j]) * scale;
+         out[j] = beta / (beta + 1);
+      }
+   else
+      for (long j = 0; j < n; j++) out[j] = in[j] * scale + shift;
+}
+
+static void _thermal_task_(long begin, long end, int thread,
+                           void* context) {
+   // Evaluate rows [begin, end), one batch call for each temperature.
+   struct ThermalContext* sweep = context;
+   struct Config* config = sweep->config;
+   struct Thermal* thermal = sweep->thermal;
+   real** scratch = sweep->scratch + thread * config->nin;
+   while (begin < end) {
+      long t = begin / sweep->n, i = begin % sweep->n;
+      long stop = (t + 1) * sweep->n < end ? (t + 1) * sweep->n : end;
+      long n = stop - begin;
+      real T = sweep->temperatures[t], dT = T - thermal->T0;
+      real* inputs[CONFIG_COLUMNS];
+      real* outputs[CONFIG_COLUMNS];
+      for (int c = 0; c < config->nin; c++) {
+         struct ThermalColumn column = sweep->columns[c];
+         inputs[c] = sweep->in[c] + i;
+         if (column.relative == 0 && column.shift == 0 &&
+             !column.saturation) continue;
+         _thermal_inputs_(thermal, column, T, n, inputs[c], scratch[c]);
+         inputs[c] = scratch[c];
+      }
+      for (int c = 0; c < config->nout; c++)
+         outputs[c] = sweep->out[c] + begin;
+      if (config->thermal)
+         config->thermal(thermal->Vbe + thermal->dVbe * dT,
+                         thermal->VT * (T + THERMAL_KELVIN) /
+                         (thermal->T0 + THERMAL_KELVIN),
+                         n, inputs, outputs);
+      else config->batch(n, inputs, outputs);
+      begin = stop;
+   }
+}
+
+int run_thermal(struct Thermal* thermal, struct Config* config, long n,
+                real** in, long nt, real* temperatures, int threads,
+                real** out) {
+   // Evaluate 'n' points of 'in' columns at 'nt' temperatures (°C) on
+   // 'threads' threads (all cores if it is zero). Each of 'out'
+   // columns must have room for nt * n values, point i at temperature
+   // t is at t * n + i. -1 is returned if memory is not enough.
+   struct ThermalContext context = {thermal, config, n, in,
+                                    temperatures, out, {{0}}, NULL};
+   for (int c = 0; c < config->nin; c++)
+      context.columns[c] = _thermal_column_(thermal, config->inputs[c]);
+   threads = _sweep_threads_(threads);
+   long size = (long) threads * config->nin;
+   context.scratch = calloc(size > 0 ? size : 1, sizeof(real*));
+   int status = context.scratch ? 0 : -1;
+   for (long k = 0; status == 0 && k < size; k++)
+      if (!(context.scratch[k] = malloc(SWEEP_CHUNK * sizeof(real))))
+         status = -1;
+   if (status == 0)
+      status = _schedule_(nt * n, threads, _thermal_task_, &context);
+   for (long k = 0; context.scratch && k < size; k++)
+      free(context.scratch[k]);
+   free(context.scratch);
+   return status;
+}
+
+#endif
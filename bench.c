@@ -0,0 +1,295 @@
+/* Benchmarks of All Transistor Configurations
+
+Every configuration of 'BJTConfigs', 'FETConfigs' and 'MOSFETConfigs'
+is timed on randomized but physically valid parameters in these
+modes:
+
+--> 'scalar' calls the original configuration function (e.g.
+    'b_voltage_divider') once per point.
+--> 'batch' calls the batch function of configuration once for all
+    points on one thread.
+--> 'mt' evaluates all points as a list sweep (SWEEP.h) on all cores
+    or on the number of threads given by '-t'.
+--> 'cache' queries an operating-point cache (CACHE.h) one point at
+    a time. Points repeat every BENCH_CACHE_POINTS, so after warm up
+    every query is a hit (like a slider that is moved back and forth).
+--> 'jacobian' evaluates results and their derivatives with respect
+    to all parameters (DUAL.h) one point at a time.
+--> 'response' computes the complex gain, input and output impedance
+    of a "bode" entry (BODE.h) at BENCH_FREQUENCIES frequencies, one
+    design at a time. Only every BENCH_RESPONSE_STRIDE-th point is a
+    design, and the designs are the reported points.
+--> 'thermal' evaluates the first points at BENCH_TEMPERATURES
+    temperatures from -40 to 125 °C (THERMAL.h) on all cores or on
+    the number of threads given by '-t'. All rows are the reported
+    points.
+--> 'region' calls the batch function of a "dc" or "newton" entry
+    and classifies the operating region of every point (REGION.h).
+--> 'checked' validates the parameters of every point and calls the
+    batch function with status codes (STATUS.h).
+--> 'mixed' evaluates a batch whose every second point is the p-type
+    mirror (pnp or p-channel) of its n-type parameters (POLARITY.h).
+
+bench only measures. Results of the modes are checked by the tests
+('make test', see test.c), which use the same points (POINTS.h).
+
+"bode" entries have no scalar functions and no Jacobians, so only
+their 'batch', 'mt', 'cache' and 'response' modes are timed. "newton"
+entries (NEWTON.h) have no scalar functions either.
+
+Each measurement is repeated and the fastest run is reported as one
+CSV line: family, configuration, analysis, option, mode, points,
+threads, ns/point, points/s and cycles/point (time-stamp counter
+cycles, 0 if there is not one). The CSV lines are stable, so results
+of two releases can be compared by a script.
+
+Build: gcc -O2 -pthread bench.c -o build/bench -lm
+       (add -DPRECISION_DOUBLE or -DPRECISION_MIXED, see PRECISION.h)
+Usage: bench [-n points] [-r repeats] [-t threads]
+             [-m scalar|batch|mt|cache|jacobian|response|thermal|
+                 region|checked|mixed]
+             [-f bjt|fet|mosfet]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "POINTS.h"
+#include "SWEEP.h"
+#include "THERMAL.h"
+#include "REGION.h"
+#include "STATUS.h"
+#include "POLARITY.h"
+#include "CACHE.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define _cycles_() __rdtsc()
+#else
+#define _cycles_() 0
+#endif
+
+/* Measurements */
+
+// Number of different points of 'cache' mode.
+#define BENCH_CACHE_POINTS 4096
+// Frequencies of a design of 'response' mode (1 Hz to 100 MHz) and
+// the stride of its designs in the points.
+#define BENCH_FREQUENCIES 1024
+#define BENCH_RESPONSE_STRIDE 256
+// Temperatures of 'thermal' mode (-40 to 125 °C by 1 °C).
+#define BENCH_TEMPERATURES 166
+// Cache of 'cache' mode, it is shared by all configurations.
+struct OpCache* bench_cache;
+// Regions or status codes of points of 'region' and 'checked' modes.
+unsigned char* bench_codes;
+// Polarities of points of 'mixed' mode, n-type and p-type in turn.
+real* bench_polarity;
+
+struct BodeModel* _bench_bode_(struct Config* config) {
+   // Frequency-response model of a "bode" entry.
+   struct BodeModel* tables[] = {BJTBodeModels, FETBodeModels,
+                                 MOSFETBodeModels};
+   int counts[] = {BJTBodeModelCount, FETBodeModelCount,
+                   MOSFETBodeModelCount};
+   for (int t = 0; t < 3; t++)
+      for (int i = 0; i < counts[t]; i++) {
+         struct BodeModel* model = &tables[t][i];
+         if (strcmp(model->family, config->family) == 0 &&
+             strcmp(model->name, config->name) == 0 &&
+             (model->option == config->option ||
+              (model->option && config->option &&
+               strcmp(model->option, config->option) == 0)))
+            return model;
+      }
+   return NULL;
+}
+
+double _now_() {
+   struct timespec time;
+   clock_gettime(CLOCK_MONOTONIC, &time);
+   return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+void _run_mode_(struct Config* config, char* mode, long n, int threads,
+                real** in, real** out) {
+   // Evaluate all points once in 'mode'.
+   if (strcmp(mode, "scalar") == 0)
+      for (long i = 0; i < n; i++)
+         _scalar_call_(config, i, in, out, NULL);
+   else if (strcmp(mode, "batch") == 0) config->batch(n, in, out);
+   else if (strcmp(mode, "region") == 0) {
+      config->batch(n, in, out);
+      run_region(config, n, in, out, bench_codes);
+   }
+   else if (strcmp(mode, "checked") == 0)
+      run_checked(config, n, in, out, bench_codes);
+   else if (strcmp(mode, "mixed") == 0)
+      run_mixed(config, n, in, bench_polarity, out);
+   else if (strcmp(mode, "cache") == 0) {
+      real point[CONFIG_COLUMNS], results[CONFIG_COLUMNS];
+      for (long i = 0; i < n; i++) {
+         long k = i % BENCH_CACHE_POINTS;
+         for (int c = 0; c < config->nin; c++) point[c] = in[c][k];
+         op_cache_eval(bench_cache, config, point, results);
+         for (int c = 0; c < config->nout; c++) out[c][i] = results[c];
+      }
+   }
+   else if (strcmp(mode, "response") == 0) {
+      // 'out' columns have room for frequencies and curves of a design.
+      struct BodeModel* model = _bench_bode_(config);
+      real point[CONFIG_COLUMNS];
+      bode_frequencies(1, 100e6, BENCH_FREQUENCIES, out[6]);
+      for (long i = 0; i < n; i++) {
+         long k = i * BENCH_RESPONSE_STRIDE;
+         for (int c = 0; c < config->nin; c++) point[c] = in[c][k];
+         bode_response(model, point, BENCH_FREQUENCIES, out[6], out);
+      }
+   }
+   else if (strcmp(mode, "thermal") == 0) {
+      struct Thermal thermal;
+      real temperatures[BENCH_TEMPERATURES];
+      thermal_defaults(&thermal);
+      sweep_range(-40, 125, BENCH_TEMPERATURES, 0, temperatures);
+      run_thermal(&thermal, config, n / BENCH_TEMPERATURES, in,
+                  BENCH_TEMPERATURES, temperatures, threads, out);
+   }
+   else if (strcmp(mode, "jacobian") == 0) {
+      real point[CONFIG_COLUMNS], results[CONFIG_COLUMNS];
+      real jacobian[CONFIG_COLUMNS * CONFIG_COLUMNS];
+      for (long i = 0; i < n; i++) {
+         for (int c = 0; c < config->nin; c++) point[c] = in[c][i];
+         config->jacobian(point, results, jacobian);
+         for (int c = 0; c < config->nout; c++) out[c][i] = results[c];
+      }
+   }
+   else {
+      struct Sweep sweep = {config, 0};
+      for (int c = 0; c < config->nin; c++) {
+         sweep.values[c] = in[c];
+         sweep.counts[c] = n;
+      }
+      run_sweep(&sweep, threads, out);
+   }
+}
+
+int _bench_mode_(struct Config* config, char* mode, long n) {
+   // Check that configuration has the functions of mode.
+   int bode = strcmp(config->analysis, "bode") == 0;
+   int newton = strcmp(config->analysis, "newton") == 0;
+   if (strcmp(mode, "scalar") == 0) return !bode && !newton;
+   if (strcmp(mode, "jacobian") == 0) return config->jacobian != NULL;
+   if (strcmp(mode, "response") == 0)
+      return bode && n / BENCH_RESPONSE_STRIDE > 0 &&
+             n >= BENCH_FREQUENCIES;
+   if (strcmp(mode, "thermal") == 0) return n >= BENCH_TEMPERATURES;
+   if (strcmp(mode, "region") == 0)
+      return newton || strcmp(config->analysis, "dc") == 0;
+   return 1;
+}
+
+void _bench_mirror_(struct Config* config, long n, real** in) {
+   // Change parameters of p-type points of 'mixed' mode into their
+   // mirrors, or back, by the signs of parameters (POLARITY.h).
+   for (int c = 0; c < config->nin; c++)
+      if (config->input_signs[c] == '-')
+         for (long i = 0; i < n; i++) in[c][i] *= bench_polarity[i];
+}
+
+void _bench_(struct Config* config, char* mode, long n, int repeats,
+             int threads, real** in, real** out) {
+   // Time a configuration in a mode and write its CSV line.
+   double best = 1e30, cycles = 0;
+   int mixed = strcmp(mode, "mixed") == 0;
+   if (mixed) _bench_mirror_(config, n, in);
+   _run_mode_(config, mode, n, threads, in, out); // warm up
+   for (int r = 0; r < repeats; r++) {
+      unsigned long long start_cycles = _cycles_();
+      double start = _now_();
+      _run_mode_(config, mode, n, threads, in, out);
+      double time = _now_() - start;
+      unsigned long long end_cycles = _cycles_();
+      if (time < best) {
+         best = time;
+         cycles = (double) (end_cycles - start_cycles);
+      }
+   }
+   printf("%s,%s,%s,%s,%s,%ld,%d,%.3f,%.0f,%.2f\n", config->family,
+          config->name, config->analysis,
+          config->option ? config->option : "", mode, n,
+          strcmp(mode, "mt") && strcmp(mode, "thermal") ? 1 : threads,
+          best * 1e9 / n, n / best,
+          cycles / n);
+   fflush(stdout);
+   if (mixed) _bench_mirror_(config, n, in);
+}
+
+int main(int argc, char* argv[]) {
+   long n = 1 << 20;
+   int repeats = 5, threads = 0, option;
+   char* modes[] = {"scalar", "batch", "mt", "cache", "jacobian",
+                    "response", "thermal", "region", "checked",
+                    "mixed"};
+   char* only_mode = NULL;
+   char* only_family = NULL;
+   while ((option = getopt(argc, argv, "n:r:t:m:f:")) != -1) {
+      if (option == 'n') n = atol(optarg);
+      else if (option == 'r') repeats = atoi(optarg);
+      else if (option == 't') threads = atoi(optarg);
+      else if (option == 'm') only_mode = optarg;
+      else if (option == 'f') only_family = optarg;
+      else {
+         fprintf(stderr, "Usage: %s [-n points] [-r repeats] "
+                 "[-t threads] [-m mode] [-f family]\n", argv[0]);
+         return 1;
+      }
+   }
+   if (n <= 0 || repeats <= 0) return 1;
+   threads = _sweep_threads_(threads);
+   real* in[CONFIG_COLUMNS];
+   real* out[CONFIG_COLUMNS];
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      in[c] = malloc(n * sizeof(real));
+      out[c] = malloc(n * sizeof(real));
+      if (!in[c] || !out[c]) {
+         fprintf(stderr, "Can not allocate %ld points !!!\n", n);
+         return 1;
+      }
+   }
+   struct Config* tables[] = {BJTConfigs, FETConfigs, MOSFETConfigs};
+   int counts[] = {BJTConfigCount, FETConfigCount, MOSFETConfigCount};
+   bench_cache = op_cache_create(2L * BENCH_CACHE_POINTS *
+                                 (BJTConfigCount + FETConfigCount +
+                                  MOSFETConfigCount), 0);
+   bench_codes = malloc(n);
+   bench_polarity = malloc(n * sizeof(real));
+   if (!bench_cache || !bench_codes || !bench_polarity) {
+      fprintf(stderr, "Can not allocate the cache or codes !!!\n");
+      return 1;
+   }
+   for (long i = 0; i < n; i++)
+      bench_polarity[i] = i % 2 ? POLARITY_P : POLARITY_N;
+   puts("family,config,analysis,option,mode,points,threads,"
+        "ns_per_point,points_per_s,cycles_per_point");
+   for (int t = 0; t < 3; t++) {
+      for (int k = 0; k < counts[t]; k++) {
+         struct Config* config = &tables[t][k];
+         if (only_family && strcmp(only_family, config->family)) continue;
+         _random_parameters_(config, n, in);
+         for (int m = 0; m < 10; m++) {
+            if (only_mode && strcmp(only_mode, modes[m])) continue;
+            if (!_bench_mode_(config, modes[m], n)) continue;
+            if (strcmp(modes[m], "response") == 0)
+               _bench_(config, modes[m], n / BENCH_RESPONSE_STRIDE,
+                       repeats, threads, in, out);
+            else if (strcmp(modes[m], "thermal") == 0)
+               _bench_(config, modes[m],
+                       n / BENCH_TEMPERATURES * BENCH_TEMPERATURES,
+                       repeats, threads, in, out);
+            else _bench_(config, modes[m], n, repeats, threads, in, out);
+         }
+      }
+   }
+   return 0;
+}
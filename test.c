@@ -0,0 +1,950 @@
+/* Tests of All Transistor Configurations
+
+'make test' builds this program and runs it. Every configuration of
+'BJTConfigs', 'FETConfigs' and 'MOSFETConfigs' is evaluated on the
+random points of bench (POINTS.h) and these checks are done:
+
+--> 'scalar': the batch function of every "dc" and "ac" entry gives
+    the results of the original configuration function (e.g.
+    'b_voltage_divider') at every point.
+--> 'jacobian': results of 'jacobian' are the ones of the batch
+    function, and its derivatives are the central finite differences
+    of the batch function.
+--> 'newton': "newton" entries without their nonlinear effects
+    (lambda = 0, IKF = 0 and BR = 1) give the results of their "dc"
+    entries. FETs must agree to the tolerance of the solver, currents
+    of BJTs to TEST_JUNCTION as their Vbe is not BJT_VBE. The "newton"
+    fixed-bias BJT also solves a point in cut-off ('test_cutoff'),
+    where the closed-form start has a negative Ib.
+--> 'cutoff': points of closed forms in cut-off ('test_cutoffs') have
+    no drain current, also by the scalar function and the "newton"
+    entry, are REGION_CUTOFF and STATUS_OK.
+--> 'mirror': every entry has a sign for each column, and 'run_mixed'
+    gives the results of the n-type mirror of a p-type point with
+    columns of sign '-' negated.
+--> 'sweep': 'run_sweep' gives the batch results of the points of a
+    grid and a list in their order, and rejects a list with a count
+    that is neither 1 nor the number of points.
+--> 'status': scalar functions give the status codes of 'run_checked'
+    (and NaN results) also at points with an invalid parameter, as
+    both check the same domains of the parameters of the entry.
+--> 'poles': "bode" entries without device capacitances give zero for
+    their missing high poles and cutoff, and their points are
+    STATUS_OK.
+--> 'thermal': 'run_thermal' at T0 gives the batch results.
+--> 'jobs': results of the points as job lines ('run_jobs') and as a
+    deck ('run_deck') are the bytes of 'run_checked' results written
+    in the binary format of COLUMNS.h.
+--> 'incremental': every model gives the results of a full evaluation
+    after each change of one parameter by 'incremental_update'.
+--> 'cache': 'op_cache_eval' counts a miss and then a hit of a point
+    with same results, evicts old points of a full set and gives the
+    batch results to threads that share it.
+--> 'monte': 'run_monte_carlo' gives same trials and statistics on
+    one and on TEST_THREADS threads.
+--> 'design': 'stream_design' gives the designs of 'run_design' in
+    the same order.
+--> 'format': '_format_float_' of text columns writes the digits of
+    "%e", also for values in the middle of two last digits.
+
+Results are compared relative to the largest magnitude of their
+column, and NaN matches only NaN. Every failed check is reported to
+stderr and test exits with 1.
+
+Build: gcc -O2 -pthread test.c -o build/test -lm
+       (add -DPRECISION_DOUBLE or -DPRECISION_MIXED, see PRECISION.h)
+Usage: test [-n points]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "POINTS.h"
+#include "POLARITY.h"
+#include "REGION.h"
+#include "STATUS.h"
+#include "CACHE.h"
+#include "INCREMENTAL.h"
+#include "MONTE.h"
+#include "THERMAL.h"
+#include "DECK.h"
+#include "OPTIMIZE.h"
+
+// Relative tolerances of results, of finite differences (and their
+// relative step) and of Newton solutions.
+#if PRECISION_DOUBLE
+#define TEST_TOLERANCE 1e-9
+#define TEST_STEP 1e-6
+#define TEST_DERIVATIVE 1e-5
+#define TEST_NEWTON 1e-6
+#else
+#define TEST_TOLERANCE 1e-4
+#define TEST_STEP 1e-3
+#define TEST_DERIVATIVE 2e-2
+#define TEST_NEWTON 1e-3
+#endif
+// Tolerance of "newton" BJTs against the constant Vbe of "dc".
+#define TEST_JUNCTION 5e-2
+// Points of the 'jacobian' check (each one is evaluated 2 * nin + 1
+// times).
+#define TEST_JACOBIAN_POINTS 64
+// Threads of the checks of threaded functions.
+#define TEST_THREADS 4
+// Points of the 'cache' check which every thread evaluates twice.
+#define TEST_CACHE_POINTS 64
+// Updates of the 'incremental' check of every model.
+#define TEST_UPDATES 32
+// Trials of the 'monte' check, a few chunks of SWEEP.h.
+#define TEST_TRIALS (3 * SWEEP_CHUNK + 17)
+
+// Number of failed checks.
+long test_failures;
+
+void _test_fail_(struct Config* config, char* check, char* column,
+                 long i, real got, real expected) {
+   // Report a failed check of point 'i'.
+   fprintf(stderr, "%s %s %s%s%s: %s of '%s' at point %ld is %g, "
+           "expected %g !!!\n", config->family, config->name,
+           config->analysis, config->option ? " " : "",
+           config->option ? config->option : "", check, column, i,
+           (double) got, (double) expected);
+   test_failures++;
+}
+
+real _test_scale_(long n, real* column) {
+   // Largest magnitude of finite values of 'column'.
+   real scale = 0;
+   for (long i = 0; i < n; i++)
+      if (column[i] - column[i] == 0)
+         scale = real_fmax(scale, real_fabs(column[i]));
+   return scale;
+}
+
+int _test_close_(real got, real expected, real scale, real tolerance) {
+   // 1 if 'got' is 'expected' to 'tolerance' of 'scale', or both are
+   // NaN.
+   if (got != got || expected != expected)
+      return got != got && expected != expected;
+   return got == expected || real_fabs(got - expected) <= tolerance * scale;
+}
+
+void _test_column_(struct Config* config, char* check, char* name,
+                   long n, real* got, real* expected, real tolerance) {
+   // Compare a result column, only its first failed point is reported.
+   real scale = _test_scale_(n, expected);
+   for (long i = 0; i < n; i++)
+      if (!_test_close_(got[i], expected[i], scale, tolerance)) {
+         _test_fail_(config, check, name, i, got[i], expected[i]);
+         return;
+      }
+}
+
+void _test_columns_(struct Config* config, char* check, long n,
+                    real** got, real** expected, real tolerance) {
+   // Compare all result columns.
+   for (int c = 0; c < config->nout; c++)
+      _test_column_(config, check, config->outputs[c], n, got[c],
+                    expected[c], tolerance);
+}
+
+/* Checks */
+
+void _test_scalar_(struct Config* config, long n, real** in,
+                   real** out, real** ref) {
+   // Batch results against scalar results.
+   for (long i = 0; i < n; i++) _scalar_call_(config, i, in, ref, NULL);
+   config->batch(n, in, out);
+   _test_columns_(config, "scalar", n, out, ref, TEST_TOLERANCE);
+}
+
+void _test_jacobian_(struct Config* config, long n, real** in,
+                     real** out) {
+   // Jacobian against central differences of the batch function.
+   int nin = config->nin, nout = config->nout;
+   long m = n < TEST_JACOBIAN_POINTS ? n : TEST_JACOBIAN_POINTS;
+   real point[CONFIG_COLUMNS], results[CONFIG_COLUMNS];
+   real jacobian[CONFIG_COLUMNS * CONFIG_COLUMNS];
+   real values[3][CONFIG_COLUMNS];
+   real* p[CONFIG_COLUMNS];
+   real* o[CONFIG_COLUMNS];
+   config->batch(m, in, out);
+   for (long i = 0; i < m; i++) {
+      for (int c = 0; c < nin; c++) {
+         point[c] = in[c][i];
+         p[c] = &point[c];
+      }
+      config->jacobian(point, results, jacobian);
+      for (int r = 0; r < nout; r++) {
+         real scale = real_fabs(out[r][i]);
+         if (!_test_close_(results[r], out[r][i], scale, TEST_TOLERANCE))
+            _test_fail_(config, "jacobian", config->outputs[r], i,
+                        results[r], out[r][i]);
+      }
+      for (int c = 0; c < nin; c++) {
+         real x = point[c];
+         real h = TEST_STEP * (x != 0 ? real_fabs(x) : 1);
+         for (int s = 0; s < 2; s++) {
+            point[c] = s ? x - h : x + h;
+            for (int r = 0; r < nout; r++) o[r] = &values[s][r];
+            config->batch(1, p, o);
+         }
+         point[c] = x;
+         for (int r = 0; r < nout; r++) {
+            real fd = (values[0][r] - values[1][r]) / (2 * h);
+            real d = jacobian[r * nin + c];
+            // Rounding of the differences is relative to the result.
+            real scale = real_fabs(d) + real_fabs(fd) +
+                         real_fabs(results[r]) / (x != 0 ?
+                                                  real_fabs(x) : 1);
+            if (_test_close_(d, fd, scale, TEST_DERIVATIVE)) continue;
+            char name[64];
+            snprintf(name, sizeof(name), "d %s / d %s",
+                     config->outputs[r], config->inputs[c]);
+            _test_fail_(config, "jacobian", name, i, d, fd);
+         }
+      }
+   }
+}
+
+// Parameters of "newton" entries that are not in their "dc" entries
+// and the values that turn the nonlinear effects off.
+struct TestDefault {
+   char* name;
+   real value;
+};
+struct TestDefault test_defaults[] = {
+   {"lambda", 0}, {"Is", 1e-14}, {"IKF", 0}, {"BR", 1}
+};
+
+struct Config* _test_dc_entry_(struct Config* config) {
+   // "dc" entry of the configuration of a "newton" entry.
+   struct Config* tables[] = {BJTConfigs, FETConfigs, MOSFETConfigs};
+   int counts[] = {BJTConfigCount, FETConfigCount, MOSFETConfigCount};
+   for (int t = 0; t < 3; t++)
+      if (strcmp(tables[t][0].family, config->family) == 0)
+         return _find_config_(tables[t], counts[t], config->name, "dc",
+                              NULL);
+   return NULL;
+}
+
+void _test_newton_(struct Config* config, long n, real** in,
+                   real** out, real** ref) {
+   // Newton solutions without nonlinear effects against "dc" results.
+   struct Config* dc = _test_dc_entry_(config);
+   real* columns[CONFIG_COLUMNS];
+   int ndefaults = sizeof(test_defaults) / sizeof(test_defaults[0]);
+   if (!dc) return;
+   for (int c = 0; c < config->nin; c++)
+      for (int d = 0; d < ndefaults; d++)
+         if (strcmp(config->inputs[c], test_defaults[d].name) == 0)
+            for (long i = 0; i < n; i++)
+               in[c][i] = test_defaults[d].value;
+   for (int c = 0; c < dc->nin; c++)
+      columns[c] = in[_find_column_(config->inputs, config->nin,
+                                    dc->inputs[c])];
+   dc->batch(n, columns, ref);
+   config->batch(n, in, out);
+   // Compare the results of the "dc" entry. Node voltages of closed
+   // forms of BJTs are not all of the same nodes (e.g. -1 of ones
+   // that are not found), so only their currents are compared.
+   int bjt = strcmp(config->family, "bjt") == 0;
+   for (int c = 0; c < dc->nout; c++) {
+      if (bjt && dc->outputs[c][0] != 'I') continue;
+      int k = _find_column_(config->outputs, config->nout, dc->outputs[c]);
+      _test_column_(config, "newton", dc->outputs[c], n, out[k], ref[c],
+                    bjt ? TEST_JUNCTION : TEST_NEWTON);
+   }
+}
+
+// A point of "newton" fixed-bias in cut-off: Vcc Rb Rc beta, Is IKF
+// BR. Ic is only the leakage Is exp(Vcc/VT) and Vce is nearly Vcc.
+real test_cutoff[] = {0.3, 100e3, 10e3, 200, 1e-14, 0, 1};
+
+void _test_cutoff_(void) {
+   // The "newton" fixed-bias BJT solves 'test_cutoff'.
+   struct Config* config = _find_config_(BJTConfigs, BJTConfigCount,
+                                         "fb", "newton", NULL);
+   real values[CONFIG_COLUMNS];
+   real* in[CONFIG_COLUMNS];
+   real* out[CONFIG_COLUMNS];
+   for (int c = 0; c < config->nin; c++) in[c] = &test_cutoff[c];
+   for (int c = 0; c < config->nout; c++) out[c] = &values[c];
+   config->batch(1, in, out);
+   real Ic = values[_find_column_(config->outputs, config->nout, "Ic")];
+   real Vce = values[_find_column_(config->outputs, config->nout,
+                                   "Vce")];
+   if (!(Ic >= 0 && Ic < 1e-6))
+      _test_fail_(config, "cutoff", "Ic", 0, Ic, 0);
+   if (!(real_fabs(Vce - test_cutoff[0]) < 1e-3))
+      _test_fail_(config, "cutoff", "Vce", 0, Vce, test_cutoff[0]);
+}
+
+// Points in cut-off of closed forms: E-MOSFET drain-feedback and
+// voltage-divider with Vdd and Vg below Vgsth, JFET fixed-bias with
+// Vgs below Vp.
+struct {
+   char* family;
+   char* name;
+   real values[CONFIG_COLUMNS];
+} test_cutoffs[] = {
+   {"mosfet", "df", {2, 2e3, 6e-3, 8, 3}},
+   {"mosfet", "vd", {12, 22e6, 2e6, 3e3, 1e3, 6e-3, 8, 3}},
+   {"fet", "fb", {16, 5, 2e3, 10e-3, -4}},
+};
+
+void _test_cutoffs_(struct Config** tables, int* counts) {
+   // Cut-off points of "dc" entries against zero drain current.
+   int ncutoffs = sizeof(test_cutoffs) / sizeof(test_cutoffs[0]);
+   for (int p = 0; p < ncutoffs; p++) {
+      int t = strcmp(test_cutoffs[p].family, "fet") ? 2 : 1;
+      struct Config* config = _find_config_(tables[t], counts[t],
+                                            test_cutoffs[p].name, "dc",
+                                            NULL);
+      struct Config* newton = _find_config_(tables[t], counts[t],
+                                            test_cutoffs[p].name,
+                                            "newton", NULL);
+      real values[CONFIG_COLUMNS], scalar[CONFIG_COLUMNS];
+      real solved[CONFIG_COLUMNS], lambda = 0;
+      real* in[CONFIG_COLUMNS];
+      real* out[CONFIG_COLUMNS];
+      real* ref[CONFIG_COLUMNS];
+      unsigned char status, region;
+      for (int c = 0; c < config->nin; c++)
+         in[c] = &test_cutoffs[p].values[c];
+      for (int c = 0; c < config->nout; c++) {
+         out[c] = &values[c];
+         ref[c] = &scalar[c];
+      }
+      run_checked(config, 1, in, out, &status);
+      run_region(config, 1, in, out, &region);
+      _scalar_call_(config, 0, in, ref, NULL);
+      int Id = _find_column_(config->outputs, config->nout, "Id");
+      if (values[Id] != 0)
+         _test_fail_(config, "cutoff", "Id", p, values[Id], 0);
+      if (status != STATUS_OK)
+         _test_fail_(config, "cutoff", "status", p, status, STATUS_OK);
+      if (region != REGION_CUTOFF)
+         _test_fail_(config, "cutoff", "region", p, region,
+                     REGION_CUTOFF);
+      for (int c = 0; c < config->nout; c++)
+         if (!_test_close_(scalar[c], values[c], real_fabs(values[c]),
+                           TEST_TOLERANCE))
+            _test_fail_(config, "cutoff", config->outputs[c], p,
+                        scalar[c], values[c]);
+      if (!newton) continue;
+      // The "newton" entry with lambda = 0 (its last parameter).
+      in[newton->nin - 1] = &lambda;
+      for (int c = 0; c < newton->nout; c++) out[c] = &solved[c];
+      newton->batch(1, in, out);
+      for (int c = 0; c < config->nout; c++) {
+         int k = _find_column_(newton->outputs, newton->nout,
+                               config->outputs[c]);
+         if (!_test_close_(solved[k], values[c], real_fabs(values[c]),
+                           TEST_NEWTON))
+            _test_fail_(newton, "cutoff", config->outputs[c], p,
+                        solved[k], values[c]);
+      }
+   }
+}
+
+void _test_sweep_(int grid, long* counts, int threads) {
+   // 'run_sweep' of fixed-bias "dc" against its batch function at the
+   // points of the grid (the last parameter changes fastest) or of the
+   // list. Values of parameter c are 1 + c + k / 8 (k'th value).
+   struct Config* config = _find_config_(BJTConfigs, BJTConfigCount,
+                                         "fb", "dc", NULL);
+   struct Sweep sweep = {config, grid};
+   real values[CONFIG_COLUMNS][8], point[CONFIG_COLUMNS];
+   real results[CONFIG_COLUMNS][64], expected[CONFIG_COLUMNS];
+   real* in[CONFIG_COLUMNS];
+   real* out[CONFIG_COLUMNS];
+   real* ref[CONFIG_COLUMNS];
+   for (int c = 0; c < config->nin; c++) {
+      for (int k = 0; k < 8; k++) values[c][k] = 1 + c + k / 8.0;
+      // Vcc is above Vbe, resistors and beta are large.
+      values[c][0] += c ? 1e3 : 10;
+      sweep.values[c] = values[c];
+      sweep.counts[c] = counts[c];
+      in[c] = &point[c];
+   }
+   for (int c = 0; c < config->nout; c++) {
+      out[c] = results[c];
+      ref[c] = &expected[c];
+   }
+   long total = sweep_points(&sweep);
+   int status = run_sweep(&sweep, threads, out);
+   int valid = 1;
+   for (int c = 0; !grid && c < config->nin; c++)
+      valid &= counts[c] == 1 || counts[c] == total;
+   if (status != (valid ? 0 : -1))
+      _test_fail_(config, "sweep", "status", 0, status, valid ? 0 : -1);
+   if (!valid || status) return;
+   for (long i = 0; i < total; i++) {
+      long rest = i;
+      for (int c = config->nin - 1; c >= 0; c--) {
+         long k = grid ? rest % counts[c] : counts[c] == 1 ? 0 : i;
+         rest /= grid ? counts[c] : 1;
+         point[c] = values[c][k];
+      }
+      config->batch(1, in, ref);
+      for (int c = 0; c < config->nout; c++)
+         if (results[c][i] != expected[c]) {
+            _test_fail_(config, "sweep", config->outputs[c], i,
+                        results[c][i], expected[c]);
+            return;
+         }
+   }
+}
+
+// Values that are out of the domain of some parameters (see STATUS.h),
+// e.g. 1.5 is an invalid alpha and -10e-3 an invalid Idss or Idon.
+real test_invalid[] = {0, -1, -10e-3, 1.5, INFINITY, -INFINITY, NAN};
+
+void _test_status_(struct Config* config, long n, real** in,
+                   real** out, real** ref) {
+   // Status of scalar functions against 'run_checked' on points with
+   // one parameter set to a value of 'test_invalid' (every third point
+   // is kept as it is).
+   int ninvalid = sizeof(test_invalid) / sizeof(test_invalid[0]);
+   unsigned char* status = malloc(2 * n);
+   if (!status) return;
+   for (long i = 0; i < n; i++)
+      if (i % 3)
+         in[i % config->nin][i] = test_invalid[i / 3 % ninvalid];
+   for (long i = 0; i < n; i++) _scalar_call_(config, i, in, ref, status);
+   run_checked(config, n, in, out, status + n);
+   for (long i = 0; i < n; i++) {
+      if (status[i] != status[n + i]) {
+         _test_fail_(config, "status", "status", i, status[i],
+                     status[n + i]);
+         break;
+      }
+      // Results of invalid points are NaN like the ones of
+      // 'run_checked'.
+      for (int c = 0; c < config->nout; c++)
+         if (status[i] == STATUS_INVALID && ref[c][i] == ref[c][i])
+            _test_fail_(config, "status", config->outputs[c], i,
+                        ref[c][i], NAN);
+   }
+   free(status);
+}
+
+void _test_poles_(struct Config* config, long n, real** in,
+                  real** out) {
+   // "bode" entries without device capacitances (the last two
+   // parameters) have no high poles: fH, fHi and fHo are zero and
+   // points are STATUS_OK.
+   unsigned char* status = malloc(n);
+   if (!status) return;
+   for (long i = 0; i < n; i++)
+      in[config->nin - 1][i] = in[config->nin - 2][i] = 0;
+   run_checked(config, n, in, out, status);
+   int high[] = {2, 6, 7};
+   for (long i = 0; i < n; i++) {
+      if (status[i] != STATUS_OK) {
+         _test_fail_(config, "poles", "status", i, status[i], STATUS_OK);
+         break;
+      }
+      for (int h = 0; h < 3; h++)
+         if (out[high[h]][i] != 0)
+            _test_fail_(config, "poles", config->outputs[high[h]], i,
+                        out[high[h]][i], 0);
+   }
+   free(status);
+}
+
+void _test_thermal_(struct Config* config, long n, real** in,
+                    real** out, real** ref) {
+   // 'run_thermal' at the reference temperature against the batch
+   // function.
+   struct Thermal thermal;
+   thermal_defaults(&thermal);
+   // One thread, so Newton solutions are found in the blocks of the
+   // batch function (a solution depends on the other points of its
+   // block to the tolerance of the solver).
+   if (run_thermal(&thermal, config, n, in, 1, &thermal.T0, 1, out)) {
+      _test_fail_(config, "thermal", "status", 0, -1, 0);
+      return;
+   }
+   config->batch(n, in, ref);
+   _test_columns_(config, "thermal", n, out, ref, TEST_TOLERANCE);
+}
+
+long _test_read_(FILE* file, char** data) {
+   // Read all bytes of a temporary file into '*data' (NULL on error).
+   long size = ftell(file);
+   *data = size > 0 ? malloc(size) : NULL;
+   rewind(file);
+   if (*data && fread(*data, 1, size, file) != (size_t) size) {
+      free(*data);
+      *data = NULL;
+   }
+   return size;
+}
+
+void _test_jobs_(struct Config* config, long n, real** in, real** out,
+                 struct JobTable* tables) {
+   // The points as job lines and as a deck section against the binary
+   // results of 'run_checked'. Jobs are collected into one batch.
+   long m = n < JOB_BATCH ? n : JOB_BATCH;
+   char name[64], path[] = "/tmp/test-deck-XXXXXX";
+   snprintf(name, sizeof(name), "%s %s %s%s%s", config->family,
+            config->name, config->analysis, config->option ? " " : "",
+            config->option ? config->option : "");
+   int file = mkstemp(path);
+   FILE* files[5] = {file >= 0 ? fdopen(file, "w+") : NULL, tmpfile(),
+                     tmpfile(), tmpfile(), tmpfile()};
+   FILE* deck = files[0];
+   FILE* jobs = files[1];
+   char* data[3] = {NULL};
+   long sizes[3] = {0};
+   unsigned char* status = malloc(m);
+   int ready = status != NULL;
+   for (int f = 0; f < 5; f++) ready &= files[f] != NULL;
+   if (ready) {
+      struct ColumnWriter writer = {deck, COLUMNS_BINARY, sizeof(real)};
+      begin_columns(&writer, name, config->nin, config->inputs);
+      write_columns(&writer, m, in);
+      end_columns(&writer);
+      for (long i = 0; i < m; i++) {
+         fputs(name, jobs);
+         for (int c = 0; c < config->nin; c++)
+            fprintf(jobs, " %.17g", (double) in[c][i]);
+         fputc('\n', jobs);
+      }
+      rewind(jobs);
+      // Expected results, then results of jobs and of the deck.
+      writer.file = files[2];
+      run_checked(config, m, in, out, status);
+      begin_columns(&writer, name, config->nout, config->outputs);
+      write_columns(&writer, m, out);
+      end_columns(&writer);
+      struct Deck mapped;
+      ready = run_jobs(jobs, files[3], COLUMNS_BINARY, tables, 3) == 0 &&
+              open_deck(&mapped, path) == 0;
+      writer.file = files[4];
+      if (ready) {
+         ready = run_deck(&mapped, tables, 3, &writer) == m;
+         close_deck(&mapped);
+      }
+      for (int f = 0; f < 3; f++)
+         sizes[f] = _test_read_(files[f + 2], &data[f]);
+      for (int f = 0; f < 3; f++) ready &= data[f] != NULL;
+   }
+   if (!ready) _test_fail_(config, "jobs", "status", 0, -1, 0);
+   for (int f = 1; ready && f < 3; f++)
+      if (sizes[f] != sizes[0] || memcmp(data[f], data[0], sizes[0]))
+         _test_fail_(config, "jobs", f == 1 ? "jobs" : "deck", 0,
+                     sizes[f], sizes[0]);
+   for (int f = 0; f < 5; f++)
+      if (files[f]) fclose(files[f]);
+   if (file >= 0) unlink(path);
+   for (int f = 0; f < 3; f++) free(data[f]);
+   free(status);
+}
+
+void _test_stages_(struct Incremental* inc, real* dc, real* ac) {
+   // Results of the DC and AC stages of an evaluation, in order of
+   // result columns of "dc" and "ac" entries.
+   real* out[2][CONFIG_COLUMNS];
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      out[0][c] = &dc[c]; out[1][c] = &ac[c];
+      dc[c] = ac[c] = 0;
+   }
+   char* family = inc->model->family;
+   for (int s = 0; s < 2; s++) {
+      char* analysis = s ? "ac" : "dc";
+      if (strcmp(family, "bjt") == 0)
+         _bjt_results_(analysis, &inc->dc.bjt, &inc->ac.bjt, out[s],
+                       NULL, 0);
+      else if (strcmp(family, "fet") == 0)
+         _fet_results_(analysis, &inc->dc.fet, &inc->ac.fet, out[s],
+                       NULL, 0);
+      else _mosfet_results_(analysis, &inc->dc.mosfet, &inc->ac.mosfet,
+                            out[s], NULL, 0);
+   }
+}
+
+void _test_incremental_(struct Model* model) {
+   // Incremental updates of one parameter at a time against a new
+   // evaluation of all stages at same parameters.
+   struct Config entry = {model->family, model->name, "incremental",
+                          model->option, model->nparams};
+   real values[CONFIG_COLUMNS][TEST_UPDATES];
+   real* columns[CONFIG_COLUMNS];
+   real params[CONFIG_COLUMNS];
+   for (int c = 0; c < model->nparams; c++) {
+      entry.inputs[c] = model->params[c];
+      columns[c] = values[c];
+   }
+   _random_parameters_(&entry, TEST_UPDATES, columns);
+   for (int c = 0; c < model->nparams; c++) params[c] = values[c][0];
+   struct Incremental inc, full;
+   if (incremental_init(&inc, model, model->analyses, params)) {
+      _test_fail_(&entry, "incremental", "status", 0, -1, 0);
+      return;
+   }
+   incremental_update(&inc);
+   for (int u = 1; u < TEST_UPDATES; u++) {
+      int p = u % model->nparams;
+      real got[2][CONFIG_COLUMNS], expected[2][CONFIG_COLUMNS];
+      incremental_set(&inc, p, values[p][u]);
+      incremental_update(&inc);
+      incremental_init(&full, model, model->analyses, inc.params);
+      incremental_update(&full);
+      _test_stages_(&inc, got[0], got[1]);
+      _test_stages_(&full, expected[0], expected[1]);
+      for (int s = 0; s < 2; s++)
+         for (int c = 0; c < CONFIG_COLUMNS; c++)
+            if (!_test_close_(got[s][c], expected[s][c], 0, 0)) {
+               _test_fail_(&entry, "incremental", s ? "ac" : "dc", u,
+                           got[s][c], expected[s][c]);
+               return;
+            }
+   }
+}
+
+// Points of the 'cache' check which are shared by its threads.
+struct TestCache {
+   struct OpCache* cache;
+   struct Config* config;
+   real (*points)[CONFIG_COLUMNS];
+   // Results of both passes of a thread over the points.
+   real results[2][TEST_CACHE_POINTS][CONFIG_COLUMNS];
+};
+
+void* _test_cache_thread_(void* context) {
+   // Evaluate all points twice through the shared cache.
+   struct TestCache* test = context;
+   for (int pass = 0; pass < 2; pass++)
+      for (int p = 0; p < TEST_CACHE_POINTS; p++)
+         op_cache_eval(test->cache, test->config, test->points[p],
+                       test->results[pass][p]);
+   return NULL;
+}
+
+void _test_cache_(void) {
+   // A miss and then a hit of a point, eviction of the point by other
+   // points of its set, and threads that share a cache against the
+   // batch function.
+   struct Config* config = _find_config_(BJTConfigs, BJTConfigCount,
+                                         "vd", "dc", NULL);
+   real values[CONFIG_COLUMNS][TEST_CACHE_POINTS];
+   real points[TEST_CACHE_POINTS][CONFIG_COLUMNS];
+   real expected[TEST_CACHE_POINTS][CONFIG_COLUMNS];
+   real first[CONFIG_COLUMNS], second[CONFIG_COLUMNS];
+   real* in[CONFIG_COLUMNS];
+   real* out[CONFIG_COLUMNS];
+   long hits, misses;
+   for (int c = 0; c < config->nin; c++) in[c] = values[c];
+   _random_parameters_(config, TEST_CACHE_POINTS, in);
+   for (int p = 0; p < TEST_CACHE_POINTS; p++) {
+      for (int c = 0; c < config->nin; c++) {
+         points[p][c] = values[c][p];
+         in[c] = &points[p][c];
+      }
+      for (int c = 0; c < config->nout; c++) out[c] = &expected[p][c];
+      config->batch(1, in, out);
+   }
+   // The smallest cache has one set of CACHE_WAYS slots per shard.
+   struct OpCache* cache = op_cache_create(1, 0);
+   if (!cache) return;
+   int miss = op_cache_eval(cache, config, points[0], first);
+   int hit = op_cache_eval(cache, config, points[0], second);
+   op_cache_stats(cache, &hits, &misses);
+   if (miss != 0 || hit != 1 || hits != 1 || misses != 1)
+      _test_fail_(config, "cache", "hits", 0, hits, 1);
+   for (int c = 0; c < config->nout; c++)
+      if (!_test_close_(first[c], expected[0][c], 0, 0) ||
+          !_test_close_(second[c], expected[0][c], 0, 0))
+         _test_fail_(config, "cache", config->outputs[c], 0, second[c],
+                     expected[0][c]);
+   // Many more points than slots evict the first one.
+   real point[CONFIG_COLUMNS];
+   memcpy(point, points[0], sizeof(point));
+   for (long k = 0; k < 16 * CACHE_SHARDS * CACHE_WAYS; k++) {
+      point[1] = points[0][1] * (2 + k);
+      op_cache_eval(cache, config, point, second);
+   }
+   if (op_cache_eval(cache, config, points[0], second) != 0)
+      _test_fail_(config, "cache", "eviction", 0, 1, 0);
+   op_cache_destroy(cache);
+   // Threads that share a cache (room for all points).
+   struct TestCache* tests = malloc(TEST_THREADS *
+                                    sizeof(struct TestCache));
+   pthread_t threads[TEST_THREADS];
+   cache = op_cache_create(64 * TEST_CACHE_POINTS, 0);
+   if (!tests || !cache) {
+      free(tests); op_cache_destroy(cache);
+      return;
+   }
+   for (int t = 0; t < TEST_THREADS; t++) {
+      tests[t].cache = cache; tests[t].config = config;
+      tests[t].points = points;
+      pthread_create(&threads[t], NULL, _test_cache_thread_, &tests[t]);
+   }
+   for (int t = 0; t < TEST_THREADS; t++) pthread_join(threads[t], NULL);
+   op_cache_stats(cache, &hits, &misses);
+   if (hits + misses != 2 * TEST_THREADS * TEST_CACHE_POINTS ||
+       misses < TEST_CACHE_POINTS)
+      _test_fail_(config, "cache", "misses", 0, misses,
+                  TEST_CACHE_POINTS);
+   for (int t = 0; t < TEST_THREADS; t++)
+      for (int pass = 0; pass < 2; pass++)
+         for (int p = 0; p < TEST_CACHE_POINTS; p++)
+            for (int c = 0; c < config->nout; c++)
+               if (!_test_close_(tests[t].results[pass][p][c],
+                                 expected[p][c], 0, 0)) {
+                  _test_fail_(config, "cache", config->outputs[c], p,
+                              tests[t].results[pass][p][c],
+                              expected[p][c]);
+                  break;
+               }
+   op_cache_destroy(cache);
+   free(tests);
+}
+
+void _test_monte_(void) {
+   // Trials and statistics of one thread against TEST_THREADS threads.
+   struct Config* config = _find_config_(BJTConfigs, BJTConfigCount,
+                                         "vd", "dc", NULL);
+   struct MonteCarlo mc = {config};
+   struct MonteStats stats[2][CONFIG_COLUMNS];
+   real* results[2][CONFIG_COLUMNS];
+   real values[CONFIG_COLUMNS];
+   real* in[CONFIG_COLUMNS];
+   int ready = 1;
+   for (int c = 0; c < config->nin; c++) in[c] = &values[c];
+   _random_parameters_(config, 1, in);
+   for (int c = 0; c < config->nin; c++) {
+      // Vcc is exact, the others uniform or gaussian.
+      mc.nominal[c] = values[c];
+      mc.distributions[c] = !c ? MONTE_EXACT : c % 2 ? MONTE_UNIFORM :
+                            MONTE_GAUSSIAN;
+      mc.tolerances[c] = 0.05;
+   }
+   mc.trials = TEST_TRIALS;
+   mc.seed = 0x5EED5EED12345678ULL;
+   for (int c = 0; c < config->nout; c++)
+      for (int r = 0; r < 2; r++)
+         ready &= (results[r][c] = malloc(TEST_TRIALS * sizeof(real)))
+                  != NULL;
+   if (!ready || run_monte_carlo(&mc, 1, results[0], stats[0]) ||
+       run_monte_carlo(&mc, TEST_THREADS, results[1], stats[1]))
+      _test_fail_(config, "monte", "status", 0, -1, 0);
+   for (int c = 0; ready && c < config->nout; c++) {
+      _test_column_(config, "monte", config->outputs[c], TEST_TRIALS,
+                    results[1][c], results[0][c], 0);
+      struct MonteStats* one = &stats[0][c];
+      struct MonteStats* many = &stats[1][c];
+      int same = one->count == many->count &&
+                 one->mean == many->mean && one->sigma == many->sigma &&
+                 one->min == many->min && one->max == many->max;
+      for (int p = 0; p < MONTE_PERCENTILES; p++)
+         same &= one->percentiles[p] == many->percentiles[p];
+      if (!same)
+         _test_fail_(config, "monte", config->outputs[c], 0, many->mean,
+                     one->mean);
+   }
+   for (int c = 0; c < config->nout; c++)
+      for (int r = 0; r < 2; r++) free(results[r][c]);
+}
+
+void _test_format_(void) {
+   // Text of random values of all exponents and of values near the
+   // middle of two 7-digit numbers against "%e".
+   struct Config* config = _find_config_(BJTConfigs, BJTConfigCount,
+                                         "fb", "dc", NULL);
+   unsigned long long state = 88172645463325252ULL;
+   char got[32], expected[32];
+   for (long i = 0; i < 200000; i++) {
+      state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+      double middle = (state % 9000000 + 1000000.5) *
+                      pow(10, (long) (state >> 40) % 60 - 36);
+      double value = i % 2 ? middle : ldexp(state >> 11, i % 200 - 160);
+      if (i == 0) value = 9.9999995e-5;
+      got[_format_float_(got, value)] = '\0';
+      snprintf(expected, sizeof(expected), "%e", value);
+      if (strcmp(got, expected)) {
+         _test_fail_(config, "format", expected, i, value, value);
+         return;
+      }
+   }
+}
+
+// Designs which are given by 'stream_design'.
+struct TestDesigns {
+   int count;
+   struct DesignResult designs[5];
+};
+
+int _test_emit_(struct DesignResult* result, void* context) {
+   struct TestDesigns* test = context;
+   test->designs[test->count++] = *result;
+   return test->count == 5;
+}
+
+void _test_design_(void) {
+   // Best-first designs against the search of all threads. It is the
+   // voltage-divider example of OPTIMIZE.h.
+   struct Config* dc = _find_config_(BJTConfigs, BJTConfigCount, "vd",
+                                     "dc", NULL);
+   struct Config* ac = _find_config_(BJTConfigs, BJTConfigCount, "vd",
+                                     "ac", "unbypassed");
+   struct Design design;
+   struct DesignResult best[5];
+   struct TestDesigns streamed = {0};
+   design_init(&design, dc, ac);
+   design.series = 24;
+   design_param(&design, "Vcc", 20, 20);
+   design_param(&design, "beta", 120, 120);
+   design_param(&design, "ro", 50e3, 50e3);
+   design_param(&design, "Rb1", 1e3, 1e6);
+   design_param(&design, "Rb2", 1e3, 1e6);
+   design_param(&design, "Rc", 100, 100e3);
+   design_param(&design, "Re", 10, 10e3);
+   design_target(&design, "Av", -50, 0.1);
+   design_target(&design, "Ic", 2e-3, 0.05);
+   design_target(&design, "Vce", 10, 0.1);
+   int found = run_design(&design, TEST_THREADS, 5, best);
+   int emitted = stream_design(&design, 5, _test_emit_, &streamed);
+   if (found <= 0 || emitted != found || streamed.count != found)
+      _test_fail_(ac, "design", "count", 0, emitted, found);
+   for (int i = 0; i < streamed.count && i < found; i++) {
+      struct DesignResult* got = &streamed.designs[i];
+      int same = _test_close_(got->error, best[i].error, best[i].error,
+                              TEST_TOLERANCE);
+      for (int p = 0; p < design.nparams; p++)
+         same &= got->params[p] == best[i].params[p];
+      if (!same)
+         _test_fail_(ac, "design", "error", i, got->error, best[i].error);
+   }
+}
+
+int _test_signs_(char* signs, int columns) {
+   // 1 if 'signs' has a '+' or '-' for each of 'columns'.
+   if (!signs || (int) strlen(signs) != columns) return 0;
+   return strspn(signs, "+-") == strlen(signs);
+}
+
+void _test_mirror_(struct Config* config, long n, real** in,
+                   real** out, real** ref) {
+   // p-type results of 'run_mixed' against their n-type mirrors. Odd
+   // points are p-type. Columns are mirrored here point by point by
+   // their signs, not by the blocks of POLARITY.h.
+   real* polarity = malloc(n * sizeof(real));
+   real* mirror[CONFIG_COLUMNS];
+   if (!polarity) return;
+   if (!_test_signs_(config->input_signs, config->nin) ||
+       !_test_signs_(config->output_signs, config->nout)) {
+      _test_fail_(config, "mirror", "signs", 0, 0, 0);
+      free(polarity);
+      return;
+   }
+   for (long i = 0; i < n; i++)
+      polarity[i] = i % 2 ? POLARITY_P : POLARITY_N;
+   for (int c = 0; c < config->nin; c++) {
+      mirror[c] = ref[c];
+      for (long i = 0; i < n; i++)
+         mirror[c][i] = config->input_signs[c] == '-' ?
+                        polarity[i] * in[c][i] : in[c][i];
+   }
+   run_mixed(config, n, mirror, polarity, out);
+   config->batch(n, in, ref);
+   for (int c = 0; c < config->nout; c++)
+      if (config->output_signs[c] == '-')
+         for (long i = 0; i < n; i++) ref[c][i] *= polarity[i];
+   _test_columns_(config, "mirror", n, out, ref, 0);
+   free(polarity);
+}
+
+int main(int argc, char* argv[]) {
+   long n = 1003;
+   int option;
+   while ((option = getopt(argc, argv, "n:")) != -1) {
+      if (option == 'n') n = atol(optarg);
+      else {
+         fprintf(stderr, "Usage: %s [-n points]\n", argv[0]);
+         return 1;
+      }
+   }
+   if (n <= 0) return 1;
+   real* in[CONFIG_COLUMNS];
+   real* out[CONFIG_COLUMNS];
+   real* ref[CONFIG_COLUMNS];
+   for (int c = 0; c < CONFIG_COLUMNS; c++) {
+      in[c] = malloc(n * sizeof(real));
+      out[c] = malloc(n * sizeof(real));
+      ref[c] = malloc(n * sizeof(real));
+      if (!in[c] || !out[c] || !ref[c]) {
+         fprintf(stderr, "Can not allocate %ld points !!!\n", n);
+         return 1;
+      }
+   }
+   struct Config* tables[] = {BJTConfigs, FETConfigs, MOSFETConfigs};
+   int counts[] = {BJTConfigCount, FETConfigCount, MOSFETConfigCount};
+   struct JobTable jobs[] = {{"bjt", BJTConfigs, BJTConfigCount},
+                             {"fet", FETConfigs, FETConfigCount},
+                             {"mosfet", MOSFETConfigs, MOSFETConfigCount}};
+   struct Model* models[] = {BJTModels, FETModels, MOSFETModels};
+   int nmodels[] = {BJTModelCount, FETModelCount, MOSFETModelCount};
+   long checks = 9;
+   long grid[] = {2, 3, 1, 4}, list[] = {5, 1, 5, 5};
+   long uneven[] = {5, 3, 1, 1};
+   _test_cutoff_();
+   _test_cutoffs_(tables, counts);
+   _test_sweep_(1, grid, 3);
+   _test_sweep_(0, list, 2);
+   _test_sweep_(0, uneven, 2);
+   _test_cache_();
+   _test_monte_();
+   _test_design_();
+   _test_format_();
+   for (int t = 0; t < 3; t++)
+      for (int k = 0; k < nmodels[t]; k++) {
+         _test_incremental_(&models[t][k]);
+         checks++;
+      }
+   for (int t = 0; t < 3; t++) {
+      for (int k = 0; k < counts[t]; k++) {
+         struct Config* config = &tables[t][k];
+         int bode = strcmp(config->analysis, "bode") == 0;
+         int newton = strcmp(config->analysis, "newton") == 0;
+         _random_parameters_(config, n, in);
+         if (!bode && !newton) {
+            _test_scalar_(config, n, in, out, ref);
+            checks++;
+         }
+         if (config->jacobian) {
+            _test_jacobian_(config, n, in, out);
+            checks++;
+         }
+         _test_mirror_(config, n, in, out, ref);
+         checks++;
+         if (newton) {
+            _test_newton_(config, n, in, out, ref);
+            checks++;
+         }
+         _test_thermal_(config, n, in, out, ref);
+         _test_jobs_(config, n, in, out, jobs);
+         checks += 2;
+         // Parameters are changed, so these checks are the last ones.
+         if (!bode && !newton) {
+            _test_status_(config, n, in, out, ref);
+            checks++;
+         }
+         if (bode) {
+            _test_poles_(config, n, in, out);
+            checks++;
+         }
+      }
+   }
+   if (test_failures) {
+      fprintf(stderr, "%ld failures in %ld checks !!!\n", test_failures,
+              checks);
+      return 1;
+   }
+   printf("All %ld checks passed.\n", checks);
+   return 0;
+}
@@ -0,0 +1,72 @@
+/* libtransistor
+
+The library is this single translation unit: it includes the headers
+that define all configurations and adds the functions of transistor.h
+that are not defined by them. It is built with -fvisibility=hidden,
+so helpers like '_shockley_Id_' stay internal (see Makefile).
+*/
+
+#include <string.h>
+#include "transistor.h"
+#include "BJT.h"
+#include "MOSFET.h"
+#include "CACHE.h"
+#include "INCREMENTAL.h"
+#include "OPTIMIZE.h"
+#include "SWEEP.h"
+#include "MONTE.h"
+#include "THERMAL.h"
+#include "STATUS.h"
+#include "POLARITY.h"
+
+// Percentiles of Monte Carlo statistics (MONTE.h).
+real monte_percentiles[MONTE_PERCENTILES] = {MONTE_RANKS};
+
+struct Config* transistor_config(char* family, char* name,
+                                 char* analysis, char* option) {
+   // Find the table of family and then the configuration in it.
+   struct Config* tables[] = {BJTConfigs, FETConfigs, MOSFETConfigs};
+   int counts[] = {BJTConfigCount, FETConfigCount, MOSFETConfigCount};
+   for (int t = 0; t < 3; t++)
+      if (counts[t] > 0 && strcmp(tables[t][0].family, family) == 0)
+         return _find_config_(tables[t], counts[t], name, analysis,
+                              option);
+   return NULL;
+}
+
+struct Model* transistor_model(char* family, char* name, char* option) {
+   // Find the model in table of family.
+   struct Model* tables[] = {BJTModels, FETModels, MOSFETModels};
+   int counts[] = {BJTModelCount, FETModelCount, MOSFETModelCount};
+   for (int t = 0; t < 3; t++) {
+      if (counts[t] == 0 || strcmp(tables[t][0].family, family)) continue;
+      for (int i = 0; i < counts[t]; i++)
+         if (strcmp(tables[t][i].name, name) == 0 &&
+             (!option || (tables[t][i].option &&
+                          strcmp(tables[t][i].option, option) == 0)))
+            return &tables[t][i];
+   }
+   return NULL;
+}
+
+struct BodeModel* transistor_bode(char* family, char* name,
+                                  char* option) {
+   // Find the frequency-response model in table of family.
+   struct BodeModel* tables[] = {BJTBodeModels, FETBodeModels,
+                                 MOSFETBodeModels};
+   int counts[] = {BJTBodeModelCount, FETBodeModelCount,
+                   MOSFETBodeModelCount};
+   for (int t = 0; t < 3; t++) {
+      if (counts[t] == 0 || strcmp(tables[t][0].family, family)) continue;
+      for (int i = 0; i < counts[t]; i++)
+         if (strcmp(tables[t][i].name, name) == 0 &&
+             (!option || (tables[t][i].option &&
+                          strcmp(tables[t][i].option, option) == 0)))
+            return &tables[t][i];
+   }
+   return NULL;
+}
+
+int transistor_precision(void) {
+   return sizeof(real);
+}
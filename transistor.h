@@ -0,0 +1,748 @@
+/* Public Interface of libtransistor
+
+This header declares everything that the library exports with a
+plain C ABI: result structs, the scalar and batch configuration
+functions and the 'Config' tables. A program that links
+libtransistor (static or shared) includes only this header. The
+programs in this directory include the implementation headers
+instead, which also include this one.
+
+'real' is float, or double when the library and the program are
+both built with -DPRECISION_DOUBLE (see PRECISION.h). A program can
+compare 'transistor_precision()' with sizeof(real) to be sure.
+
+'analysis' of a scalar function is "dc", "ac" or "both". With "both"
+the 'dc' and 'ac' structs are written in one call and the operating
+point is solved only once.
+*/
+
+#ifndef TRANSISTOR_H
+#define TRANSISTOR_H
+
+#include <stdint.h>
+#include "PRECISION.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Library is built with -fvisibility=hidden, so only declarations
+// that are marked with 'TRANSISTOR_API' are exported.
+#if defined(__GNUC__)
+#define TRANSISTOR_API __attribute__((visibility("default")))
+#else
+#define TRANSISTOR_API
+#endif
+
+/* Configuration Tables */
+
+// Maximum number of parameter or result columns of a configuration.
+#define CONFIG_COLUMNS 16
+
+struct Config {
+   char* family; // "bjt", "fet" (jfet and d-mosfet) or "mosfet"
+   char* name; // short name of configuration, e.g. "vd"
+   // "dc", "ac", "bode" (see BODE.h) or "newton" (nonlinear DC
+   // analysis with junctions of BJTs and channel-length modulation
+   // of FETs, see NEWTON.h)
+   char* analysis;
+   char* option; // bypass option of configuration or NULL
+   int nin; // number of parameter columns
+   char* inputs[CONFIG_COLUMNS]; // names of parameter columns
+   // Sign of every parameter column for p-type devices (POLARITY.h):
+   // '-' if it is negated (voltages of the circuit), '+' if not.
+   char* input_signs;
+   int nout; // number of result columns
+   char* outputs[CONFIG_COLUMNS]; // names of result columns
+   char* output_signs; // signs of result columns like 'input_signs'
+   // Batch function that reads 'in' and writes 'out' columns.
+   void (*batch)(long n, real** in, real** out);
+   // Write results of one point 'in' into 'out' and their derivatives
+   // with respect to all parameters into 'jacobian' (d out[r] / d in[c]
+   // at r * nin + c), from one evaluation with dual numbers (DUAL.h).
+   // NULL for "bode" and "newton" entries.
+   void (*jacobian)(real* in, real* out, real* jacobian);
+   // Write bounds of results over the box of parameters [low, high]
+   // into 'out_low' and 'out_high' (INTERVAL.h). NULL if results of
+   // configuration are not bounded.
+   void (*bound)(real* low, real* high, real* out_low, real* out_high);
+   // Batch function at base-emitter voltage 'Vbe' and thermal voltage
+   // 'VT' of a temperature (THERMAL.h). NULL if all parameters that
+   // depend on temperature are columns.
+   void (*thermal)(real Vbe, real VT, long n, real** in, real** out);
+};
+
+// Tables of configurations which have batch functions.
+TRANSISTOR_API extern struct Config BJTConfigs[];
+TRANSISTOR_API extern int BJTConfigCount;
+TRANSISTOR_API extern struct Config FETConfigs[];
+TRANSISTOR_API extern int FETConfigCount;
+TRANSISTOR_API extern struct Config MOSFETConfigs[];
+TRANSISTOR_API extern int MOSFETConfigCount;
+
+// Find configuration "family name analysis [option]" in all tables,
+// NULL if there is not. Family is "bjt", "fet" or "mosfet".
+TRANSISTOR_API
+struct Config* transistor_config(char* family, char* name,
+                                 char* analysis, char* option);
+// Bytes of 'real' which the library is built with.
+TRANSISTOR_API int transistor_precision(void);
+
+/* Operating-Point Cache */
+
+// Results of configurations keyed by parameters rounded to 'bits'
+// mantissa bits (see CACHE.h). Caches can be shared by threads.
+struct OpCache;
+
+// Create a cache of at least 'capacity' results, NULL if memory is
+// not enough.
+TRANSISTOR_API struct OpCache* op_cache_create(long capacity, int bits);
+TRANSISTOR_API void op_cache_destroy(struct OpCache* cache);
+// Write results of 'config' at parameters 'in' into 'out' (one value
+// per column). 1 is returned for a hit, 0 for a miss.
+TRANSISTOR_API
+int op_cache_eval(struct OpCache* cache, struct Config* config,
+                  real* in, real* out);
+// Number of hits and misses of cache since it is created.
+TRANSISTOR_API
+void op_cache_stats(struct OpCache* cache, long* hits, long* misses);
+
+/* Operating Regions */
+
+// Region of the transistor at a DC operating point (see REGION.h).
+// REGION_ACTIVE is the amplifying region: forward-active of BJTs and
+// saturation (pinch-off) of FETs.
+#define REGION_CUTOFF 0
+#define REGION_ACTIVE 1
+#define REGION_SATURATION 2 // BJT saturation
+#define REGION_TRIODE 3 // FET ohmic region
+#define REGION_INVALID 4 // a result is NaN, e.g. of invalid parameters
+// Set of regions for 'run_filter', e.g. REGION_MASK(REGION_ACTIVE).
+#define REGION_MASK(region) (1 << (region))
+
+// Write regions of 'n' points of DC entry 'config' from its parameter
+// columns 'in' and result columns 'out' into 'region'. -1 is returned
+// if results of entry do not have the region.
+TRANSISTOR_API
+int run_region(struct Config* config, long n, real** in, real** out,
+               unsigned char* region);
+// Evaluate 'n' points by 'dc' (columns 'dc_in'), then only the ones
+// whose region is in set 'regions' (bit 1 << region) by 'next'
+// (columns 'next_in' of same points), REGION_INVALID points never.
+// Rows of 'out' are results of kept points and 'index' gets the point
+// of each row. The number of
+// rows is returned, -1 if 'dc' has no region or memory is not enough.
+TRANSISTOR_API
+long run_filter(struct Config* dc, struct Config* next, long n,
+                real** dc_in, real** next_in, int regions, real** out,
+                long* index);
+
+/* Polarity of Devices */
+
+// Polarity of the transistor of a point (see POLARITY.h). Functions
+// are written for n-type devices, p-type points are their mirrors.
+#define POLARITY_N 1 // npn BJT, n-channel FET
+#define POLARITY_P -1 // pnp BJT, p-channel FET
+
+// Evaluate 'n' points of 'config' whose devices have 'polarity' like
+// its batch function. -1 is returned if memory is not enough.
+TRANSISTOR_API
+int run_polarity(struct Config* config, int polarity, long n,
+                 real** in, real** out);
+// Same with the polarity of every point in column 'polarity'.
+TRANSISTOR_API
+int run_mixed(struct Config* config, long n, real** in, real* polarity,
+              real** out);
+
+/* Status of Points */
+
+// Status of a point of batch (see STATUS.h) or scalar analysis.
+// Results of invalid and unsupported points are NaN.
+#define STATUS_OK 0
+#define STATUS_INVALID 1 // a parameter is out of its domain
+#define STATUS_UNSUPPORTED 2 // analysis is not supported
+#define STATUS_NONFINITE 3 // a result is not finite
+
+// Write the set of parameter columns of each of 'n' points which are
+// out of their domains into 'invalid' (bit c for 'in[c]'). The number
+// of invalid points is returned.
+TRANSISTOR_API
+long run_validate(struct Config* config, long n, real** in,
+                  unsigned* invalid);
+// Evaluate 'n' points like the batch function of 'config' and write
+// the status of every point into 'status'. The number of points which
+// are not STATUS_OK is returned.
+TRANSISTOR_API
+long run_checked(struct Config* config, long n, real** in, real** out,
+                 unsigned char* status);
+
+/* BJT Configurations */
+
+// Results of DC analysis
+struct DCBJT {
+   real Ib; // base current
+   real Ic; // collector current
+   real Ie; // emitter current
+   real Icsat; // collector saturation (max) current
+   real Vce; // collector-emitter voltage
+   real Vc; // collector voltage
+   real Ve; // emitter voltage
+   real Vb; // base voltage
+   real Vbc; // base-collector voltage
+   int region; // operating region
+   int status; // status of point
+};
+// Results of AC analysis
+struct ACBJT {
+   real re; // re factor
+   real Zi;  // input impedance
+   real Zo; // output impedance
+   real Av; // voltage gain
+   char* phase; // phase relationship
+   int status; // status of point
+};
+TRANSISTOR_API
+void b_fixed_bias(char* analysis, real Vcc, real Rb, real Rc, real beta,
+                  real ro, struct DCBJT* dc, struct ACBJT* ac);
+TRANSISTOR_API
+void b_emitter_bias(char* analysis, real Vcc, real Rb, real Rc, real Re,
+                    real beta, real ro, struct DCBJT* dc,
+                    struct ACBJT* ac);
+TRANSISTOR_API
+void b_voltage_divider(char* analysis, real Vcc, real Rb1, real Rb2,
+                       real Rc, real Re, real beta, real ro,
+                       char* bypass, struct DCBJT* dc,
+                       struct ACBJT* ac);
+TRANSISTOR_API
+void b_collector_feedback(char* analysis, real Vcc, real Rf, real Rc,
+                          real Re, real beta, real ro, struct DCBJT* dc,
+                          struct ACBJT* ac);
+TRANSISTOR_API
+void b_collector_dc_feedback(char* analysis, real Vcc, real Rf1,
+                             real Rf2, real Rc, real beta, real ro,
+                             struct DCBJT* dc, struct ACBJT* ac);
+TRANSISTOR_API
+void b_emitter_follower(char* analysis, real Vcc, real Vee, real Rb,
+                        real Re, real beta, real ro, struct DCBJT* dc,
+                        struct ACBJT* ac);
+TRANSISTOR_API
+void b_common_base(char* analysis, real Vcc, real Vee, real Rc, real Re,
+                   real beta, real alpha, struct DCBJT* dc,
+                   struct ACBJT* ac);
+TRANSISTOR_API
+void b_miscellaneous_bias(char* analysis, real Vcc, real Rb, real Rc,
+                          real beta, struct DCBJT* dc,
+                          struct ACBJT* ac);
+
+// Columns of DC results
+struct DCBJTBatch {
+   real* Ib; // base currents
+   real* Ic; // collector currents
+   real* Ie; // emitter currents
+   real* Icsat; // collector saturation (max) currents
+   real* Vce; // collector-emitter voltages
+   real* Vc; // collector voltages
+   real* Ve; // emitter voltages
+   real* Vb; // base voltages
+   real* Vbc; // base-collector voltages
+};
+// Columns of AC results
+struct ACBJTBatch {
+   real* re; // re factors
+   real* Zi; // input impedances
+   real* Zo; // output impedances
+   real* Av; // voltage gains
+};
+TRANSISTOR_API
+void b_fixed_bias_dc_batch(long n, real* Vcc, real* Rb, real* Rc,
+                           real* beta, struct DCBJTBatch* dc);
+TRANSISTOR_API
+void b_fixed_bias_ac_batch(long n, real* Vcc, real* Rb, real* Rc,
+                           real* beta, real* ro, struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_emitter_bias_dc_batch(long n, real* Vcc, real* Rb, real* Rc,
+                             real* Re, real* beta,
+                             struct DCBJTBatch* dc);
+TRANSISTOR_API
+void b_emitter_bias_ac_batch(long n, real* Vcc, real* Rb, real* Rc,
+                             real* Re, real* beta, real* ro,
+                             struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_voltage_divider_dc_batch(long n, real* Vcc, real* Rb1, real* Rb2,
+                                real* Rc, real* Re, real* beta,
+                                struct DCBJTBatch* dc);
+TRANSISTOR_API
+void b_voltage_divider_ac_batch(long n, real* Vcc, real* Rb1, real* Rb2,
+                                real* Rc, real* Re, real* beta,
+                                real* ro, char* bypass,
+                                struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_collector_feedback_dc_batch(long n, real* Vcc, real* Rf,
+                                   real* Rc, real* Re, real* beta,
+                                   struct DCBJTBatch* dc);
+TRANSISTOR_API
+void b_collector_feedback_ac_batch(long n, real* Vcc, real* Rf,
+                                   real* Rc, real* beta, real* ro,
+                                   struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_collector_dc_feedback_ac_batch(long n, real* Vcc, real* Rf1,
+                                      real* Rf2, real* Rc, real* beta,
+                                      real* ro, struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_emitter_follower_dc_batch(long n, real* Vee, real* Rb, real* Re,
+                                 real* beta, struct DCBJTBatch* dc);
+TRANSISTOR_API
+void b_emitter_follower_ac_batch(long n, real* Vcc, real* Rb, real* Re,
+                                 real* beta, real* ro,
+                                 struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_common_base_dc_batch(long n, real* Vcc, real* Vee, real* Rc,
+                            real* Re, real* beta,
+                            struct DCBJTBatch* dc);
+TRANSISTOR_API
+void b_common_base_ac_batch(long n, real* Vee, real* Rc, real* Re,
+                            real* alpha, struct ACBJTBatch* ac);
+TRANSISTOR_API
+void b_miscellaneous_bias_dc_batch(long n, real* Vcc, real* Rb,
+                                   real* Rc, real* beta,
+                                   struct DCBJTBatch* dc);
+/* JFET and D-MOSFET Configurations */
+
+// Results of DC Analysis
+struct DCFET {
+   real Id; // drain current
+   real Vgs; // gate-source voltage
+   real Vds; // drain-source voltage
+   real Vs; // source voltage
+   real Vd; // drain voltage
+   real Vg; // gate voltage
+   int region; // operating region
+   int status; // status of point
+};
+// Results of AC Analysis
+struct ACFET {
+   real gm; // transconductance factor
+   real Zi; // input impedance
+   real Zo; // output impedance
+   real Av; // voltage gain
+   char* phase; // phase relationship
+   int status; // status of point
+};
+TRANSISTOR_API
+void f_fixed_bias(char* analysis, real Vdd, real Vgg, real Rg, real Rd,
+                  real Idss, real Vp, real rd, struct DCFET* dc,
+                  struct ACFET* ac);
+TRANSISTOR_API
+void f_self_bias(char* analysis, real Vdd, real Rg, real Rd, real Rs,
+                 real Idss, real Vp, real rd, struct DCFET* dc,
+                 struct ACFET* ac);
+TRANSISTOR_API
+void f_voltage_divider(char* analysis, real Vdd, real Rg1, real Rg2,
+                       real Rd, real Rs, real Idss, real Vp, real rd,
+                       struct DCFET* dc, struct ACFET* ac);
+TRANSISTOR_API
+void f_common_gate(char* analysis, real Vdd, real Vss, real Rd, real Rs,
+                   real Idss, real Vp, real rd, struct DCFET* dc,
+                   struct ACFET* ac);
+TRANSISTOR_API
+void f_source_follower(char* analysis, real Vdd, real Vgs, real Rg,
+                       real Rs, real Idss, real Vp, real rd,
+                       struct DCFET* dc, struct ACFET* ac);
+
+// Columns of DC results
+struct DCFETBatch {
+   real* Id; // drain currents
+   real* Vgs; // gate-source voltages
+   real* Vds; // drain-source voltages
+   real* Vs; // source voltages
+   real* Vd; // drain voltages
+   real* Vg; // gate voltages
+};
+// Columns of AC results
+struct ACFETBatch {
+   real* gm; // transconductance factors
+   real* Zi; // input impedances
+   real* Zo; // output impedances
+   real* Av; // voltage gains
+};
+TRANSISTOR_API
+void f_fixed_bias_dc_batch(long n, real* Vdd, real* Vgg, real* Rd,
+                           real* Idss, real* Vp, struct DCFETBatch* dc);
+TRANSISTOR_API
+void f_fixed_bias_ac_batch(long n, real* Vgg, real* Rg, real* Rd,
+                           real* Idss, real* Vp, real* rd,
+                           struct ACFETBatch* ac);
+TRANSISTOR_API
+void f_self_bias_dc_batch(long n, real* Vdd, real* Rd, real* Rs,
+                          real* Idss, real* Vp, struct DCFETBatch* dc);
+TRANSISTOR_API
+void f_self_bias_ac_batch(long n, real* Rg, real* Rd, real* Rs,
+                          real* Idss, real* Vp, real* rd,
+                          struct ACFETBatch* ac);
+TRANSISTOR_API
+void f_voltage_divider_dc_batch(long n, real* Vdd, real* Rg1, real* Rg2,
+                                real* Rd, real* Rs, real* Idss, real* Vp,
+                                struct DCFETBatch* dc);
+TRANSISTOR_API
+void f_voltage_divider_ac_batch(long n, real* Vdd, real* Rg1, real* Rg2,
+                                real* Rd, real* Rs, real* Idss, real* Vp,
+                                real* rd, struct ACFETBatch* ac);
+TRANSISTOR_API
+void f_common_gate_dc_batch(long n, real* Vdd, real* Vss, real* Rd,
+                            real* Rs, real* Idss, real* Vp,
+                            struct DCFETBatch* dc);
+TRANSISTOR_API
+void f_common_gate_ac_batch(long n, real* Vss, real* Rd, real* Rs,
+                            real* Idss, real* Vp, real* rd,
+                            struct ACFETBatch* ac);
+TRANSISTOR_API
+void f_source_follower_ac_batch(long n, real* Vgs, real* Rg, real* Rs,
+                                real* Idss, real* Vp, real* rd,
+                                struct ACFETBatch* ac);
+/* E-MOSFET Configurations */
+
+// Results of DC Analysis
+struct DCMOSFET {
+   real k; // k constant
+   real Id; // drain current
+   real Vgs; // gate-source voltage
+   real Vds; // drain-source voltage
+   int region; // operating region
+   int status; // status of point
+};
+// Results of AC Analysis
+struct ACMOSFET {
+   real gm; // transconductance factor
+   real Zi; // input impedance
+   real Zo; // output impedance
+   real Av; // voltage gain
+   char* phase; // phase relationship
+   int status; // status of point
+};
+TRANSISTOR_API
+void m_drain_feedback(char* analysis, real Vdd, real Rg, real Rd,
+                      real Idon, real Vgson, real Vgsth, real rd,
+                      struct DCMOSFET* dc, struct ACMOSFET* ac);
+TRANSISTOR_API
+void m_voltage_divider(char* analysis, real Vdd, real Rg1, real Rg2,
+                       real Rd, real Rs, real Idon, real Vgson,
+                       real Vgsth, real rd, struct DCMOSFET* dc,
+                       struct ACMOSFET* ac);
+
+// Columns of DC results
+struct DCMOSFETBatch {
+   real* k; // k constants
+   real* Id; // drain currents
+   real* Vgs; // gate-source voltages
+   real* Vds; // drain-source voltages
+};
+// Columns of AC results
+struct ACMOSFETBatch {
+   real* gm; // transconductance factors
+   real* Zi; // input impedances
+   real* Zo; // output impedances
+   real* Av; // voltage gains
+};
+TRANSISTOR_API
+void m_drain_feedback_dc_batch(long n, real* Vdd, real* Rd, real* Idon,
+                               real* Vgson, real* Vgsth,
+                               struct DCMOSFETBatch* dc);
+TRANSISTOR_API
+void m_drain_feedback_ac_batch(long n, real* Vdd, real* Rg, real* Rd,
+                               real* Idon, real* Vgson, real* Vgsth,
+                               real* rd, struct ACMOSFETBatch* ac);
+TRANSISTOR_API
+void m_voltage_divider_dc_batch(long n, real* Vdd, real* Rg1, real* Rg2,
+                                real* Rd, real* Rs, real* Idon,
+                                real* Vgson, real* Vgsth,
+                                struct DCMOSFETBatch* dc);
+TRANSISTOR_API
+void m_voltage_divider_ac_batch(long n, real* Vdd, real* Rg1, real* Rg2,
+                                real* Rd, real* Rs, real* Idon,
+                                real* Vgson, real* Vgsth, real* rd,
+                                struct ACMOSFETBatch* ac);
+/* Incremental Evaluation */
+
+// Maximum number of values of an operating point.
+#define MODEL_OP 4
+
+// Stages of a configuration and parameters which they read. A stage
+// is solved again only when one of its parameters is changed.
+struct Model {
+   char* family; // "bjt", "fet" (jfet and d-mosfet) or "mosfet"
+   char* name; // short name of configuration, e.g. "vd"
+   char* option; // bypass option of configuration or NULL
+   char* analyses; // supported analysis: "dc", "ac" or "both"
+   int nparams; // number of parameters
+   // Names of parameters in order of the configuration function.
+   char* params[CONFIG_COLUMNS];
+   // Parameters (names separated by spaces) which the operating
+   // point, the DC stage and the AC stage read.
+   char* op_depends;
+   char* dc_depends;
+   char* ac_depends;
+   // Run 'stages' with parameters 'p' and operating point 'op', and
+   // write results of stages into 'dc' and 'ac' structs of family.
+   void (*run)(int stages, real* p, real* op, void* dc, void* ac);
+};
+
+// Tables of configuration models.
+TRANSISTOR_API extern struct Model BJTModels[];
+TRANSISTOR_API extern int BJTModelCount;
+TRANSISTOR_API extern struct Model FETModels[];
+TRANSISTOR_API extern int FETModelCount;
+TRANSISTOR_API extern struct Model MOSFETModels[];
+TRANSISTOR_API extern int MOSFETModelCount;
+
+// Evaluation of a configuration which keeps its operating point and
+// results between updates.
+struct Incremental {
+   struct Model* model;
+   int stages; // kept stages (analysis codes of CONFIG.h)
+   real params[CONFIG_COLUMNS]; // current parameters
+   unsigned depends[3]; // parameter masks of operating point, dc, ac
+   unsigned changed; // mask of parameters changed since last update
+   int solved; // zero until the first update
+   real op[MODEL_OP]; // operating point
+   union {
+      struct DCBJT bjt;
+      struct DCFET fet;
+      struct DCMOSFET mosfet;
+   } dc; // results of DC analysis
+   union {
+      struct ACBJT bjt;
+      struct ACFET fet;
+      struct ACMOSFET mosfet;
+   } ac; // results of AC analysis
+   long runs[3]; // runs of operating point, DC and AC stages
+};
+
+// Find model "family name [option]" in all tables, NULL if there is
+// not. If 'option' is NULL, the first one with the name is returned.
+TRANSISTOR_API
+struct Model* transistor_model(char* family, char* name, char* option);
+// Start evaluation of 'model' for "dc", "ac" or "both" analysis with
+// 'params' (in order of 'params' of model). -1 is returned if model
+// does not support the analysis.
+TRANSISTOR_API
+int incremental_init(struct Incremental* inc, struct Model* model,
+                     char* analysis, real* params);
+// Index of parameter 'name' of evaluation, -1 if there is not.
+TRANSISTOR_API int incremental_param(struct Incremental* inc, char* name);
+// Change parameter 'param' (index), results are not updated yet.
+TRANSISTOR_API
+void incremental_set(struct Incremental* inc, int param, real value);
+// Solve again only the stages which read changed parameters.
+TRANSISTOR_API void incremental_update(struct Incremental* inc);
+
+/* Frequency Response */
+
+// Topologies of configurations for Miller capacitances (BODE.h).
+#define BODE_INVERTING 0 // common emitter or source, Cbc/Cgd bridge
+#define BODE_COMMON_BASE 1 // common base or gate, no bridge
+#define BODE_FOLLOWER 2 // emitter or source follower, Cbe/Cgs bridge
+
+// Frequency response of a configuration from its AC entry. Parameters
+// of a design are the ones of the AC entry, then Rsig, RL, Cin, Cout,
+// the bypass capacitor (if 'bypassed' is not -1) and the capacitances
+// of the device (Cbe and Cbc, or Cgs and Cgd).
+struct BodeModel {
+   char* family; // "bjt", "fet" (jfet and d-mosfet) or "mosfet"
+   char* name; // short name of configuration, e.g. "vd"
+   char* option; // bypass option of configuration or NULL
+   int topology; // BODE_INVERTING, BODE_COMMON_BASE or BODE_FOLLOWER
+   int nin; // number of parameters of the AC entry
+   int bypassed; // parameter of bypassed Re or Rs, -1 if there is not
+   int beta; // parameter of beta (BJT), -1 if there is not
+   void (*ac)(long n, real** in, real** out); // batch of the AC entry
+};
+
+// Tables of frequency-response models.
+TRANSISTOR_API extern struct BodeModel BJTBodeModels[];
+TRANSISTOR_API extern int BJTBodeModelCount;
+TRANSISTOR_API extern struct BodeModel FETBodeModels[];
+TRANSISTOR_API extern int FETBodeModelCount;
+TRANSISTOR_API extern struct BodeModel MOSFETBodeModels[];
+TRANSISTOR_API extern int MOSFETBodeModelCount;
+
+// Find model "family name [option]" in all tables, NULL if there is
+// not. If 'option' is NULL, the first one with the name is returned.
+TRANSISTOR_API
+struct BodeModel* transistor_bode(char* family, char* name,
+                                  char* option);
+// Write the complex gain from source to load, input and output
+// impedance of design 'in' at 'nf' frequencies 'f' (Hz) into columns
+// 'out': Av real, Av imaginary, Zi real, Zi imaginary, Zo real and
+// Zo imaginary.
+TRANSISTOR_API
+void bode_response(struct BodeModel* model, real* in, long nf, real* f,
+                   real** out);
+// Write 'n' log-spaced frequencies from 'low' to 'high' into 'f'.
+TRANSISTOR_API
+void bode_frequencies(real low, real high, long n, real* f);
+
+/* Design Optimizer */
+
+// A target of a result column. The relative error of result is
+// (result - value) / |value| (result - value if value is zero).
+struct DesignTarget {
+   char* result; // name of result column, e.g. "Av"
+   real value; // target value
+   real tolerance; // maximum relative error, 0 if it is not limited
+};
+
+// Search of parameter values of a configuration that meet targets of
+// its DC and AC results (see OPTIMIZE.h).
+struct Design {
+   struct Config* dc; // DC entry of configuration or NULL
+   struct Config* ac; // AC entry of configuration or NULL
+   // 12, 24 or 96 for values of E12, E24 or E96 series, 0 for any
+   // value in range.
+   int series;
+   int nparams; // parameters of both entries
+   char* params[CONFIG_COLUMNS];
+   // Range of each parameter, a fixed parameter has low = high.
+   real low[CONFIG_COLUMNS], high[CONFIG_COLUMNS];
+   int ntargets;
+   struct DesignTarget targets[CONFIG_COLUMNS];
+   long evaluated; // points evaluated by the last search
+};
+
+// A design which is found by a search.
+struct DesignResult {
+   real params[CONFIG_COLUMNS]; // in order of 'params' of design
+   real results[CONFIG_COLUMNS]; // in order of targets of design
+   real error; // sum of squares of relative errors of targets
+};
+
+// Start a design of configuration with its 'dc' and 'ac' entries (one
+// can be NULL). Parameters are not set yet. -1 is returned if both
+// entries are NULL or parameters are too many.
+TRANSISTOR_API
+int design_init(struct Design* design, struct Config* dc,
+                struct Config* ac);
+// Search parameter 'name' in [low, high] or fix it (low = high). -1 is
+// returned if there is not a parameter 'name'.
+TRANSISTOR_API
+int design_param(struct Design* design, char* name, real low, real high);
+// Add a target of result column 'result'. -1 is returned if there is
+// not a result 'result' or targets are too many.
+TRANSISTOR_API
+int design_target(struct Design* design, char* result, real value,
+                  real tolerance);
+// Search on 'threads' threads (all cores if zero) and write at most
+// 'count' best designs into 'best', the best one first. The number of
+// designs is returned, -1 if a parameter is not set, a range has too
+// many series values or memory is not enough.
+TRANSISTOR_API
+int run_design(struct Design* design, int threads, int count,
+               struct DesignResult* best);
+// Search best-first on the calling thread and give each design to
+// 'emit' as soon as no better design can be found, the best one first.
+// The search stops after 'count' designs or when 'emit' returns
+// nonzero. The number of designs is returned, -1 as 'run_design' or
+// if open branches of search are too many.
+TRANSISTOR_API
+int stream_design(struct Design* design, int count,
+                  int (*emit)(struct DesignResult* result, void* context),
+                  void* context);
+
+/* Parameter Sweeps */
+
+// Points of a configuration: a grid of values (every combination) or
+// a list (i'th values of all parameters form the i'th point).
+struct Sweep {
+   struct Config* config; // configuration to be evaluated
+   int grid; // 1 for grid of values, 0 for list of points
+   real* values[CONFIG_COLUMNS]; // values of each parameter
+   // Number of values of each parameter. In a list, a parameter that
+   // has one value is same for all points, the others must have one
+   // value for each point (the largest count).
+   long counts[CONFIG_COLUMNS];
+};
+
+// Number of points of sweep.
+TRANSISTOR_API long sweep_points(struct Sweep* sweep);
+// Write 'count' linearly or logarithmically spaced values from
+// 'start' to 'stop' into 'values'.
+TRANSISTOR_API
+void sweep_range(real start, real stop, long count, int logarithmic,
+                 real* values);
+// Evaluate all points of sweep on 'threads' threads (all cores if
+// zero). Each of 'results' columns must have room for 'sweep_points'
+// values. -1 is returned if memory is not enough or a count of a list
+// is neither 1 nor 'sweep_points'.
+TRANSISTOR_API
+int run_sweep(struct Sweep* sweep, int threads, real** results);
+
+/* Monte Carlo Tolerance Analysis */
+
+// Distributions of parameters.
+#define MONTE_EXACT 0
+#define MONTE_UNIFORM 1
+#define MONTE_GAUSSIAN 2
+
+// Percentiles which are reported for every result column (MONTE.h).
+#define MONTE_PERCENTILES 7
+#define MONTE_RANKS 1, 5, 25, 50, 75, 95, 99
+TRANSISTOR_API extern real monte_percentiles[MONTE_PERCENTILES];
+
+struct MonteCarlo {
+   struct Config* config; // configuration to be evaluated
+   real nominal[CONFIG_COLUMNS]; // nominal values of parameters
+   int distributions[CONFIG_COLUMNS]; // distribution of parameters
+   real tolerances[CONFIG_COLUMNS]; // relative tolerance of them
+   long trials; // number of trials
+   uint64_t seed; // seed of random numbers
+};
+
+// Statistics of a result column.
+struct MonteStats {
+   long count; // number of trials with a valid (not NaN) result
+   double mean, sigma;
+   real min, max;
+   real percentiles[MONTE_PERCENTILES];
+};
+
+// Run all trials on 'threads' threads (all cores if zero). Results of
+// trials are written into 'results' columns if they are given, and
+// 'stats' gets statistics of every result column. -1 is returned if
+// memory is not enough.
+TRANSISTOR_API
+int run_monte_carlo(struct MonteCarlo* mc, int threads, real** results,
+                    struct MonteStats* stats);
+// Fraction of 'n' results of 'column' which are in [low, high].
+TRANSISTOR_API real monte_yield(real* column, long n, real low, real high);
+
+/* Temperature Sweeps */
+
+// Coefficients of device parameters over temperature (THERMAL.h).
+struct Thermal {
+   real T0; // reference temperature of parameters (°C)
+   real Vbe, VT; // base-emitter and thermal voltage at T0 (V)
+   real dVbe; // change of Vbe (V/°C)
+   real dbeta; // relative change of beta (1/°C)
+   real dIdss; // relative change of Idss (1/°C)
+   real dVp; // change of Vp (V/°C)
+   real dVgsth; // change of Vgs(th) and Vgs(on) (V/°C)
+   real dk; // relative change of k and Id(on) (1/°C)
+   real XTI; // exponent of temperature of Is
+   real Eg; // energy gap (eV) of Is
+};
+
+// Typical coefficients of small-signal silicon transistors.
+TRANSISTOR_API void thermal_defaults(struct Thermal* thermal);
+// Evaluate 'n' points of 'in' columns at 'nt' temperatures (°C) on
+// 'threads' threads (all cores if zero). Each of 'out' columns must
+// have room for nt * n values, point i at temperature t is at
+// t * n + i. -1 is returned if memory is not enough.
+TRANSISTOR_API
+int run_thermal(struct Thermal* thermal, struct Config* config, long n,
+                real** in, long nt, real* temperatures, int threads,
+                real** out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif